@@ -0,0 +1,157 @@
+#include "clock_face.h"
+#include <stdio.h>
+
+// 7段数码管模式定义
+constexpr uint8_t segment_patterns[10] = {
+    0b1111110, // 0: abcdef
+    0b0110000, // 1: bc
+    0b1101101, // 2: abged
+    0b1111001, // 3: abgcd
+    0b0110011, // 4: fgbc
+    0b1011011, // 5: afgcd
+    0b1011111, // 6: afgcde
+    0b1110000, // 7: abc
+    0b1111111, // 8: abcdefg
+    0b1111011  // 9: abcfgd
+};
+
+// 7段数码管数字（缩小版本：14x28像素），编译期合成，含黑色背景
+constexpr ssd1306_static_image_t<14, 28> make_segment_digit(int digit) {
+    ssd1306_static_image_t<14, 28> img{};
+    const uint8_t pattern = segment_patterns[digit];
+    if (pattern & 0b1000000) img.fillRect(1, 1, 12, 1);   // a段 - 上横线
+    if (pattern & 0b0100000) img.fillRect(12, 3, 1, 10);  // b段 - 右上竖线
+    if (pattern & 0b0010000) img.fillRect(12, 15, 1, 10); // c段 - 右下竖线
+    if (pattern & 0b0001000) img.fillRect(1, 25, 12, 1);  // d段 - 下横线
+    if (pattern & 0b0000100) img.fillRect(1, 15, 1, 10);  // e段 - 左下竖线
+    if (pattern & 0b0000010) img.fillRect(1, 3, 1, 10);   // f段 - 左上竖线
+    if (pattern & 0b0000001) img.fillRect(1, 13, 12, 1);  // g段 - 中横线
+    return img;
+}
+
+static constexpr ssd1306_static_image_t<14, 28> segment_digits[10] = {
+    make_segment_digit(0), make_segment_digit(1), make_segment_digit(2), make_segment_digit(3),
+    make_segment_digit(4), make_segment_digit(5), make_segment_digit(6), make_segment_digit(7),
+    make_segment_digit(8), make_segment_digit(9)
+};
+
+// 星期标签，DS3231的星期定义：0=Sunday, 1=Monday, 2=Tuesday, ..., 6=Saturday
+static constexpr ssd1306_static_image_t<18, 8> weekday_labels[7] = {
+    ssd1306_static_text("Sun"), ssd1306_static_text("Mon"), ssd1306_static_text("Tue"),
+    ssd1306_static_text("Wed"), ssd1306_static_text("Thu"), ssd1306_static_text("Fri"),
+    ssd1306_static_text("Sat")
+};
+
+// 绘制7段数码管数字：复制预合成的图像，同时清除数字区域
+void draw7SegmentDigit(SSD1306& oled, int x, int y, int digit, bool highlight) {
+    if (digit < 0 || digit > 9) return;
+    
+    oled.drawStatic(x, y, segment_digits[digit], SSD1306_BLEND_COPY);
+    
+    // 添加高亮效果（边框）
+    if (highlight) {
+        oled.drawRect(x, y, 14, 28, SSD1306_WHITE);
+    }
+}
+
+// 绘制冒号（缩小版本）
+void drawColon(SSD1306& oled, int x, int y, bool blink) {
+    static bool colon_state = false;
+    if (blink) {
+        colon_state = !colon_state;
+    }
+    
+    if (colon_state || !blink) {
+        // 上点（缩小）
+        oled.fillCircle(x + 2, y + 8, 1, SSD1306_WHITE);
+        // 下点（缩小）
+        oled.fillCircle(x + 2, y + 20, 1, SSD1306_WHITE);
+    }
+}
+
+// 绘制黄色区域内容（按方案三重新设计）
+void drawYellowArea(SSD1306& oled, int year, int month, int day, int weekday, float temperature) {
+    // 清除黄色区域
+    oled.fillRect(0, 0, 128, YELLOW_HEIGHT, SSD1306_BLACK);
+    
+    // 第1行：显示日期（左对齐）
+    char date_str[16];
+    snprintf(date_str, sizeof(date_str), "%04d-%02d-%02d", year, month, day);
+    oled.setCursor(2, 1);
+    oled.setTextSize(1);
+    oled.print(date_str);
+    
+    // 第2行：星期（左对齐）+ 温度（右对齐）
+    if (weekday >= 0 && weekday < 7) {
+        oled.drawStatic(2, 9, weekday_labels[weekday]);
+    }
+    
+    // 温度显示在右侧
+    char temp_str[12];
+    snprintf(temp_str, sizeof(temp_str), "%.1f°C", temperature);
+    oled.setCursor(90, 9); // 右对齐位置
+    oled.setTextSize(1);
+    oled.print(temp_str);
+}
+
+// 绘制蓝色区域内容（时间）
+void drawBlueArea(SSD1306& oled, int hour, int minute, int second, bool colon_blink, bool show_seconds) {
+    // 清除蓝色区域
+    oled.fillRect(0, YELLOW_HEIGHT, 128, BLUE_HEIGHT, SSD1306_BLACK);
+    
+    // 重新计算时间显示位置（缩小字体后的布局）
+    // 新布局：6个数字×14 + 2个冒号×4 + 间距 = 约100px
+    // 起始位置: (128-100)/2 = 14，居中显示
+    // 隐藏秒时HH:MM约70px，起始位置(128-70)/2 = 29
+    int start_x = show_seconds ? 14 : 29;
+    int y = YELLOW_HEIGHT + 8; // 蓝色区域内的垂直居中
+    
+    // 绘制小时 (HH)
+    draw7SegmentDigit(oled, start_x, y, hour / 10);
+    draw7SegmentDigit(oled, start_x + 16, y, hour % 10);
+    
+    // 绘制第一个冒号（小时和分钟之间，增加左右间距）
+    drawColon(oled, start_x + 34, y + 2, false); // 左边间距2像素
+    
+    // 绘制分钟 (MM)
+    draw7SegmentDigit(oled, start_x + 40, y, minute / 10); // 右边间距2像素
+    draw7SegmentDigit(oled, start_x + 56, y, minute % 10);
+    
+    if (!show_seconds) {
+        return;
+    }
+    
+    // 绘制第二个冒号（分钟和秒之间，增加左右间距）
+    drawColon(oled, start_x + 70, y + 2, false); // 左边间距2像素
+    
+    // 绘制秒 (SS)
+    draw7SegmentDigit(oled, start_x + 76, y, second / 10); // 右边间距2像素
+    draw7SegmentDigit(oled, start_x + 92, y, second % 10);
+}
+
+// 移除装饰性背景
+void drawBackground(SSD1306& oled) {
+    // 移除所有装饰线条
+}
+
+// 渲染双色时钟到缓冲区（不传输）
+void renderDualColorClock(SSD1306& oled, const ds3231_time_t& time, float temperature, bool colon_blink,
+                          bool show_seconds) {
+    SSD1306_TRACE_SCOPE("clock.render");
+    oled.clearDisplay();
+    
+    // 绘制背景装饰
+    drawBackground(oled);
+    
+    // 绘制黄色区域（日期、温度和星期）
+    drawYellowArea(oled, 2000 + time.year, time.month, time.date, time.day, temperature);
+    
+    // 绘制蓝色区域（时间）
+    drawBlueArea(oled, time.hours, time.minutes, time.seconds, colon_blink, show_seconds);
+}
+
+// 绘制双色时钟
+void drawDualColorClock(SSD1306& oled, const ds3231_time_t& time, float temperature, bool colon_blink) {
+    renderDualColorClock(oled, time, temperature, colon_blink);
+    oled.display();
+}
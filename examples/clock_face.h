@@ -0,0 +1,27 @@
+#ifndef CLOCK_FACE_H
+#define CLOCK_FACE_H
+
+#include "ssd1306.h"
+#include "ds3231/ds3231.h"
+
+// 双色时钟表盘：上方黄色区域显示日期、星期和温度，下方蓝色区域以7段数码管显示时间。
+// 只写帧缓冲，不传输；示例与主机端工具（tools/ssd1306_golden_render）共用同一份绘制代码
+
+// 显示区域定义
+#define YELLOW_HEIGHT 20
+#define BLUE_HEIGHT 44
+
+void draw7SegmentDigit(SSD1306& oled, int x, int y, int digit, bool highlight = false);
+void drawColon(SSD1306& oled, int x, int y, bool blink = false);
+void drawYellowArea(SSD1306& oled, int year, int month, int day, int weekday, float temperature);
+void drawBlueArea(SSD1306& oled, int hour, int minute, int second, bool colon_blink = true,
+                  bool show_seconds = true);
+void drawBackground(SSD1306& oled);
+
+// 渲染双色时钟到缓冲区（不传输）；show_seconds为false时只显示时分
+void renderDualColorClock(SSD1306& oled, const ds3231_time_t& time, float temperature, bool colon_blink = true,
+                          bool show_seconds = true);
+// 渲染并传输整屏
+void drawDualColorClock(SSD1306& oled, const ds3231_time_t& time, float temperature, bool colon_blink = true);
+
+#endif // CLOCK_FACE_H
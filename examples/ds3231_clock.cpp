@@ -4,8 +4,22 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
+#include "hardware/watchdog.h"
 #include "ssd1306.h"
+#include "ssd1306_anim.h"
+#include "ssd1306_codec.h"
+#include "ssd1306_power.h"
+#include "ssd1306_golden.h"
+#include "ssd1306_rowmajor.h"
+#include "ssd1306_ref.h"
+#include "event_loop.h"
+#include "log_sink.h"
 #include "ds3231/ds3231.h"
+#include "ds3231/ds3231_calendar.h"
+#include "ds3231/ds3231_timekeeper.h"
+#include "ds3231/ds3231_calibration.h"
+#include "clock_face.h"
+#include "golden_scenes.h"
 
 // 硬件连接定义
 #define SSD1306_I2C_PORT i2c0
@@ -14,159 +28,852 @@
 #define DS3231_I2C_PORT i2c1
 #define DS3231_SDA_PIN 4
 #define DS3231_SCL_PIN 5
+#define DS3231_SQW_PIN 6   // DS3231 SQW/INT（开漏，内部上拉）
 
-// 显示区域定义
-#define YELLOW_HEIGHT 20
-#define BLUE_HEIGHT 44
-
-// 7段数码管模式定义
-const uint8_t segment_patterns[10] = {
-    0b1111110, // 0: abcdef
-    0b0110000, // 1: bc
-    0b1101101, // 2: abged
-    0b1111001, // 3: abgcd
-    0b0110011, // 4: fgbc
-    0b1011011, // 5: afgcd
-    0b1011111, // 6: afgcde
-    0b1110000, // 7: abc
-    0b1111111, // 8: abcdefg
-    0b1111011  // 9: abcfgd
-};
+// 共享总线：置1时SSD1306和DS3231都接在I2C0（GP2/GP3）上，由总线仲裁器调度
+#define SHARED_I2C_BUS 0
 
-// 绘制7段数码管数字（缩小版本：14x28像素）
-void draw7SegmentDigit(SSD1306& oled, int x, int y, int digit, bool highlight = false) {
-    if (digit < 0 || digit > 9) return;
-    
-    uint8_t pattern = segment_patterns[digit];
-    
-    // 清除数字区域（缩小到14x28）
-    oled.fillRect(x, y, 14, 28, SSD1306_BLACK);
+// 事件时间戳：置1时DS3231 32kHz输出接GP7（PWM3 B通道），GP8上的边沿以RTC时间标记
+#define EVENT_STAMPING 0
+#define DS3231_32KHZ_PIN 7
+#define EVENT_INPUT_PIN 8
+
+// 低功耗显示：置1时无操作1分钟后隐藏秒、改为每分钟刷新并降低对比度，
+// 23:00-07:00关闭面板；GP9接按键（另一端接地）回到每秒刷新。
+// LOW_POWER_DORMANT置1时两次唤醒之间MCU进入dormant（USB串口不可用，请用UART）
+#define LOW_POWER_MODE 0
+#define LOW_POWER_DORMANT 0
+#define WAKE_BUTTON_PIN 9
+
+// 黄金图像场景（golden_scenes.cpp）：置1时启动后在设备上渲染一组场景，以$SSDG记录行输出画面
+// 与渲染耗时，主机用tools/ssd1306_golden与tools/golden中的黄金图像比较。只检查画面时
+// 不需要设备：tools/ssd1306_golden_render在主机上渲染同一组场景（耗时只能在设备上测量）。
+// SSD1306_INSTRUMENT=1时另输出$SSDC开销记录，与主机上的计数相同
+#define GOLDEN_SCENES 0
+#define GOLDEN_SCENE_RUNS 8 // 每个场景渲染的次数，取最短耗时
+
+// 帧缓冲布局基准：置1时启动后比较页格式与行主序（RowCanvas）绘制文本和进度条画面的耗时
+#define LAYOUT_BENCH 0
+#define LAYOUT_BENCH_RUNS 16
+
+// 绘图原语性质测试：置1时启动后用随机用例（坐标偏向画面边缘与int16极值）比较SSD1306的
+// 绘图原语与参考光栅化器（ssd1306_ref.h），打印前几个不一致的调用形式与差异图，
+// 以及每种原语优化实现与参考实现的平均耗时
+#define PRIMITIVE_FUZZ 0
+#define PRIMITIVE_FUZZ_CASES 20000
+#define PRIMITIVE_FUZZ_SEED 1
+
+// 帧调度：主循环10fps检测秒变化，启动过渡动画50fps
+#define CLOCK_FRAME_PERIOD_US 100000
+#define TRANSITION_FRAME_PERIOD_US 20000
+#define TRANSITION_DURATION_US 400000
+
+// 等待SQW节拍的超时时间，超时后认为SQW未连接，退回轮询
+#define SQW_TICK_TIMEOUT_US 1500000
+
+// 软件计时与DS3231的重新同步间隔（秒）
+#define TIMEKEEPER_RESYNC_S 600
+
+// 块刷新：置1时主循环每秒只传输内容变化的8x8块，置0时每秒传输整屏
+#define TILE_FLUSH 1
+
+// 串口参考时间的轮询周期
+#define SERIAL_POLL_PERIOD_US 100000
+
+// 每秒记录读取的时间与温度（调试用）
+#define CLOCK_DEBUG_LOG 0
+
+// 主循环的日志先写入缓冲区，由最低优先级的log任务输出；置1时以$SSDL记录行输出，
+// 由tools/log_decode在主机上格式化，设备上不做浮点格式化
+#define LOG_BINARY 0
+#define LOG_DRAIN_BATCH 4       // log任务每次最多输出的行数
+
+// 画面镜像：置1后每帧以压缩记录行输出到串口，主机用tools/ssd1306_replay回放
+#define FRAME_MIRROR_ENABLED 0
+
+// 冷启动时等待面板上电复位完成（ms）
+#define SSD1306_POWERUP_DELAY_MS 100
+// 启动画面显示时间，期间USB串口完成枚举
+#define SPLASH_SCREEN_MS 2000
+
+// 面板内容影子：放在复位时不清零的RAM中，看门狗复位后仍有效
+static ssd1306_shadow_t __uninitialized_ram(panel_shadow);
+
+#if SSD1306_INSTRUMENT
+// 驱动追踪事件先缓存，每10秒以$SSDT记录行输出（主机用tools/ssd1306_trace转换）
+#define TRACE_DUMP_PERIOD_S 10
+static ssd1306_trace_buffer_t trace_buffer;
+#endif
+
+#if GOLDEN_SCENES
+// 逐个渲染场景（见golden_scenes.h）并输出记录；计时只含渲染，不含输出
+static void runGoldenScenes(SSD1306& oled) {
+    const size_t size = oled.width() * ((oled.height() + 7) / 8);
     
-    // 绘制各个段（按比例缩小）
-    if (pattern & 0b1000000) { // a段 - 上横线
-        oled.drawFastHLine(x + 1, y + 1, 12, SSD1306_WHITE);
-    }
-    if (pattern & 0b0100000) { // b段 - 右上竖线
-        oled.drawFastVLine(x + 12, y + 3, 10, SSD1306_WHITE);
+    printf("黄金图像场景: %u个\n", (unsigned)golden_scene_count);
+    for (size_t i = 0; i < golden_scene_count; i++) {
+        const GoldenScene& scene = golden_scenes[i];
+        uint32_t best_us = UINT32_MAX;
+        for (int run = 0; run < GOLDEN_SCENE_RUNS; run++) {
+            uint64_t t0 = time_us_64();
+            scene.render(oled);
+            uint32_t us = (uint32_t)(time_us_64() - t0);
+            if (us < best_us) {
+                best_us = us;
+            }
+        }
+#if SSD1306_INSTRUMENT
+        const ssd1306_golden_cost_t cost = golden_scene_cost(oled, scene);
+        ssd1306_golden_cost_record(scene.name, &cost);
+#endif
+        ssd1306_golden_record(scene.name, best_us, oled.getBuffer(), size);
     }
-    if (pattern & 0b0010000) { // c段 - 右下竖线
-        oled.drawFastVLine(x + 12, y + 15, 10, SSD1306_WHITE);
+    oled.clearDisplay();
+}
+#endif
+
+#if LAYOUT_BENCH
+// 基准画面：同一模板分别在SSD1306（页格式）和RowCanvas（行主序）上绘制
+template <typename Canvas>
+static void benchTextScreen(Canvas& c) {
+    c.clear();
+    c.setTextSize(1);
+    c.setCursor(0, 0);
+    for (int line = 0; line < 8; line++) {
+        c.print("The quick brown fox j");
     }
-    if (pattern & 0b0001000) { // d段 - 下横线
-        oled.drawFastHLine(x + 1, y + 25, 12, SSD1306_WHITE);
+}
+
+template <typename Canvas>
+static void benchBarScreen(Canvas& c) {
+    static const char* labels[] = {"CPU", "RAM", "BAT", "NET", "I2C"};
+    c.clear();
+    c.setTextSize(1);
+    for (int i = 0; i < 5; i++) {
+        const int16_t y = i * 12 + 2;
+        c.setCursor(0, y);
+        c.print(labels[i]);
+        c.drawRect(22, y - 1, 104, 10, SSD1306_WHITE);
+        c.fillRect(24, y + 1, 100 - i * 17, 6, SSD1306_WHITE);
     }
-    if (pattern & 0b0000100) { // e段 - 左下竖线
-        oled.drawFastVLine(x + 1, y + 15, 10, SSD1306_WHITE);
+}
+
+template <typename Canvas>
+static void benchLargeText(Canvas& c) {
+    c.clear();
+    c.setTextSize(2);
+    c.setCursor(0, 0);
+    c.print("12:34:56");
+    c.setCursor(0, 16);
+    c.print("23.5 C");
+    c.setTextSize(3);
+    c.setCursor(0, 34);
+    c.print("ABCDEFG");
+    c.setTextSize(1);
+}
+
+// 行主序的耗时包括把脏块转换为页格式；两种布局的结果逐字节比较
+static void runLayoutBench(SSD1306& oled) {
+    struct Bench {
+        const char* name;
+        void (*page)(SSD1306&);
+        void (*rows)(RowCanvas&);
+    };
+    static const Bench benches[] = {
+        {"text", benchTextScreen<SSD1306>, benchTextScreen<RowCanvas>},
+        {"bars", benchBarScreen<SSD1306>, benchBarScreen<RowCanvas>},
+        {"large_text", benchLargeText<SSD1306>, benchLargeText<RowCanvas>},
+    };
+    static RowCanvas canvas;
+    static uint8_t page_result[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+    const size_t size = oled.width() * ((oled.height() + 7) / 8);
+    
+    for (const Bench& b : benches) {
+        uint32_t page_us = UINT32_MAX, rows_us = UINT32_MAX;
+        uint16_t tiles = 0;
+        for (int run = 0; run < LAYOUT_BENCH_RUNS; run++) {
+            uint64_t t0 = time_us_64();
+            b.page(oled);
+            uint32_t us = (uint32_t)(time_us_64() - t0);
+            if (us < page_us) {
+                page_us = us;
+            }
+        }
+        memcpy(page_result, oled.getBuffer(), size);
+        // 帧缓冲刚被页格式绘制改写过
+        canvas.markAllDirty();
+        for (int run = 0; run < LAYOUT_BENCH_RUNS; run++) {
+            uint64_t t0 = time_us_64();
+            b.rows(canvas);
+            tiles = canvas.convert(oled.getBuffer());
+            uint32_t us = (uint32_t)(time_us_64() - t0);
+            if (us < rows_us) {
+                rows_us = us;
+            }
+        }
+        printf("布局基准 %-10s 页格式 %5luus, 行主序 %5luus（含转换%u块）, 画面%s\n", b.name,
+               (unsigned long)page_us, (unsigned long)rows_us, tiles,
+               memcmp(page_result, oled.getBuffer(), size) == 0 ? "一致" : "不一致");
     }
-    if (pattern & 0b0000010) { // f段 - 左上竖线
-        oled.drawFastVLine(x + 1, y + 3, 10, SSD1306_WHITE);
+    oled.clearDisplay();
+}
+#endif
+
+#if PRIMITIVE_FUZZ
+// 每个用例在同一随机背景上分别用SSD1306和参考实现绘制后逐字节比较；
+// 耗时按用例累加（微秒计时器，用例数多时平均值才有意义）
+static void runPrimitiveFuzz(SSD1306& oled) {
+    static uint8_t expected[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+    uint32_t cases[SSD1306_REF_PRIM_COUNT] = {};
+    uint32_t optimized_us[SSD1306_REF_PRIM_COUNT] = {};
+    uint32_t reference_us[SSD1306_REF_PRIM_COUNT] = {};
+    uint8_t* frame = oled.getBuffer();
+    const int16_t w = oled.width(), h = oled.height();
+    const size_t size = w * ((h + 7) / 8);
+    uint32_t state = PRIMITIVE_FUZZ_SEED ? PRIMITIVE_FUZZ_SEED : 1;
+    uint32_t mismatches = 0;
+    
+    printf("原语测试: 种子%lu, %lu个用例\n", (unsigned long)state, (unsigned long)PRIMITIVE_FUZZ_CASES);
+    for (uint32_t n = 0; n < PRIMITIVE_FUZZ_CASES; n++) {
+        ssd1306_ref_case_t c;
+        ssd1306_ref_random_case(&state, SSD1306_REF_ALL_MASK, w, h, &c);
+        for (size_t i = 0; i < size; i++) {
+            frame[i] = (uint8_t)ssd1306_ref_random(&state);
+        }
+        memcpy(expected, frame, size);
+        
+        uint32_t t0 = time_us_32();
+        ssd1306_ref_apply(oled, c);
+        uint32_t t1 = time_us_32();
+        ssd1306_ref_draw(expected, w, h, &c);
+        uint32_t t2 = time_us_32();
+        cases[c.prim]++;
+        optimized_us[c.prim] += t1 - t0;
+        reference_us[c.prim] += t2 - t1;
+        
+        if (memcmp(frame, expected, size) != 0 && ++mismatches <= 3) {
+            char text[96];
+            ssd1306_ref_describe(&c, text, sizeof(text));
+            ssd1306_frame_diff_t diff;
+            const uint32_t pixels = ssd1306_frame_diff(frame, expected, w, h, &diff);
+            printf("原语不一致: %s, %lu个像素\n", text, (unsigned long)pixels);
+            ssd1306_frame_print_diff(stdout, frame, expected, w, h, &diff);
+        }
     }
-    if (pattern & 0b0000001) { // g段 - 中横线
-        oled.drawFastHLine(x + 1, y + 13, 12, SSD1306_WHITE);
+    for (uint8_t p = 0; p < SSD1306_REF_PRIM_COUNT; p++) {
+        if (cases[p]) {
+            printf("原语 %-12s %5lu例 优化 %5.1fus/例 参考 %6.1fus/例\n", ssd1306_ref_prim_name(p),
+                   (unsigned long)cases[p], (double)optimized_us[p] / cases[p], (double)reference_us[p] / cases[p]);
+        }
     }
-    
-    // 添加高亮效果（边框）
-    if (highlight) {
-        oled.drawRect(x, y, 14, 28, SSD1306_WHITE);
+    printf("原语测试完成: 不一致%lu\n", (unsigned long)mismatches);
+    oled.setTextSize(1);
+    oled.setTextColor(SSD1306_WHITE);
+    oled.setCursor(0, 0);
+    oled.clearDisplay();
+}
+#endif
+
+// 参考时间输入：主机通过串口发送一行"$TIME,<Unix毫秒>"，用于老化偏移校准
+bool pollReferenceTime(int64_t* ref_us) {
+    static char line[32];
+    static uint8_t len = 0;
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == '\r' || c == '\n') {
+            line[len] = '\0';
+            len = 0;
+            if (strncmp(line, "$TIME,", 6) == 0) {
+                int64_t ms = 0;
+                for (const char* p = line + 6; *p >= '0' && *p <= '9'; p++) {
+                    ms = ms * 10 + (*p - '0');
+                }
+                *ref_us = ms * 1000;
+                return true;
+            }
+        } else if (len < sizeof(line) - 1) {
+            line[len++] = (char)c;
+        }
     }
+    return false;
 }
 
-// 绘制冒号（缩小版本）
-void drawColon(SSD1306& oled, int x, int y, bool blink = false) {
-    static bool colon_state = false;
-    if (blink) {
-        colon_state = !colon_state;
+// 从启动画面擦入第一帧时钟画面，每步只传输新露出的列
+void playStartupTransition(SSD1306& oled, ds3231_time_t& time, float temperature) {
+    const size_t size = oled.width() * ((oled.height() + 7) / 8);
+    static uint8_t splash[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+    static uint8_t clock[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+    
+    memcpy(splash, oled.getBuffer(), size);
+    renderDualColorClock(oled, time, temperature);
+    memcpy(clock, oled.getBuffer(), size);
+    memcpy(oled.getBuffer(), splash, size);
+    
+    FrameScheduler scheduler(TRANSITION_FRAME_PERIOD_US);
+    Transition wipe(oled);
+    wipe.start(splash, clock, SSD1306_TRANSITION_WIPE_LEFT, TRANSITION_DURATION_US,
+               time_us_64(), SSD1306_EASE_OUT_QUAD);
+    while (wipe.active()) {
+        uint64_t frame_us = scheduler.waitNextFrame();
+        scheduler.beginRender();
+        bool changed = wipe.render(frame_us);
+        scheduler.endRender();
+        if (changed) {
+            scheduler.beginFlush();
+            wipe.flush();
+            scheduler.endFlush();
+        }
     }
     
-    if (colon_state || !blink) {
-        // 上点（缩小）
-        oled.fillCircle(x + 2, y + 8, 1, SSD1306_WHITE);
-        // 下点（缩小）
-        oled.fillCircle(x + 2, y + 20, 1, SSD1306_WHITE);
+    const ssd1306_frame_stats_t& st = scheduler.stats();
+    printf("过渡动画: %lu帧, 丢帧%lu, 传输最长%luus\n",
+           (unsigned long)st.frames, (unsigned long)st.dropped, (unsigned long)st.flush_us_max);
+}
+
+// 切换唤醒源：每秒用1Hz SQW，每分钟用闹钟2（INTCN=1，SQW停止，秒为00时INT拉低）
+void setWakePeriod(ds3231_t* ds3231, uint8_t period_s) {
+    if (period_s == 1) {
+        ds3231_enable_alarm_interrupts(ds3231, false, false);
+        ds3231_set_sqw(ds3231, DS3231_SQW_1HZ);
+    } else {
+        ds3231_alarm_t every = {0, 0, 0, 1};
+        ds3231_set_alarm2(ds3231, &every, DS3231_ALARM2_EVERY_MINUTE);
+        ds3231_clear_alarm_flags(ds3231, DS3231_ALARM2_FLAG);
+        ds3231_enable_alarm_interrupts(ds3231, false, true);
     }
 }
 
-// 绘制黄色区域内容（按方案三重新设计）
-void drawYellowArea(SSD1306& oled, int year, int month, int day, int weekday, float temperature) {
-    // 清除黄色区域
-    oled.fillRect(0, 0, 128, YELLOW_HEIGHT, SSD1306_BLACK);
+// 低功耗主循环（不返回）：每次唤醒直接读取DS3231，由PowerManager决定刷新与面板开关；
+// dormant期间本地定时器停止，因此不使用软件计时
+void runLowPowerClock(SSD1306& oled, ds3231_t* ds3231, ds3231_tick_t* tick) {
+    static const ssd1306_power_policy_t policy = {
+        60,                 // 1分钟无操作后隐藏秒
+        0,                  // 白天不关闭面板
+        23 * 60, 7 * 60,    // 夜间关闭面板
+        60,                 // 夜间按键后点亮1分钟
+        true,               // 局部刷新
+        true,               // 空闲时降低对比度
+        LOW_POWER_DORMANT != 0
+    };
+    static PowerManager power(policy);
+    static const char* mode_names[] = {"每秒刷新", "每分钟刷新", "面板关闭"};
+    const uint8_t pages = (SSD1306_LCDHEIGHT + 7) / 8;
     
-    // 第1行：显示日期（左对齐）
-    char date_str[16];
-    snprintf(date_str, sizeof(date_str), "%04d-%02d-%02d", year, month, day);
-    oled.setCursor(2, 1);
-    oled.setTextSize(1);
-    oled.print(date_str);
+    static ds3231_tick_t button;
+    ds3231_tick_init(&button);
+    ds3231_tick_attach_gpio(&button, WAKE_BUTTON_PIN);
     
-    // 第2行：星期（左对齐）+ 温度（右对齐）
-    // 修正DS3231的星期定义：0=Sunday, 1=Monday, 2=Tuesday, ..., 6=Saturday
-    const char* weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
-    oled.setCursor(2, 9);
-    oled.setTextSize(1);
-    oled.print(weekdays[weekday]);
+    uint8_t wake_period = 1; // 进入时SQW为1Hz
+    uint32_t report_s = 0;
+    power.invalidate();
     
-    // 温度显示在右侧
-    char temp_str[12];
-    snprintf(temp_str, sizeof(temp_str), "%.1f°C", temperature);
-    oled.setCursor(90, 9); // 右对齐位置
-    oled.setTextSize(1);
-    oled.print(temp_str);
+    while (true) {
+        // 等待SQW/INT或按键；超时后照常读取一次RTC，不会停在这里
+#if LOW_POWER_DORMANT
+        if (!ds3231_tick_pending(tick) && !ds3231_tick_pending(&button)) {
+            ds3231_dormant_until_edge((1u << DS3231_SQW_PIN) | (1u << WAKE_BUTTON_PIN));
+        }
+#else
+        absolute_time_t deadline = make_timeout_time_us(wake_period * 1000000ull + 500000);
+        while (!ds3231_tick_pending(tick) && !ds3231_tick_pending(&button)) {
+            if (best_effort_wfe_or_timeout(deadline)) {
+                break;
+            }
+        }
+#endif
+        uint64_t wake_us = time_us_64();
+        bool alarm = ds3231_tick_dispatch(tick) > 0;
+        bool pressed = ds3231_tick_dispatch(&button) > 0;
+        
+        ds3231_time_t now;
+        if (!ds3231_read_time(ds3231, &now)) {
+            continue;
+        }
+        power.accountTransfer(1 + 7, 2, DS3231_I2C_BAUDRATE); // 寄存器地址 + 7字节时间
+        if (alarm && wake_period == 60) {
+            ds3231_clear_alarm_flags(ds3231, DS3231_ALARM2_FLAG); // 释放INT
+            power.accountTransfer(2, 1, DS3231_I2C_BAUDRATE);
+        }
+        
+        uint32_t now_s = (uint32_t)ds3231_time_to_epoch(&now);
+        if (pressed) {
+            power.activity(now_s);
+        }
+        ssd1306_power_plan_t plan = power.plan(now_s, now.hours * 60 + now.minutes);
+        if (plan.panel_changed) {
+            if (plan.panel_on) {
+                oled.wake();
+            } else {
+                oled.sleep();
+            }
+        }
+        if (plan.dim_changed) {
+            oled.dim(plan.dim);
+        }
+        if (plan.redraw) {
+            // 每秒刷新时使用温度缓存；每分钟一次时直接读取（dormant期间缓存的期限不会到）
+            float temperature;
+            bool ok = plan.show_seconds ? ds3231_get_temperature(ds3231, &temperature)
+                                        : ds3231_read_temperature(ds3231, &temperature);
+            if (!ok) {
+                temperature = 0.0f;
+            }
+            renderDualColorClock(oled, now, temperature, true, plan.show_seconds);
+            ssd1306_power_region_t r;
+            if (power.flush(oled.getBuffer(), SSD1306_LCDWIDTH, pages, &r)) {
+                oled.displayRegion(r.x0, r.x1, r.page0, r.page1);
+            }
+        }
+        if (plan.wake_period_s != wake_period) {
+            setWakePeriod(ds3231, plan.wake_period_s);
+            wake_period = plan.wake_period_s;
+        }
+        if (plan.mode_changed) {
+            printf("显示模式: %s\n", mode_names[plan.mode]);
+        }
+        
+        // 每小时输出一次估算
+        if (now_s - report_s >= 3600) {
+            if (report_s) {
+                ssd1306_power_report_t rep;
+                power.report(&rep);
+                printf("低功耗统计(每小时): 总线%.1fms, 唤醒%.1fms, 唤醒%.0f次, 刷新%.0f次, 面板点亮%.0f%%\n",
+                       rep.bus_ms, rep.awake_ms, rep.wakeups, rep.flushes, rep.panel_on_pct);
+            }
+            report_s = now_s;
+        }
+        power.accountAwake((uint32_t)(time_us_64() - wake_us));
+    }
+}
+
+// 主循环状态：各任务共享
+struct ClockApp {
+    event_loop_t loop;
+    event_task_t sqw_task;          // SQW节拍分发与超时检测
+    event_task_t clock_task;        // 读取时间、渲染
+    event_task_t rtc_task;          // 读取DS3231（重新同步、温度）
+    event_task_t display_task;      // 传输帧
+    event_task_t serial_task;       // 串口参考时间
+    event_task_t events_task;       // 事件时间戳
+    event_task_t stats_task;        // 统计输出
+    
+    SSD1306* oled;
+    ds3231_t* ds3231;
+    FrameScheduler* scheduler;
+    i2c_bus_t* bus;
+    FrameRecorder* mirror;
+    ds3231_tick_t tick;
+    ds3231_timekeeper_t timekeeper;
+    ds3231_calib_t calib;
+#if EVENT_STAMPING
+    ds3231_stamp_t stamp;
+#endif
+#if TILE_FLUSH
+    TileMap tile_map;
+#endif
+    // RTC读取的进度（rtcTask在传输期间返回）
+    ds3231_async_t rtc_op;
+    uint8_t rtc_regs[7];
+    uint8_t rtc_pending;       // 待处理的RTC_EV_*
+    uint64_t rtc_edge_us;      // 本次同步所用的SQW下降沿
+    // 分块传输的进度（displayTask在两块之间返回，局部变量不保留）
+    ssd1306_power_region_t flush_windows[SSD1306_TILE_MAX_WINDOWS];
+    uint8_t flush_window_count;
+    uint8_t flush_window;
+    uint8_t flush_page;
+    bool use_sqw;
+    uint64_t second_edge_us;   // 最近一个已分发节拍的SQW下降沿
+    uint8_t last_second = 255; // 确保第一次会更新显示
+    event_task_t log_task;          // 日志输出（最低优先级）
+    log_sink_t log;
+};
+
+// 日志格式编号，与log_formats的下标一致
+enum {
+    LOG_TIME,
+    LOG_TEMPERATURE,
+    LOG_SYNC,
+    LOG_READ_ERROR,
+    LOG_CALIB,
+    LOG_EVENT_RISE,
+    LOG_EVENT_FALL,
+    LOG_SQW_TIMEOUT,
+    LOG_FRAME_STATS,
+    LOG_BUS_STATS,
+    LOG_TILE_STATS,
+    LOG_SSD1306_COUNTERS,
+    LOG_SSD1306_PRIM,
+    LOG_SHARED_BUS,
+    LOG_LOG_STATS,
+    LOG_TASK_HEADER,
+    LOG_TASK_STATS,
+    LOG_TASK_IDLE,
+    LOG_FORMAT_COUNT
+};
+
+static const char* const log_formats[LOG_FORMAT_COUNT] = {
+    "DS3231时间: %04d-%02d-%02d %02d:%02d:%02d (星期%d)\n",
+    "温度: %.1f°C\n",
+    "时间同步: 偏差%ldus, 频偏%ldppb\n",
+    "错误：无法读取DS3231时间\n",
+    "老化偏移校准: 频偏%ldppb, 偏移%d\n",
+    "事件: %lu个, 最后一个 GP%u 上升 @ %lu + %u/32768秒, 累计丢弃%lu\n",
+    "事件: %lu个, 最后一个 GP%u 下降 @ %lu + %u/32768秒, 累计丢弃%lu\n",
+    "%lums内未检测到SQW节拍，改为轮询\n",
+    "帧统计: 渲染%luus(最长%lu), 传输%luus(最长%lu), 丢帧%lu\n",
+    "DS3231总线: p50 %luus, p99 %luus, 最长%luus, 超时%lu, 恢复%lu\n",
+    "块刷新: 脏块%lu, 内容未变%lu, 传输%lu块/%lu个窗口\n",
+    "SSD1306: 命令 %lu次/%lu字节, 数据 %lu次/%lu字节, 刷新 %lu次 p50 %luus p99 %luus 最长 %luus\n",
+    "  图元%u: 像素%lu, 调用%lu\n",
+    "共享总线: RTC最长等待%luus, 最长占用%luus, 速率切换%lu\n",
+    "日志: %lu条, 丢弃%lu, 缓冲最高%lu/%u字\n",
+    "任务统计（%lums）:\n",
+    "  任务%u 运行%6lu次 CPU %8luus (%2lu.%02lu%%) 最长%6luus 最大延迟%6luus 错过周期%lu\n",
+    "  空闲 %lu次 %luus (%2lu.%02lu%%)\n",
+};
+
+// 任务事件
+#define CLOCK_EV_SECOND  0x01   // SQW节拍
+#define RTC_EV_SYNC      0x01   // 在当前SQW边沿之后读取时间并重新同步
+#define RTC_EV_TEMPERATURE 0x02 // 温度缓存已过期
+#define DISPLAY_EV_FRAME 0x01   // 新帧已渲染
+#define DISPLAY_CHUNK_BYTES I2C_BUS_CHUNK_BYTES // 每块最多传输的字节数，400kHz下约3ms
+
+// 异步读取count个寄存器的总线时间：写地址、寄存器指针、重复起始后的读地址与数据，每字节9位
+#define RTC_TRANSFER_US(count) (((count) + 3) * 9 * 1000000u / DS3231_I2C_BAUDRATE + 20)
+#define EVENTS_EV_DRAIN  0x01
+#define STATS_EV_MINUTE  0x01
+#define LOG_EV_FORMATS   0x01   // 输出格式表与任务编号
+#define LOG_EV_TRACE     0x02   // 输出追踪缓冲区
+
+static uint64_t loopNow(void* ctx) {
+    return time_us_64();
+}
+
+// 无任务就绪时休眠到最近的定时器，任何中断（SQW、GPIO）都会提前唤醒
+static void loopIdle(void* ctx, uint64_t until_us) {
+    best_effort_wfe_or_timeout(from_us_since_boot(until_us));
+}
+
+static bool sqwPending(void* ctx) {
+    return ds3231_tick_pending(&((ClockApp*)ctx)->tick);
+}
+
+// SQW节拍回调：记下边沿并通知clock任务，读取与绘制在任务中完成
+void onSecondTick(uint32_t tick, uint64_t edge_us, void* ctx) {
+    event_task_t* clock_task = (event_task_t*)ctx;
+    ((ClockApp*)clock_task->ctx)->second_edge_us = edge_us;
+    event_task_signal(clock_task, CLOCK_EV_SECOND);
+}
+
+static void sqwTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    if (events & EVENT_POLL) {
+        ds3231_tick_dispatch(&app->tick);
+        event_task_timer(&app->loop, task, SQW_TICK_TIMEOUT_US, 0);
+    } else if (events & EVENT_TIMER) {
+        log_sink_write(&app->log, LOG_SQW_TIMEOUT, (unsigned long)(SQW_TICK_TIMEOUT_US / 1000));
+        ds3231_tick_detach_gpio(DS3231_SQW_PIN);
+        app->use_sqw = false;
+        event_task_set_poll(task, NULL);
+        event_task_timer(&app->loop, &app->clock_task, 0, CLOCK_FRAME_PERIOD_US);
+    }
 }
 
-// 绘制蓝色区域内容（时间）
-void drawBlueArea(SSD1306& oled, int hour, int minute, int second, bool colon_blink = true) {
-    // 清除蓝色区域
-    oled.fillRect(0, YELLOW_HEIGHT, 128, BLUE_HEIGHT, SSD1306_BLACK);
+static void clockTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    ds3231_timekeeper_t* timekeeper = &app->timekeeper;
+    
+    // 到期时与DS3231同步（有SQW时以下降沿为秒起点，只读一次）。首次同步前没有推算值，
+    // 在这里直接读取；之后的重新同步交给rtc任务，本帧仍用推算值
+    if (ds3231_timekeeper_resync_due(timekeeper)) {
+        if (app->use_sqw && timekeeper->synced && (events & CLOCK_EV_SECOND)) {
+            event_task_signal(&app->rtc_task, RTC_EV_SYNC);
+        } else if ((app->use_sqw && ds3231_timekeeper_sync_at_edge(timekeeper, app->second_edge_us)) ||
+                   ds3231_timekeeper_sync(timekeeper)) {
+            log_sink_write(&app->log, LOG_SYNC, (long)timekeeper->last_error_us, (long)timekeeper->drift_ppb);
+        }
+    }
     
-    // 重新计算时间显示位置（缩小字体后的布局）
-    // 新布局：6个数字×14 + 2个冒号×4 + 间距 = 约100px
-    // 起始位置: (128-100)/2 = 14，居中显示
-    int start_x = 14;
-    int y = YELLOW_HEIGHT + 8; // 蓝色区域内的垂直居中
+    // 读取本地推算的时间，失败时等下一个节拍重试。节拍触发时取边沿开始的那一秒
+    // （四舍五入）：推算值在边沿处可能略早于整秒，截断会与上一秒相同而跳过这一帧
+    ds3231_time_t now;
+    bool ok = (events & CLOCK_EV_SECOND) ? ds3231_timekeeper_at_edge(timekeeper, app->second_edge_us, &now)
+                                         : ds3231_timekeeper_now(timekeeper, &now, NULL);
+    if (!ok) {
+        log_sink_write(&app->log, LOG_READ_ERROR);
+        return;
+    }
+    if (now.seconds == app->last_second) {
+        return;
+    }
+    app->last_second = now.seconds;
     
-    // 绘制小时 (HH)
-    draw7SegmentDigit(oled, start_x, y, hour / 10);
-    draw7SegmentDigit(oled, start_x + 16, y, hour % 10);
+    // 温度（芯片每64秒转换一次）：使用缓存，过期时由rtc任务读取，本帧仍显示旧值
+    float temperature;
+    bool expired;
+    if (!ds3231_peek_temperature(app->ds3231, &temperature, &expired)) {
+        temperature = 0.0f; // 还没有读到过，使用默认值
+        expired = true;
+    }
+    if (expired) {
+        event_task_signal(&app->rtc_task, RTC_EV_TEMPERATURE);
+    }
     
-    // 绘制第一个冒号（小时和分钟之间，增加左右间距）
-    drawColon(oled, start_x + 34, y + 2, false); // 左边间距2像素
+#if CLOCK_DEBUG_LOG
+    log_sink_write(&app->log, LOG_TIME, 2000 + now.year, now.month, now.date, now.hours, now.minutes, now.seconds,
+                   now.day);
+    log_sink_write(&app->log, LOG_TEMPERATURE, temperature);
+#endif
     
-    // 绘制分钟 (MM)
-    draw7SegmentDigit(oled, start_x + 40, y, minute / 10); // 右边间距2像素
-    draw7SegmentDigit(oled, start_x + 56, y, minute % 10);
+    // 渲染后交给display任务传输，其间更高优先级的任务可以先运行
+    app->scheduler->beginRender();
+    renderDualColorClock(*app->oled, now, temperature, true);
+    app->scheduler->endRender();
+    event_task_signal(&app->display_task, DISPLAY_EV_FRAME);
     
-    // 绘制第二个冒号（分钟和秒之间，增加左右间距）
-    drawColon(oled, start_x + 70, y + 2, false); // 左边间距2像素
+#if EVENT_STAMPING
+    event_task_signal(&app->events_task, EVENTS_EV_DRAIN);
+#endif
+#if SSD1306_INSTRUMENT
+    if (now.seconds % TRACE_DUMP_PERIOD_S == 0) {
+        event_task_signal(&app->log_task, LOG_EV_TRACE);
+    }
+#endif
+    if (now.seconds == 0) {
+        event_task_signal(&app->stats_task, STATS_EV_MINUTE);
+    }
+}
+
+// RTC读取：DS3231单独在I2C1上时异步读取，启动后睡眠到传输应完成的时刻再轮询，
+// 其间display任务可以在I2C0上传输；共享总线上没有异步接口，阻塞读取（仲裁器以高优先级插入）
+static void rtcTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    app->rtc_pending |= (uint8_t)(events & (RTC_EV_SYNC | RTC_EV_TEMPERATURE));
     
-    // 绘制秒 (SS)
-    draw7SegmentDigit(oled, start_x + 76, y, second / 10); // 右边间距2像素
-    draw7SegmentDigit(oled, start_x + 92, y, second % 10);
+    EVENT_TASK_BEGIN(task);
+    while (app->rtc_pending & RTC_EV_SYNC) {
+        app->rtc_pending &= ~RTC_EV_SYNC;
+        app->rtc_edge_us = app->second_edge_us;
+        if (!ds3231_read_registers_async(&app->rtc_op, app->ds3231, DS3231_SECONDS_REG, app->rtc_regs, 7, NULL,
+                                         NULL)) {
+            if (ds3231_timekeeper_sync_at_edge(&app->timekeeper, app->rtc_edge_us)) {
+                log_sink_write(&app->log, LOG_SYNC, (long)app->timekeeper.last_error_us,
+                               (long)app->timekeeper.drift_ppb);
+            }
+            continue;
+        }
+        while (ds3231_async_poll(&app->rtc_op) == DS3231_ASYNC_BUSY) {
+            EVENT_TASK_SLEEP(task, &app->loop, RTC_TRANSFER_US(7));
+        }
+        ds3231_time_t t;
+        if (app->rtc_op.state == DS3231_ASYNC_DONE && ds3231_decode_time(app->rtc_regs, &t) &&
+            ds3231_timekeeper_sync_with_time(&app->timekeeper, app->rtc_edge_us, &t)) {
+            log_sink_write(&app->log, LOG_SYNC, (long)app->timekeeper.last_error_us, (long)app->timekeeper.drift_ppb);
+        }
+    }
+    while (app->rtc_pending & RTC_EV_TEMPERATURE) {
+        app->rtc_pending &= ~RTC_EV_TEMPERATURE;
+        float temperature;
+        if (!ds3231_read_registers_async(&app->rtc_op, app->ds3231, DS3231_TEMP_MSB, app->rtc_regs, 2, NULL,
+                                         NULL)) {
+            if (ds3231_read_temperature(app->ds3231, &temperature)) {
+                ds3231_calib_service(&app->calib, temperature);
+            }
+            continue;
+        }
+        while (ds3231_async_poll(&app->rtc_op) == DS3231_ASYNC_BUSY) {
+            EVENT_TASK_SLEEP(task, &app->loop, RTC_TRANSFER_US(2));
+        }
+        if (app->rtc_op.state == DS3231_ASYNC_DONE &&
+            ds3231_store_temperature(app->ds3231, app->rtc_regs, &temperature)) {
+            ds3231_calib_service(&app->calib, temperature);
+        }
+    }
+    EVENT_TASK_END(task);
 }
 
-// 移除装饰性背景
-void drawBackground(SSD1306& oled) {
-    // 移除所有装饰线条
+// 窗口每块的页数：不超过DISPLAY_CHUNK_BYTES的整页数，至少一页
+static uint8_t chunkPages(const ssd1306_power_region_t& w) {
+    const uint8_t pages = (uint8_t)(DISPLAY_CHUNK_BYTES / (w.x1 - w.x0 + 1));
+    return pages ? pages : 1;
 }
 
-// 绘制双色时钟
-void drawDualColorClock(SSD1306& oled, ds3231_time_t& time, float temperature, bool colon_blink = true) {
-    oled.clearDisplay();
-    
-    // 绘制背景装饰
-    drawBackground(oled);
-    
-    // 绘制黄色区域（日期、温度和星期）
-    drawYellowArea(oled, 2000 + time.year, time.month, time.date, time.day, temperature);
+// 分块传输：不超过DISPLAY_CHUNK_BYTES的窗口（如秒的数字）一次displayRegion()传完，
+// 更大的窗口按整页拆成不超过该长度的块（每块另发一次窗口命令），块之间让出主循环，
+// 更高优先级的任务（SQW节拍、RTC读取）不必等整帧传完。DS3231在另一路I2C上时，
+// 它的传输与OLED的块交替进行；共享总线时由i2c_bus在分片之间插入
+static void displayTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    // 传输途中渲染的新帧留到这一帧传完之后再传一次（已传的页可能是旧内容）
+    if (task->line && (events & DISPLAY_EV_FRAME)) {
+        event_task_signal(task, DISPLAY_EV_FRAME);
+    }
     
-    // 绘制蓝色区域（时间）
-    drawBlueArea(oled, time.hours, time.minutes, time.seconds, colon_blink);
+    EVENT_TASK_BEGIN(task);
+    if (!(events & DISPLAY_EV_FRAME)) {
+        return;
+    }
+    app->scheduler->beginFlush();
+#if TILE_FLUSH
+    app->flush_window_count = app->tile_map.filter(app->oled->getBuffer())
+                                  ? app->tile_map.windows(app->flush_windows, SSD1306_TILE_MAX_WINDOWS)
+                                  : 0;
+#else
+    app->flush_windows[0] = {0, SSD1306_LCDWIDTH - 1, 0, (SSD1306_LCDHEIGHT + 7) / 8 - 1};
+    app->flush_window_count = 1;
+#endif
+    for (app->flush_window = 0; app->flush_window < app->flush_window_count; app->flush_window++) {
+        for (app->flush_page = app->flush_windows[app->flush_window].page0;
+             app->flush_page <= app->flush_windows[app->flush_window].page1;
+             app->flush_page += chunkPages(app->flush_windows[app->flush_window])) {
+            {
+                // 局部变量不能跨过EVENT_TASK_YIELD的恢复点
+                const ssd1306_power_region_t& w = app->flush_windows[app->flush_window];
+                const uint8_t last = app->flush_page + chunkPages(w) - 1;
+                app->oled->displayRegion(w.x0, w.x1, app->flush_page, last < w.page1 ? last : w.page1);
+            }
+            EVENT_TASK_YIELD(task);
+        }
+    }
+    app->scheduler->endFlush();
+#if FRAME_MIRROR_ENABLED
+    app->mirror->record(app->oled->getBuffer(), SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8), time_us_64());
+#endif
+    EVENT_TASK_END(task);
+}
+
+// 参考时间到达时记录校准样本
+static void serialTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    int64_t ref_us;
+    if (pollReferenceTime(&ref_us) && app->timekeeper.synced) {
+        float ref_temperature;
+        if (ds3231_get_temperature(app->ds3231, &ref_temperature) &&
+            ds3231_calib_add_reference(&app->calib, ref_us, (int64_t)ds3231_timekeeper_now_us(&app->timekeeper),
+                                       ref_temperature)) {
+            log_sink_write(&app->log, LOG_CALIB, (long)app->calib.last_ppb, (int)app->ds3231->aging_cache);
+        }
+    }
+}
+
+#if EVENT_STAMPING
+// 取出上一秒的事件，只打印最后一个
+static void eventsTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    ds3231_stamp_event_t buf[32];
+    uint32_t n, count = 0;
+    ds3231_stamp_event_t last = {};
+    while ((n = ds3231_stamp_read(&app->stamp, buf, 32)) > 0) {
+        count += n;
+        last = buf[n - 1];
+    }
+    if (count) {
+        log_sink_write(&app->log, last.edge == DS3231_STAMP_RISE ? LOG_EVENT_RISE : LOG_EVENT_FALL,
+                       (unsigned long)count, last.source, (unsigned long)last.seconds, last.ticks,
+                       (unsigned long)app->stamp.dropped);
+    }
+}
+#endif
+
+// 万分比，用于以整数输出百分比（两位小数）
+static uint32_t perMyriad(uint64_t part, uint64_t whole) {
+    return whole ? (uint32_t)(part * 10000 / whole) : 0;
+}
+
+// 每分钟的统计只写入日志缓冲区，格式化与串口输出由更低优先级的log任务完成
+static void statsTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    if (!(events & STATS_EV_MINUTE)) {
+        return;
+    }
     
-    oled.display();
+    // 帧时间、总线与各任务的CPU时间
+    const ssd1306_frame_stats_t& st = app->scheduler->stats();
+    log_sink_write(&app->log, LOG_FRAME_STATS, st.render_us_last, st.render_us_max, st.flush_us_last,
+                   st.flush_us_max, st.dropped);
+    log_sink_write(&app->log, LOG_BUS_STATS, ds3231_bus_latency_percentile(&app->ds3231->bus, 50),
+                   ds3231_bus_latency_percentile(&app->ds3231->bus, 99), app->ds3231->bus.max_us,
+                   app->ds3231->bus.timeouts, app->ds3231->bus.recoveries);
+#if TILE_FLUSH
+    const ssd1306_tile_stats_t& ts = app->tile_map.stats();
+    log_sink_write(&app->log, LOG_TILE_STATS, ts.marked, ts.skipped, ts.sent, ts.windows);
+    app->tile_map.resetStats();
+#endif
+#if SSD1306_INSTRUMENT
+    const ssd1306_counters_t& c = app->oled->counters();
+    log_sink_write(&app->log, LOG_SSD1306_COUNTERS, c.command_txns, c.command_bytes, c.data_txns, c.data_bytes,
+                   c.flushes, ssd1306_counters_flush_percentile(&c, 50), ssd1306_counters_flush_percentile(&c, 99),
+                   c.flush_us_max);
+    for (uint8_t i = 0; i < SSD1306_PRIM_COUNT; i++) {
+        if (c.calls[i]) {
+            log_sink_write(&app->log, LOG_SSD1306_PRIM, i, c.pixels[i], c.calls[i]);
+        }
+    }
+    app->oled->resetCounters();
+#endif
+#if SHARED_I2C_BUS
+    log_sink_write(&app->log, LOG_SHARED_BUS, app->bus->stats.max_wait_us[I2C_BUS_PRIORITY_HIGH],
+                   app->bus->stats.max_chunk_us, app->bus->stats.speed_switches);
+#endif
+    log_sink_write(&app->log, LOG_LOG_STATS, app->log.records, app->log.dropped, app->log.high_water,
+                   LOG_SINK_RING_WORDS);
+
+    // 任务以编号记录（日志参数不能是字符串），编号与名称的对应由log任务随格式表输出
+    const event_loop_t* loop = &app->loop;
+    const uint64_t elapsed = loop->now(loop->port_ctx) - loop->stats_start_us;
+    log_sink_write(&app->log, LOG_TASK_HEADER, (uint32_t)(elapsed / 1000));
+    for (uint8_t i = 0; i < loop->task_count; i++) {
+        const event_task_t* t = loop->tasks[i];
+        const uint32_t pm = perMyriad(t->cpu_us, elapsed);
+        log_sink_write(&app->log, LOG_TASK_STATS, i, t->runs, (uint32_t)t->cpu_us, pm / 100, pm % 100, t->max_us,
+                       t->max_late_us, t->overruns);
+    }
+    const uint32_t idle_pm = perMyriad(loop->idle_us, elapsed);
+    log_sink_write(&app->log, LOG_TASK_IDLE, loop->idles, (uint32_t)loop->idle_us, idle_pm / 100, idle_pm % 100);
+    event_loop_reset_stats(&app->loop);
+#if LOG_BINARY
+    // 主机随时接入都能拿到格式表
+    event_task_signal(&app->log_task, LOG_EV_FORMATS);
+#endif
+}
+
+static bool logPending(void* ctx) {
+    return log_sink_pending(&((ClockApp*)ctx)->log);
+}
+
+// 每次只输出几行，串口阻塞时不影响其他任务的响应
+static void logTask(event_task_t* task, uint32_t events) {
+    ClockApp* app = (ClockApp*)task->ctx;
+    if (events & LOG_EV_FORMATS) {
+#if LOG_BINARY
+        log_sink_print_formats(&app->log);
+#endif
+        printf("任务编号:");
+        for (uint8_t i = 0; i < app->loop.task_count; i++) {
+            printf(" %u=%s", i, app->loop.tasks[i]->name);
+        }
+        printf("\n");
+    }
+#if SSD1306_INSTRUMENT
+    if (events & LOG_EV_TRACE) {
+        ssd1306_trace_dump(&trace_buffer);
+    }
+#endif
+    log_sink_drain(&app->log, LOG_DRAIN_BATCH, LOG_BINARY);
 }
 
 int main() {
     stdio_init_all();
-    sleep_ms(2000);
+    
+    // 看门狗复位且复位前面板已初始化时热启动：面板仍保持着配置与画面，
+    // 跳过初始化序列、启动画面和串口等待，只刷新变化的区域。
+    // 掉电复位后影子内容随机，魔数不匹配，按冷启动处理
+    const bool warm_boot = watchdog_caused_reboot() && panel_shadow.magic == SSD1306_SHADOW_VALID;
+    
+#if SSD1306_INSTRUMENT
+    ssd1306_trace_set_hook(ssd1306_trace_buffer_hook, &trace_buffer);
+#endif
     
     printf("=====================================\n");
     printf("    DS3231 双色数字时钟\n");
@@ -185,6 +892,11 @@ int main() {
     printf("DS3231 I2C地址: 0x%02X\n", DS3231_I2C_ADDR);
     printf("=====================================\n\n");
     
+#if SHARED_I2C_BUS
+    printf("初始化共享I2C0总线（SSD1306 + DS3231）...\n");
+    static i2c_bus_t shared_bus;
+    i2c_bus_init(&shared_bus, SSD1306_I2C_PORT, SSD1306_SDA_PIN, SSD1306_SCL_PIN, SSD1306_BUS_BAUDRATE);
+#else
     // 初始化I2C0用于SSD1306
     printf("初始化I2C0接口（SSD1306）...\n");
     i2c_init(i2c0, 400000); // SSD1306可以使用更高频率
@@ -192,7 +904,6 @@ int main() {
     gpio_set_function(SSD1306_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(SSD1306_SDA_PIN);
     gpio_pull_up(SSD1306_SCL_PIN);
-    sleep_ms(100);
     
     // 初始化I2C1用于DS3231
     printf("初始化I2C1接口（DS3231）...\n");
@@ -201,22 +912,60 @@ int main() {
     gpio_set_function(DS3231_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(DS3231_SDA_PIN);
     gpio_pull_up(DS3231_SCL_PIN);
-    sleep_ms(100);
+#endif
+    
+    if (!warm_boot) {
+        sleep_ms(SSD1306_POWERUP_DELAY_MS);
+    }
     
     // 初始化OLED
     printf("初始化OLED显示屏...\n");
+#if SHARED_I2C_BUS
+    SSD1306 oled(&shared_bus, SSD1306::ADDRESS);
+#else
     SSD1306 oled(i2c0, SSD1306::ADDRESS);
-    if (!oled.begin()) {
+#endif
+    oled.attachShadow(&panel_shadow);
+    if (!oled.begin(SSD1306_SWITCHCAPVCC, 0, !warm_boot)) {
         printf("错误：无法初始化SSD1306，请检查连接\n");
         return -1;
     }
-    printf("SSD1306初始化成功！\n");
+    printf("SSD1306初始化成功！%s\n", warm_boot ? "（热启动，保留面板内容）" : "");
+#if GOLDEN_SCENES
+    runGoldenScenes(oled);
+#endif
+#if LAYOUT_BENCH
+    runLayoutBench(oled);
+#endif
+#if PRIMITIVE_FUZZ
+    runPrimitiveFuzz(oled);
+#endif
     oled.setContrast(0x8F);
     
+    // 首帧时刻：定时器在时钟初始化时从0开始计数，不含启动ROM与boot2的几毫秒
+    uint64_t first_frame_us = 0;
+    if (!warm_boot) {
+        // 先显示启动画面，再等待USB串口枚举
+        printf("显示启动信息到屏幕...\n");
+        oled.clearDisplay();
+        oled.setCursor(10, 8);
+        oled.setTextSize(1);
+        oled.print("DS3231 Clock");
+        oled.setCursor(20, 24);
+        oled.print("Starting...");
+        oled.display();
+        first_frame_us = time_us_64();
+        sleep_ms(SPLASH_SCREEN_MS);
+    }
+    
     // 初始化DS3231
     printf("初始化DS3231实时时钟...\n");
     ds3231_t ds3231;
+#if SHARED_I2C_BUS
+    if (!ds3231_init_shared(&ds3231, &shared_bus)) {
+#else
     if (!ds3231_init(&ds3231, i2c1, DS3231_SDA_PIN, DS3231_SCL_PIN)) {
+#endif
         printf("错误：无法初始化DS3231，请检查连接\n");
         return -1;
     }
@@ -232,17 +981,6 @@ int main() {
         }
     }
     
-    // 显示启动画面
-    printf("显示启动信息到屏幕...\n");
-    oled.clearDisplay();
-    oled.setCursor(10, 8);
-    oled.setTextSize(1);
-    oled.print("DS3231 Clock");
-    oled.setCursor(20, 24);
-    oled.print("Starting...");
-    oled.display();
-    sleep_ms(2000);
-    
     // 读取并显示当前时间
     ds3231_time_t current_time;
     if (!ds3231_read_time(&ds3231, &current_time)) {
@@ -260,42 +998,93 @@ int main() {
         printf("DS3231温度: %.1f°C\n", temperature);
     }
     
+    if (warm_boot) {
+        // 面板上仍是复位前的时钟画面，通常只有秒数字需要重传
+        renderDualColorClock(oled, current_time, temperature);
+        oled.displayChanged();
+        first_frame_us = time_us_64();
+    } else {
+        // 从启动画面过渡到时钟画面
+        playStartupTransition(oled, current_time, temperature);
+    }
+    printf("复位到首帧: %lu.%03lums（%s）\n", (unsigned long)(first_frame_us / 1000),
+           (unsigned long)(first_frame_us % 1000), warm_boot ? "热启动，显示时钟" : "冷启动，显示启动画面");
+    
     printf("进入主循环...\n");
     
-    uint8_t last_second = 255; // 确保第一次会更新显示
+    FrameScheduler scheduler(CLOCK_FRAME_PERIOD_US);
+#if FRAME_MIRROR_ENABLED
+    static FrameRecorder mirror;
+#endif
     
-    while (true) {
-        // 读取DS3231时间
-        ds3231_time_t now;
-        if (!ds3231_read_time(&ds3231, &now)) {
-            printf("错误：无法读取DS3231时间\n");
-            sleep_ms(1000);
-            continue;
-        }
-        
-        // 每秒更新一次显示
-        if (now.seconds != last_second) {
-            // 读取温度
-            float temperature;
-            if (!ds3231_read_temperature(&ds3231, &temperature)) {
-                temperature = 0.0f; // 如果读取失败，使用默认值
-            }
-            
-            // 添加调试输出
-            printf("DS3231时间: %04d-%02d-%02d %02d:%02d:%02d (星期%d)\n", 
-                   2000 + now.year, now.month, now.date, now.hours, now.minutes, now.seconds, now.day);
-            printf("显示时间: 小时=%d(%d,%d), 分钟=%d(%d,%d), 秒=%d(%d,%d)\n",
-                   now.hours, now.hours/10, now.hours%10,
-                   now.minutes, now.minutes/10, now.minutes%10,
-                   now.seconds, now.seconds/10, now.seconds%10);
-            printf("温度: %.1f°C\n", temperature);
-            
-            drawDualColorClock(oled, now, temperature, true);
-            last_second = now.seconds;
-        }
-        
-        sleep_ms(100);
+    // 主循环的各个任务
+    static ClockApp app;
+    app.oled = &oled;
+    app.ds3231 = &ds3231;
+    app.scheduler = &scheduler;
+#if SHARED_I2C_BUS
+    app.bus = &shared_bus;
+#endif
+#if FRAME_MIRROR_ENABLED
+    app.mirror = &mirror;
+#endif
+    event_loop_t* loop = &app.loop;
+    event_loop_init(loop, loopNow, loopIdle, NULL);
+    event_loop_add(loop, &app.sqw_task, "sqw", sqwTask, &app);
+    event_loop_add(loop, &app.clock_task, "clock", clockTask, &app);
+    event_loop_add(loop, &app.rtc_task, "rtc", rtcTask, &app);
+    event_loop_add(loop, &app.display_task, "display", displayTask, &app);
+    event_loop_add(loop, &app.serial_task, "serial", serialTask, &app);
+#if EVENT_STAMPING
+    event_loop_add(loop, &app.events_task, "events", eventsTask, &app);
+#endif
+    event_loop_add(loop, &app.stats_task, "stats", statsTask, &app);
+    event_loop_add(loop, &app.log_task, "log", logTask, &app);
+    event_task_set_poll(&app.log_task, logPending);
+    log_sink_init(&app.log, log_formats, LOG_FORMAT_COUNT, loopNow, NULL);
+    event_task_signal(&app.log_task, LOG_EV_FORMATS);
+    
+    // 1Hz SQW节拍：秒寄存器更新时产生下降沿，两次节拍之间内核休眠
+    ds3231_tick_t* tick = &app.tick;
+    ds3231_tick_init(tick);
+    ds3231_tick_subscribe(tick, 1, 0, onSecondTick, &app.clock_task);
+    app.use_sqw = ds3231_set_sqw(&ds3231, DS3231_SQW_1HZ) &&
+                  ds3231_tick_attach_gpio(tick, DS3231_SQW_PIN);
+    printf("秒节拍来源: %s\n", app.use_sqw ? "DS3231 SQW中断" : "轮询");
+    
+    // 软件计时：两次同步之间用本地定时器推算时间，不访问I2C
+    ds3231_timekeeper_init(&app.timekeeper, &ds3231, TIMEKEEPER_RESYNC_S);
+    
+    // 老化偏移校准：按温度段学习，参考时间来自串口
+    ds3231_calib_init(&app.calib, &ds3231);
+    
+#if EVENT_STAMPING
+    // 事件在本核中断中捕获，每秒由events任务取出
+    bool stamping = ds3231_stamp_start(&ds3231, &app.stamp, DS3231_32KHZ_PIN, app.use_sqw ? DS3231_SQW_PIN : -1) &&
+                    ds3231_stamp_attach_gpios(1u << EVENT_INPUT_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+    printf("事件时间戳: %s\n", stamping ? "已启动" : "启动失败");
+#endif
+    
+#if LOW_POWER_MODE
+    if (app.use_sqw) {
+        runLowPowerClock(oled, &ds3231, tick);
+    }
+    printf("低功耗模式需要SQW/INT连接，使用普通模式\n");
+#endif
+    
+#if TILE_FLUSH
+    // 每秒整屏重绘，通常只有秒数字所在的几个块内容变化
+    oled.attachTiles(&app.tile_map);
+#endif
+    
+    if (app.use_sqw) {
+        event_task_set_poll(&app.sqw_task, sqwPending);
+        event_task_timer(loop, &app.sqw_task, SQW_TICK_TIMEOUT_US, 0);
+    } else {
+        event_task_timer(loop, &app.clock_task, 0, CLOCK_FRAME_PERIOD_US);
     }
+    event_task_timer(loop, &app.serial_task, SERIAL_POLL_PERIOD_US, SERIAL_POLL_PERIOD_US);
+    event_loop_run(loop, 0);
     
     return 0;
 }
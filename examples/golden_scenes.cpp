@@ -0,0 +1,107 @@
+#include "golden_scenes.h"
+#include "clock_face.h"
+
+// 每个场景从清屏开始（电池画面由drawBatteryStatus()自行清屏）
+static void sceneClock(SSD1306& oled) {
+    ds3231_time_t t = {56, 34, 12, 3, 18, 6, 25};
+    renderDualColorClock(oled, t, 23.5f);
+}
+
+static void sceneClockMidnight(SSD1306& oled) {
+    ds3231_time_t t = {0, 0, 0, 0, 1, 1, 30};
+    renderDualColorClock(oled, t, -5.25f);
+}
+
+static void sceneClockIdle(SSD1306& oled) {
+    ds3231_time_t t = {59, 59, 23, 6, 31, 12, 99};
+    renderDualColorClock(oled, t, 38.0f, true, false);
+}
+
+static void sceneText(SSD1306& oled) {
+    oled.clearDisplay();
+    oled.setTextSize(1);
+    oled.setCursor(0, 0);
+    for (char c = 32; c <= 126; c++) {
+        oled.write((uint8_t)c);
+    }
+    oled.setTextSize(2);
+    oled.setCursor(0, 40);
+    oled.print("Ag@9");
+    oled.setTextSize(3);
+    oled.setTextColor(SSD1306_INVERSE);
+    oled.setCursor(100, 36);
+    oled.print("W");
+    oled.setTextColor(SSD1306_WHITE);
+    oled.setTextSize(1);
+}
+
+static void sceneLines(SSD1306& oled) {
+    oled.clearDisplay();
+    // 各方向的线，端点部分在画面外
+    for (int16_t i = -16; i <= 144; i += 20) {
+        oled.drawLine(64, 32, i, -10, SSD1306_WHITE);
+        oled.drawLine(64, 32, i, 73, SSD1306_WHITE);
+    }
+    for (int16_t i = -8; i <= 72; i += 16) {
+        oled.drawLine(64, 32, -20, i, SSD1306_WHITE);
+        oled.drawLine(64, 32, 147, i, SSD1306_WHITE);
+    }
+    oled.drawLine(0, 63, 127, 0, SSD1306_INVERSE);
+    oled.drawFastHLine(-5, 5, 200, SSD1306_INVERSE);
+    oled.drawFastVLine(120, -3, 80, SSD1306_INVERSE);
+}
+
+static void sceneRects(SSD1306& oled) {
+    oled.clearDisplay();
+    oled.fillRect(-4, -4, 40, 30, SSD1306_WHITE);
+    oled.fillRect(8, 5, 12, 13, SSD1306_BLACK);
+    oled.fillRect(20, 3, 50, 50, SSD1306_INVERSE);
+    oled.drawRect(60, 10, 40, 27, SSD1306_WHITE);
+    oled.drawRect(110, 50, 30, 30, SSD1306_WHITE);
+    oled.fillRect(90, 1, 1, 62, SSD1306_WHITE);
+    oled.fillRect(70, 60, 0, 4, SSD1306_WHITE);
+}
+
+static void sceneCircles(SSD1306& oled) {
+    oled.clearDisplay();
+    oled.drawCircle(20, 20, 15, SSD1306_WHITE);
+    oled.fillCircle(60, 32, 20, SSD1306_WHITE);
+    oled.fillCircle(66, 32, 8, SSD1306_INVERSE);
+    oled.drawCircle(120, 60, 12, SSD1306_WHITE);
+    oled.fillCircle(0, 63, 10, SSD1306_WHITE);
+    oled.drawCircle(100, 10, 0, SSD1306_WHITE);
+}
+
+static void sceneBattery(SSD1306& oled) {
+    oled.drawBatteryStatus(3.87f, 72.0f);
+}
+
+const GoldenScene golden_scenes[] = {
+    {"clock", sceneClock},
+    {"clock_midnight", sceneClockMidnight},
+    {"clock_idle", sceneClockIdle},
+    {"text", sceneText},
+    {"lines", sceneLines},
+    {"rects", sceneRects},
+    {"circles", sceneCircles},
+    {"battery", sceneBattery},
+};
+
+const size_t golden_scene_count = sizeof(golden_scenes) / sizeof(golden_scenes[0]);
+
+#if SSD1306_INSTRUMENT
+ssd1306_golden_cost_t golden_scene_cost(SSD1306& oled, const GoldenScene& scene) {
+    oled.resetCounters();
+    scene.render(oled);
+    oled.display();
+    const ssd1306_counters_t& c = oled.counters();
+    ssd1306_golden_cost_t cost = {};
+    for (uint8_t i = 0; i < SSD1306_PRIM_COUNT; i++) {
+        cost.pixels += c.pixels[i];
+        cost.calls += c.calls[i];
+    }
+    cost.txns = c.command_txns + c.data_txns;
+    cost.bytes = c.command_bytes + c.data_bytes;
+    return cost;
+}
+#endif
@@ -0,0 +1,25 @@
+#ifndef GOLDEN_SCENES_H
+#define GOLDEN_SCENES_H
+
+#include "ssd1306.h"
+#include "ssd1306_golden.h"
+#include <stddef.h>
+
+// 黄金图像场景：用固定输入渲染时钟画面和各绘图原语（含越界裁剪与三种颜色），
+// 每个场景从清屏开始，只写帧缓冲。设备上由示例在GOLDEN_SCENES=1时渲染并计时，
+// 主机上由tools/ssd1306_golden_render渲染，两者都以$SSDG记录行输出，
+// 与tools/golden/<场景名>.pbm比较
+struct GoldenScene {
+    const char* name;
+    void (*render)(SSD1306& oled);
+};
+
+extern const GoldenScene golden_scenes[];
+extern const size_t golden_scene_count;
+
+#if SSD1306_INSTRUMENT
+// 渲染场景并传输一次整帧，返回这期间的驱动计数（$SSDC记录的内容）
+ssd1306_golden_cost_t golden_scene_cost(SSD1306& oled, const GoldenScene& scene);
+#endif
+
+#endif // GOLDEN_SCENES_H
@@ -4,6 +4,9 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
+#include "ds3231/ds3231_tick.h"
+#include "ds3231/ds3231_stamp.h"
+#include "i2c_bus.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,6 +15,10 @@ extern "C" {
 // DS3231 I2C地址
 #define DS3231_I2C_ADDR 0x68
 
+// I2C总线参数
+#define DS3231_I2C_BAUDRATE   100000
+#define DS3231_I2C_TIMEOUT_US 5000   // 单次事务期限（19字节突发读在100kHz下约2ms）
+
 // DS3231寄存器地址
 #define DS3231_SECONDS_REG    0x00
 #define DS3231_MINUTES_REG    0x01
@@ -32,6 +39,14 @@ extern "C" {
 #define DS3231_AGING_REG      0x10
 #define DS3231_TEMP_MSB       0x11
 #define DS3231_TEMP_LSB       0x12
+#define DS3231_REG_COUNT      19   // 0x00-0x12，整个寄存器文件
+
+// 温度转换：芯片每64秒自动转换一次，强制转换约需200ms
+#define DS3231_TEMP_CONV_PERIOD_US 64000000
+#define DS3231_TEMP_CONV_TIME_US   200000
+
+// 时间戳锚定时等待秒边沿的期限
+#define DS3231_STAMP_ANCHOR_TIMEOUT_US 2500000
 
 // 控制寄存器位定义
 #define DS3231_EOSC_BIT       7
@@ -55,32 +70,196 @@ typedef struct {
     uint8_t seconds;   // 0-59
     uint8_t minutes;   // 0-59
     uint8_t hours;     // 0-23 (24小时制)
-    uint8_t day;       // 1-7 (1=Sunday)
+    uint8_t day;       // 0-6 (0=Sunday)，读取时由日期推算
     uint8_t date;      // 1-31
     uint8_t month;     // 1-12
     uint8_t year;      // 0-99 (相对于2000年)
 } ds3231_time_t;
 
+// SQW方波输出频率（控制寄存器RS2:RS1）
+typedef enum {
+    DS3231_SQW_1HZ    = 0,
+    DS3231_SQW_1024HZ = 1,
+    DS3231_SQW_4096HZ = 2,
+    DS3231_SQW_8192HZ = 3
+} ds3231_sqw_rate_t;
+
+// 闹钟1匹配模式（A1M4:A1M1与DY/DT位）
+typedef enum {
+    DS3231_ALARM1_EVERY_SECOND = 0,  // 每秒触发
+    DS3231_ALARM1_MATCH_S,           // 秒匹配
+    DS3231_ALARM1_MATCH_MS,          // 分、秒匹配
+    DS3231_ALARM1_MATCH_HMS,         // 时、分、秒匹配
+    DS3231_ALARM1_MATCH_DATE_HMS,    // 日期、时、分、秒匹配
+    DS3231_ALARM1_MATCH_DAY_HMS      // 星期、时、分、秒匹配
+} ds3231_alarm1_mode_t;
+
+// 闹钟2匹配模式（A2M4:A2M2与DY/DT位），在秒为00时触发
+typedef enum {
+    DS3231_ALARM2_EVERY_MINUTE = 0,  // 每分钟触发
+    DS3231_ALARM2_MATCH_M,           // 分匹配
+    DS3231_ALARM2_MATCH_HM,          // 时、分匹配
+    DS3231_ALARM2_MATCH_DATE_HM,     // 日期、时、分匹配
+    DS3231_ALARM2_MATCH_DAY_HM       // 星期、时、分匹配
+} ds3231_alarm2_mode_t;
+
+// 闹钟时间，闹钟2忽略seconds
+typedef struct {
+    uint8_t seconds;   // 0-59
+    uint8_t minutes;   // 0-59
+    uint8_t hours;     // 0-23
+    uint8_t day_date;  // 日期1-31，或星期0-6（0=Sunday），由匹配模式决定
+} ds3231_alarm_t;
+
+// 闹钟标志掩码（状态寄存器A1F/A2F）
+#define DS3231_ALARM1_FLAG    (1 << DS3231_A1F_BIT)
+#define DS3231_ALARM2_FLAG    (1 << DS3231_A2F_BIT)
+
+// 事务延迟直方图：第i桶统计[2^i, 2^(i+1)) 微秒
+#define DS3231_LATENCY_BUCKETS 16
+
+typedef struct {
+    uint32_t count;        // 成功的事务数
+    uint32_t errors;       // NAK等错误
+    uint32_t timeouts;
+    uint32_t recoveries;   // 总线恢复次数
+    uint32_t max_us;
+    uint32_t histogram[DS3231_LATENCY_BUCKETS];
+} ds3231_bus_stats_t;
+
 // DS3231设备结构体
 typedef struct {
     i2c_inst_t *i2c;
     uint8_t sda_pin;
     uint8_t scl_pin;
     uint8_t addr;
+    // 写穿缓存：控制寄存器、老化寄存器和状态寄存器的EN32kHz位只由主机改写，
+    // 读改写操作直接使用缓存，不必先读
+    uint8_t control_cache;
+    uint8_t status_cache;
+    uint8_t aging_cache;
+    bool cache_valid;
+    uint32_t transfers;    // 累计I2C事务数（写地址+读取算一次）
+    bool async_busy;       // 有异步事务进行中，阻塞接口此时返回false
+    ds3231_bus_stats_t bus;
+    i2c_bus_t *shared_bus; // 非NULL时所有事务经仲裁器以高优先级提交
+    i2c_bus_device_t bus_device;
+    // 温度缓存：下一次转换完成之前不再读取温度寄存器
+    float temp_cache;
+    uint64_t temp_expire_us;
+    bool temp_valid;
 } ds3231_t;
 
+// 异步事务状态
+typedef enum {
+    DS3231_ASYNC_IDLE = 0,
+    DS3231_ASYNC_BUSY,
+    DS3231_ASYNC_DONE,
+    DS3231_ASYNC_ERROR,      // NAK或仲裁失败
+    DS3231_ASYNC_TIMEOUT     // 超过期限，已执行总线恢复
+} ds3231_async_state_t;
+
+typedef void (*ds3231_async_callback_t)(ds3231_async_state_t state, void *ctx);
+
+// 异步事务：由ds3231_async_poll()推进的状态机，每次调用只搬运FIFO中可用的数据，
+// 不等待总线；可在主循环或定时器回调中轮询。
+// 没有使用I2C中断或DMA：读时间（地址+7条读命令）、读温度（地址+2条）这类事务启动时
+// 全部命令就放进了16级TX FIFO，读回的数据也装得下16级RX FIFO，之后由控制器独立完成；
+// 完成时刻可按字节数和波特率算出（每字节9位），调用方定时到那时轮询一两次即可
+// （见examples/ds3231_clock.cpp的rtcTask）。中断只能省下这一两次轮询，却要占用
+// I2C中断向量并与阻塞接口争用控制器。超过FIFO深度的事务（如19字节的快照）须多次轮询
+typedef struct {
+    ds3231_t *ds3231;
+    uint8_t wbuf[DS3231_REG_COUNT + 1];  // 寄存器地址+写入数据
+    uint8_t wlen;
+    uint8_t *rbuf;
+    uint8_t rlen;
+    uint8_t issued;          // 已写入TX FIFO的命令数
+    uint8_t received;
+    uint64_t start_us;
+    uint64_t deadline_us;
+    volatile ds3231_async_state_t state;
+    ds3231_async_callback_t callback;   // 完成时调用，可为NULL
+    void *ctx;
+} ds3231_async_t;
+
 // 函数声明
 bool ds3231_init(ds3231_t *ds3231, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin);
+// 挂到共享总线上（不重新初始化控制器；异步接口在共享总线上不可用）
+bool ds3231_init_shared(ds3231_t *ds3231, i2c_bus_t *bus);
 bool ds3231_write_register(ds3231_t *ds3231, uint8_t reg, uint8_t value);
 bool ds3231_read_register(ds3231_t *ds3231, uint8_t reg, uint8_t *value);
+// 连续寄存器的单次突发读写（地址自动递增）
+bool ds3231_read_registers(ds3231_t *ds3231, uint8_t start, uint8_t *buf, uint8_t count);
+bool ds3231_write_registers(ds3231_t *ds3231, uint8_t start, const uint8_t *buf, uint8_t count);
+// 异步突发读写：启动后轮询ds3231_async_poll()直到状态不再是BUSY
+bool ds3231_read_registers_async(ds3231_async_t *op, ds3231_t *ds3231, uint8_t start, uint8_t *buf, uint8_t count,
+                                 ds3231_async_callback_t callback, void *ctx);
+bool ds3231_write_registers_async(ds3231_async_t *op, ds3231_t *ds3231, uint8_t start, const uint8_t *buf,
+                                  uint8_t count, ds3231_async_callback_t callback, void *ctx);
+ds3231_async_state_t ds3231_async_poll(ds3231_async_t *op);
+// 总线恢复（见i2c_bus_recover_pins），共享总线时由仲裁器恢复
+bool ds3231_bus_recover(ds3231_t *ds3231);
+// 事务延迟百分位（返回所在桶的上界，微秒），没有样本时返回0
+uint32_t ds3231_bus_latency_percentile(const ds3231_bus_stats_t *stats, uint8_t percent);
+void ds3231_bus_stats_reset(ds3231_t *ds3231);
+// 一次事务读取整个寄存器文件（同时刷新缓存）
+bool ds3231_read_snapshot(ds3231_t *ds3231, uint8_t regs[DS3231_REG_COUNT]);
+// 重新读取缓存的寄存器（DS3231掉电复位后调用）
+bool ds3231_refresh_cache(ds3231_t *ds3231);
 bool ds3231_read_time(ds3231_t *ds3231, ds3231_time_t *time);
 bool ds3231_write_time(ds3231_t *ds3231, const ds3231_time_t *time);
 bool ds3231_read_temperature(ds3231_t *ds3231, float *temperature);
+// 带缓存的温度：缓存到下一次可能的转换之后才重新读取
+bool ds3231_get_temperature(ds3231_t *ds3231, float *temperature);
+// 由温度寄存器0x11-0x12的原始值换算并写入缓存（异步读取完成后调用）
+bool ds3231_store_temperature(ds3231_t *ds3231, const uint8_t raw[2], float *temperature);
+// 只读缓存，不访问I2C：从未读到过温度时返回false，expired（可为NULL）表示是否已到下一次转换
+bool ds3231_peek_temperature(const ds3231_t *ds3231, float *temperature, bool *expired);
+// 强制温度转换（同时按新的老化偏移调整振荡器），BSY置位时返回false
+bool ds3231_force_conversion(ds3231_t *ds3231);
+bool ds3231_is_converting(ds3231_t *ds3231, bool *busy);
+// 老化偏移：每LSB约0.1ppm，正值使振荡器变慢；写入后强制一次转换使其立即生效
+bool ds3231_set_aging_offset(ds3231_t *ds3231, int8_t offset);
+bool ds3231_get_aging_offset(ds3231_t *ds3231, int8_t *offset);
 bool ds3231_enable_oscillator(ds3231_t *ds3231, bool enable);
 bool ds3231_is_oscillator_stopped(ds3231_t *ds3231, bool *stopped);
+// SQW/INT输出：启用方波（INTCN=0）或切回中断模式（INTCN=1，引脚空闲为高）
+bool ds3231_set_sqw(ds3231_t *ds3231, ds3231_sqw_rate_t rate);
+bool ds3231_disable_sqw(ds3231_t *ds3231);
+// 把SQW引脚所接GPIO的下降沿（秒寄存器更新时刻）接到节拍分发器
+// 注意：使用gpio_set_irq_enabled_with_callback，会占用本核的GPIO中断回调
+bool ds3231_tick_attach_gpio(ds3231_tick_t *tick, uint gpio);
+void ds3231_tick_detach_gpio(uint gpio);
+bool ds3231_enable_32khz(ds3231_t *ds3231, bool enable);
+// 事件时间戳：启用32kHz输出并用clk_gpio（须为PWM的B通道，即奇数GPIO）所在的PWM slice
+// 计数，在秒边沿锚定后启用计数器回绕中断。sqw_gpio为1Hz SQW所接引脚（-1表示轮询秒寄存器）；
+// 锚定最长阻塞DS3231_STAMP_ANCHOR_TIMEOUT_US。同一时间只支持一个实例，
+// 生产者为调用核上的中断，事件可在任一核上用ds3231_stamp_read()取出
+bool ds3231_stamp_start(ds3231_t *ds3231, ds3231_stamp_t *stamp, uint clk_gpio, int sqw_gpio);
+// 接入事件引脚，edges为GPIO_IRQ_EDGE_RISE/GPIO_IRQ_EDGE_FALL的组合；
+// 使用原始GPIO中断，不影响ds3231_tick_attach_gpio()占用的回调
+bool ds3231_stamp_attach_gpios(uint32_t gpio_mask, uint32_t edges);
+void ds3231_stamp_stop(void);
+// MCU进入dormant，直到gpio_mask中任一引脚出现下降沿（DS3231 SQW/INT、按键等），返回唤醒的引脚。
+// 期间所有时钟停止：time_us_64()不前进（醒来后须与DS3231重新同步），USB连接会断开。
+// 醒来后按启动配置恢复时钟；边沿不在此确认，已接入的GPIO中断照常收到
+uint32_t ds3231_dormant_until_edge(uint32_t gpio_mask);
+// 闹钟：写入闹钟寄存器后用ds3231_enable_alarm_interrupts()接到INT引脚。
+// INTCN=1时SQW方波停止，引脚在任一已启用闹钟标志置位时拉低，清除标志后释放；
+// INT同样是下降沿有效，可以用ds3231_tick_attach_gpio()接到一个单独的分发器
+bool ds3231_set_alarm1(ds3231_t *ds3231, const ds3231_alarm_t *alarm, ds3231_alarm1_mode_t mode);
+bool ds3231_set_alarm2(ds3231_t *ds3231, const ds3231_alarm_t *alarm, ds3231_alarm2_mode_t mode);
+bool ds3231_enable_alarm_interrupts(ds3231_t *ds3231, bool alarm1, bool alarm2);
+bool ds3231_read_alarm_flags(ds3231_t *ds3231, uint8_t *flags); // DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG
+bool ds3231_clear_alarm_flags(ds3231_t *ds3231, uint8_t flags);
 void ds3231_time_to_string(const ds3231_time_t *time, char *buffer, size_t buffer_size);
 
 // 辅助函数
+// 时间寄存器0x00-0x06与ds3231_time_t互转，一次处理全部7个字段并校验范围，
+// 无效的BCD数字、越界字段或不存在的日期返回false；星期由日期推算
+bool ds3231_decode_time(const uint8_t regs[7], ds3231_time_t *time);
+bool ds3231_encode_time(const ds3231_time_t *time, uint8_t regs[7]);
 uint8_t bcd_to_bin(uint8_t bcd);
 uint8_t bin_to_bcd(uint8_t bin);
 
@@ -0,0 +1,62 @@
+#ifndef DS3231_ALARM_H
+#define DS3231_ALARM_H
+
+#include "ds3231/ds3231.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 软件定时器调度器
+//
+// 任意数量的软件定时器（上限DS3231_ALARM_MAX_TIMERS）按截止时间保存在最小堆中，
+// 只把最近的截止时间写入闹钟1（日期+时分秒匹配），把其后的截止时间按分钟向下取整
+// 写入闹钟2：闹钟1触发后重新设置失败时闹钟2仍会在不晚于下一个截止时间时唤醒。
+// 本次写入闹钟1失败时，闹钟2改为覆盖最近的截止时间（该截止时间就在当前这一分钟内时，
+// 在下一个整分钟唤醒，最多迟到59秒）。
+// MCU在两次INT之间可以休眠，不必轮询。
+//
+// 截止时间为Unix秒。闹钟1只能匹配月内日期，超过DS3231_ALARM_MAX_AHEAD_S的截止时间
+// 先设一个中间唤醒点。回调中可以添加或取消定时器。
+
+#define DS3231_ALARM_MAX_TIMERS   16
+#define DS3231_ALARM_MAX_AHEAD_S  (27L * 86400) // 不超过最短的月份，避免日期匹配提前命中
+
+// id为ds3231_alarm_scheduler_add()返回的编号，deadline为本次到期的截止时间
+typedef void (*ds3231_alarm_callback_t)(uint32_t id, int64_t deadline, void *ctx);
+
+typedef struct {
+    int64_t deadline;
+    uint32_t period_s;                 // 0为单次定时器
+    uint32_t id;
+    ds3231_alarm_callback_t callback;
+    void *ctx;
+} ds3231_alarm_timer_t;
+
+typedef struct {
+    ds3231_t *rtc;
+    ds3231_alarm_timer_t heap[DS3231_ALARM_MAX_TIMERS];
+    uint8_t count;
+    uint32_t next_id;
+    int64_t armed1;                    // 写入闹钟1的时间，-1表示未设置
+    int64_t armed2;                    // 写入闹钟2的时间，-1表示未设置
+    uint8_t irq_enabled;               // 已写入控制寄存器的A1IE/A2IE组合
+    uint32_t fired;                    // 累计执行的回调数
+} ds3231_alarm_scheduler_t;
+
+bool ds3231_alarm_scheduler_init(ds3231_alarm_scheduler_t *sched, ds3231_t *rtc);
+// 添加定时器，返回id，失败返回0；period_s非0时为周期定时器
+uint32_t ds3231_alarm_scheduler_add(ds3231_alarm_scheduler_t *sched, int64_t deadline, uint32_t period_s,
+                                    ds3231_alarm_callback_t callback, void *ctx);
+bool ds3231_alarm_scheduler_cancel(ds3231_alarm_scheduler_t *sched, uint32_t id);
+// 最近的截止时间，没有定时器时返回false
+bool ds3231_alarm_scheduler_next(const ds3231_alarm_scheduler_t *sched, int64_t *deadline);
+// INT触发后（或添加/取消定时器后）调用：清除闹钟标志，执行now之前到期的定时器，
+// 重新设置两个闹钟。返回本次执行的回调数
+uint32_t ds3231_alarm_scheduler_service(ds3231_alarm_scheduler_t *sched, int64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_ALARM_H
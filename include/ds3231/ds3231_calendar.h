@@ -0,0 +1,58 @@
+#ifndef DS3231_CALENDAR_H
+#define DS3231_CALENDAR_H
+
+#include "ds3231/ds3231.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 日历换算与格式化（纯计算，不访问I2C；换算不查表，格式化不使用snprintf）
+//
+// epoch为Unix时间（1970-01-01 00:00:00起的秒数），ds3231_time_t的年份相对2000年。
+
+// 公历日期与1970-01-01之间的天数
+int32_t ds3231_days_from_civil(int32_t year, uint32_t month, uint32_t date);
+// 天数转公历日期
+void ds3231_civil_from_days(int32_t days, int32_t *year, uint32_t *month, uint32_t *date);
+
+uint8_t ds3231_days_in_month(int32_t year, uint32_t month);
+// 星期（0=Sunday），由天数或日期推算，不依赖星期寄存器
+uint8_t ds3231_weekday_from_days(int32_t days);
+uint8_t ds3231_weekday(const ds3231_time_t *time);
+
+int64_t ds3231_time_to_epoch(const ds3231_time_t *time);
+// 星期由日期推算，0=Sunday
+void ds3231_epoch_to_time(int64_t epoch, ds3231_time_t *time);
+
+// 夏令时切换规则（POSIX TZ的Mm.w.d/time形式）
+typedef struct {
+    uint8_t month;     // 1-12，0表示不使用夏令时
+    uint8_t week;      // 1-5，5表示该月最后一个
+    uint8_t weekday;   // 0=Sunday
+    int16_t minute;    // 当地时间的切换时刻，从当天0点起的分钟数
+} ds3231_dst_rule_t;
+
+// 时区：例如中国为{480, 0, {0}, {0}}，欧洲中部为{60, 60, {3, 5, 0, 120}, {10, 5, 0, 180}}
+typedef struct {
+    int16_t std_offset_min;     // 标准时间相对UTC的偏移（分钟，东为正）
+    int16_t dst_delta_min;      // 夏令时额外偏移，通常为60
+    ds3231_dst_rule_t dst_start; // 以标准时间表示
+    ds3231_dst_rule_t dst_end;   // 以夏令时表示
+} ds3231_tz_t;
+
+// UTC到当地时间的总偏移（分钟）
+int32_t ds3231_tz_offset_min(const ds3231_tz_t *tz, int64_t utc_epoch, bool *is_dst);
+int64_t ds3231_utc_to_local(const ds3231_tz_t *tz, int64_t utc_epoch, bool *is_dst);
+
+// 格式化到调用者的缓冲区，返回写入的字符数（不含结尾0），缓冲区不足时截断。
+// 模式：%Y %y %m %d %H %M %S %a(星期缩写) %%，其余字符原样输出
+size_t ds3231_format(char *buf, size_t size, const char *pattern, const ds3231_time_t *time);
+// ISO-8601：YYYY-MM-DDTHH:MM:SS，再加Z（utc_offset_min为0）或±HH:MM
+size_t ds3231_format_iso8601(char *buf, size_t size, const ds3231_time_t *time, int16_t utc_offset_min);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_CALENDAR_H
@@ -0,0 +1,47 @@
+#ifndef DS3231_CALIBRATION_H
+#define DS3231_CALIBRATION_H
+
+#include "ds3231/ds3231.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 老化偏移校准服务
+//
+// 用外部参考时间（例如主机通过USB发来的时间戳）测量RTC的频偏，换算成老化偏移写入芯片。
+// 频偏随温度变化，因此按温度分段学习：一个测量窗口内温度必须停留在同一段，
+// 窗口跨度达到DS3231_CALIB_MIN_SPAN_S后更新该段的偏移；温度进入已学习的段时
+// 由ds3231_calib_service()写入对应的偏移。
+
+#define DS3231_CALIB_MIN_SPAN_S   21600   // 6小时：1ms的时间戳抖动对应不到0.05ppm
+#define DS3231_CALIB_MAX_PPB      200000  // 超过200ppm视为参考时间跳变，丢弃窗口
+#define DS3231_CALIB_PPB_PER_LSB  100     // 老化偏移每LSB约0.1ppm
+#define DS3231_CALIB_TEMP_MIN     (-10)   // 第0段的下限（°C）
+#define DS3231_CALIB_BIN_C        5
+#define DS3231_CALIB_BINS         12      // -10°C ~ 50°C
+
+typedef struct {
+    ds3231_t *rtc;
+    int64_t ref_start_us;     // 窗口起点的参考时间
+    int64_t rtc_start_us;     // 窗口起点的RTC时间
+    int8_t window_bin;        // 窗口所在温度段，-1表示没有窗口
+    int8_t applied_bin;       // 当前芯片中的偏移对应的温度段，-1表示未应用
+    int8_t offsets[DS3231_CALIB_BINS];
+    bool learned[DS3231_CALIB_BINS];
+    int32_t last_ppb;         // 最近一次测得的频偏，正值表示RTC偏快
+    uint32_t updates;         // 写入老化偏移的次数
+} ds3231_calib_t;
+
+bool ds3231_calib_init(ds3231_calib_t *calib, ds3231_t *rtc);
+// 提交一个参考样本：ref_us为参考源的Unix微秒，rtc_us为同一时刻RTC的Unix微秒
+// （可由ds3231_timekeeper_now_us()得到）。窗口完成并更新偏移时返回true
+bool ds3231_calib_add_reference(ds3231_calib_t *calib, int64_t ref_us, int64_t rtc_us, float temperature);
+// 温度更新后调用：进入已学习的温度段时写入该段的偏移，写入时返回true
+bool ds3231_calib_service(ds3231_calib_t *calib, float temperature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_CALIBRATION_H
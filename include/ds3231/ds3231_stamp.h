@@ -0,0 +1,75 @@
+#ifndef DS3231_STAMP_H
+#define DS3231_STAMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 事件时间戳（不依赖Pico SDK，可在主机上用模拟计数器测试）
+//
+// DS3231的32kHz输出与秒寄存器来自同一个振荡器分频链，用硬件计数器对它计数，
+// 在某个秒边沿记下计数值作为锚点后，任意时刻的计数值都能换算成
+// “RTC秒 + 秒内1/32768”的时间戳，不需要再访问I2C。
+//
+// 16位硬件计数由回绕次数扩展为64位：计数器回绕中断调用ds3231_stamp_wrap()，
+// 读取计数时一并读取回绕中断的挂起标志，挂起且计数位于前半周期说明回绕已经发生
+// 但中断尚未处理（不能用“两次读数之差”扩展：回绕中断延迟固定时，
+// 相邻两次读数恰好相差65536，差值为0）。
+//
+// 生产者（捕获中断）调用ds3231_stamp_capture()写入环形缓冲区，消费者（任一核）
+// 调用ds3231_stamp_read()。单生产者单消费者，head只由生产者写、tail只由消费者写，
+// 无需加锁；发布与回收都带内存屏障，跨核可见。回绕中断与捕获中断须在同一核上、
+// 同一优先级，互不抢占。
+
+#define DS3231_STAMP_HZ        32768
+#define DS3231_STAMP_HZ_SHIFT  15
+#define DS3231_STAMP_RING_SIZE 256      // 2的幂
+
+// 事件边沿
+#define DS3231_STAMP_RISE 0x01
+#define DS3231_STAMP_FALL 0x02
+
+typedef struct {
+    uint32_t seconds;   // RTC时间（Unix秒）
+    uint16_t ticks;     // 秒内的1/32768秒
+    uint8_t source;     // 事件来源（GPIO号）
+    uint8_t edge;       // DS3231_STAMP_RISE / DS3231_STAMP_FALL
+} ds3231_stamp_event_t;
+
+typedef struct {
+    volatile uint32_t wraps;   // 回绕次数，回绕中断中递增
+    uint64_t anchor_count;     // 秒边沿处的计数
+    uint32_t anchor_seconds;   // 该秒边沿开始的RTC秒
+    bool anchored;
+    uint32_t captured;
+    uint32_t dropped;          // 缓冲区满或尚未锚定时丢弃的事件
+    // 环形缓冲区
+    volatile uint32_t head;    // 生产者写
+    volatile uint32_t tail;    // 消费者写
+    ds3231_stamp_event_t events[DS3231_STAMP_RING_SIZE];
+} ds3231_stamp_t;
+
+void ds3231_stamp_init(ds3231_stamp_t *stamp);
+// 计数器回绕（回绕中断）
+void ds3231_stamp_wrap(ds3231_stamp_t *stamp);
+// 16位计数扩展为64位；wrap_pending为读取计数之后读到的回绕中断挂起标志。
+// 在回绕中断之外调用时须关中断，保证读取期间回绕中断不会被处理
+uint64_t ds3231_stamp_count(const ds3231_stamp_t *stamp, uint16_t raw, bool wrap_pending);
+// 以秒边沿处的计数锚定RTC秒（捕获开始之前）
+void ds3231_stamp_anchor(ds3231_stamp_t *stamp, uint64_t count, uint32_t rtc_seconds);
+// 扩展后的计数换算为时间戳
+bool ds3231_stamp_convert(const ds3231_stamp_t *stamp, uint64_t count, uint32_t *seconds, uint16_t *ticks);
+// 捕获一个事件（生产者），缓冲区满或尚未锚定时丢弃并返回false
+bool ds3231_stamp_capture(ds3231_stamp_t *stamp, uint64_t count, uint8_t source, uint8_t edge);
+// 取出最多max个事件（消费者），返回取出的数量
+uint32_t ds3231_stamp_read(ds3231_stamp_t *stamp, ds3231_stamp_event_t *events, uint32_t max);
+uint32_t ds3231_stamp_available(const ds3231_stamp_t *stamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_STAMP_H
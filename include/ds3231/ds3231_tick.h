@@ -0,0 +1,51 @@
+#ifndef DS3231_TICK_H
+#define DS3231_TICK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 节拍分发器（不依赖Pico SDK，可在主机上用模拟节拍源测试）
+//
+// 节拍源（DS3231 SQW引脚的GPIO中断，或主机上的模拟源）调用ds3231_tick_post()，
+// 主循环调用ds3231_tick_dispatch()把累积的节拍依次分发给订阅者。
+// post只由中断写入posted计数，dispatch只由主循环写入dispatched计数，无需加锁。
+
+#define DS3231_TICK_MAX_SUBSCRIBERS 8
+
+// tick为从0开始的节拍序号，edge_us为本次dispatch时最近一个已投递边沿的时间戳。
+// 只保存最后一个边沿：积压多个节拍时（lagged计数），本次分发的各节拍收到同一个
+// edge_us，即最后一个节拍的边沿，较早的节拍没有各自的时间戳
+typedef void (*ds3231_tick_callback_t)(uint32_t tick, uint64_t edge_us, void *ctx);
+
+typedef struct {
+    ds3231_tick_callback_t callback;
+    void *ctx;
+    uint32_t period;   // 每period个节拍调用一次
+    uint32_t phase;    // tick % period == phase时调用
+} ds3231_tick_subscriber_t;
+
+typedef struct {
+    volatile uint32_t posted;      // 中断中递增
+    volatile uint64_t last_edge_us;
+    uint32_t dispatched;
+    uint32_t lagged;               // dispatch时积压超过1个节拍的次数
+    ds3231_tick_subscriber_t subscribers[DS3231_TICK_MAX_SUBSCRIBERS];
+    uint8_t subscriber_count;
+} ds3231_tick_t;
+
+void ds3231_tick_init(ds3231_tick_t *tick);
+bool ds3231_tick_subscribe(ds3231_tick_t *tick, uint32_t period, uint32_t phase,
+                           ds3231_tick_callback_t callback, void *ctx);
+void ds3231_tick_post(ds3231_tick_t *tick, uint64_t edge_us);
+bool ds3231_tick_pending(const ds3231_tick_t *tick);
+uint32_t ds3231_tick_dispatch(ds3231_tick_t *tick); // 返回本次分发的节拍数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_TICK_H
@@ -0,0 +1,57 @@
+#ifndef DS3231_TIMEKEEPER_H
+#define DS3231_TIMEKEEPER_H
+
+#include "ds3231/ds3231.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 软件计时服务
+//
+// 从DS3231读取一次时间后用RP2040的微秒定时器本地推算，按设定间隔重新同步，
+// 并测量、补偿两个时钟之间的频率偏差。now系列函数不产生任何I2C传输。
+//
+// 同步需要知道秒的起点：有SQW节拍时用ds3231_timekeeper_sync_at_edge()
+// （下降沿即秒更新时刻，只需一次读取）；否则ds3231_timekeeper_sync()
+// 以DS3231_TIMEKEEPER_POLL_US为间隔轮询到秒变化为止。
+
+#define DS3231_TIMEKEEPER_POLL_US      5000
+#define DS3231_TIMEKEEPER_MIN_DRIFT_S  60   // 两次同步间隔至少这么久才更新频偏估计
+#define DS3231_TIMEKEEPER_MAX_DRIFT_PPM 1000 // 超过此频偏的测量值视为RTC跳变，不计入估计
+
+typedef struct {
+    ds3231_t *rtc;
+    uint64_t base_us;            // 同步时刻的time_us_64()
+    int64_t base_epoch;          // 同步时刻的Unix时间（秒）
+    uint64_t resync_interval_us;
+    int32_t drift_ppb;           // 本地定时器相对RTC的频偏，正值表示本地偏快
+    int32_t last_error_us;       // 上次同步时本地推算值与RTC的差
+    uint32_t sync_count;
+    uint32_t rtc_reads;          // 累计的RTC时间读取次数
+    uint32_t steps;              // 检测到的RTC跳变次数（丢弃了频偏估计）
+    bool synced;
+    bool drift_valid;
+} ds3231_timekeeper_t;
+
+bool ds3231_timekeeper_init(ds3231_timekeeper_t *tk, ds3231_t *rtc, uint32_t resync_interval_s);
+bool ds3231_timekeeper_sync(ds3231_timekeeper_t *tk);
+bool ds3231_timekeeper_sync_at_edge(ds3231_timekeeper_t *tk, uint64_t edge_us);
+// 同上，时间由调用方读取（如异步读取完成后）：time为边沿edge_us之后读到的时间，
+// 须在边沿后的同一秒内调用
+bool ds3231_timekeeper_sync_with_time(ds3231_timekeeper_t *tk, uint64_t edge_us, const ds3231_time_t *time);
+bool ds3231_timekeeper_resync_due(const ds3231_timekeeper_t *tk);
+
+// Unix时间（微秒），未同步时返回0
+uint64_t ds3231_timekeeper_now_us(const ds3231_timekeeper_t *tk);
+// 当前时间，subsec_us可为NULL
+bool ds3231_timekeeper_now(const ds3231_timekeeper_t *tk, ds3231_time_t *time, uint32_t *subsec_us);
+// SQW下降沿edge_us开始的那一秒：推算到边沿并四舍五入到整秒。
+// 边沿时刻的推算值可能比整秒略早（频偏估计误差、中断延迟），截断会得到上一秒
+bool ds3231_timekeeper_at_edge(const ds3231_timekeeper_t *tk, uint64_t edge_us, ds3231_time_t *time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DS3231_TIMEKEEPER_H
@@ -0,0 +1,119 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 协作式事件循环（不依赖Pico SDK，可在主机上用虚拟时钟做确定性模拟，见tools/event_loop_sim）
+//
+// 任务是一个步进函数：每次有事件时被调用一次，做完一小步就返回，不在其中等待。
+// 事件来源：
+//   - 主循环内的信号：event_task_signal()置位，如渲染完成后通知传输任务；
+//   - 定时器：event_task_timer()，单次或周期；
+//   - 轮询：任务的poll函数返回true。中断只更新驱动自己的计数（如ds3231_tick_post()），
+//     poll在主循环中读取（如ds3231_tick_pending()）。
+// 每次只运行一个就绪任务，然后从头重新检查，添加顺序即优先级。没有就绪任务时调用
+// idle(until_us)：设备上为WFE等待中断或最近的定时器，主机模拟中直接把虚拟时钟拨到until_us。
+// 每个任务统计运行次数与CPU时间，空闲时间单独统计。
+
+#define EVENT_LOOP_MAX_TASKS 12
+
+// 系统事件位，其余位由任务自行定义
+#define EVENT_TIMER 0x80000000u     // 定时器到期
+#define EVENT_POLL  0x20000000u     // poll函数返回true
+#define EVENT_YIELD 0x10000000u     // EVENT_TASK_YIELD()
+#define EVENT_USER_MASK 0x0FFFFFFFu
+
+typedef struct event_task event_task_t;
+
+typedef void (*event_task_fn_t)(event_task_t *task, uint32_t events);
+typedef bool (*event_poll_fn_t)(void *ctx);
+
+struct event_task {
+    const char *name;
+    event_task_fn_t fn;
+    event_poll_fn_t poll;           // 可为NULL
+    void *ctx;
+    uint32_t signals;               // 待处理的用户事件
+    uint64_t deadline_us;           // 定时器到期时刻（timer_armed时有效）
+    bool timer_armed;
+    uint32_t period_us;             // 0为单次定时器
+    uint16_t line;                  // EVENT_TASK_*宏的恢复点
+    // 统计
+    uint32_t runs;
+    uint64_t cpu_us;
+    uint32_t max_us;
+    uint32_t max_late_us;           // 定时器到期到开始运行的最长延迟
+    uint32_t overruns;              // 周期定时器错过的周期数
+};
+
+typedef uint64_t (*event_now_fn_t)(void *ctx);
+typedef void (*event_idle_fn_t)(void *ctx, uint64_t until_us);
+
+typedef struct {
+    event_now_fn_t now;
+    event_idle_fn_t idle;
+    void *port_ctx;
+    event_task_t *tasks[EVENT_LOOP_MAX_TASKS];
+    uint8_t task_count;
+    event_task_t *current;          // 正在运行的任务
+    // 统计
+    uint64_t stats_start_us;
+    uint64_t idle_us;
+    uint32_t idles;
+} event_loop_t;
+
+// now返回单调微秒时间；idle在无任务就绪时调用，可提前返回（有中断时）
+void event_loop_init(event_loop_t *loop, event_now_fn_t now, event_idle_fn_t idle, void *port_ctx);
+// 添加任务，按添加顺序决定优先级（先添加的优先）
+bool event_loop_add(event_loop_t *loop, event_task_t *task, const char *name, event_task_fn_t fn, void *ctx);
+void event_task_set_poll(event_task_t *task, event_poll_fn_t poll);
+
+// 主循环内置位用户事件
+void event_task_signal(event_task_t *task, uint32_t events);
+// 启动定时器：delay_us后到期，period_us非0时之后按周期到期（以到期时刻为基准，不累积漂移）
+void event_task_timer(event_loop_t *loop, event_task_t *task, uint32_t delay_us, uint32_t period_us);
+void event_task_cancel_timer(event_task_t *task);
+
+// 运行一个就绪任务；没有就绪任务时空闲到最近的定时器（最多max_idle_us）。返回是否运行了任务
+bool event_loop_run_once(event_loop_t *loop, uint32_t max_idle_us);
+// 运行直到now() >= until_us（主机模拟），until_us为0时不返回
+void event_loop_run(event_loop_t *loop, uint64_t until_us);
+
+// 打印每个任务的运行次数、CPU时间与占比
+void event_loop_print_stats(const event_loop_t *loop);
+void event_loop_reset_stats(event_loop_t *loop);
+
+// 状态机式任务的顺序写法（C++20协程的替代，C++17可用）：
+//
+//   void blink(event_task_t *t, uint32_t events) {
+//       EVENT_TASK_BEGIN(t);
+//       while (true) {
+//           led_on();
+//           EVENT_TASK_SLEEP(t, loop, 100000);
+//           led_off();
+//           EVENT_TASK_SLEEP(t, loop, 900000);
+//       }
+//       EVENT_TASK_END(t);
+//   }
+//
+// 恢复点存在task->line中，局部变量在SLEEP/YIELD之后不保留（状态放在ctx里）；
+// BEGIN与END之间不能再用switch，每行最多一个YIELD/SLEEP（恢复点用行号区分）
+#define EVENT_TASK_BEGIN(t) switch ((t)->line) { case 0:
+#define EVENT_TASK_END(t) } (t)->line = 0
+// 返回并在下一轮循环继续
+#define EVENT_TASK_YIELD(t) \
+    do { (t)->line = __LINE__; event_task_signal((t), EVENT_YIELD); return; case __LINE__:; } while (0)
+// 返回，us微秒后从此处继续（占用任务的定时器）
+#define EVENT_TASK_SLEEP(t, loop, us) \
+    do { (t)->line = __LINE__; event_task_timer((loop), (t), (us), 0); return; case __LINE__:; } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_LOOP_H
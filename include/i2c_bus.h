@@ -0,0 +1,115 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 共享I2C总线仲裁器
+//
+// 一个i2c_bus_t独占一个I2C控制器，多个设备驱动把事务提交到它的队列：
+// - 按优先级调度，同优先级先到先服务；
+// - 可拆分的大块写入（如SSD1306帧缓冲）按分片发送，每个分片是一次独立的I2C事务，
+//   分片之间会先服务更高优先级的事务，RTC读取最多等待一个分片；
+// - 每个设备有自己的总线速率，切换设备时自动调整；
+// - 分片期限超时后执行总线恢复。
+//
+// i2c_bus_submit()可在中断中调用；i2c_bus_poll()/i2c_bus_wait()只能在主循环中调用，
+// 完成回调在i2c_bus_poll()中执行，回调里只能提交事务，不能等待。
+
+#define I2C_BUS_MAX_PENDING   8
+#define I2C_BUS_CHUNK_BYTES   128     // 分片长度上限，400kHz下约3ms（tools/i2c_bus_sim）
+#define I2C_BUS_TIMEOUT_US    10000   // 单个分片的期限
+
+// 优先级
+#define I2C_BUS_PRIORITY_LOW    0     // 帧缓冲等大块写入
+#define I2C_BUS_PRIORITY_NORMAL 1     // 命令
+#define I2C_BUS_PRIORITY_HIGH   2     // 对延迟敏感的读取（RTC）
+#define I2C_BUS_PRIORITIES      3
+
+typedef struct {
+    uint8_t addr;
+    uint32_t baudrate;
+} i2c_bus_device_t;
+
+typedef enum {
+    I2C_BUS_TXN_IDLE = 0,
+    I2C_BUS_TXN_PENDING,
+    I2C_BUS_TXN_ACTIVE,      // 可拆分写入已发送部分分片
+    I2C_BUS_TXN_DONE,
+    I2C_BUS_TXN_ERROR,
+    I2C_BUS_TXN_TIMEOUT
+} i2c_bus_txn_state_t;
+
+typedef void (*i2c_bus_callback_t)(i2c_bus_txn_state_t state, void *ctx);
+
+// 事务：先写wbuf，再读rbuf（重复起始）；chunk非0时wbuf按chunk字节拆分，
+// 每个分片前重复发送header（如SSD1306的数据控制字节0x40），此时不能读取
+typedef struct {
+    const i2c_bus_device_t *device;
+    const uint8_t *header;
+    uint8_t header_len;
+    const uint8_t *wbuf;
+    uint16_t wlen;
+    uint8_t *rbuf;
+    uint16_t rlen;
+    uint16_t chunk;
+    uint8_t priority;
+    uint16_t offset;         // 已发送的wbuf字节数
+    uint64_t submit_us;
+    volatile i2c_bus_txn_state_t state;
+    i2c_bus_callback_t callback;
+    void *ctx;
+} i2c_bus_txn_t;
+
+typedef struct {
+    uint32_t completed;
+    uint32_t chunks;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t recoveries;
+    uint32_t speed_switches;
+    uint32_t max_wait_us[I2C_BUS_PRIORITIES];  // 提交到开始执行的最长等待
+    uint32_t max_chunk_us;                     // 最长的单次总线占用，即高优先级事务的最坏阻塞
+} i2c_bus_stats_t;
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t sda_pin;
+    uint8_t scl_pin;
+    uint32_t baudrate;                         // 当前速率
+    i2c_bus_txn_t *queue[I2C_BUS_MAX_PENDING]; // 按提交顺序
+    volatile uint8_t count;
+    bool polling;
+    i2c_bus_stats_t stats;
+    uint8_t staging[I2C_BUS_CHUNK_BYTES + 4];  // header+分片
+} i2c_bus_t;
+
+// 初始化控制器和引脚（只在这里初始化一次，设备驱动不再调用i2c_init）
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin, uint32_t baudrate);
+
+void i2c_bus_txn_init(i2c_bus_txn_t *txn, const i2c_bus_device_t *device, const uint8_t *wbuf, uint16_t wlen,
+                      uint8_t *rbuf, uint16_t rlen, uint8_t priority);
+// 提交事务，txn在完成前必须保持有效
+bool i2c_bus_submit(i2c_bus_t *bus, i2c_bus_txn_t *txn);
+// 执行一步（一个原子事务或一个分片），返回队列是否还有事务
+bool i2c_bus_poll(i2c_bus_t *bus);
+// 轮询直到txn完成，期间其他事务按优先级穿插执行
+bool i2c_bus_wait(i2c_bus_t *bus, i2c_bus_txn_t *txn);
+// 提交并等待
+bool i2c_bus_transfer(i2c_bus_t *bus, const i2c_bus_device_t *device, const uint8_t *wbuf, uint16_t wlen,
+                      uint8_t *rbuf, uint16_t rlen, uint8_t priority);
+
+// 总线恢复：SDA被从机拉住时以GPIO方式输出最多9个SCL脉冲，再产生START+STOP，
+// 然后以baudrate重新初始化控制器。返回总线是否已释放
+bool i2c_bus_recover_pins(i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin, uint32_t baudrate);
+bool i2c_bus_recover(i2c_bus_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_BUS_H
@@ -0,0 +1,116 @@
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 延迟格式化的二进制日志（不依赖Pico SDK）
+//
+// 调用方只写入格式编号、时间戳与原始参数（每个参数一个32位字）到环形缓冲区，
+// 不在调用处格式化、不等待串口。格式化在低优先级任务中进行（log_sink_drain()），
+// 或者把记录按二进制记录行原样输出，由主机上的tools/log_decode格式化，
+// 设备上不再做浮点格式化。缓冲区满时丢弃新记录并计数，不阻塞。
+//
+// 格式串放在编号表中（log_sink_init()时传入，编号即下标），支持的转换：
+// %d %i %u %x %X %o %c（32位整数，可带l/h修饰）、%f %e %g（float），
+// 标志、宽度、精度与%%；不支持%s、%p、*宽度（参数不能是指针）。
+// 浮点参数以float保存，精度约7位有效数字。
+//
+// 单生产者单消费者：head只由写入方写、tail只由输出方写，发布与回收带内存屏障，
+// 两方可在不同核上。中断中不要写日志（与主循环构成两个生产者）。
+
+#define LOG_SINK_RING_WORDS 1024    // 2的幂
+#define LOG_SINK_MAX_ARGS   12
+#define LOG_SINK_LINE_MAX   192     // 一行输出的最大长度（含结尾的0）
+
+// 记录行格式（文本，可与普通printf输出混在同一串口中）：
+//   $SSDL,F,<编号>,<格式串>     格式表，\n与\\转义；编号0的表行同时重置时间基准
+//   $SSDL,R,<十六进制字节>      记录：格式编号、时间增量（us）、各参数，
+//                               均为LEB128变长整数，参数先做zigzag变换
+//   $SSDL,D,<累计丢弃数>
+#define LOG_SINK_PREFIX "$SSDL,"
+
+typedef uint64_t (*log_now_fn_t)(void *ctx);
+
+typedef struct {
+    const char *const *formats;
+    uint16_t format_count;
+    log_now_fn_t now;
+    void *now_ctx;
+    // 环形缓冲区：每条记录为头字（格式编号<<16 | 参数个数）、时间戳低32位、参数
+    volatile uint32_t head;     // 写入方写，按字计数
+    volatile uint32_t tail;     // 输出方写
+    uint32_t words[LOG_SINK_RING_WORDS];
+    // 写入方的统计
+    uint32_t records;
+    uint32_t dropped;           // 缓冲区满或参数不合法时丢弃的记录
+    uint32_t high_water;        // 缓冲区占用的最大字数
+    // 输出方的状态
+    uint32_t reported_dropped;
+    uint32_t last_ts;           // 二进制记录的时间基准
+} log_sink_t;
+
+// formats须在日志的整个生命周期内有效
+void log_sink_init(log_sink_t *sink, const char *const *formats, uint16_t format_count, log_now_fn_t now,
+                   void *now_ctx);
+
+// 写入一条记录，缓冲区满时返回false并计入dropped
+bool log_sink_push(log_sink_t *sink, uint16_t format, uint8_t nargs, const uint32_t *args);
+
+// 是否有待输出的记录或丢弃计数
+bool log_sink_pending(const log_sink_t *sink);
+
+// 取出一条记录写成一行到buf（文本为格式化结果，binary时为$SSDL记录行），
+// 返回长度，没有记录时返回0。有新的丢弃时先返回一行丢弃提示
+size_t log_sink_next(log_sink_t *sink, char *buf, size_t size, bool binary);
+
+// 最多输出max_records行到stdout，返回输出的行数
+uint32_t log_sink_drain(log_sink_t *sink, uint32_t max_records, bool binary);
+
+// 以$SSDL,F记录行输出格式表（主机随时接入时都能解码），并重置时间基准
+void log_sink_print_formats(log_sink_t *sink);
+
+// 按格式串格式化原始参数（设备与主机工具共用），返回写入的长度（不含结尾的0）；
+// 参数不足或转换不支持时对应位置输出'?'
+size_t log_sink_format(const char *format, const uint32_t *args, uint8_t nargs, char *buf, size_t size);
+
+// 解析$SSDL,R记录行的十六进制部分，返回参数个数，格式错误时返回-1
+int log_sink_decode_record(const char *hex, uint16_t *format, uint32_t *ts_delta, uint32_t *args,
+                           uint8_t max_args);
+
+#ifdef __cplusplus
+}
+
+#include <type_traits>
+
+// 参数转换：整数按32位保存，浮点数按float位模式保存
+inline uint32_t log_sink_arg(float v) {
+    uint32_t w;
+    memcpy(&w, &v, sizeof(w));
+    return w;
+}
+inline uint32_t log_sink_arg(double v) {
+    return log_sink_arg((float)v);
+}
+template <typename T>
+inline uint32_t log_sink_arg(T v) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "日志参数只能是整数或浮点数");
+    return (uint32_t)v;
+}
+
+//   log_sink_write(&log, LOG_TEMPERATURE, temperature);
+template <typename... Args>
+inline bool log_sink_write(log_sink_t *sink, uint16_t format, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_SINK_MAX_ARGS, "日志参数过多");
+    const uint32_t words[sizeof...(Args) + 1] = {log_sink_arg(args)...};
+    return log_sink_push(sink, format, (uint8_t)sizeof...(Args), words);
+}
+#endif
+
+#endif // LOG_SINK_H
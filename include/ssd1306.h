@@ -3,6 +3,11 @@
 
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "ssd1306_blend.h"
+#include "ssd1306_trace.h"
+#include "ssd1306_tile.h"
+#include "ssd1306_static.h"
+#include "i2c_bus.h"
 #include <cstdint>
 #include <cstring>
 
@@ -32,6 +37,9 @@
 #define SSD1306_SETHIGHCOLUMN 0x10
 #define SSD1306_SETSTARTLINE 0x40
 
+// ssd1306_commandList()一次事务最多发送的命令字节数（以0x00开头的命令流）
+#define SSD1306_COMMAND_STREAM_MAX 32
+
 #define SSD1306_EXTERNALVCC 0x01
 #define SSD1306_SWITCHCAPVCC 0x02
 
@@ -40,15 +48,33 @@
 #define SSD1306_WHITE 1
 #define SSD1306_INVERSE 2
 
+// 抖动方式（见ssd1306_gray.h）
+#define SSD1306_DITHER_ORDERED         0 // 8x8 Bayer有序抖动（按字并行）
+#define SSD1306_DITHER_FLOYD_STEINBERG 1 // 误差扩散（逐像素串行）
+
 // 兼容性定义
 #define BLACK SSD1306_BLACK
 #define WHITE SSD1306_WHITE
 #define INVERSE SSD1306_INVERSE
 
+// 共享总线上SSD1306使用的速率
+#define SSD1306_BUS_BAUDRATE 400000
+
+// 面板内容影子的有效标记
+#define SSD1306_SHADOW_VALID 0x53534431 // 'SSD1'
+
 // 显示尺寸
 #define SSD1306_LCDWIDTH 128
 #define SSD1306_LCDHEIGHT 64
 
+// 面板内容影子：记录已传输到GDDRAM的内容（逻辑布局）。
+// 放在复位时不清零的RAM中（__uninitialized_ram），看门狗复位后面板仍保持
+// 配置与GDDRAM，据此只重传变化的区域；传输进行中magic清零，复位打断传输时自动失效
+typedef struct {
+    uint32_t magic;     // SSD1306_SHADOW_VALID时与面板内容一致
+    uint8_t frame[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+} ssd1306_shadow_t;
+
 class SSD1306 {
 public:
     // SSD1306 I2C地址
@@ -56,18 +82,43 @@ public:
     
     // 构造函数
     SSD1306(i2c_inst_t* i2c_instance, uint8_t address = ADDRESS);
+    // 挂到共享总线上：帧缓冲按分片以低优先级写入，命令以普通优先级写入
+    SSD1306(i2c_bus_t* bus, uint8_t address = ADDRESS);
     ~SSD1306();
     
-    // 初始化
+    // 初始化：整个初始化序列在一次I2C事务中发送，面板无应答时返回false。
+    // reset为false时为热启动：面板保持着复位前的配置与GDDRAM，只同步电荷泵、
+    // 对比度、方向并开启显示（同样一次事务），不清除面板内容
     bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true);
+    // 使用面板内容影子，之后displayRegion()会同步更新它
+    void attachShadow(ssd1306_shadow_t* shadow);
+    // 使用块脏位图：之后绘图函数标记写入的8x8块，displayRegion()同步更新块的哈希缓存。
+    // 通过getBuffer()直接改写帧缓冲后须自行标记（tiles->markRect()/markAll()）
+    void attachTiles(TileMap* tiles);
     
     // 显示控制
     void display();
+    void displayRegion(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1); // 只传输列[x0,x1]、页[page0,page1]
+    bool displayChanged(); // 只传输与影子不同的区域（无有效影子时传输整屏），无变化时返回false
+    bool displayTiles();   // 只传输内容变化的脏块，合并为若干窗口（未使用块脏位图时传输整屏），无变化时返回false
     void clearDisplay();
     void clear(); // 兼容性函数
     void invertDisplay(bool i);
     void dim(bool dim);
+    // 面板休眠：关闭显示并停止电荷泵，GDDRAM内容保持，wake()后无需重传
+    void sleep();
+    void wake();
+    bool isSleeping() const { return sleeping_; }
     void setContrast(uint8_t contrast);
+    uint8_t getContrast() const;
+    void setStartLine(uint8_t line); // 硬件垂直滚动（显示起始行0-63）
+    
+    // 旋转与镜像（调用后需重绘并display()）
+    // 0/180度及镜像由SEGREMAP/COMSCAN硬件完成；90/270度时逻辑尺寸为64x128，
+    // 在display()时按8x8块转置
+    void setRotation(uint8_t rotation); // 0-3，对应0/90/180/270度
+    uint8_t getRotation() const { return rotation_; }
+    void setMirror(bool mirror_x, bool mirror_y);
     
     // 绘图函数
     void drawPixel(int16_t x, int16_t y, uint16_t color);
@@ -79,6 +130,21 @@ public:
     void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
     void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
     
+    // 合成函数（op为SSD1306_BLEND_*，见ssd1306_blend.h）
+    void blend(const uint8_t* src, uint8_t op);
+    void blendImage(int16_t x, int16_t y, const uint8_t* img, int16_t w, int16_t h, uint8_t op);
+    void blendRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t op);
+    
+    // 绘制编译期预合成的图像（见ssd1306_static.h）；默认OR，与白色print()结果相同
+    template <int16_t W, int16_t H>
+    void drawStatic(int16_t x, int16_t y, const ssd1306_static_image_t<W, H>& img, uint8_t op = SSD1306_BLEND_OR) {
+        blendImage(x, y, img.data, W, H, op);
+    }
+    
+    // 8位灰度图像（行主序）抖动后绘制
+    void drawGrayImage(int16_t x, int16_t y, const uint8_t* gray, int16_t w, int16_t h,
+                       uint8_t dither = SSD1306_DITHER_ORDERED);
+    
     // 文本函数
     void setCursor(int16_t x, int16_t y);
     void setTextSize(uint8_t s);
@@ -99,19 +165,35 @@ public:
     uint8_t* getBuffer();
     
     // 获取显示尺寸
-    int16_t width() const { return WIDTH; }
-    int16_t height() const { return HEIGHT; }
+    int16_t width() const { return width_; }
+    int16_t height() const { return height_; }
+    
+#if SSD1306_INSTRUMENT
+    // 插桩计数（见ssd1306_trace.h）
+    const ssd1306_counters_t& counters() const { return counters_; }
+    void resetCounters();
+#endif
 
 private:
     i2c_inst_t* i2c_;
+    i2c_bus_t* bus_;
+    i2c_bus_device_t bus_device_;
     uint8_t address_;
     uint8_t* buffer_;
+    ssd1306_shadow_t* shadow_;
+    TileMap* tiles_;
     uint8_t vccstate_;
     uint8_t contrast_;
+    bool sleeping_;
+    uint8_t rotation_;
+    bool mirror_x_;
+    bool mirror_y_;
     
-    // 显示尺寸
+    // 显示尺寸（WIDTH/HEIGHT为物理尺寸，width_/height_为旋转后的逻辑尺寸）
     static const int16_t WIDTH = SSD1306_LCDWIDTH;
     static const int16_t HEIGHT = SSD1306_LCDHEIGHT;
+    int16_t width_;
+    int16_t height_;
     
     // 文本属性
     int16_t cursor_x;
@@ -120,18 +202,27 @@ private:
     uint16_t textcolor;
     bool textwrap;
     
+#if SSD1306_INSTRUMENT
+    ssd1306_counters_t counters_;
+    uint8_t prim_;  // 当前最外层的绘图原语，SSD1306_PRIM_NONE表示不在原语中
+#endif
+    
     // 低层通信函数
     void ssd1306_command(uint8_t c);
     void ssd1306_commandList(const uint8_t* c, uint8_t n);
     void ssd1306_data(uint8_t* data, size_t size);
+    bool writeRaw(const uint8_t* data, size_t size);
+    void orientationCommands(uint8_t* segremap, uint8_t* comscan) const;
+    void applyOrientation();
+    
+    // 面板内容未知时使影子与块哈希缓存失效
+    void invalidatePanel();
     
     // 内部绘图函数
     void drawFastHLineInternal(int16_t x, int16_t y, int16_t w, uint16_t color);
     void drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t color);
     void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
-    
-    // 字体数据（5x7字体）
-    static const uint8_t font5x7[][5];
+    void drawVSpan(int32_t x, int32_t y, int32_t h, uint16_t color); // 32位坐标的竖线，裁剪后再画
 };
 
 #endif // SSD1306_H 
\ No newline at end of file
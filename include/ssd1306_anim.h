@@ -0,0 +1,108 @@
+#ifndef SSD1306_ANIM_H
+#define SSD1306_ANIM_H
+
+#include "ssd1306.h"
+#include <cstdint>
+
+// 缓动曲线
+#define SSD1306_EASE_LINEAR      0
+#define SSD1306_EASE_IN_QUAD     1
+#define SSD1306_EASE_OUT_QUAD    2
+#define SSD1306_EASE_IN_OUT_QUAD 3
+
+// 过渡效果
+#define SSD1306_TRANSITION_WIPE_LEFT   0 // 新画面从左向右擦入
+#define SSD1306_TRANSITION_WIPE_RIGHT  1 // 新画面从右向左擦入
+#define SSD1306_TRANSITION_SLIDE_LEFT  2 // 旧画面向左移出，新画面从右侧进入
+#define SSD1306_TRANSITION_SLIDE_RIGHT 3 // 旧画面向右移出，新画面从左侧进入
+
+// 补间：在duration_us内把整数值从from变化到to（位置、对比度、滚动偏移等）
+class Tween {
+public:
+    Tween();
+
+    void start(int32_t from, int32_t to, uint32_t duration_us, uint64_t now_us,
+               uint8_t easing = SSD1306_EASE_LINEAR);
+    int32_t value(uint64_t now_us) const;
+    bool done(uint64_t now_us) const;
+
+private:
+    int32_t from_;
+    int32_t to_;
+    uint64_t start_us_;
+    uint32_t duration_us_;
+    uint8_t easing_;
+};
+
+// 帧时间统计
+typedef struct {
+    uint32_t frames;          // 已执行的帧数
+    uint32_t dropped;         // 因落后而跳过的帧数
+    uint32_t render_us_last;
+    uint32_t render_us_max;
+    uint64_t render_us_total;
+    uint32_t flush_us_last;
+    uint32_t flush_us_max;
+    uint64_t flush_us_total;
+} ssd1306_frame_stats_t;
+
+// 固定步长帧调度器
+//
+// waitNextFrame()睡眠到下一个帧时刻并返回该帧的时间戳。若渲染+传输
+// 超过一个周期，错过的帧直接跳过并计入dropped，而不是连续补帧；
+// 动画按帧时间戳求值，因此跳帧不影响动画速度。
+class FrameScheduler {
+public:
+    explicit FrameScheduler(uint32_t period_us);
+
+    uint64_t waitNextFrame();
+    void setPeriod(uint32_t period_us);
+    uint32_t period() const { return period_us_; }
+
+    // 遥测：包围渲染和传输阶段（两者各自计时，分块传输途中可以渲染下一帧）
+    void beginRender();
+    void endRender();
+    void beginFlush();
+    void endFlush();
+
+    const ssd1306_frame_stats_t& stats() const { return stats_; }
+    void resetStats();
+
+private:
+    uint32_t period_us_;
+    uint64_t next_frame_us_;
+    uint64_t render_start_us_;
+    uint64_t flush_start_us_;
+    ssd1306_frame_stats_t stats_;
+};
+
+// 两个画布（页格式缓冲区，与getBuffer()同尺寸）之间的过渡
+//
+// render()把当前进度写入显示缓冲区并记录变化的列范围，flush()只传输
+// 这些列：擦除效果每步只发送新露出的几列。from/to不能是显示缓冲区本身。
+class Transition {
+public:
+    explicit Transition(SSD1306& oled);
+
+    void start(const uint8_t* from, const uint8_t* to, uint8_t type,
+               uint32_t duration_us, uint64_t now_us,
+               uint8_t easing = SSD1306_EASE_LINEAR);
+    bool render(uint64_t now_us); // 返回本步缓冲区是否有变化
+    void flush();
+    bool active() const { return active_; }
+
+private:
+    SSD1306& oled_;
+    const uint8_t* from_;
+    const uint8_t* to_;
+    uint8_t type_;
+    Tween tween_;
+    int16_t pos_;      // 已擦入的列数或滑动偏移
+    int16_t dirty_x0_;
+    int16_t dirty_x1_;
+    bool active_;
+
+    void markDirty(int16_t x0, int16_t x1);
+};
+
+#endif // SSD1306_ANIM_H
@@ -0,0 +1,39 @@
+#ifndef SSD1306_BLEND_H
+#define SSD1306_BLEND_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 混合操作定义（d = 目标像素, s = 源像素）
+#define SSD1306_BLEND_COPY   0  // d = s
+#define SSD1306_BLEND_OR     1  // d = d | s
+#define SSD1306_BLEND_AND    2  // d = d & s
+#define SSD1306_BLEND_XOR    3  // d = d ^ s
+#define SSD1306_BLEND_ANDNOT 4  // d = d & ~s
+
+// 页格式缓冲区合成内核
+//
+// 页格式：每字节为一列中的8个垂直像素（bit0在上），每页宽度为buf_w字节，
+// 共(buf_h + 7) / 8页，与SSD1306显存及SSD1306::getBuffer()布局一致。
+// 所有内核按32位字处理，首尾不足一个字的部分按字节处理。
+
+// 整缓冲区合成：dst[i] = op(dst[i], src[i])
+void ssd1306_blend_buffer(uint8_t* dst, const uint8_t* src, size_t size, uint8_t op);
+
+// 带掩码复制：dst[i] = (dst[i] & ~mask[i]) | (src[i] & mask[i])
+void ssd1306_blend_masked(uint8_t* dst, const uint8_t* src, const uint8_t* mask, size_t size);
+
+// 将页格式图像(img_w x img_h)以op合成到目标缓冲区的(x, y)处
+// y不必按8对齐，跨页的位移在内核中以字为单位完成；超出目标的部分被裁剪
+void ssd1306_blend_image(uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                         int16_t x, int16_t y,
+                         const uint8_t* img, int16_t img_w, int16_t img_h,
+                         uint8_t op);
+
+// 对矩形区域应用常量“全1”源：
+// OR = 置亮, ANDNOT = 清除, XOR = 反色（高亮、闪烁光标）
+void ssd1306_blend_rect(uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                        int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint8_t op);
+
+#endif // SSD1306_BLEND_H
@@ -0,0 +1,68 @@
+#ifndef SSD1306_CODEC_H
+#define SSD1306_CODEC_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 页格式帧压缩（不依赖Pico SDK，可在主机上编译解码）
+//
+// 编码帧 = 3字节头 + 令牌流
+//   头:   [类型][原始长度低字节][原始长度高字节]
+//   类型: SSD1306_CODEC_KEY   - 令牌流为帧本身
+//         SSD1306_CODEC_DELTA - 令牌流为本帧与上一帧的异或
+//   令牌: 0x00-0x7F 后跟(n+1)个字面字节
+//         0x80-0xFF 表示((n & 0x7F) + 1)个零字节
+// 时钟画面每秒只有几个数字变化，差分后绝大部分为零，游程压缩效果很好。
+#define SSD1306_CODEC_KEY   0x4B // 'K'
+#define SSD1306_CODEC_DELTA 0x44 // 'D'
+
+#define SSD1306_CODEC_HEADER_SIZE 3
+
+// 最坏情况下的编码长度（全部为字面字节）
+#define SSD1306_CODEC_MAX_SIZE(n) (SSD1306_CODEC_HEADER_SIZE + (n) + ((n) + 127) / 128)
+
+// 编码一帧：prev为nullptr时输出关键帧。返回编码长度，out_cap不足时返回0
+size_t ssd1306_codec_encode(const uint8_t* cur, const uint8_t* prev, size_t size,
+                            uint8_t* out, size_t out_cap);
+
+// 解码一帧：frame中为上一帧内容（关键帧时忽略），解码后就地更新为本帧
+bool ssd1306_codec_decode(const uint8_t* in, size_t in_len, uint8_t* frame, size_t size);
+
+// 帧记录行格式（文本，可与普通printf输出混在同一串口中）：
+//   $SSDF,<序号>,<时间戳us>,<base64编码帧>\n
+// 序号每帧加1（32位回绕），回放端据此发现丢失的行：差分帧依赖上一帧，
+// 丢行之后必须等到下一个关键帧才能继续解码。
+#define SSD1306_RECORD_PREFIX "$SSDF,"
+
+// 解析一行记录，成功时返回true并输出序号、时间戳和编码帧
+bool ssd1306_record_parse_line(const char* line, uint32_t* seq, uint64_t* timestamp_us,
+                               uint8_t* payload, size_t payload_cap, size_t* payload_len);
+
+// 帧记录器：对每帧做差分+游程编码，按记录行格式输出到stdout
+//
+// 每key_interval帧输出一个关键帧，主机端中途接入或丢行后也能重新同步。
+class FrameRecorder {
+public:
+    static constexpr size_t MAX_FRAME = 1024;
+
+    explicit FrameRecorder(uint16_t key_interval = 60);
+
+    bool record(const uint8_t* frame, size_t size, uint64_t timestamp_us);
+    void reset(); // 下一帧强制为关键帧
+
+    uint32_t frames() const { return frames_; }
+    uint64_t rawBytes() const { return raw_bytes_; }
+    uint64_t encodedBytes() const { return encoded_bytes_; }
+
+private:
+    uint8_t prev_[MAX_FRAME];
+    uint8_t encoded_[SSD1306_CODEC_MAX_SIZE(MAX_FRAME)];
+    uint16_t key_interval_;
+    uint16_t since_key_;
+    bool have_prev_;
+    uint32_t frames_;
+    uint64_t raw_bytes_;
+    uint64_t encoded_bytes_;
+};
+
+#endif // SSD1306_CODEC_H
@@ -0,0 +1,70 @@
+#ifndef SSD1306_GOLDEN_H
+#define SSD1306_GOLDEN_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+// 黄金图像回归检查（不依赖Pico SDK，可在主机上编译比较）
+//
+// 设备端用固定的输入渲染一组场景，每个场景输出一行记录，包含帧内容与渲染耗时；
+// 主机端tools/ssd1306_golden把每帧与tools/golden/<场景名>.pbm比较，不一致时打印
+// 差异图并保存实际图像，同时与记录的耗时基线比较。优化绘图函数前后各跑一次，
+// 画面不变且耗时不退化才合入。
+//
+// SSD1306_INSTRUMENT=1时每个场景另有一行开销记录：渲染并传输一次整帧的驱动计数
+// （写入的像素、绘图原语调用、I2C事务与字节）。计数与时钟无关，主机与设备上相同，
+// 与tools/golden/costs.txt比较即可在主机上检查性能退化。
+//
+// 记录行格式（文本，可与普通printf输出混在同一串口中）：
+//   $SSDG,<场景名>,<渲染耗时us>,<FNV-1a哈希(8位十六进制)>,<页格式帧(十六进制)>\n
+//   $SSDC,<场景名>,<像素>,<原语调用>,<I2C事务>,<I2C字节>\n
+#define SSD1306_GOLDEN_PREFIX "$SSDG,"
+#define SSD1306_GOLDEN_COST_PREFIX "$SSDC,"
+#define SSD1306_GOLDEN_NAME_MAX 32
+
+typedef struct {
+    uint32_t pixels;            // 各绘图原语写入的像素数之和
+    uint32_t calls;             // 绘图原语调用次数之和
+    uint32_t txns;              // 命令与数据事务
+    uint32_t bytes;             // 命令与数据字节（含控制字节）
+} ssd1306_golden_cost_t;
+
+#define SSD1306_GOLDEN_COST_FIELDS 4
+
+// 帧内容的FNV-1a哈希
+uint32_t ssd1306_frame_hash(const uint8_t* frame, size_t size);
+
+// 输出一行记录到stdout
+void ssd1306_golden_record(const char* name, uint32_t render_us, const uint8_t* frame, size_t size);
+
+// 解析一行记录，哈希与帧内容不符（传输出错）时返回false
+bool ssd1306_golden_parse_line(const char* line, char* name, size_t name_cap, uint32_t* render_us,
+                               uint8_t* frame, size_t frame_cap, size_t* frame_len);
+
+// 输出、解析开销记录
+void ssd1306_golden_cost_record(const char* name, const ssd1306_golden_cost_t* cost);
+bool ssd1306_golden_cost_parse_line(const char* line, char* name, size_t name_cap, ssd1306_golden_cost_t* cost);
+// 开销各字段的值与名称（按记录中的顺序），用于逐项比较
+uint32_t ssd1306_golden_cost_field(const ssd1306_golden_cost_t* cost, uint8_t field);
+const char* ssd1306_golden_cost_field_name(uint8_t field);
+
+// PBM与页格式帧互转（帧宽width、高height像素，页格式每字节为一列中的8行，低位在上）
+bool ssd1306_pbm_write(FILE* out, const uint8_t* frame, uint16_t width, uint16_t height); // P4（二进制）
+bool ssd1306_pbm_read(FILE* in, uint8_t* frame, uint16_t width, uint16_t height);         // P1/P4，尺寸须一致
+
+typedef struct {
+    uint32_t pixels;            // 不同的像素数
+    uint16_t x0, x1, y0, y1;    // 包含全部不同像素的最小矩形（pixels为0时无意义）
+} ssd1306_frame_diff_t;
+
+// 逐像素比较两帧，返回不同的像素数
+uint32_t ssd1306_frame_diff(const uint8_t* actual, const uint8_t* expected, uint16_t width, uint16_t height,
+                            ssd1306_frame_diff_t* diff);
+
+// 以字符画打印差异矩形（四周各扩2像素）：
+//   '#' 两帧都点亮  '+' 只有实际帧点亮  '-' 只有黄金图像点亮  '.' 都不亮
+void ssd1306_frame_print_diff(FILE* out, const uint8_t* actual, const uint8_t* expected, uint16_t width,
+                              uint16_t height, const ssd1306_frame_diff_t* diff);
+
+#endif // SSD1306_GOLDEN_H
@@ -0,0 +1,62 @@
+#ifndef SSD1306_GRAY_H
+#define SSD1306_GRAY_H
+
+#include "ssd1306.h"
+#include <cstdint>
+
+// Floyd–Steinberg误差缓冲区支持的最大图像宽度
+#define SSD1306_DITHER_FS_MAX_WIDTH SSD1306_LCDWIDTH
+
+// 时间调制灰度的最大位平面数（3个位平面 = 8级灰度）
+#define SSD1306_GRAY_MAX_PLANES 3
+
+// 8位灰度（行主序，每行stride字节）的最多8行有序抖动为w个页格式字节
+// 每次处理4列：用SWAR逐字节比较灰度与阈值，比较结果的最高位直接移入页字节
+void ssd1306_dither_ordered_page(const uint8_t* gray, int16_t stride, int16_t w,
+                                 uint8_t rows, uint8_t* out);
+
+// Floyd–Steinberg抖动整幅图像，结果写入页格式缓冲区的(x, y)处（超出部分裁剪）
+// w超过SSD1306_DITHER_FS_MAX_WIDTH时返回false
+bool ssd1306_dither_fs(const uint8_t* gray, int16_t w, int16_t h,
+                       uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                       int16_t x, int16_t y);
+
+// 把灰度图量化为planes位，第k位写入planes_out[k]（buf_w x buf_h页格式，左上角对齐）
+void ssd1306_gray_to_planes(const uint8_t* gray, int16_t w, int16_t h, uint8_t planes,
+                            uint8_t* const* planes_out, int16_t buf_w, int16_t buf_h);
+
+// 时间调制灰度显示
+//
+// 每个位平面以与其权重成比例的对比度轮流显示，肉眼平均后得到2^planes级灰度。
+// 相邻位平面只传输两者不同的区域（包围盒），减少每个平面的传输时间以维持刷新率。
+// step()需以固定频率调用（例如由FrameScheduler驱动）；planesPerSecond()给出实际
+// 达到的平面刷新率，除以平面数即为灰度帧率。
+class GrayscalePlayer {
+public:
+    explicit GrayscalePlayer(SSD1306& oled);
+
+    // plane_storage需至少planes * 帧缓冲区大小字节，在播放期间保持有效
+    bool load(const uint8_t* gray, int16_t w, int16_t h, uint8_t planes,
+              uint8_t* plane_storage, uint8_t base_contrast = 0xFF);
+    void step();
+    void stop(); // 停止并恢复原对比度
+
+    uint32_t planesPerSecond() const;
+    uint32_t bytesSent() const { return bytes_sent_; }
+
+private:
+    SSD1306& oled_;
+    uint8_t* planes_[SSD1306_GRAY_MAX_PLANES];
+    uint8_t contrast_[SSD1306_GRAY_MAX_PLANES];
+    uint8_t plane_count_;
+    uint8_t current_;
+    uint8_t saved_contrast_;
+    bool full_refresh_;
+    uint32_t frames_;
+    uint32_t bytes_sent_;
+    uint64_t start_us_;
+
+    size_t frameSize() const;
+};
+
+#endif // SSD1306_GRAY_H
@@ -0,0 +1,144 @@
+#ifndef SSD1306_POWER_H
+#define SSD1306_POWER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 低功耗显示策略（不依赖Pico SDK，可在主机上模拟比较不同策略）
+//
+// 时钟大部分时间无人观看，按无操作时长和夜间窗口分三档：
+//   ACTIVE - 每秒刷新，显示秒
+//   IDLE   - 隐藏秒，每分钟刷新一次（可同时降低对比度）
+//   OFF    - 关闭显示并停止电荷泵，面板RAM保持，唤醒后无需重传
+// PowerManager只给出每次唤醒该做什么，并按传输字节数估算总线时间、
+// 按调用方报告的唤醒时长统计运行时间，折算为每小时的数值。
+
+#define SSD1306_POWER_ACTIVE 0
+#define SSD1306_POWER_IDLE   1
+#define SSD1306_POWER_OFF    2
+
+// 一次I2C事务的位数：起始+停止，每字节8位数据加1位ACK（含地址字节）
+#define SSD1306_POWER_TXN_BITS(bytes) ((uint32_t)(bytes) * 9 + 2)
+
+// n条命令以控制字节0x00开头的命令流一次事务发送：地址 + 控制字节 + 命令
+#define SSD1306_POWER_COMMAND_BYTES(n) ((uint32_t)(n) + 2)
+#define SSD1306_POWER_COMMAND_BITS(n) SSD1306_POWER_TXN_BITS(SSD1306_POWER_COMMAND_BYTES(n))
+
+// displayRegion()的窗口命令（PAGEADDR、COLUMNADDR各带两个参数）、sleep()/wake()与dim()发送的命令数
+#define SSD1306_POWER_WINDOW_COMMANDS 6
+#define SSD1306_POWER_PANEL_COMMANDS 3
+#define SSD1306_POWER_DIM_COMMANDS   2
+
+typedef struct {
+    uint32_t idle_after_s;      // 无操作多久后隐藏秒、改为每分钟刷新，0表示不降频
+    uint32_t off_after_s;       // 无操作多久后关闭面板，0表示不关闭
+    uint16_t night_start_min;   // 夜间窗口（当地时间，0点起的分钟数），窗口内关闭面板；
+    uint16_t night_end_min;     // 起止相等表示没有夜间窗口，start > end表示跨午夜
+    uint32_t night_grace_s;     // 夜间窗口内操作后保持点亮的时间，0表示窗口内始终关闭
+    bool partial_flush;         // 只传输与上次不同的区域
+    bool dim_when_idle;         // IDLE时降低对比度
+    bool dormant;               // 两次唤醒之间MCU进入dormant（由调用方执行，此处只记录）
+} ssd1306_power_policy_t;
+
+// 每次唤醒的动作
+typedef struct {
+    uint8_t mode;               // SSD1306_POWER_*
+    bool mode_changed;
+    bool redraw;                // 需要重绘并刷新
+    bool show_seconds;
+    bool panel_on;
+    bool panel_changed;         // 需要调用sleep()/wake()
+    bool dim;
+    bool dim_changed;           // 需要调用dim()
+    uint8_t wake_period_s;      // 下次唤醒间隔：1为每秒（SQW 1Hz），60为每分钟（闹钟2）
+} ssd1306_power_plan_t;
+
+// 传输窗口（逻辑坐标，可直接传给displayRegion()）
+typedef struct {
+    uint8_t x0, x1;
+    uint8_t page0, page1;
+} ssd1306_power_region_t;
+
+typedef struct {
+    uint64_t elapsed_s;         // 统计时长（墙上时间）
+    uint64_t panel_on_s;
+    uint64_t bus_bits;
+    uint64_t bus_us;            // 按各总线速率估算的传输时间
+    uint64_t bus_bytes;
+    uint64_t awake_us;          // 调用方报告的唤醒时长
+    uint32_t wakeups;
+    uint32_t flushes;
+    uint32_t skipped;           // 画面无变化而省去的刷新
+    uint32_t mode_s[3];         // 各档位累计秒数
+} ssd1306_power_stats_t;
+
+// 折算为每小时
+typedef struct {
+    float bus_ms;
+    float awake_ms;
+    float bus_bytes;
+    float wakeups;
+    float flushes;
+    float panel_on_pct;
+} ssd1306_power_report_t;
+
+// 一次displayRegion()的总线位数：窗口命令事务 + 数据事务（地址+控制字节+数据）
+uint32_t ssd1306_power_region_bits(const ssd1306_power_region_t* region);
+
+// 与上一帧比较，求包含全部变化字节的最小窗口；无变化时返回false。
+// width为帧宽（列），pages为页数
+bool ssd1306_power_dirty_region(const uint8_t* cur, const uint8_t* prev, uint8_t width, uint8_t pages,
+                                ssd1306_power_region_t* region);
+
+// 低功耗显示管理器
+//
+// 每次唤醒（SQW节拍、分钟闹钟或按键）时调用plan()，按返回的动作操作面板，
+// 重绘后用flush()求传输窗口；调用方在再次睡眠前用accountAwake()报告本次唤醒时长。
+class PowerManager {
+public:
+    static constexpr size_t MAX_FRAME = 1024;
+
+    explicit PowerManager(const ssd1306_power_policy_t& policy, uint32_t bus_baud = 400000);
+
+    void setPolicy(const ssd1306_power_policy_t& policy);
+    const ssd1306_power_policy_t& policy() const { return policy_; }
+
+    // 按键等用户操作：回到ACTIVE并重新计时
+    void activity(uint32_t now_s);
+
+    // now_s为单调秒（如Unix秒），minute_of_day为当地时间0点起的分钟数
+    ssd1306_power_plan_t plan(uint32_t now_s, uint16_t minute_of_day);
+
+    // 求本帧的传输窗口并记下本帧；策略不做局部刷新时返回整屏。
+    // 返回false表示与上次传输的内容相同，不必刷新
+    bool flush(const uint8_t* frame, uint8_t width, uint8_t pages, ssd1306_power_region_t* region);
+    // 面板内容被其他途径改写后（如过渡动画），下一次flush()传输整屏
+    void invalidate() { have_prev_ = false; }
+
+    // 其他总线传输（如读取RTC），baud为该总线速率
+    void accountTransfer(uint32_t bytes, uint32_t transactions, uint32_t baud);
+    void accountAwake(uint32_t awake_us);
+
+    const ssd1306_power_stats_t& stats() const { return stats_; }
+    void report(ssd1306_power_report_t* out) const;
+    void resetStats();
+
+private:
+    void accountBits(uint32_t bits, uint32_t bytes, uint32_t baud);
+    bool inNight(uint16_t minute_of_day) const;
+
+    ssd1306_power_policy_t policy_;
+    uint32_t bus_baud_;
+    uint32_t last_activity_s_;
+    uint32_t last_plan_s_;
+    uint16_t last_minute_;
+    uint8_t mode_;
+    bool panel_on_;
+    bool dimmed_;
+    bool started_;
+    bool have_prev_;
+    ssd1306_power_stats_t stats_;
+    uint8_t prev_[MAX_FRAME];
+};
+
+#endif // SSD1306_POWER_H
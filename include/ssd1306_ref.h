@@ -0,0 +1,105 @@
+#ifndef SSD1306_REF_H
+#define SSD1306_REF_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 绘图原语的参考光栅化器与随机用例（不依赖Pico SDK）
+//
+// 参考实现逐像素绘制：坐标用64位整数计算，每个像素单独做边界检查，不做裁剪、
+// 按字节或按页的优化，因此慢但显然正确。优化过的原语（SSD1306、RowCanvas、
+// 合成内核）在同一随机背景上执行同一用例，结果须与参考实现逐像素相同。
+//
+// 用例的坐标偏向边界：画面边缘附近、int16的极值与随机的全范围值都会出现。
+// 直线、圆的像素选取规则与SSD1306相同（Bresenham，err初值dx/2；中点画圆），
+// drawRect为两条水平线加两条竖线（反色时四个角各翻转两次，与SSD1306一致）。
+
+#define SSD1306_REF_PIXEL       0
+#define SSD1306_REF_HLINE       1
+#define SSD1306_REF_VLINE       2
+#define SSD1306_REF_RECT        3
+#define SSD1306_REF_FILL_RECT   4
+#define SSD1306_REF_CHAR        5
+#define SSD1306_REF_LINE        6
+#define SSD1306_REF_CIRCLE      7
+#define SSD1306_REF_FILL_CIRCLE 8
+#define SSD1306_REF_PRIM_COUNT  9
+
+// RowCanvas与合成内核支持的原语
+#define SSD1306_REF_BASIC_MASK  0x3Fu
+#define SSD1306_REF_ALL_MASK    0x1FFu
+
+typedef struct {
+    uint8_t prim;
+    int16_t x, y;       // 点、起点、矩形左上角、圆心或光标
+    int16_t a, b;       // 直线终点；矩形宽高；线长（a）；半径（a）
+    uint16_t color;     // 0黑、1白、2反色（与SSD1306_BLACK/WHITE/INVERSE相同）
+    uint8_t size;       // 字号（CHAR）
+    uint8_t ch;         // 字符（CHAR，任意字节，超出字体范围时不绘制）
+} ssd1306_ref_case_t;
+
+const char* ssd1306_ref_prim_name(uint8_t prim);
+
+// xorshift32，state不能为0
+uint32_t ssd1306_ref_random(uint32_t* state);
+
+// 生成一个用例，prim_mask的第i位允许原语i
+void ssd1306_ref_random_case(uint32_t* state, uint32_t prim_mask, int16_t width, int16_t height,
+                             ssd1306_ref_case_t* c);
+
+// 从字节串构造用例（供libFuzzer等输入驱动的工具使用），字节不足时返回false
+bool ssd1306_ref_case_from_bytes(const uint8_t* data, size_t size, uint32_t prim_mask, ssd1306_ref_case_t* c);
+
+// 在页格式帧上用参考算法绘制（每页width字节）
+void ssd1306_ref_draw(uint8_t* frame, int16_t width, int16_t height, const ssd1306_ref_case_t* c);
+
+// 以可复现的调用形式描述用例，如"drawLine(-32768, 3, 200, 7, 1)"
+int ssd1306_ref_describe(const ssd1306_ref_case_t* c, char* buf, size_t size);
+
+// 在画布上执行用例（SSD1306或RowCanvas）。basic只包含SSD1306_REF_BASIC_MASK中的原语
+template <typename Canvas>
+void ssd1306_ref_apply_basic(Canvas& canvas, const ssd1306_ref_case_t& c) {
+    switch (c.prim) {
+    case SSD1306_REF_PIXEL:
+        canvas.drawPixel(c.x, c.y, c.color);
+        break;
+    case SSD1306_REF_HLINE:
+        canvas.drawFastHLine(c.x, c.y, c.a, c.color);
+        break;
+    case SSD1306_REF_VLINE:
+        canvas.drawFastVLine(c.x, c.y, c.a, c.color);
+        break;
+    case SSD1306_REF_RECT:
+        canvas.drawRect(c.x, c.y, c.a, c.b, c.color);
+        break;
+    case SSD1306_REF_FILL_RECT:
+        canvas.fillRect(c.x, c.y, c.a, c.b, c.color);
+        break;
+    case SSD1306_REF_CHAR:
+        canvas.setCursor(c.x, c.y);
+        canvas.setTextSize(c.size);
+        canvas.setTextColor(c.color);
+        canvas.write(c.ch);
+        break;
+    }
+}
+
+template <typename Canvas>
+void ssd1306_ref_apply(Canvas& canvas, const ssd1306_ref_case_t& c) {
+    switch (c.prim) {
+    case SSD1306_REF_LINE:
+        canvas.drawLine(c.x, c.y, c.a, c.b, c.color);
+        break;
+    case SSD1306_REF_CIRCLE:
+        canvas.drawCircle(c.x, c.y, c.a, c.color);
+        break;
+    case SSD1306_REF_FILL_CIRCLE:
+        canvas.fillCircle(c.x, c.y, c.a, c.color);
+        break;
+    default:
+        ssd1306_ref_apply_basic(canvas, c);
+        break;
+    }
+}
+
+#endif // SSD1306_REF_H
@@ -0,0 +1,73 @@
+#ifndef SSD1306_ROWMAJOR_H
+#define SSD1306_ROWMAJOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 行主序工作帧缓冲（不依赖Pico SDK）
+//
+// 页格式下每字节是一列中的8行，水平线和文本行的每个像素落在不同字节上，只能逐字节改一位。
+// RowCanvas按行存储（每字节为8个水平相邻的像素，bit0在左），水平填充是整字节memset，
+// 字形的一行移位后只写1-2个字节。绘图时按8x8块记录脏块，convert()只把脏块用
+// ssd1306_transpose8x8转成页格式写入SSD1306的帧缓冲，之后照常display()/displayChanged()。
+//
+// 文本、进度条等水平元素为主的画面适合在RowCanvas上绘制；七段数字、圆等竖直元素多的
+// 画面直接在页格式上绘制更快，可以按画面选择（对比见示例中的LAYOUT_BENCH）。
+// 绘图与文本函数的参数和结果与SSD1306的同名函数一致，color为0黑、1白、2反色。
+class RowCanvas {
+public:
+    static constexpr int16_t MAX_WIDTH = 128;
+    static constexpr int16_t MAX_HEIGHT = 64;
+
+    // 宽高向下取整到8的倍数，不超过MAX_WIDTH/MAX_HEIGHT
+    explicit RowCanvas(int16_t width = MAX_WIDTH, int16_t height = MAX_HEIGHT);
+
+    int16_t width() const { return width_; }
+    int16_t height() const { return height_; }
+
+    void clear();
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    void setCursor(int16_t x, int16_t y);
+    void setTextSize(uint8_t s);
+    void setTextColor(uint16_t c);
+    void setTextWrap(bool w);
+    size_t write(uint8_t c);
+    void print(const char* str);
+
+    // 把脏块转换为页格式写入page_frame（每页width()字节）并清除脏标记，返回转换的块数。
+    // page_frame中其余块保持不变：clear()后只有上次转换时有内容的块需要重写为空白，
+    // 因此两次convert()之间page_frame被其他途径改写时，须先调用markAllDirty()
+    uint16_t convert(uint8_t* page_frame);
+    void markAllDirty();
+    bool dirty() const;
+
+    // 行主序缓冲区：第y行从getBuffer() + y * width() / 8开始
+    uint8_t* getBuffer() { return rows_; }
+
+private:
+    // span的参数已裁剪到画面内；bits只要求y在画面内，x方向自行裁剪
+    void span(int16_t y, int16_t x0, int16_t x1, uint8_t op);
+    void bits(int16_t y, int16_t x, uint32_t mask, int16_t n, uint8_t op);
+    void markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    int16_t width_;
+    int16_t height_;
+    uint8_t stride_;    // 每行字节数
+
+    int16_t cursor_x_;
+    int16_t cursor_y_;
+    uint8_t textsize_;
+    uint16_t textcolor_;
+    bool textwrap_;
+
+    uint16_t dirty_[MAX_HEIGHT / 8];    // 每页一个字，第i位对应第i个8列块
+    uint16_t drawn_[MAX_HEIGHT / 8];    // 上次转换时不为空白的块
+    uint8_t rows_[MAX_WIDTH / 8 * MAX_HEIGHT];
+};
+
+#endif // SSD1306_ROWMAJOR_H
@@ -0,0 +1,87 @@
+#ifndef SSD1306_STATIC_H
+#define SSD1306_STATIC_H
+
+#include "ssd1306_font.h"
+#include <cstdint>
+#include <cstddef>
+
+// 编译期预合成的页格式图像（不依赖Pico SDK）
+//
+// 固定的标签、图标在编译期由constexpr求值光栅化为页格式字节数组，放在flash中，
+// 绘制时只是一次合成（SSD1306::drawStatic()，y按8对齐且为COPY时每页一次memcpy），
+// 不再逐帧逐像素绘制字形。
+//
+//   static constexpr auto label = ssd1306_static_text("Temp");        // 24x8
+//   static constexpr auto big = ssd1306_static_text<2>("12");         // 24x16
+//   static constexpr auto icon = ssd1306_static_bitmap<5, 3>(".#.#."
+//                                                             "#####"
+//                                                             ".#.#.");
+//   oled.drawStatic(2, 9, label);
+template <int16_t W, int16_t H>
+struct ssd1306_static_image_t {
+    static constexpr int16_t width = W;
+    static constexpr int16_t height = H;
+    uint8_t data[W * ((H + 7) / 8)] = {};   // 每页W字节，共(H + 7) / 8页
+
+    constexpr void setPixel(int16_t x, int16_t y) {
+        if (x >= 0 && x < W && y >= 0 && y < H) {
+            data[(y / 8) * W + x] |= (uint8_t)(1 << (y & 7));
+        }
+    }
+    constexpr void fillRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+        for (int16_t j = y; j < y + h; j++) {
+            for (int16_t i = x; i < x + w; i++) {
+                setPixel(i, j);
+            }
+        }
+    }
+};
+
+// 文本占用的宽度，与SSD1306::print()的光标前进量一致（每字符6*size列，含字符间的空列）
+constexpr int16_t ssd1306_text_width(size_t len, uint8_t size = 1) {
+    return (int16_t)(len * 6 * size);
+}
+
+// 字符超出字体范围时调用，使常量求值失败（编译错误）
+void ssd1306_static_text_unsupported_char();
+
+// 文本光栅化，结果与在空白处print()（白色、字号Size）逐像素相同；
+// 每字符后的空列也在图像中，以COPY绘制时会清除该列
+template <uint8_t Size = 1, size_t N>
+constexpr ssd1306_static_image_t<ssd1306_text_width(N - 1, Size), 8 * Size> ssd1306_static_text(const char (&str)[N]) {
+    static_assert(Size > 0, "字号须大于0");
+    ssd1306_static_image_t<ssd1306_text_width(N - 1, Size), 8 * Size> img{};
+    for (size_t k = 0; k + 1 < N; k++) {
+        const uint8_t c = (uint8_t)str[k];
+        if (c < SSD1306_FONT_FIRST || c > SSD1306_FONT_LAST) {
+            ssd1306_static_text_unsupported_char();
+        }
+        const int16_t x = ssd1306_text_width(k, Size);
+        for (int16_t i = 0; i < SSD1306_FONT_WIDTH; i++) {
+            const uint8_t line = ssd1306_font5x7[c - SSD1306_FONT_FIRST][i];
+            for (int16_t j = 0; j < 8; j++) {
+                if ((line >> j) & 1) {
+                    img.fillRect(x + i * Size, j * Size, Size, Size);
+                }
+            }
+        }
+    }
+    return img;
+}
+
+// 字符画光栅化：art为H行、每行W个字符（按行连接），'#'为点亮，其余为空白
+template <int16_t W, int16_t H, size_t N>
+constexpr ssd1306_static_image_t<W, H> ssd1306_static_bitmap(const char (&art)[N]) {
+    static_assert(N == (size_t)W * H + 1, "字符画的长度与尺寸不符");
+    ssd1306_static_image_t<W, H> img{};
+    for (int16_t y = 0; y < H; y++) {
+        for (int16_t x = 0; x < W; x++) {
+            if (art[y * W + x] == '#') {
+                img.setPixel(x, y);
+            }
+        }
+    }
+    return img;
+}
+
+#endif // SSD1306_STATIC_H
@@ -0,0 +1,85 @@
+#ifndef SSD1306_TILE_H
+#define SSD1306_TILE_H
+
+#include "ssd1306_power.h"
+#include <cstdint>
+#include <cstddef>
+
+// 8x8块脏位图与块哈希缓存（不依赖Pico SDK）
+//
+// 页格式帧按8x8像素分块，每块是一页中连续的8个字节（128x64共16x8=128块）。
+// 绘图时标记脏块；刷新时对脏块计算哈希，与该块上次传输内容的哈希相同时（先清屏
+// 再按原样重绘的区域、空白区域、未变化的数字等）不再传输，剩余脏块合并成尽量少的
+// 地址窗口，每个窗口一次displayRegion()。每次刷新的工作量与脏块数成正比，
+// 字符单元式的界面每秒只传输变化的几个字符格。
+//
+// 哈希为32位，块内容改变后哈希恰好与旧内容相同的概率约为2^-32，此时该块不会被重传，
+// 直到内容再次变化或调用invalidate()。
+
+#define SSD1306_TILE_MAX 128        // 最大块数（128x64）
+#define SSD1306_TILE_MAX_WINDOWS 16 // 一次刷新最多的窗口数，超过时合并为包围盒
+
+typedef struct {
+    uint32_t marked;            // filter()时的脏块数
+    uint32_t skipped;           // 哈希与面板内容相同而省去的块
+    uint32_t sent;              // 经displayRegion()传输的完整块
+    uint32_t windows;           // 地址窗口数
+    uint32_t flushes;           // filter()次数
+} ssd1306_tile_stats_t;
+
+class TileMap {
+public:
+    // width/height为逻辑尺寸（像素），向上取整到8的倍数，最多SSD1306_TILE_MAX块
+    explicit TileMap(int16_t width = 128, int16_t height = 64);
+
+    // 改变尺寸（如旋转后），同时invalidate()
+    void setSize(int16_t width, int16_t height);
+    uint8_t cols() const { return cols_; }
+    uint8_t rows() const { return rows_; }
+
+    // 面板内容未知（上电、传输失败、方向改变）：全部块标记为脏，哈希缓存失效
+    void invalidate();
+    void markAll();
+    // 参数为已裁剪到画面内的像素坐标（闭区间）
+    void markPixel(int16_t x, int16_t y) {
+        const uint16_t t = (uint16_t)((y >> 3) * cols_ + (x >> 3));
+        dirty_[t >> 5] |= 1u << (t & 31);
+    }
+    void markRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    bool dirty() const;
+    uint16_t dirtyCount() const;
+    bool isDirty(uint8_t col, uint8_t row) const { return test(dirty_, (uint16_t)(row * cols_ + col)); }
+
+    // 对脏块计算哈希，与面板上内容相同的块清除脏标记，返回剩余的脏块数。
+    // frame为页格式帧，每页cols()*8字节
+    uint16_t filter(const uint8_t* frame);
+
+    // 把脏块合并为地址窗口（逻辑坐标，按块对齐），返回窗口数。
+    // 相邻的块段在合并后总线位数不增加时合并（间隔的干净块一并传输），
+    // 上下相邻且列范围相同的块段合并为一个窗口；超过max个窗口或总位数
+    // 不少于包围盒时返回包围盒
+    uint8_t windows(ssd1306_power_region_t* out, uint8_t max) const;
+
+    // displayRegion()成功传输窗口后调用：完整覆盖的块记下哈希并清除脏标记；
+    // 部分覆盖的脏块面板内容不确定，哈希失效并保持为脏
+    void sent(const uint8_t* frame, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+
+    const ssd1306_tile_stats_t& stats() const { return stats_; }
+    void resetStats();
+
+private:
+    static bool test(const uint32_t* bits, uint16_t t) { return (bits[t >> 5] >> (t & 31)) & 1; }
+    static void set(uint32_t* bits, uint16_t t) { bits[t >> 5] |= 1u << (t & 31); }
+    static void reset(uint32_t* bits, uint16_t t) { bits[t >> 5] &= ~(1u << (t & 31)); }
+    uint32_t hashTile(const uint8_t* frame, uint16_t t) const;
+
+    uint8_t cols_;
+    uint8_t rows_;
+    uint32_t dirty_[SSD1306_TILE_MAX / 32];
+    uint32_t known_[SSD1306_TILE_MAX / 32];     // hash_有效：与面板上该块的内容一致
+    uint32_t hash_[SSD1306_TILE_MAX];
+    ssd1306_tile_stats_t stats_;
+};
+
+#endif // SSD1306_TILE_H
@@ -0,0 +1,112 @@
+#ifndef SSD1306_TRACE_H
+#define SSD1306_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+
+// SSD1306驱动插桩（编译期开关）
+//
+// SSD1306_INSTRUMENT为1时，SSD1306对象统计各绘图原语写入的像素数、命令与数据
+// 传输的事务数和字节数、每次刷新的耗时直方图，并在初始化、刷新、文本与灰度绘制
+// 前后发出追踪事件。为0时（默认）计数成员、计数代码和追踪调用全部不参与编译。
+// 该开关改变SSD1306的成员布局，须对整个目标统一定义（见CMakeLists.txt）。
+#ifndef SSD1306_INSTRUMENT
+#define SSD1306_INSTRUMENT 0
+#endif
+
+// 绘图原语：像素计入最外层的原语（drawLine内部的drawPixel计入LINE）
+#define SSD1306_PRIM_PIXEL  0
+#define SSD1306_PRIM_HLINE  1
+#define SSD1306_PRIM_VLINE  2
+#define SSD1306_PRIM_LINE   3
+#define SSD1306_PRIM_RECT   4 // drawRect / fillRect
+#define SSD1306_PRIM_CIRCLE 5 // drawCircle / fillCircle
+#define SSD1306_PRIM_TEXT   6
+#define SSD1306_PRIM_BLEND  7
+#define SSD1306_PRIM_GRAY   8
+#define SSD1306_PRIM_COUNT  9
+#define SSD1306_PRIM_NONE   0xFF
+
+// 刷新耗时直方图：第i桶统计[2^i, 2^(i+1)) 微秒
+#define SSD1306_TRACE_HIST_BUCKETS 16
+
+typedef struct {
+    uint32_t calls[SSD1306_PRIM_COUNT];
+    uint32_t pixels[SSD1306_PRIM_COUNT];   // 裁剪后写入的像素数
+    uint32_t command_txns;                 // ssd1306_command()等命令事务
+    uint32_t command_bytes;                // 含控制字节，不含地址
+    uint32_t data_txns;                    // display()/displayRegion()的数据事务
+    uint32_t data_bytes;
+    uint32_t flushes;
+    uint32_t flush_us_max;
+    uint32_t flush_hist[SSD1306_TRACE_HIST_BUCKETS];
+} ssd1306_counters_t;
+
+void ssd1306_counters_record_flush(ssd1306_counters_t* counters, uint32_t us);
+// 由直方图估算刷新耗时的百分位数（返回所在桶的上界）
+uint32_t ssd1306_counters_flush_percentile(const ssd1306_counters_t* counters, uint8_t percentile);
+void ssd1306_counters_print(const ssd1306_counters_t* counters);
+
+// 追踪事件
+#define SSD1306_TRACE_BEGIN 'B'
+#define SSD1306_TRACE_END   'E'
+
+// 追踪钩子：name为静态字符串，phase为SSD1306_TRACE_BEGIN/END
+typedef void (*ssd1306_trace_hook_t)(const char* name, char phase, uint64_t ts_us, void* ctx);
+
+void ssd1306_trace_set_hook(ssd1306_trace_hook_t hook, void* ctx);
+void ssd1306_trace_emit(const char* name, char phase, uint64_t ts_us);
+uint64_t ssd1306_trace_now_us(); // 由驱动提供（time_us_64）
+
+// 追踪记录行格式（文本，可与普通printf输出混在同一串口中）：
+//   $SSDT,<时间戳us>,<B|E>,<名称>\n
+// 主机用tools/ssd1306_trace转换为Chrome trace格式（chrome://tracing、Perfetto）
+#define SSD1306_TRACE_PREFIX "$SSDT,"
+#define SSD1306_TRACE_RING 512
+
+typedef struct {
+    const char* name;
+    uint64_t ts_us;
+    char phase;
+} ssd1306_trace_event_t;
+
+// 缓冲钩子：事件先存入缓冲区，空闲时再用ssd1306_trace_dump()输出，
+// 不在被测代码中途调用printf；缓冲区满时丢弃新事件
+typedef struct {
+    ssd1306_trace_event_t events[SSD1306_TRACE_RING];
+    uint32_t count;
+    uint32_t dropped;
+} ssd1306_trace_buffer_t;
+
+void ssd1306_trace_buffer_hook(const char* name, char phase, uint64_t ts_us, void* ctx); // ctx为缓冲区
+// 直接输出钩子：每个事件立即打印一行，printf的耗时会计入被测区间
+void ssd1306_trace_print_hook(const char* name, char phase, uint64_t ts_us, void* ctx);
+// 以记录行输出缓冲区中的事件并清空，返回输出的事件数
+uint32_t ssd1306_trace_dump(ssd1306_trace_buffer_t* buffer);
+
+// 解析一行记录，成功时返回true（不依赖SSD1306_INSTRUMENT，供主机工具使用）
+bool ssd1306_trace_parse_line(const char* line, uint64_t* ts_us, char* phase, char* name, size_t name_cap);
+
+#if SSD1306_INSTRUMENT
+// 作用域追踪：构造时发出BEGIN，析构时发出END
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name_(name) {
+        ssd1306_trace_emit(name_, SSD1306_TRACE_BEGIN, ssd1306_trace_now_us());
+    }
+    ~TraceSpan() {
+        ssd1306_trace_emit(name_, SSD1306_TRACE_END, ssd1306_trace_now_us());
+    }
+
+private:
+    const char* name_;
+};
+
+#define SSD1306_TRACE_CONCAT_(a, b) a##b
+#define SSD1306_TRACE_CONCAT(a, b) SSD1306_TRACE_CONCAT_(a, b)
+#define SSD1306_TRACE_SCOPE(name) TraceSpan SSD1306_TRACE_CONCAT(trace_span_, __LINE__)(name)
+#else
+#define SSD1306_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // SSD1306_TRACE_H
@@ -0,0 +1,51 @@
+#ifndef SSD1306_TRANSFORM_H
+#define SSD1306_TRANSFORM_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 8x8位矩阵转置：dst字节j的第i位 = src字节i的第j位
+//
+// 页格式下一个8x8块由8个相邻列字节组成，转置后即得到旋转90度
+// （或行主序<->页格式互换）所需的8个字节。src/dst的步长以字节为单位。
+// 使用32位掩码交换（4x4、2x2、1x1三级），Cortex-M0+上无需64位运算。
+static inline void ssd1306_transpose8x8(const uint8_t* src, size_t src_stride,
+                                        uint8_t* dst, size_t dst_stride) {
+    uint32_t lo = (uint32_t)src[0]
+                | ((uint32_t)src[src_stride] << 8)
+                | ((uint32_t)src[2 * src_stride] << 16)
+                | ((uint32_t)src[3 * src_stride] << 24);
+    uint32_t hi = (uint32_t)src[4 * src_stride]
+                | ((uint32_t)src[5 * src_stride] << 8)
+                | ((uint32_t)src[6 * src_stride] << 16)
+                | ((uint32_t)src[7 * src_stride] << 24);
+    uint32_t t;
+
+    // 交换4x4子块
+    t = ((lo >> 4) ^ hi) & 0x0F0F0F0Fu;
+    hi ^= t;
+    lo ^= t << 4;
+
+    // 交换2x2子块
+    t = (lo ^ (lo << 14)) & 0x33330000u;
+    lo ^= t ^ (t >> 14);
+    t = (hi ^ (hi << 14)) & 0x33330000u;
+    hi ^= t ^ (t >> 14);
+
+    // 交换1x1
+    t = (lo ^ (lo << 7)) & 0x55005500u;
+    lo ^= t ^ (t >> 7);
+    t = (hi ^ (hi << 7)) & 0x55005500u;
+    hi ^= t ^ (t >> 7);
+
+    dst[0]              = (uint8_t)lo;
+    dst[dst_stride]     = (uint8_t)(lo >> 8);
+    dst[2 * dst_stride] = (uint8_t)(lo >> 16);
+    dst[3 * dst_stride] = (uint8_t)(lo >> 24);
+    dst[4 * dst_stride] = (uint8_t)hi;
+    dst[5 * dst_stride] = (uint8_t)(hi >> 8);
+    dst[6 * dst_stride] = (uint8_t)(hi >> 16);
+    dst[7 * dst_stride] = (uint8_t)(hi >> 24);
+}
+
+#endif // SSD1306_TRANSFORM_H
@@ -0,0 +1,208 @@
+#include "ds3231/ds3231_alarm.h"
+#include "ds3231/ds3231_calendar.h"
+#include <string.h>
+
+static void swap_timer(ds3231_alarm_timer_t *a, ds3231_alarm_timer_t *b) {
+    ds3231_alarm_timer_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void sift_up(ds3231_alarm_timer_t *heap, uint8_t i) {
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (heap[parent].deadline <= heap[i].deadline) {
+            break;
+        }
+        swap_timer(&heap[parent], &heap[i]);
+        i = parent;
+    }
+}
+
+static void sift_down(ds3231_alarm_timer_t *heap, uint8_t count, uint8_t i) {
+    while (true) {
+        uint8_t smallest = i;
+        uint8_t l = 2 * i + 1;
+        uint8_t r = 2 * i + 2;
+        if (l < count && heap[l].deadline < heap[smallest].deadline) smallest = l;
+        if (r < count && heap[r].deadline < heap[smallest].deadline) smallest = r;
+        if (smallest == i) {
+            break;
+        }
+        swap_timer(&heap[smallest], &heap[i]);
+        i = smallest;
+    }
+}
+
+static void remove_at(ds3231_alarm_scheduler_t *sched, uint8_t i) {
+    sched->count--;
+    if (i < sched->count) {
+        sched->heap[i] = sched->heap[sched->count];
+        sift_up(sched->heap, i);
+        sift_down(sched->heap, sched->count, i);
+    }
+}
+
+// 整分钟向下取整
+static int64_t minute_floor(int64_t t) {
+    return t - (((t % 60) + 60) % 60);
+}
+
+// 把截止时间写入闹钟1（秒精度）与闹钟2（分钟精度，向下取整）
+static void arm_alarms(ds3231_alarm_scheduler_t *sched, int64_t now) {
+    int64_t target1 = -1;
+
+    if (sched->count > 0) {
+        target1 = sched->heap[0].deadline;
+        if (target1 - now > DS3231_ALARM_MAX_AHEAD_S) {
+            target1 = now + DS3231_ALARM_MAX_AHEAD_S;
+        }
+    }
+
+    ds3231_time_t t;
+    ds3231_alarm_t alarm;
+    if (target1 >= 0 && target1 != sched->armed1) {
+        ds3231_epoch_to_time(target1, &t);
+        alarm.seconds = t.seconds;
+        alarm.minutes = t.minutes;
+        alarm.hours = t.hours;
+        alarm.day_date = t.date;
+        sched->armed1 = ds3231_set_alarm1(sched->rtc, &alarm, DS3231_ALARM1_MATCH_DATE_HMS) ? target1 : -1;
+    } else if (target1 < 0) {
+        sched->armed1 = -1;
+    }
+
+    int64_t target2 = -1;
+    if (target1 >= 0 && sched->armed1 < 0) {
+        // 闹钟1没有设置成功：闹钟2改为覆盖最近的截止时间，截止时间就在当前这一分钟内时
+        // 只能在下一个整分钟唤醒
+        target2 = minute_floor(target1);
+        if (target2 <= now) {
+            target2 = minute_floor(now) + 60;
+        }
+    } else if (sched->count > 1) {
+        // 次小值必在根的两个子节点之一
+        int64_t second = sched->heap[1].deadline;
+        if (sched->count > 2 && sched->heap[2].deadline < second) {
+            second = sched->heap[2].deadline;
+        }
+        int64_t floor = minute_floor(second);
+        if (floor > now && floor - now <= DS3231_ALARM_MAX_AHEAD_S && floor != target1) {
+            target2 = floor;
+        }
+    }
+
+    if (target2 >= 0 && target2 != sched->armed2) {
+        ds3231_epoch_to_time(target2, &t);
+        alarm.seconds = 0;
+        alarm.minutes = t.minutes;
+        alarm.hours = t.hours;
+        alarm.day_date = t.date;
+        sched->armed2 = ds3231_set_alarm2(sched->rtc, &alarm, DS3231_ALARM2_MATCH_DATE_HM) ? target2 : -1;
+    } else if (target2 < 0) {
+        sched->armed2 = -1;
+    }
+
+    // 只在中断使能组合变化时写控制寄存器
+    uint8_t irq = (sched->armed1 >= 0 ? 1 : 0) | (sched->armed2 >= 0 ? 2 : 0);
+    if (irq != sched->irq_enabled &&
+        ds3231_enable_alarm_interrupts(sched->rtc, irq & 1, irq & 2)) {
+        sched->irq_enabled = irq;
+    }
+}
+
+// 初始化调度器
+bool ds3231_alarm_scheduler_init(ds3231_alarm_scheduler_t *sched, ds3231_t *rtc) {
+    if (!sched || !rtc) {
+        return false;
+    }
+
+    memset(sched, 0, sizeof(*sched));
+    sched->rtc = rtc;
+    sched->next_id = 1;
+    sched->armed1 = -1;
+    sched->armed2 = -1;
+    sched->irq_enabled = 0xFF; // 第一次service时写入控制寄存器
+    return true;
+}
+
+// 添加定时器
+uint32_t ds3231_alarm_scheduler_add(ds3231_alarm_scheduler_t *sched, int64_t deadline, uint32_t period_s,
+                                    ds3231_alarm_callback_t callback, void *ctx) {
+    if (!sched || !callback || deadline < 0 || sched->count >= DS3231_ALARM_MAX_TIMERS) {
+        return 0;
+    }
+
+    ds3231_alarm_timer_t *timer = &sched->heap[sched->count];
+    timer->deadline = deadline;
+    timer->period_s = period_s;
+    timer->id = sched->next_id++;
+    if (sched->next_id == 0) {
+        sched->next_id = 1;
+    }
+    timer->callback = callback;
+    timer->ctx = ctx;
+
+    uint32_t id = timer->id;
+    sift_up(sched->heap, sched->count++);
+    return id;
+}
+
+// 取消定时器
+bool ds3231_alarm_scheduler_cancel(ds3231_alarm_scheduler_t *sched, uint32_t id) {
+    if (!sched) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < sched->count; i++) {
+        if (sched->heap[i].id == id) {
+            remove_at(sched, i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 最近的截止时间
+bool ds3231_alarm_scheduler_next(const ds3231_alarm_scheduler_t *sched, int64_t *deadline) {
+    if (!sched || !deadline || sched->count == 0) {
+        return false;
+    }
+    *deadline = sched->heap[0].deadline;
+    return true;
+}
+
+// 执行到期定时器并重新设置闹钟
+uint32_t ds3231_alarm_scheduler_service(ds3231_alarm_scheduler_t *sched, int64_t now) {
+    if (!sched) {
+        return 0;
+    }
+
+    // 先清标志，让INT在本次处理期间再次触发时能产生新的下降沿
+    uint8_t flags;
+    if (ds3231_read_alarm_flags(sched->rtc, &flags) && flags) {
+        ds3231_clear_alarm_flags(sched->rtc, flags);
+    }
+    sched->armed1 = sched->armed1 > now ? sched->armed1 : -1;
+    sched->armed2 = sched->armed2 > now ? sched->armed2 : -1;
+
+    uint32_t fired = 0;
+    while (sched->count > 0 && sched->heap[0].deadline <= now) {
+        // 回调前先把堆整理好，回调中可以安全地添加或取消定时器
+        ds3231_alarm_timer_t timer = sched->heap[0];
+        if (timer.period_s) {
+            // 错过多个周期时只执行一次
+            int64_t missed = (now - timer.deadline) / timer.period_s + 1;
+            sched->heap[0].deadline += missed * timer.period_s;
+            sift_down(sched->heap, sched->count, 0);
+        } else {
+            remove_at(sched, 0);
+        }
+        timer.callback(timer.id, timer.deadline, timer.ctx);
+        fired++;
+    }
+
+    sched->fired += fired;
+    arm_alarms(sched, now);
+    return fired;
+}
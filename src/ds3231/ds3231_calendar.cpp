@@ -0,0 +1,193 @@
+#include "ds3231/ds3231_calendar.h"
+
+// 公历日期与1970-01-01之间的天数（days-from-civil算法）
+int32_t ds3231_days_from_civil(int32_t year, uint32_t month, uint32_t date) {
+    year -= month <= 2;
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t yoe = (uint32_t)(year - era * 400);
+    const uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + date - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+// 天数转公历日期
+void ds3231_civil_from_days(int32_t days, int32_t *year, uint32_t *month, uint32_t *date) {
+    days += 719468;
+    const int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const uint32_t doe = (uint32_t)(days - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    *date = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = (int32_t)yoe + era * 400 + (*month <= 2);
+}
+
+// 某月天数
+uint8_t ds3231_days_in_month(int32_t year, uint32_t month) {
+    if (month == 2) {
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return leap ? 29 : 28;
+    }
+    // 3月起按5个月为周期31/30交替：31,30,31,30,31 | 31,30,31,30,31 | 31
+    uint32_t m = month >= 3 ? month - 3 : month + 9;
+    return 30 + ((m % 5) % 2 == 0);
+}
+
+// 星期（1970-01-01为星期四）
+uint8_t ds3231_weekday_from_days(int32_t days) {
+    int32_t w = (days + 4) % 7;
+    return (uint8_t)(w < 0 ? w + 7 : w);
+}
+
+uint8_t ds3231_weekday(const ds3231_time_t *time) {
+    return ds3231_weekday_from_days(ds3231_days_from_civil(2000 + time->year, time->month, time->date));
+}
+
+// 时间转Unix秒
+int64_t ds3231_time_to_epoch(const ds3231_time_t *time) {
+    return (int64_t)ds3231_days_from_civil(2000 + time->year, time->month, time->date) * 86400
+         + time->hours * 3600 + time->minutes * 60 + time->seconds;
+}
+
+// Unix秒转时间
+void ds3231_epoch_to_time(int64_t epoch, ds3231_time_t *time) {
+    int64_t days = epoch / 86400;
+    int64_t sod = epoch % 86400;
+    if (sod < 0) {
+        sod += 86400;
+        days--;
+    }
+
+    int32_t y;
+    uint32_t m, d;
+    ds3231_civil_from_days((int32_t)days, &y, &m, &d);
+
+    time->year = (uint8_t)(y - 2000);
+    time->month = (uint8_t)m;
+    time->date = (uint8_t)d;
+    time->hours = (uint8_t)(sod / 3600);
+    time->minutes = (uint8_t)((sod / 60) % 60);
+    time->seconds = (uint8_t)(sod % 60);
+    time->day = ds3231_weekday_from_days((int32_t)days);
+}
+
+// 某年切换时刻的UTC时间：该月第week个weekday（5为最后一个）的当地minute分，
+// offset_min为规则所用时间相对UTC的偏移
+static int64_t dst_transition_utc(int32_t year, const ds3231_dst_rule_t *rule, int32_t offset_min) {
+    int32_t first = ds3231_days_from_civil(year, rule->month, 1);
+    int32_t day = (rule->weekday - ds3231_weekday_from_days(first) + 7) % 7 + (rule->week - 1) * 7;
+    if (day >= ds3231_days_in_month(year, rule->month)) {
+        day -= 7;
+    }
+    return ((int64_t)(first + day) * 1440 + rule->minute - offset_min) * 60;
+}
+
+// UTC到当地时间的总偏移
+int32_t ds3231_tz_offset_min(const ds3231_tz_t *tz, int64_t utc_epoch, bool *is_dst) {
+    bool dst = false;
+    if (tz->dst_start.month && tz->dst_delta_min) {
+        int64_t days = utc_epoch / 86400 - (utc_epoch % 86400 < 0);
+        int32_t year;
+        uint32_t month, date;
+        ds3231_civil_from_days((int32_t)days, &year, &month, &date);
+
+        int64_t start = dst_transition_utc(year, &tz->dst_start, tz->std_offset_min);
+        int64_t end = dst_transition_utc(year, &tz->dst_end, tz->std_offset_min + tz->dst_delta_min);
+        // 南半球夏令时跨年：start晚于end
+        dst = start < end ? (utc_epoch >= start && utc_epoch < end)
+                          : (utc_epoch >= start || utc_epoch < end);
+    }
+    if (is_dst) {
+        *is_dst = dst;
+    }
+    return tz->std_offset_min + (dst ? tz->dst_delta_min : 0);
+}
+
+int64_t ds3231_utc_to_local(const ds3231_tz_t *tz, int64_t utc_epoch, bool *is_dst) {
+    return utc_epoch + (int64_t)ds3231_tz_offset_min(tz, utc_epoch, is_dst) * 60;
+}
+
+// 带边界检查的输出
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} format_out_t;
+
+static void put_char(format_out_t *out, char c) {
+    if (out->len + 1 < out->size) {
+        out->buf[out->len++] = c;
+    }
+}
+
+static void put_digits(format_out_t *out, uint32_t value, uint8_t width) {
+    char digits[10];
+    uint8_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value && n < sizeof(digits));
+    while (n < width) {
+        digits[n++] = '0';
+    }
+    while (n) {
+        put_char(out, digits[--n]);
+    }
+}
+
+// 格式化
+size_t ds3231_format(char *buf, size_t size, const char *pattern, const ds3231_time_t *time) {
+    if (!buf || size == 0) {
+        return 0;
+    }
+
+    static const char day_names[] = "SunMonTueWedThuFriSat";
+    format_out_t out = {buf, size, 0};
+    for (const char *p = pattern; p && *p; p++) {
+        if (*p != '%' || !p[1]) {
+            put_char(&out, *p);
+            continue;
+        }
+        switch (*++p) {
+            case 'Y': put_digits(&out, 2000 + time->year, 4); break;
+            case 'y': put_digits(&out, time->year, 2); break;
+            case 'm': put_digits(&out, time->month, 2); break;
+            case 'd': put_digits(&out, time->date, 2); break;
+            case 'H': put_digits(&out, time->hours, 2); break;
+            case 'M': put_digits(&out, time->minutes, 2); break;
+            case 'S': put_digits(&out, time->seconds, 2); break;
+            case 'a': {
+                const char *name = &day_names[(time->day % 7) * 3];
+                put_char(&out, name[0]);
+                put_char(&out, name[1]);
+                put_char(&out, name[2]);
+                break;
+            }
+            default: put_char(&out, *p); break;
+        }
+    }
+    buf[out.len] = '\0';
+    return out.len;
+}
+
+// ISO-8601
+size_t ds3231_format_iso8601(char *buf, size_t size, const ds3231_time_t *time, int16_t utc_offset_min) {
+    size_t len = ds3231_format(buf, size, "%Y-%m-%dT%H:%M:%S", time);
+    if (!buf || size == 0) {
+        return len;
+    }
+
+    format_out_t out = {buf, size, len};
+    if (utc_offset_min == 0) {
+        put_char(&out, 'Z');
+    } else {
+        uint32_t abs_min = utc_offset_min < 0 ? -utc_offset_min : utc_offset_min;
+        put_char(&out, utc_offset_min < 0 ? '-' : '+');
+        put_digits(&out, abs_min / 60, 2);
+        put_char(&out, ':');
+        put_digits(&out, abs_min % 60, 2);
+    }
+    buf[out.len] = '\0';
+    return out.len;
+}
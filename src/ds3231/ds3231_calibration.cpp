@@ -0,0 +1,105 @@
+#include "ds3231/ds3231_calibration.h"
+#include <string.h>
+
+// 温度所在的分段，超出范围时返回-1
+static int8_t temp_bin(float temperature) {
+    float t = (temperature - DS3231_CALIB_TEMP_MIN) / DS3231_CALIB_BIN_C;
+    if (t < 0.0f || t >= DS3231_CALIB_BINS) {
+        return -1;
+    }
+    return (int8_t)t;
+}
+
+static void start_window(ds3231_calib_t *calib, int64_t ref_us, int64_t rtc_us, int8_t bin) {
+    calib->ref_start_us = ref_us;
+    calib->rtc_start_us = rtc_us;
+    calib->window_bin = bin;
+}
+
+// 初始化校准服务
+bool ds3231_calib_init(ds3231_calib_t *calib, ds3231_t *rtc) {
+    if (!calib || !rtc) {
+        return false;
+    }
+
+    memset(calib, 0, sizeof(*calib));
+    calib->rtc = rtc;
+    calib->window_bin = -1;
+    calib->applied_bin = -1;
+    return true;
+}
+
+// 提交参考样本
+bool ds3231_calib_add_reference(ds3231_calib_t *calib, int64_t ref_us, int64_t rtc_us, float temperature) {
+    if (!calib) {
+        return false;
+    }
+
+    int8_t bin = temp_bin(temperature);
+    if (bin < 0) {
+        calib->window_bin = -1;
+        return false;
+    }
+
+    // 温度离开窗口所在的段：频偏不再可比，重新开始
+    if (calib->window_bin != bin) {
+        start_window(calib, ref_us, rtc_us, bin);
+        return false;
+    }
+
+    int64_t ref_span = ref_us - calib->ref_start_us;
+    if (ref_span < (int64_t)DS3231_CALIB_MIN_SPAN_S * 1000000) {
+        return false;
+    }
+
+    int64_t ppb = (rtc_us - calib->rtc_start_us - ref_span) * 1000000000 / ref_span;
+    if (ppb > DS3231_CALIB_MAX_PPB || ppb < -DS3231_CALIB_MAX_PPB) {
+        start_window(calib, ref_us, rtc_us, bin);
+        return false;
+    }
+    calib->last_ppb = (int32_t)ppb;
+
+    // RTC偏快则增大偏移（增加负载电容使振荡器变慢），四舍五入到LSB
+    int8_t current;
+    if (!ds3231_get_aging_offset(calib->rtc, &current)) {
+        return false;
+    }
+    int32_t step = (int32_t)((ppb >= 0 ? ppb + DS3231_CALIB_PPB_PER_LSB / 2 : ppb - DS3231_CALIB_PPB_PER_LSB / 2)
+                             / DS3231_CALIB_PPB_PER_LSB);
+    int32_t offset = current + step;
+    if (offset > 127) offset = 127;
+    if (offset < -128) offset = -128;
+
+    calib->offsets[bin] = (int8_t)offset;
+    calib->learned[bin] = true;
+    start_window(calib, ref_us, rtc_us, bin);
+
+    if (offset != current && !ds3231_set_aging_offset(calib->rtc, (int8_t)offset)) {
+        return false;
+    }
+    calib->applied_bin = bin;
+    calib->updates++;
+    return true;
+}
+
+// 按温度应用已学习的偏移
+bool ds3231_calib_service(ds3231_calib_t *calib, float temperature) {
+    if (!calib) {
+        return false;
+    }
+
+    int8_t bin = temp_bin(temperature);
+    if (bin < 0 || bin == calib->applied_bin || !calib->learned[bin]) {
+        return false;
+    }
+
+    if (!ds3231_set_aging_offset(calib->rtc, calib->offsets[bin])) {
+        return false;
+    }
+    calib->applied_bin = bin;
+    calib->updates++;
+
+    // 偏移变化后原窗口的测量不再有效
+    calib->window_bin = -1;
+    return true;
+}
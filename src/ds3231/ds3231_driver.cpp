@@ -1,6 +1,14 @@
 #include "ds3231/ds3231.h"
-#include <stdio.h>
+#include "ds3231/ds3231_calendar.h"
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "hardware/structs/iobank0.h"
 #include <string.h>
+#include <stddef.h>
 
 // 初始化DS3231
 bool ds3231_init(ds3231_t *ds3231, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin) {
@@ -12,9 +20,15 @@ bool ds3231_init(ds3231_t *ds3231, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl
     ds3231->sda_pin = sda_pin;
     ds3231->scl_pin = scl_pin;
     ds3231->addr = DS3231_I2C_ADDR;
+    ds3231->cache_valid = false;
+    ds3231->transfers = 0;
+    ds3231->async_busy = false;
+    memset(&ds3231->bus, 0, sizeof(ds3231->bus));
+    ds3231->shared_bus = NULL;
+    ds3231->temp_valid = false;
     
     // 初始化I2C (DS3231支持400kHz高速I2C，但使用100kHz更稳定)
-    i2c_init(i2c, 100000); // 100kHz
+    i2c_init(i2c, DS3231_I2C_BAUDRATE);
     
     // 设置GPIO引脚
     gpio_set_function(sda_pin, GPIO_FUNC_I2C);
@@ -22,89 +36,409 @@ bool ds3231_init(ds3231_t *ds3231, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl
     gpio_pull_up(sda_pin);
     gpio_pull_up(scl_pin);
     
-    // 启用振荡器
+    // 载入寄存器缓存，然后启用振荡器
+    if (!ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
     return ds3231_enable_oscillator(ds3231, true);
 }
 
-// 写入寄存器
-bool ds3231_write_register(ds3231_t *ds3231, uint8_t reg, uint8_t value) {
-    if (!ds3231) {
+// 挂到共享总线上
+bool ds3231_init_shared(ds3231_t *ds3231, i2c_bus_t *bus) {
+    if (!ds3231 || !bus) {
         return false;
     }
     
-    uint8_t data[2] = {reg, value};
-    int result = i2c_write_blocking(ds3231->i2c, ds3231->addr, data, 2, false);
-    return result == 2;
+    ds3231->i2c = bus->i2c;
+    ds3231->sda_pin = bus->sda_pin;
+    ds3231->scl_pin = bus->scl_pin;
+    ds3231->addr = DS3231_I2C_ADDR;
+    ds3231->cache_valid = false;
+    ds3231->transfers = 0;
+    ds3231->async_busy = false;
+    memset(&ds3231->bus, 0, sizeof(ds3231->bus));
+    ds3231->shared_bus = bus;
+    ds3231->bus_device.addr = DS3231_I2C_ADDR;
+    ds3231->bus_device.baudrate = DS3231_I2C_BAUDRATE;
+    ds3231->temp_valid = false;
+    
+    if (!ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
+    return ds3231_enable_oscillator(ds3231, true);
 }
 
-// 读取寄存器
-bool ds3231_read_register(ds3231_t *ds3231, uint8_t reg, uint8_t *value) {
-    if (!ds3231 || !value) {
+// 更新缓存中主机拥有的寄存器
+static void cache_store(ds3231_t *ds3231, uint8_t start, const uint8_t *buf, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t reg = start + i;
+        if (reg == DS3231_CONTROL_REG) {
+            ds3231->control_cache = buf[i] & ~(1 << DS3231_CONV_BIT); // CONV转换完成后自动清零
+        } else if (reg == DS3231_STATUS_REG) {
+            ds3231->status_cache = buf[i] & (1 << DS3231_EN32KHZ_BIT);
+        } else if (reg == DS3231_AGING_REG) {
+            ds3231->aging_cache = buf[i];
+        }
+    }
+}
+
+// 记录一次成功事务的延迟
+static void record_latency(ds3231_bus_stats_t *stats, uint32_t us) {
+    uint8_t bucket = us ? 31 - __builtin_clz(us) : 0;
+    if (bucket >= DS3231_LATENCY_BUCKETS) {
+        bucket = DS3231_LATENCY_BUCKETS - 1;
+    }
+    stats->histogram[bucket]++;
+    stats->count++;
+    if (us > stats->max_us) {
+        stats->max_us = us;
+    }
+}
+
+// 统计事务结果，超时后恢复总线
+static bool finish_transfer(ds3231_t *ds3231, bool ok, int result, uint64_t start_us) {
+    if (ok) {
+        record_latency(&ds3231->bus, (uint32_t)(time_us_64() - start_us));
+        return true;
+    }
+    
+    if (result == PICO_ERROR_TIMEOUT) {
+        ds3231->bus.timeouts++;
+        ds3231_bus_recover(ds3231);
+    } else {
+        ds3231->bus.errors++;
+    }
+    return false;
+}
+
+// 连续读取寄存器
+bool ds3231_read_registers(ds3231_t *ds3231, uint8_t start, uint8_t *buf, uint8_t count) {
+    if (!ds3231 || !buf || count == 0 || start >= DS3231_REG_COUNT || count > DS3231_REG_COUNT - start) {
+        return false;
+    }
+    if (ds3231->async_busy) {
         return false;
     }
     
-    // 写入寄存器地址
-    int result = i2c_write_blocking(ds3231->i2c, ds3231->addr, &reg, 1, true);
+    ds3231->transfers++;
+    uint64_t start_us = time_us_64();
+    
+    // 共享总线：延迟包含排队时间，超时由仲裁器恢复
+    if (ds3231->shared_bus) {
+        bool ok = i2c_bus_transfer(ds3231->shared_bus, &ds3231->bus_device, &start, 1, buf, count,
+                                   I2C_BUS_PRIORITY_HIGH);
+        return finish_transfer(ds3231, ok, 0, start_us);
+    }
+    
+    absolute_time_t deadline = make_timeout_time_us(DS3231_I2C_TIMEOUT_US);
+    
+    // 写入起始地址（重复起始），随后连续读取；两步共用一个期限
+    int result = i2c_write_blocking_until(ds3231->i2c, ds3231->addr, &start, 1, true, deadline);
     if (result != 1) {
+        return finish_transfer(ds3231, false, result, start_us);
+    }
+    
+    result = i2c_read_blocking_until(ds3231->i2c, ds3231->addr, buf, count, false, deadline);
+    return finish_transfer(ds3231, result == count, result, start_us);
+}
+
+// 连续写入寄存器
+bool ds3231_write_registers(ds3231_t *ds3231, uint8_t start, const uint8_t *buf, uint8_t count) {
+    if (!ds3231 || !buf || count == 0 || start >= DS3231_REG_COUNT || count > DS3231_REG_COUNT - start) {
+        return false;
+    }
+    if (ds3231->async_busy) {
+        return false;
+    }
+    
+    ds3231->transfers++;
+    uint64_t start_us = time_us_64();
+    
+    uint8_t data[DS3231_REG_COUNT + 1];
+    data[0] = start;
+    memcpy(&data[1], buf, count);
+    bool ok;
+    if (ds3231->shared_bus) {
+        ok = finish_transfer(ds3231, i2c_bus_transfer(ds3231->shared_bus, &ds3231->bus_device, data, count + 1,
+                                                      NULL, 0, I2C_BUS_PRIORITY_HIGH), 0, start_us);
+    } else {
+        int result = i2c_write_blocking_until(ds3231->i2c, ds3231->addr, data, count + 1, false,
+                                              make_timeout_time_us(DS3231_I2C_TIMEOUT_US));
+        ok = finish_transfer(ds3231, result == count + 1, result, start_us);
+    }
+    if (!ok) {
         return false;
     }
     
-    // 读取数据
-    result = i2c_read_blocking(ds3231->i2c, ds3231->addr, value, 1, false);
-    return result == 1;
+    cache_store(ds3231, start, buf, count);
+    return true;
 }
 
-// 读取时间
-bool ds3231_read_time(ds3231_t *ds3231, ds3231_time_t *time) {
-    if (!ds3231 || !time) {
+// 第i条命令：先发地址和写入数据，读取部分以重复起始开头，最后一条带STOP
+static uint32_t async_command(const ds3231_async_t *op, uint8_t i) {
+    uint32_t cmd;
+    if (i < op->wlen) {
+        cmd = op->wbuf[i];
+    } else {
+        cmd = I2C_IC_DATA_CMD_CMD_BITS;
+        if (i == op->wlen) {
+            cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+    }
+    if (i == op->wlen + op->rlen - 1) {
+        cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    return cmd;
+}
+
+static ds3231_async_state_t async_finish(ds3231_async_t *op, ds3231_async_state_t state) {
+    ds3231_t *ds3231 = op->ds3231;
+    
+    if (state == DS3231_ASYNC_DONE) {
+        record_latency(&ds3231->bus, (uint32_t)(time_us_64() - op->start_us));
+        if (op->rlen == 0) {
+            cache_store(ds3231, op->wbuf[0], &op->wbuf[1], op->wlen - 1);
+        }
+    } else if (state == DS3231_ASYNC_TIMEOUT) {
+        ds3231->bus.timeouts++;
+        ds3231_bus_recover(ds3231);
+    } else {
+        ds3231->bus.errors++;
+    }
+    
+    ds3231->async_busy = false;
+    op->state = state;
+    if (op->callback) {
+        op->callback(state, op->ctx);
+    }
+    return state;
+}
+
+static bool async_start(ds3231_async_t *op, ds3231_t *ds3231, ds3231_async_callback_t callback, void *ctx) {
+    if (ds3231->async_busy || ds3231->shared_bus) {
         return false;
     }
     
-    uint8_t data[7];
+    op->ds3231 = ds3231;
+    op->issued = 0;
+    op->received = 0;
+    op->callback = callback;
+    op->ctx = ctx;
+    op->start_us = time_us_64();
+    op->deadline_us = op->start_us + DS3231_I2C_TIMEOUT_US;
+    op->state = DS3231_ASYNC_BUSY;
+    ds3231->async_busy = true;
+    ds3231->transfers++;
     
-    // 写入起始寄存器地址
-    uint8_t reg = DS3231_SECONDS_REG;
-    int result = i2c_write_blocking(ds3231->i2c, ds3231->addr, &reg, 1, true);
-    if (result != 1) {
+    // 设置目标地址并清除上一次事务遗留的STOP/中止标志
+    i2c_hw_t *hw = i2c_get_hw(ds3231->i2c);
+    hw->enable = 0;
+    hw->tar = ds3231->addr;
+    hw->enable = 1;
+    (void)hw->clr_intr;
+    
+    ds3231_async_poll(op);
+    return true;
+}
+
+// 启动异步读取
+bool ds3231_read_registers_async(ds3231_async_t *op, ds3231_t *ds3231, uint8_t start, uint8_t *buf, uint8_t count,
+                                 ds3231_async_callback_t callback, void *ctx) {
+    if (!op || !ds3231 || !buf || count == 0 || start >= DS3231_REG_COUNT || count > DS3231_REG_COUNT - start) {
+        return false;
+    }
+    
+    op->wbuf[0] = start;
+    op->wlen = 1;
+    op->rbuf = buf;
+    op->rlen = count;
+    return async_start(op, ds3231, callback, ctx);
+}
+
+// 启动异步写入
+bool ds3231_write_registers_async(ds3231_async_t *op, ds3231_t *ds3231, uint8_t start, const uint8_t *buf,
+                                  uint8_t count, ds3231_async_callback_t callback, void *ctx) {
+    if (!op || !ds3231 || !buf || count == 0 || start >= DS3231_REG_COUNT || count > DS3231_REG_COUNT - start) {
+        return false;
+    }
+    
+    op->wbuf[0] = start;
+    memcpy(&op->wbuf[1], buf, count);
+    op->wlen = count + 1;
+    op->rbuf = NULL;
+    op->rlen = 0;
+    return async_start(op, ds3231, callback, ctx);
+}
+
+// 推进异步事务：填充TX FIFO、取出RX FIFO，不等待
+ds3231_async_state_t ds3231_async_poll(ds3231_async_t *op) {
+    if (!op) {
+        return DS3231_ASYNC_ERROR;
+    }
+    if (op->state != DS3231_ASYNC_BUSY) {
+        return op->state;
+    }
+    
+    i2c_inst_t *i2c = op->ds3231->i2c;
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        (void)hw->clr_tx_abrt;
+        return async_finish(op, DS3231_ASYNC_ERROR);
+    }
+    
+    // 未取走的读命令不超过RX FIFO深度
+    const uint8_t total = op->wlen + op->rlen;
+    while (op->issued < total && i2c_get_write_available(i2c) > 0) {
+        if (op->issued >= op->wlen && op->issued - op->wlen - op->received >= 16) {
+            break;
+        }
+        hw->data_cmd = async_command(op, op->issued);
+        op->issued++;
+    }
+    while (op->received < op->rlen && i2c_get_read_available(i2c) > 0) {
+        op->rbuf[op->received++] = (uint8_t)hw->data_cmd;
+    }
+    
+    if (op->issued == total && op->received == op->rlen &&
+        (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) {
+        (void)hw->clr_stop_det;
+        return async_finish(op, DS3231_ASYNC_DONE);
+    }
+    
+    if (time_us_64() >= op->deadline_us) {
+        return async_finish(op, DS3231_ASYNC_TIMEOUT);
+    }
+    return DS3231_ASYNC_BUSY;
+}
+
+// 总线恢复
+bool ds3231_bus_recover(ds3231_t *ds3231) {
+    if (!ds3231) {
         return false;
     }
     
-    // 读取7个字节的时间数据
-    result = i2c_read_blocking(ds3231->i2c, ds3231->addr, data, 7, false);
-    if (result != 7) {
+    ds3231->bus.recoveries++;
+    if (ds3231->shared_bus) {
+        return i2c_bus_recover(ds3231->shared_bus);
+    }
+    return i2c_bus_recover_pins(ds3231->i2c, ds3231->sda_pin, ds3231->scl_pin, DS3231_I2C_BAUDRATE);
+}
+
+// 事务延迟百分位
+uint32_t ds3231_bus_latency_percentile(const ds3231_bus_stats_t *stats, uint8_t percent) {
+    if (!stats || stats->count == 0) {
+        return 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    
+    uint32_t target = (uint32_t)(((uint64_t)stats->count * percent + 99) / 100);
+    if (target == 0) {
+        target = 1;
+    }
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < DS3231_LATENCY_BUCKETS; i++) {
+        seen += stats->histogram[i];
+        if (seen >= target) {
+            uint32_t upper = (i == DS3231_LATENCY_BUCKETS - 1) ? stats->max_us : (2u << i) - 1;
+            return upper < stats->max_us ? upper : stats->max_us;
+        }
+    }
+    return stats->max_us;
+}
+
+// 清零总线统计
+void ds3231_bus_stats_reset(ds3231_t *ds3231) {
+    if (!ds3231) {
+        return;
+    }
+    memset(&ds3231->bus, 0, sizeof(ds3231->bus));
+}
+
+// 读取整个寄存器文件
+bool ds3231_read_snapshot(ds3231_t *ds3231, uint8_t regs[DS3231_REG_COUNT]) {
+    if (!ds3231_read_registers(ds3231, DS3231_SECONDS_REG, regs, DS3231_REG_COUNT)) {
         return false;
     }
     
-    // 解析时间数据
-    time->seconds = bcd_to_bin(data[0] & 0x7F);
-    time->minutes = bcd_to_bin(data[1] & 0x7F);
-    time->hours = bcd_to_bin(data[2] & 0x3F);
-    time->day = data[3] & 0x07;  // 星期寄存器直接存储1-7，不需要BCD转换
-    time->date = bcd_to_bin(data[4] & 0x3F);
-    time->month = bcd_to_bin(data[5] & 0x1F);
-    time->year = bcd_to_bin(data[6]);
+    cache_store(ds3231, DS3231_CONTROL_REG, &regs[DS3231_CONTROL_REG], 3);
+    ds3231->cache_valid = true;
+    return true;
+}
+
+// 重新读取控制、状态、老化寄存器
+bool ds3231_refresh_cache(ds3231_t *ds3231) {
+    uint8_t regs[3];
+    if (!ds3231_read_registers(ds3231, DS3231_CONTROL_REG, regs, 3)) {
+        return false;
+    }
     
+    cache_store(ds3231, DS3231_CONTROL_REG, regs, 3);
+    ds3231->cache_valid = true;
     return true;
 }
 
+// 按掩码改写控制寄存器：使用缓存，值不变时不产生传输
+static bool update_control(ds3231_t *ds3231, uint8_t clear_bits, uint8_t set_bits) {
+    if (!ds3231->cache_valid && !ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
+    
+    uint8_t control_reg = (ds3231->control_cache & ~clear_bits) | set_bits;
+    if (control_reg == ds3231->control_cache && !(set_bits & (1 << DS3231_CONV_BIT))) {
+        return true;
+    }
+    return ds3231_write_registers(ds3231, DS3231_CONTROL_REG, &control_reg, 1);
+}
+
+// 写入寄存器
+bool ds3231_write_register(ds3231_t *ds3231, uint8_t reg, uint8_t value) {
+    if (!ds3231) {
+        return false;
+    }
+    
+    return ds3231_write_registers(ds3231, reg, &value, 1);
+}
+
+// 读取寄存器
+bool ds3231_read_register(ds3231_t *ds3231, uint8_t reg, uint8_t *value) {
+    if (!ds3231 || !value) {
+        return false;
+    }
+    
+    return ds3231_read_registers(ds3231, reg, value, 1);
+}
+
+// 读取时间
+bool ds3231_read_time(ds3231_t *ds3231, ds3231_time_t *time) {
+    if (!ds3231 || !time) {
+        return false;
+    }
+    
+    // 一次读取7个字节的时间数据
+    uint8_t data[7];
+    if (!ds3231_read_registers(ds3231, DS3231_SECONDS_REG, data, 7)) {
+        return false;
+    }
+    
+    // 解析并校验时间数据（总线噪声或振荡器停振后的寄存器内容可能无效）
+    return ds3231_decode_time(data, time);
+}
+
 // 写入时间
 bool ds3231_write_time(ds3231_t *ds3231, const ds3231_time_t *time) {
     if (!ds3231 || !time) {
         return false;
     }
     
-    uint8_t data[8];
-    data[0] = DS3231_SECONDS_REG;
-    data[1] = bin_to_bcd(time->seconds);
-    data[2] = bin_to_bcd(time->minutes);
-    data[3] = bin_to_bcd(time->hours);
-    data[4] = time->day & 0x07;  // 星期寄存器直接存储1-7，确保范围正确
-    data[5] = bin_to_bcd(time->date);
-    data[6] = bin_to_bcd(time->month);
-    data[7] = bin_to_bcd(time->year);
+    uint8_t data[7];
+    if (!ds3231_encode_time(time, data)) {
+        return false;
+    }
     
-    int result = i2c_write_blocking(ds3231->i2c, ds3231->addr, data, 8, false);
-    return result == 8;
+    return ds3231_write_registers(ds3231, DS3231_SECONDS_REG, data, 7);
 }
 
 // 读取温度
@@ -113,42 +447,124 @@ bool ds3231_read_temperature(ds3231_t *ds3231, float *temperature) {
         return false;
     }
     
-    uint8_t msb, lsb;
-    
-    if (!ds3231_read_register(ds3231, DS3231_TEMP_MSB, &msb)) {
+    // MSB和LSB在同一次事务中读取，避免两次读取之间温度转换完成导致数据撕裂
+    uint8_t data[2];
+    if (!ds3231_read_registers(ds3231, DS3231_TEMP_MSB, data, 2)) {
         return false;
     }
-    
-    if (!ds3231_read_register(ds3231, DS3231_TEMP_LSB, &lsb)) {
+    return ds3231_store_temperature(ds3231, data, temperature);
+}
+
+// 温度寄存器换算并写入缓存
+bool ds3231_store_temperature(ds3231_t *ds3231, const uint8_t raw[2], float *temperature) {
+    if (!ds3231 || !raw || !temperature) {
         return false;
     }
     
     // 温度计算：MSB是整数部分，LSB的高2位是小数部分
-    int16_t temp_raw = (int16_t)((msb << 8) | lsb);
+    int16_t temp_raw = (int16_t)((raw[0] << 8) | raw[1]);
     temp_raw >>= 6; // 右移6位，因为LSB的低6位未使用
     
     *temperature = temp_raw * 0.25f;
+    
+    ds3231->temp_cache = *temperature;
+    ds3231->temp_expire_us = time_us_64() + DS3231_TEMP_CONV_PERIOD_US;
+    ds3231->temp_valid = true;
     return true;
 }
 
-// 启用/禁用振荡器
-bool ds3231_enable_oscillator(ds3231_t *ds3231, bool enable) {
+// 读取温度缓存，不访问I2C
+bool ds3231_peek_temperature(const ds3231_t *ds3231, float *temperature, bool *expired) {
+    if (!ds3231 || !temperature || !ds3231->temp_valid) {
+        return false;
+    }
+    
+    *temperature = ds3231->temp_cache;
+    if (expired) {
+        *expired = time_us_64() >= ds3231->temp_expire_us;
+    }
+    return true;
+}
+
+// 带缓存的温度
+bool ds3231_get_temperature(ds3231_t *ds3231, float *temperature) {
+    bool expired;
+    if (ds3231_peek_temperature(ds3231, temperature, &expired) && !expired) {
+        return true;
+    }
+    return ds3231_read_temperature(ds3231, temperature);
+}
+
+// 是否正在转换
+bool ds3231_is_converting(ds3231_t *ds3231, bool *busy) {
+    if (!ds3231 || !busy) {
+        return false;
+    }
+    
+    uint8_t status_reg;
+    if (!ds3231_read_register(ds3231, DS3231_STATUS_REG, &status_reg)) {
+        return false;
+    }
+    
+    *busy = (status_reg & (1 << DS3231_BSY_BIT)) != 0;
+    return true;
+}
+
+// 强制温度转换
+bool ds3231_force_conversion(ds3231_t *ds3231) {
+    bool busy;
+    if (!ds3231_is_converting(ds3231, &busy) || busy) {
+        return false;
+    }
+    
+    if (!update_control(ds3231, 0, 1 << DS3231_CONV_BIT)) {
+        return false;
+    }
+    
+    // 转换完成后缓存失效
+    ds3231->temp_expire_us = time_us_64() + DS3231_TEMP_CONV_TIME_US;
+    return true;
+}
+
+// 设置老化偏移
+bool ds3231_set_aging_offset(ds3231_t *ds3231, int8_t offset) {
     if (!ds3231) {
         return false;
     }
     
-    uint8_t control_reg;
-    if (!ds3231_read_register(ds3231, DS3231_CONTROL_REG, &control_reg)) {
+    uint8_t value = (uint8_t)offset;
+    if (!ds3231_write_registers(ds3231, DS3231_AGING_REG, &value, 1)) {
         return false;
     }
     
-    if (enable) {
-        control_reg &= ~(1 << DS3231_EOSC_BIT); // 清除EOSC位以启用振荡器
-    } else {
-        control_reg |= (1 << DS3231_EOSC_BIT);  // 设置EOSC位以禁用振荡器
+    // BSY时自动转换正在进行，同样会应用新的偏移
+    ds3231_force_conversion(ds3231);
+    return true;
+}
+
+// 读取老化偏移（来自缓存）
+bool ds3231_get_aging_offset(ds3231_t *ds3231, int8_t *offset) {
+    if (!ds3231 || !offset) {
+        return false;
+    }
+    if (!ds3231->cache_valid && !ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
+    
+    *offset = (int8_t)ds3231->aging_cache;
+    return true;
+}
+
+// 启用/禁用振荡器
+bool ds3231_enable_oscillator(ds3231_t *ds3231, bool enable) {
+    if (!ds3231) {
+        return false;
     }
     
-    return ds3231_write_register(ds3231, DS3231_CONTROL_REG, control_reg);
+    if (enable) {
+        return update_control(ds3231, 1 << DS3231_EOSC_BIT, 0); // 清除EOSC位以启用振荡器
+    }
+    return update_control(ds3231, 0, 1 << DS3231_EOSC_BIT);     // 设置EOSC位以禁用振荡器
 }
 
 // 检查振荡器是否停止
@@ -166,30 +582,508 @@ bool ds3231_is_oscillator_stopped(ds3231_t *ds3231, bool *stopped) {
     return true;
 }
 
+// 启用SQW方波输出
+bool ds3231_set_sqw(ds3231_t *ds3231, ds3231_sqw_rate_t rate) {
+    if (!ds3231 || rate > DS3231_SQW_8192HZ) {
+        return false;
+    }
+    
+    return update_control(ds3231,
+                          (1 << DS3231_INTCN_BIT) | (1 << DS3231_RS2_BIT) | (1 << DS3231_RS1_BIT),
+                          (uint8_t)rate << DS3231_RS1_BIT);
+}
+
+// 关闭SQW方波输出（引脚回到闹钟中断模式）
+bool ds3231_disable_sqw(ds3231_t *ds3231) {
+    if (!ds3231) {
+        return false;
+    }
+    
+    return update_control(ds3231, 0, 1 << DS3231_INTCN_BIT);
+}
+
+// 各匹配模式下A1M1..A1M4 / A2M2..A2M4的屏蔽位（bit0对应第一个寄存器）
+static const uint8_t alarm1_mask_bits[] = {0x0F, 0x0E, 0x0C, 0x08, 0x00, 0x00};
+static const uint8_t alarm2_mask_bits[] = {0x07, 0x06, 0x04, 0x00, 0x00};
+
+// 按屏蔽位编码闹钟寄存器：bit7为AxMx，最后一个寄存器的bit6为DY/DT
+static void encode_alarm(uint8_t *regs, const uint8_t *values, uint8_t count, uint8_t mask, bool day) {
+    for (uint8_t i = 0; i < count; i++) {
+        regs[i] = bin_to_bcd(values[i]) | (((mask >> i) & 1) << 7);
+    }
+    if (day) {
+        // 星期0-6（0=Sunday）对应寄存器值1-7，与ds3231_write_time()一致
+        regs[count - 1] = ((values[count - 1] % 7) + 1) | (regs[count - 1] & 0x80) | 0x40;
+    }
+}
+
+// 设置闹钟1
+bool ds3231_set_alarm1(ds3231_t *ds3231, const ds3231_alarm_t *alarm, ds3231_alarm1_mode_t mode) {
+    if (!ds3231 || !alarm || mode > DS3231_ALARM1_MATCH_DAY_HMS) {
+        return false;
+    }
+    
+    const uint8_t values[4] = {alarm->seconds, alarm->minutes, alarm->hours, alarm->day_date};
+    uint8_t data[4];
+    encode_alarm(data, values, 4, alarm1_mask_bits[mode], mode == DS3231_ALARM1_MATCH_DAY_HMS);
+    return ds3231_write_registers(ds3231, DS3231_ALARM1_SEC, data, 4);
+}
+
+// 设置闹钟2
+bool ds3231_set_alarm2(ds3231_t *ds3231, const ds3231_alarm_t *alarm, ds3231_alarm2_mode_t mode) {
+    if (!ds3231 || !alarm || mode > DS3231_ALARM2_MATCH_DAY_HM) {
+        return false;
+    }
+    
+    const uint8_t values[3] = {alarm->minutes, alarm->hours, alarm->day_date};
+    uint8_t data[3];
+    encode_alarm(data, values, 3, alarm2_mask_bits[mode], mode == DS3231_ALARM2_MATCH_DAY_HM);
+    return ds3231_write_registers(ds3231, DS3231_ALARM2_MIN, data, 3);
+}
+
+// 启用/禁用闹钟中断（同时切到INT模式）
+bool ds3231_enable_alarm_interrupts(ds3231_t *ds3231, bool alarm1, bool alarm2) {
+    if (!ds3231) {
+        return false;
+    }
+    
+    uint8_t set_bits = (1 << DS3231_INTCN_BIT);
+    if (alarm1) {
+        set_bits |= (1 << DS3231_A1IE_BIT);
+    }
+    if (alarm2) {
+        set_bits |= (1 << DS3231_A2IE_BIT);
+    }
+    
+    return update_control(ds3231, (1 << DS3231_A1IE_BIT) | (1 << DS3231_A2IE_BIT), set_bits);
+}
+
+// 读取闹钟标志
+bool ds3231_read_alarm_flags(ds3231_t *ds3231, uint8_t *flags) {
+    if (!ds3231 || !flags) {
+        return false;
+    }
+    
+    uint8_t status_reg;
+    if (!ds3231_read_register(ds3231, DS3231_STATUS_REG, &status_reg)) {
+        return false;
+    }
+    
+    *flags = status_reg & (DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG);
+    return true;
+}
+
+// 清除闹钟标志：OSF/A1F/A2F写1不改变原值、写0清除，因此无需先读，
+// EN32kHz取自缓存
+bool ds3231_clear_alarm_flags(ds3231_t *ds3231, uint8_t flags) {
+    if (!ds3231) {
+        return false;
+    }
+    if (!ds3231->cache_valid && !ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
+    
+    uint8_t status_reg = ds3231->status_cache | (1 << DS3231_OSF_BIT) | DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG;
+    status_reg &= ~(flags & (DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG));
+    return ds3231_write_registers(ds3231, DS3231_STATUS_REG, &status_reg, 1);
+}
+
+// 每个GPIO对应的节拍分发器
+#define DS3231_TICK_MAX_GPIO 30
+static ds3231_tick_t *tick_by_gpio[DS3231_TICK_MAX_GPIO];
+
+static void ds3231_sqw_irq_handler(uint gpio, uint32_t events) {
+    if (gpio < DS3231_TICK_MAX_GPIO && tick_by_gpio[gpio] && (events & GPIO_IRQ_EDGE_FALL)) {
+        ds3231_tick_post(tick_by_gpio[gpio], time_us_64());
+    }
+}
+
+// 把SQW引脚接到节拍分发器
+bool ds3231_tick_attach_gpio(ds3231_tick_t *tick, uint gpio) {
+    if (!tick || gpio >= DS3231_TICK_MAX_GPIO) {
+        return false;
+    }
+    
+    // SQW为开漏输出，需要上拉
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+    
+    tick_by_gpio[gpio] = tick;
+    gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL, true, ds3231_sqw_irq_handler);
+    return true;
+}
+
+// 断开SQW引脚
+void ds3231_tick_detach_gpio(uint gpio) {
+    if (gpio >= DS3231_TICK_MAX_GPIO) {
+        return;
+    }
+    gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, false);
+    tick_by_gpio[gpio] = NULL;
+}
+
+// 32kHz输出（开漏，需要上拉）：状态寄存器中OSF/A1F/A2F写1保持原值
+bool ds3231_enable_32khz(ds3231_t *ds3231, bool enable) {
+    if (!ds3231) {
+        return false;
+    }
+    if (!ds3231->cache_valid && !ds3231_refresh_cache(ds3231)) {
+        return false;
+    }
+    
+    uint8_t en32 = enable ? (1 << DS3231_EN32KHZ_BIT) : 0;
+    if (ds3231->status_cache == en32) {
+        return true;
+    }
+    uint8_t status_reg = en32 | (1 << DS3231_OSF_BIT) | DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG;
+    return ds3231_write_registers(ds3231, DS3231_STATUS_REG, &status_reg, 1);
+}
+
+// 时间戳：一个PWM slice以B通道引脚的上升沿计数32kHz输出，
+// 事件引脚用原始GPIO中断处理（不经过gpio_set_irq_enabled_with_callback的回调分发）
+static ds3231_stamp_t *active_stamp;
+static uint stamp_slice;
+static uint32_t stamp_gpio_mask;
+
+// 读取扩展计数：先读计数再读回绕挂起标志。调用者须在中断中或已关中断
+static inline uint64_t stamp_count(void) {
+    uint16_t raw = (uint16_t)pwm_get_counter(stamp_slice);
+    bool pending = pwm_get_irq_status_mask() & (1u << stamp_slice);
+    return ds3231_stamp_count(active_stamp, raw, pending);
+}
+
+static uint64_t stamp_count_now(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint64_t count = stamp_count();
+    restore_interrupts(irq);
+    return count;
+}
+
+// 事件引脚中断：先读计数再处理，同一次中断中的所有事件共用一个计数值
+static void ds3231_stamp_gpio_handler(void) {
+    uint64_t count = stamp_count();
+    uint32_t mask = stamp_gpio_mask;
+    while (mask) {
+        uint gpio = __builtin_ctz(mask);
+        mask &= mask - 1;
+        uint32_t events = gpio_get_irq_event_mask(gpio);
+        if (!events) {
+            continue;
+        }
+        gpio_acknowledge_irq(gpio, events);
+        if (events & GPIO_IRQ_EDGE_RISE) {
+            ds3231_stamp_capture(active_stamp, count, (uint8_t)gpio, DS3231_STAMP_RISE);
+        }
+        if (events & GPIO_IRQ_EDGE_FALL) {
+            ds3231_stamp_capture(active_stamp, count, (uint8_t)gpio, DS3231_STAMP_FALL);
+        }
+    }
+}
+
+// 计数器回绕中断：与事件中断同为默认优先级，M0+上不会互相抢占
+static void ds3231_stamp_wrap_handler(void) {
+    if (pwm_get_irq_status_mask() & (1u << stamp_slice)) {
+        pwm_clear_irq(stamp_slice);
+        ds3231_stamp_wrap(active_stamp);
+    }
+}
+
+// 锚定：有SQW（1Hz）时轮询引脚等待下降沿，误差在1微秒内；
+// 否则轮询秒寄存器，误差不超过一次读取（100kHz下约1ms）
+static bool stamp_anchor(ds3231_t *ds3231, ds3231_stamp_t *stamp, int sqw_gpio) {
+    absolute_time_t deadline = make_timeout_time_us(DS3231_STAMP_ANCHOR_TIMEOUT_US);
+    ds3231_time_t time;
+    uint64_t count;
+    
+    if (sqw_gpio >= 0) {
+        bool last = gpio_get(sqw_gpio);
+        while (true) {
+            bool level = gpio_get(sqw_gpio);
+            if (last && !level) {
+                count = stamp_count_now();
+                break;
+            }
+            last = level;
+            if (time_reached(deadline)) {
+                return false;
+            }
+        }
+        // 秒寄存器在下降沿时已经更新
+        if (!ds3231_read_time(ds3231, &time)) {
+            return false;
+        }
+    } else {
+        ds3231_time_t first;
+        if (!ds3231_read_time(ds3231, &first)) {
+            return false;
+        }
+        do {
+            if (time_reached(deadline)) {
+                return false;
+            }
+            // DS3231在START时锁存时间寄存器，读取前的计数最接近观察到跳变的时刻
+            count = stamp_count_now();
+            if (!ds3231_read_time(ds3231, &time)) {
+                return false;
+            }
+        } while (time.seconds == first.seconds);
+    }
+    
+    ds3231_stamp_anchor(stamp, count, (uint32_t)ds3231_time_to_epoch(&time));
+    return true;
+}
+
+// 启动时间戳
+bool ds3231_stamp_start(ds3231_t *ds3231, ds3231_stamp_t *stamp, uint clk_gpio, int sqw_gpio) {
+    if (!ds3231 || !stamp || active_stamp || clk_gpio >= DS3231_TICK_MAX_GPIO) {
+        return false;
+    }
+    // PWM只能对B通道引脚（奇数GPIO）的输入计数
+    if (pwm_gpio_to_channel(clk_gpio) != PWM_CHAN_B) {
+        return false;
+    }
+    if (!ds3231_enable_32khz(ds3231, true)) {
+        return false;
+    }
+    
+    stamp_slice = pwm_gpio_to_slice_num(clk_gpio);
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_clkdiv_mode(&cfg, PWM_DIV_B_RISING);
+    pwm_config_set_wrap(&cfg, 0xFFFF);
+    pwm_init(stamp_slice, &cfg, false);
+    gpio_set_function(clk_gpio, GPIO_FUNC_PWM);
+    gpio_pull_up(clk_gpio);
+    
+    // 先启用回绕中断再锚定：等待秒边沿可能超过一个回绕周期
+    ds3231_stamp_init(stamp);
+    active_stamp = stamp;
+    pwm_clear_irq(stamp_slice);
+    pwm_set_irq_enabled(stamp_slice, true);
+    irq_add_shared_handler(PWM_IRQ_WRAP, ds3231_stamp_wrap_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+    pwm_set_enabled(stamp_slice, true);
+    
+    if (!stamp_anchor(ds3231, stamp, sqw_gpio)) {
+        ds3231_stamp_stop();
+        return false;
+    }
+    return true;
+}
+
+// 接入事件引脚（一次传入全部引脚）
+bool ds3231_stamp_attach_gpios(uint32_t gpio_mask, uint32_t edges) {
+    if (!active_stamp || stamp_gpio_mask || !gpio_mask || (gpio_mask >> DS3231_TICK_MAX_GPIO)) {
+        return false;
+    }
+    
+    stamp_gpio_mask = gpio_mask;
+    gpio_add_raw_irq_handler_masked(gpio_mask, ds3231_stamp_gpio_handler);
+    for (uint32_t mask = gpio_mask; mask; mask &= mask - 1) {
+        uint gpio = __builtin_ctz(mask);
+        gpio_init(gpio);
+        gpio_set_dir(gpio, GPIO_IN);
+        gpio_set_irq_enabled(gpio, edges & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL), true);
+    }
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
+
+// 停止时间戳（在启动它的核上调用）
+void ds3231_stamp_stop(void) {
+    if (!active_stamp) {
+        return;
+    }
+    
+    for (uint32_t mask = stamp_gpio_mask; mask; mask &= mask - 1) {
+        gpio_set_irq_enabled(__builtin_ctz(mask), GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+    }
+    if (stamp_gpio_mask) {
+        gpio_remove_raw_irq_handler_masked(stamp_gpio_mask, ds3231_stamp_gpio_handler);
+        stamp_gpio_mask = 0;
+    }
+    pwm_set_irq_enabled(stamp_slice, false);
+    irq_remove_handler(PWM_IRQ_WRAP, ds3231_stamp_wrap_handler);
+    pwm_set_enabled(stamp_slice, false);
+    active_stamp = NULL;
+}
+
+// MCU dormant，直到SQW/INT等引脚的下降沿
+uint32_t ds3231_dormant_until_edge(uint32_t gpio_mask) {
+    if (!gpio_mask) {
+        return 0;
+    }
+    
+    // 切换时钟期间不能响应中断：外设时钟在中途会变为12MHz
+    uint32_t irq_state = save_and_disable_interrupts();
+    
+    // 系统时钟改由XOSC直接提供，关闭两个PLL，停止USB/ADC/RTC时钟
+    const uint32_t hz = XOSC_MHZ * MHZ;
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, hz, hz);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, hz, hz);
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    clock_stop(clk_rtc);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, hz, hz);
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+    
+    for (uint32_t mask = gpio_mask; mask; mask &= mask - 1) {
+        gpio_set_dormant_irq_enabled(__builtin_ctz(mask), GPIO_IRQ_EDGE_FALL, true);
+    }
+    xosc_dormant(); // XOSC停振，直到边沿唤醒后从这里继续
+    
+    // 原始中断寄存器中的边沿锁存不受使能位影响，据此判断唤醒来源；
+    // 不在此确认，恢复中断后由已接入的GPIO中断（如节拍分发器）照常处理
+    uint32_t woke = 0;
+    for (uint32_t mask = gpio_mask; mask; mask &= mask - 1) {
+        uint gpio = __builtin_ctz(mask);
+        if ((iobank0_hw->intr[gpio / 8] >> (4 * (gpio % 8))) & GPIO_IRQ_EDGE_FALL) {
+            woke |= 1u << gpio;
+        }
+        gpio_set_dormant_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, false);
+    }
+    
+    // 按启动时的配置恢复PLL与全部时钟（定时器节拍也重新开始）
+    clocks_init();
+    restore_interrupts(irq_state);
+    return woke;
+}
+
 // 将时间转换为字符串
 void ds3231_time_to_string(const ds3231_time_t *time, char *buffer, size_t buffer_size) {
     if (!time || !buffer || buffer_size < 20) {
         return;
     }
     
-    const char* day_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
-    
-    snprintf(buffer, buffer_size, "%s %04d-%02d-%02d %02d:%02d:%02d",
-             day_names[time->day - 1],
-             2000 + time->year,
-             time->month,
-             time->date,
-             time->hours,
-             time->minutes,
-             time->seconds);
+    ds3231_format(buffer, buffer_size, "%a %Y-%m-%d %H:%M:%S", time);
+}
+
+// 0-99的BCD编码表，编译期生成
+struct bcd_table_t {
+    uint8_t v[100];
+};
+
+static constexpr bcd_table_t make_bcd_table() {
+    bcd_table_t t = {};
+    for (uint8_t i = 0; i < 100; i++) {
+        t.v[i] = (uint8_t)(((i / 10) << 4) | (i % 10));
+    }
+    return t;
+}
+
+static constexpr bcd_table_t bcd_table = make_bcd_table();
+
+// 时间寄存器0x00-0x06按小端装入64位字（RP2040与主机均为小端），第8字节为0。
+// 各字节的有效位、取值下限与上限；星期寄存器不参与解码（由日期推算）
+#define TIME_LANE_MASK  0x00FF1F3F003F7F7FULL
+#define TIME_LANE_MIN   0x0000010100000000ULL
+#define TIME_LANE_MAX   0x00630C1F00173B3BULL  // 99, 12, 31, -, 23, 59, 59
+#define LANES_01        0x0101010101010101ULL
+#define LANES_0F        0x0F0F0F0F0F0F0F0FULL
+#define LANES_80        0x8080808080808080ULL
+
+// 结构体按字节整体访问（reinterpret_cast为uint8_t*），字段顺序与偏移须与时间寄存器一致
+static_assert(sizeof(ds3231_time_t) == 7 && offsetof(ds3231_time_t, seconds) == 0 &&
+              offsetof(ds3231_time_t, day) == 3 && offsetof(ds3231_time_t, year) == 6,
+              "ds3231_time_t字段顺序须与时间寄存器一致");
+
+// 对7个字节同时做BCD解码与校验：两个半字节都须为0-9，解码值须在[MIN, MAX]内。
+// 半字节≤9时每字节≤99，下面的加法都不会进位到相邻字节
+static inline bool decode_time_word(uint64_t x, uint64_t *bin) {
+    x &= TIME_LANE_MASK;
+    uint64_t lo = x & LANES_0F;
+    uint64_t hi = (x >> 4) & LANES_0F;
+    if (((lo + 6 * LANES_01) | (hi + 6 * LANES_01)) & (LANES_01 << 4)) {
+        return false;
+    }
+
+    uint64_t b = x - 6 * hi;  // 16h + l - 6h = 10h + l
+    if ((b + (0x7F * LANES_01 - TIME_LANE_MAX)) & LANES_80) {
+        return false;
+    }
+    if (((b + (LANES_80 - TIME_LANE_MIN)) & LANES_80) != LANES_80) {
+        return false;
+    }
+
+    *bin = b;
+    return true;
+}
+
+// 7字节按两次重叠的32位访问装入/写出（第4字节两次取到的是同一个值），
+// 不逐字节拼装，也不经过栈上的临时变量
+static inline uint64_t load_time_word(const uint8_t *p) {
+    uint32_t lo, hi;
+    memcpy(&lo, p, 4);
+    memcpy(&hi, p + 3, 4);
+    return lo | ((uint64_t)hi << 24);
+}
+
+static inline void store_time_word(uint8_t *p, uint64_t x) {
+    uint32_t lo = (uint32_t)x;
+    uint32_t hi = (uint32_t)(x >> 24);
+    memcpy(p, &lo, 4);
+    memcpy(p + 3, &hi, 4);
+}
+
+// 解码时间寄存器
+bool ds3231_decode_time(const uint8_t regs[7], ds3231_time_t *time) {
+    if (!regs || !time) {
+        return false;
+    }
+
+    uint64_t x = load_time_word(regs);
+    uint64_t b;
+    if (!decode_time_word(x, &b)) {
+        return false;
+    }
+
+    // 2000-2099年内与芯片一致：能被4整除的年份为闰年
+    if ((uint8_t)(b >> 32) > ds3231_days_in_month(2000 + (uint8_t)(b >> 48), (uint8_t)(b >> 40))) {
+        return false;
+    }
+
+    store_time_word(reinterpret_cast<uint8_t *>(time), b);
+    time->day = ds3231_weekday(time);  // 由日期推算，不依赖星期寄存器（可能从未被正确设置）
+    return true;
+}
+
+// 编码时间寄存器
+bool ds3231_encode_time(const ds3231_time_t *time, uint8_t regs[7]) {
+    if (!time || !regs) {
+        return false;
+    }
+
+    // 星期字段不参与编码，稍后由日期推算
+    const uint8_t *fields = reinterpret_cast<const uint8_t *>(time);
+    uint64_t x = 0;
+    for (uint8_t i = 0; i < 7; i++) {
+        if (i == 3) {
+            continue;
+        }
+        if (fields[i] >= 100) {
+            return false;
+        }
+        x |= (uint64_t)bcd_table.v[fields[i]] << (i * 8);
+    }
+
+    // 复用解码路径校验各字段范围
+    uint64_t b;
+    if (!decode_time_word(x, &b) || time->date > ds3231_days_in_month(2000 + time->year, time->month)) {
+        return false;
+    }
+
+    store_time_word(regs, x);
+    regs[3] = ds3231_weekday(time) + 1;  // 星期寄存器为1-7（1=Sunday），由日期推算
+    return true;
 }
 
-// BCD转二进制
+// BCD转二进制：16h + l - 6h
 uint8_t bcd_to_bin(uint8_t bcd) {
-    return ((bcd >> 4) * 10) + (bcd & 0x0F);
+    return bcd - 6 * (bcd >> 4);
 }
 
 // 二进制转BCD
 uint8_t bin_to_bcd(uint8_t bin) {
-    return ((bin / 10) << 4) | (bin % 10);
+    return bcd_table.v[bin % 100];
 }
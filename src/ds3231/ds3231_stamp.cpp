@@ -0,0 +1,105 @@
+#include "ds3231/ds3231_stamp.h"
+#include <string.h>
+
+static_assert((DS3231_STAMP_RING_SIZE & (DS3231_STAMP_RING_SIZE - 1)) == 0, "DS3231_STAMP_RING_SIZE须为2的幂");
+static_assert(sizeof(ds3231_stamp_event_t) == 8, "事件应保持8字节");
+
+// 初始化
+void ds3231_stamp_init(ds3231_stamp_t *stamp) {
+    if (!stamp) {
+        return;
+    }
+    memset(stamp, 0, sizeof(*stamp));
+}
+
+// 计数器回绕
+void ds3231_stamp_wrap(ds3231_stamp_t *stamp) {
+    stamp->wraps = stamp->wraps + 1;
+}
+
+// 扩展计数：挂起的回绕只可能发生在读数之前不久，此时读数位于前半周期；
+// 读数位于后半周期时挂起标志属于读数之后才发生的回绕
+uint64_t ds3231_stamp_count(const ds3231_stamp_t *stamp, uint16_t raw, bool wrap_pending) {
+    uint64_t wraps = stamp->wraps + (wrap_pending && raw < 0x8000);
+    return (wraps << 16) | raw;
+}
+
+// 锚定RTC秒
+void ds3231_stamp_anchor(ds3231_stamp_t *stamp, uint64_t count, uint32_t rtc_seconds) {
+    if (!stamp) {
+        return;
+    }
+    stamp->anchor_count = count;
+    stamp->anchor_seconds = rtc_seconds;
+    stamp->anchored = true;
+}
+
+// 计数换算为时间戳：32768为2的幂，只需移位
+bool ds3231_stamp_convert(const ds3231_stamp_t *stamp, uint64_t count, uint32_t *seconds, uint16_t *ticks) {
+    if (!stamp || !stamp->anchored || count < stamp->anchor_count) {
+        return false;
+    }
+    uint64_t since = count - stamp->anchor_count;
+    *seconds = stamp->anchor_seconds + (uint32_t)(since >> DS3231_STAMP_HZ_SHIFT);
+    *ticks = (uint16_t)(since & (DS3231_STAMP_HZ - 1));
+    return true;
+}
+
+// 捕获事件
+bool ds3231_stamp_capture(ds3231_stamp_t *stamp, uint64_t count, uint8_t source, uint8_t edge) {
+    // tail由消费者写，读到旧值只会少算空位，不会覆盖未取走的事件
+    uint32_t head = stamp->head;
+    uint32_t tail = __atomic_load_n(&stamp->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= DS3231_STAMP_RING_SIZE) {
+        stamp->dropped++;
+        return false;
+    }
+
+    ds3231_stamp_event_t *ev = &stamp->events[head & (DS3231_STAMP_RING_SIZE - 1)];
+    if (!ds3231_stamp_convert(stamp, count, &ev->seconds, &ev->ticks)) {
+        stamp->dropped++;
+        return false;
+    }
+    ev->source = source;
+    ev->edge = edge;
+
+    // 事件写完之后再发布
+    __atomic_store_n(&stamp->head, head + 1, __ATOMIC_RELEASE);
+    stamp->captured++;
+    return true;
+}
+
+// 批量取出事件
+uint32_t ds3231_stamp_read(ds3231_stamp_t *stamp, ds3231_stamp_event_t *events, uint32_t max) {
+    if (!stamp || !events) {
+        return 0;
+    }
+
+    uint32_t tail = stamp->tail;
+    uint32_t head = __atomic_load_n(&stamp->head, __ATOMIC_ACQUIRE);
+    uint32_t n = head - tail;
+    if (n > max) {
+        n = max;
+    }
+
+    // 最多分两段复制（跨越缓冲区末尾时）
+    uint32_t start = tail & (DS3231_STAMP_RING_SIZE - 1);
+    uint32_t first = DS3231_STAMP_RING_SIZE - start;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(events, &stamp->events[start], first * sizeof(ds3231_stamp_event_t));
+    memcpy(events + first, &stamp->events[0], (n - first) * sizeof(ds3231_stamp_event_t));
+
+    // 复制完成后才归还空位
+    __atomic_store_n(&stamp->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+// 待取出的事件数
+uint32_t ds3231_stamp_available(const ds3231_stamp_t *stamp) {
+    if (!stamp) {
+        return 0;
+    }
+    return __atomic_load_n(&stamp->head, __ATOMIC_ACQUIRE) - stamp->tail;
+}
@@ -0,0 +1,73 @@
+#include "ds3231/ds3231_tick.h"
+#include <string.h>
+
+// 初始化节拍分发器
+void ds3231_tick_init(ds3231_tick_t *tick) {
+    if (!tick) {
+        return;
+    }
+    memset(tick, 0, sizeof(*tick));
+}
+
+// 订阅节拍
+bool ds3231_tick_subscribe(ds3231_tick_t *tick, uint32_t period, uint32_t phase,
+                           ds3231_tick_callback_t callback, void *ctx) {
+    if (!tick || !callback || period == 0 || phase >= period) {
+        return false;
+    }
+    if (tick->subscriber_count >= DS3231_TICK_MAX_SUBSCRIBERS) {
+        return false;
+    }
+
+    ds3231_tick_subscriber_t *sub = &tick->subscribers[tick->subscriber_count++];
+    sub->callback = callback;
+    sub->ctx = ctx;
+    sub->period = period;
+    sub->phase = phase;
+    return true;
+}
+
+// 投递一个节拍（可在中断中调用）
+void ds3231_tick_post(ds3231_tick_t *tick, uint64_t edge_us) {
+    if (!tick) {
+        return;
+    }
+    tick->last_edge_us = edge_us;
+    tick->posted = tick->posted + 1;
+}
+
+// 是否有未分发的节拍
+bool ds3231_tick_pending(const ds3231_tick_t *tick) {
+    return tick && tick->posted != tick->dispatched;
+}
+
+// 分发累积的节拍
+uint32_t ds3231_tick_dispatch(ds3231_tick_t *tick) {
+    if (!tick) {
+        return 0;
+    }
+
+    // 快照：分发期间到达的节拍留给下一次；64位时间戳在M0+上分两次读取，
+    // 读取期间若有新节拍则重读
+    uint32_t posted;
+    uint64_t edge_us;
+    do {
+        posted = tick->posted;
+        edge_us = tick->last_edge_us;
+    } while (posted != tick->posted);
+    const uint32_t count = posted - tick->dispatched;
+    if (count > 1) {
+        tick->lagged++;
+    }
+
+    for (uint32_t n = 0; n < count; n++) {
+        const uint32_t t = tick->dispatched++;
+        for (uint8_t i = 0; i < tick->subscriber_count; i++) {
+            ds3231_tick_subscriber_t *sub = &tick->subscribers[i];
+            if (t % sub->period == sub->phase) {
+                sub->callback(t, edge_us, sub->ctx);
+            }
+        }
+    }
+    return count;
+}
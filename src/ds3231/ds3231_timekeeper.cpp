@@ -0,0 +1,176 @@
+#include "ds3231/ds3231_timekeeper.h"
+#include "ds3231/ds3231_calendar.h"
+#include <string.h>
+
+static bool read_rtc(ds3231_timekeeper_t *tk, ds3231_time_t *t) {
+    tk->rtc_reads++;
+    return ds3231_read_time(tk->rtc, t);
+}
+
+// 本地时刻local_us对应的Unix时间（微秒）
+static int64_t epoch_us_at(const ds3231_timekeeper_t *tk, uint64_t local_us) {
+    int64_t local = (int64_t)(local_us - tk->base_us);
+    return tk->base_epoch * 1000000 + local - local * tk->drift_ppb / 1000000000;
+}
+
+// 以本地时刻edge_us对应RTC的整秒epoch完成一次同步
+static void apply_sync(ds3231_timekeeper_t *tk, uint64_t edge_us, int64_t epoch) {
+    if (tk->synced) {
+        // 本地推算与RTC之差
+        int64_t local = (int64_t)(edge_us - tk->base_us);
+        int64_t error = epoch_us_at(tk, edge_us) - epoch * 1000000;
+        if (error > INT32_MAX) error = INT32_MAX;
+        if (error < INT32_MIN) error = INT32_MIN;
+        tk->last_error_us = (int32_t)error;
+
+        // RTC被改写、跳变或读数错误时，差值超出真实频偏能解释的范围（短间隔按2秒、
+        // 长间隔按DS3231_TIMEKEEPER_MAX_DRIFT_PPM计）：丢弃频偏估计，只以本次读数为基准。
+        // 先检查再更新估计，避免跳变被当作频偏样本
+        int64_t rtc = (epoch - tk->base_epoch) * 1000000;
+        int64_t diff = local - rtc;
+        int64_t limit = rtc / 1000000 * DS3231_TIMEKEEPER_MAX_DRIFT_PPM;
+        if (limit < 2000000) limit = 2000000;
+        bool stepped = rtc < 0 || diff > limit || diff < -limit;
+
+        // 间隔足够长时更新频偏估计（指数平均，权重1/4）
+        if (!stepped && rtc >= (int64_t)DS3231_TIMEKEEPER_MIN_DRIFT_S * 1000000) {
+            int64_t measured = diff * 1000000000 / rtc;
+            if (measured > (int64_t)DS3231_TIMEKEEPER_MAX_DRIFT_PPM * 1000 ||
+                measured < -(int64_t)DS3231_TIMEKEEPER_MAX_DRIFT_PPM * 1000) {
+                stepped = true;
+            } else if (tk->drift_valid) {
+                tk->drift_ppb += ((int32_t)measured - tk->drift_ppb) / 4;
+            } else {
+                tk->drift_ppb = (int32_t)measured;
+                tk->drift_valid = true;
+            }
+        }
+        if (stepped) {
+            tk->drift_ppb = 0;
+            tk->drift_valid = false;
+            tk->steps++;
+        }
+    }
+
+    tk->base_us = edge_us;
+    tk->base_epoch = epoch;
+    tk->synced = true;
+    tk->sync_count++;
+}
+
+// 初始化计时服务（不进行同步）
+bool ds3231_timekeeper_init(ds3231_timekeeper_t *tk, ds3231_t *rtc, uint32_t resync_interval_s) {
+    if (!tk || !rtc) {
+        return false;
+    }
+
+    memset(tk, 0, sizeof(*tk));
+    tk->rtc = rtc;
+    tk->resync_interval_us = (uint64_t)resync_interval_s * 1000000;
+    return true;
+}
+
+// 轮询到秒变化为止，以变化前后两次读取的中点作为秒起点
+bool ds3231_timekeeper_sync(ds3231_timekeeper_t *tk) {
+    if (!tk) {
+        return false;
+    }
+
+    ds3231_time_t t0, t;
+    if (!read_rtc(tk, &t0)) {
+        return false;
+    }
+
+    uint64_t start_us = time_us_64();
+    uint64_t prev_us = start_us;
+    while (time_us_64() - start_us < 1200000) {
+        sleep_us(DS3231_TIMEKEEPER_POLL_US);
+        if (!read_rtc(tk, &t)) {
+            return false;
+        }
+        uint64_t now_us = time_us_64();
+        if (t.seconds != t0.seconds) {
+            apply_sync(tk, prev_us + (now_us - prev_us) / 2, ds3231_time_to_epoch(&t));
+            return true;
+        }
+        prev_us = now_us;
+    }
+
+    return false; // 秒寄存器没有变化，振荡器可能已停止
+}
+
+// 以边沿之后读到的时间同步，读取必须与边沿在同一秒内完成
+static bool sync_edge(ds3231_timekeeper_t *tk, uint64_t edge_us, const ds3231_time_t *t) {
+    if (time_us_64() - edge_us >= 900000) {
+        return false;
+    }
+
+    apply_sync(tk, edge_us, ds3231_time_to_epoch(t));
+    return true;
+}
+
+// 在SQW下降沿（秒更新时刻）之后同步，只需一次读取
+bool ds3231_timekeeper_sync_at_edge(ds3231_timekeeper_t *tk, uint64_t edge_us) {
+    if (!tk) {
+        return false;
+    }
+
+    ds3231_time_t t;
+    if (!read_rtc(tk, &t)) {
+        return false;
+    }
+    return sync_edge(tk, edge_us, &t);
+}
+
+// 以调用方读到的时间同步
+bool ds3231_timekeeper_sync_with_time(ds3231_timekeeper_t *tk, uint64_t edge_us, const ds3231_time_t *time) {
+    if (!tk || !time) {
+        return false;
+    }
+
+    tk->rtc_reads++;
+    return sync_edge(tk, edge_us, time);
+}
+
+// 是否需要重新同步
+bool ds3231_timekeeper_resync_due(const ds3231_timekeeper_t *tk) {
+    if (!tk) {
+        return false;
+    }
+    return !tk->synced || (time_us_64() - tk->base_us >= tk->resync_interval_us);
+}
+
+// 当前Unix时间（微秒）
+uint64_t ds3231_timekeeper_now_us(const ds3231_timekeeper_t *tk) {
+    if (!tk || !tk->synced) {
+        return 0;
+    }
+
+    return (uint64_t)epoch_us_at(tk, time_us_64());
+}
+
+// 当前时间（星期由日期推算，0=Sunday）
+bool ds3231_timekeeper_now(const ds3231_timekeeper_t *tk, ds3231_time_t *time, uint32_t *subsec_us) {
+    if (!tk || !time || !tk->synced) {
+        return false;
+    }
+
+    uint64_t now_us = ds3231_timekeeper_now_us(tk);
+    ds3231_epoch_to_time((int64_t)(now_us / 1000000), time);
+
+    if (subsec_us) {
+        *subsec_us = (uint32_t)(now_us % 1000000);
+    }
+    return true;
+}
+
+// SQW边沿开始的那一秒（星期由日期推算，0=Sunday）
+bool ds3231_timekeeper_at_edge(const ds3231_timekeeper_t *tk, uint64_t edge_us, ds3231_time_t *time) {
+    if (!tk || !time || !tk->synced) {
+        return false;
+    }
+
+    int64_t epoch_us = epoch_us_at(tk, edge_us);
+    ds3231_epoch_to_time((epoch_us + 500000) / 1000000, time);
+    return true;
+}
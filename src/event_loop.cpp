@@ -0,0 +1,163 @@
+#include "event_loop.h"
+#include <stdio.h>
+#include <string.h>
+
+// 初始化事件循环
+void event_loop_init(event_loop_t *loop, event_now_fn_t now, event_idle_fn_t idle, void *port_ctx) {
+    if (!loop) {
+        return;
+    }
+    memset(loop, 0, sizeof(*loop));
+    loop->now = now;
+    loop->idle = idle;
+    loop->port_ctx = port_ctx;
+    loop->stats_start_us = now ? now(port_ctx) : 0;
+}
+
+// 添加任务
+bool event_loop_add(event_loop_t *loop, event_task_t *task, const char *name, event_task_fn_t fn, void *ctx) {
+    if (!loop || !task || !fn || loop->task_count >= EVENT_LOOP_MAX_TASKS) {
+        return false;
+    }
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->fn = fn;
+    task->ctx = ctx;
+    loop->tasks[loop->task_count++] = task;
+    return true;
+}
+
+void event_task_set_poll(event_task_t *task, event_poll_fn_t poll) {
+    if (task) {
+        task->poll = poll;
+    }
+}
+
+// 置位用户事件（只在主循环中调用）
+void event_task_signal(event_task_t *task, uint32_t events) {
+    if (task) {
+        task->signals |= events;
+    }
+}
+
+// 启动定时器
+void event_task_timer(event_loop_t *loop, event_task_t *task, uint32_t delay_us, uint32_t period_us) {
+    if (!loop || !task) {
+        return;
+    }
+    task->deadline_us = loop->now(loop->port_ctx) + delay_us;
+    task->period_us = period_us;
+    task->timer_armed = true;
+}
+
+void event_task_cancel_timer(event_task_t *task) {
+    if (task) {
+        task->timer_armed = false;
+    }
+}
+
+// 收集任务的就绪事件，定时器到期时推进到下一个周期
+static uint32_t take_events(event_task_t *task, uint64_t now, uint32_t *late_us) {
+    uint32_t events = task->signals;
+    *late_us = 0;
+
+    if (task->timer_armed && now >= task->deadline_us) {
+        events |= EVENT_TIMER;
+        *late_us = (uint32_t)(now - task->deadline_us);
+        if (task->period_us) {
+            task->deadline_us += task->period_us;
+            if (task->deadline_us <= now) {
+                // 错过的周期不补跑
+                const uint64_t missed = (now - task->deadline_us) / task->period_us + 1;
+                task->overruns += (uint32_t)missed;
+                task->deadline_us += missed * task->period_us;
+            }
+        } else {
+            task->timer_armed = false;
+        }
+    }
+
+    if (task->poll && task->poll(task->ctx)) {
+        events |= EVENT_POLL;
+    }
+    task->signals = 0;
+    return events;
+}
+
+// 运行一个就绪任务，没有时空闲到最近的定时器
+bool event_loop_run_once(event_loop_t *loop, uint32_t max_idle_us) {
+    const uint64_t now = loop->now(loop->port_ctx);
+    uint64_t next_deadline = now + max_idle_us;
+
+    for (uint8_t i = 0; i < loop->task_count; i++) {
+        event_task_t *task = loop->tasks[i];
+        uint32_t late_us;
+        const uint32_t events = take_events(task, now, &late_us);
+        if (!events) {
+            if (task->timer_armed && task->deadline_us < next_deadline) {
+                next_deadline = task->deadline_us;
+            }
+            continue;
+        }
+
+        if (late_us > task->max_late_us) {
+            task->max_late_us = late_us;
+        }
+        loop->current = task;
+        task->fn(task, events);
+        loop->current = NULL;
+        const uint64_t end = loop->now(loop->port_ctx);
+        const uint32_t us = (uint32_t)(end - now);
+        task->runs++;
+        task->cpu_us += us;
+        if (us > task->max_us) {
+            task->max_us = us;
+        }
+        return true;
+    }
+
+    if (loop->idle && next_deadline > now) {
+        loop->idle(loop->port_ctx, next_deadline);
+        loop->idle_us += loop->now(loop->port_ctx) - now;
+        loop->idles++;
+    }
+    return false;
+}
+
+// 持续运行
+void event_loop_run(event_loop_t *loop, uint64_t until_us) {
+    while (until_us == 0 || loop->now(loop->port_ctx) < until_us) {
+        uint64_t now = loop->now(loop->port_ctx);
+        uint32_t max_idle = (until_us && until_us - now < UINT32_MAX) ? (uint32_t)(until_us - now) : UINT32_MAX;
+        event_loop_run_once(loop, max_idle);
+    }
+}
+
+// 打印任务统计
+void event_loop_print_stats(const event_loop_t *loop) {
+    const uint64_t elapsed = loop->now(loop->port_ctx) - loop->stats_start_us;
+    printf("任务统计（%lums）:\n", (unsigned long)(elapsed / 1000));
+    for (uint8_t i = 0; i < loop->task_count; i++) {
+        const event_task_t *t = loop->tasks[i];
+        printf("  %-10s 运行%6lu次 CPU %8luus (%5.2f%%) 最长%6luus 最大延迟%6luus 错过周期%lu\n", t->name,
+               (unsigned long)t->runs, (unsigned long)t->cpu_us,
+               elapsed ? 100.0 * (double)t->cpu_us / (double)elapsed : 0.0, (unsigned long)t->max_us,
+               (unsigned long)t->max_late_us, (unsigned long)t->overruns);
+    }
+    printf("  %-10s %lu次 %luus (%5.2f%%)\n", "空闲", (unsigned long)loop->idles, (unsigned long)loop->idle_us,
+           elapsed ? 100.0 * (double)loop->idle_us / (double)elapsed : 0.0);
+}
+
+void event_loop_reset_stats(event_loop_t *loop) {
+    for (uint8_t i = 0; i < loop->task_count; i++) {
+        event_task_t *t = loop->tasks[i];
+        t->runs = 0;
+        t->cpu_us = 0;
+        t->max_us = 0;
+        t->max_late_us = 0;
+        t->overruns = 0;
+    }
+    loop->idle_us = 0;
+    loop->idles = 0;
+    loop->stats_start_us = loop->now(loop->port_ctx);
+}
@@ -0,0 +1,255 @@
+#include "i2c_bus.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// 初始化总线
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin, uint32_t baudrate) {
+    if (!bus || !i2c) {
+        return false;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->i2c = i2c;
+    bus->sda_pin = sda_pin;
+    bus->scl_pin = scl_pin;
+    bus->baudrate = baudrate;
+
+    i2c_init(i2c, baudrate);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+    return true;
+}
+
+// 填写事务
+void i2c_bus_txn_init(i2c_bus_txn_t *txn, const i2c_bus_device_t *device, const uint8_t *wbuf, uint16_t wlen,
+                      uint8_t *rbuf, uint16_t rlen, uint8_t priority) {
+    memset(txn, 0, sizeof(*txn));
+    txn->device = device;
+    txn->wbuf = wbuf;
+    txn->wlen = wlen;
+    txn->rbuf = rbuf;
+    txn->rlen = rlen;
+    txn->priority = priority < I2C_BUS_PRIORITIES ? priority : I2C_BUS_PRIORITIES - 1;
+}
+
+// 提交事务（可在中断中调用）
+bool i2c_bus_submit(i2c_bus_t *bus, i2c_bus_txn_t *txn) {
+    if (!bus || !txn || !txn->device || (txn->wlen == 0 && txn->rlen == 0)) {
+        return false;
+    }
+    // 分片写入不能带读取，header加分片必须放得进暂存区
+    if (txn->chunk && (txn->rlen || txn->header_len > sizeof(bus->staging) - I2C_BUS_CHUNK_BYTES)) {
+        return false;
+    }
+
+    txn->offset = 0;
+    txn->submit_us = time_us_64();
+    txn->state = I2C_BUS_TXN_PENDING;
+
+    uint32_t irq = save_and_disable_interrupts();
+    bool ok = bus->count < I2C_BUS_MAX_PENDING;
+    if (ok) {
+        bus->queue[bus->count++] = txn;
+    }
+    restore_interrupts(irq);
+
+    if (!ok) {
+        txn->state = I2C_BUS_TXN_IDLE;
+    }
+    return ok;
+}
+
+// 选出下一个事务：最高优先级中最早提交的；同一设备上已开始的分片写入必须先完成，
+// 避免其他命令打断显存写入窗口
+static int8_t select_next(const i2c_bus_t *bus) {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < bus->count; i++) {
+        const i2c_bus_txn_t *txn = bus->queue[i];
+        bool blocked = false;
+        for (uint8_t j = 0; j < bus->count; j++) {
+            const i2c_bus_txn_t *other = bus->queue[j];
+            if (j != i && other->device == txn->device && other->state == I2C_BUS_TXN_ACTIVE) {
+                blocked = true;
+                break;
+            }
+        }
+        if (blocked) {
+            continue;
+        }
+        if (best < 0 || txn->priority > bus->queue[best]->priority) {
+            best = (int8_t)i;
+        }
+    }
+    return best;
+}
+
+static void complete(i2c_bus_t *bus, i2c_bus_txn_t *txn, i2c_bus_txn_state_t state) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < bus->count; i++) {
+        if (bus->queue[i] == txn) {
+            // 保持提交顺序
+            memmove(&bus->queue[i], &bus->queue[i + 1], (bus->count - i - 1) * sizeof(bus->queue[0]));
+            bus->count--;
+            break;
+        }
+    }
+    restore_interrupts(irq);
+
+    if (state == I2C_BUS_TXN_DONE) {
+        bus->stats.completed++;
+    }
+    txn->state = state;
+    if (txn->callback) {
+        txn->callback(state, txn->ctx);
+    }
+}
+
+// 执行一步
+bool i2c_bus_poll(i2c_bus_t *bus) {
+    if (!bus || bus->polling) {
+        return bus && bus->count > 0;
+    }
+
+    uint32_t irq = save_and_disable_interrupts();
+    int8_t index = select_next(bus);
+    i2c_bus_txn_t *txn = index >= 0 ? bus->queue[index] : NULL;
+    restore_interrupts(irq);
+    if (!txn) {
+        return false;
+    }
+    bus->polling = true;
+
+    const i2c_bus_device_t *device = txn->device;
+    if (device->baudrate != bus->baudrate) {
+        i2c_set_baudrate(bus->i2c, device->baudrate);
+        bus->baudrate = device->baudrate;
+        bus->stats.speed_switches++;
+    }
+
+    uint64_t start_us = time_us_64();
+    if (txn->state == I2C_BUS_TXN_PENDING) {
+        uint32_t wait_us = (uint32_t)(start_us - txn->submit_us);
+        if (wait_us > bus->stats.max_wait_us[txn->priority]) {
+            bus->stats.max_wait_us[txn->priority] = wait_us;
+        }
+    }
+
+    absolute_time_t deadline = make_timeout_time_us(I2C_BUS_TIMEOUT_US);
+    int result = 0;
+    bool ok = true;
+    bool finished = true;
+    if (txn->chunk) {
+        uint16_t n = txn->wlen - txn->offset;
+        if (n > txn->chunk) n = txn->chunk;
+        if (n > I2C_BUS_CHUNK_BYTES) n = I2C_BUS_CHUNK_BYTES;
+        memcpy(bus->staging, txn->header, txn->header_len);
+        memcpy(&bus->staging[txn->header_len], &txn->wbuf[txn->offset], n);
+        int len = txn->header_len + n;
+        result = i2c_write_blocking_until(bus->i2c, device->addr, bus->staging, len, false, deadline);
+        ok = result == len;
+        if (ok) {
+            txn->offset += n;
+            finished = txn->offset >= txn->wlen;
+        }
+    } else {
+        if (txn->wlen) {
+            result = i2c_write_blocking_until(bus->i2c, device->addr, txn->wbuf, txn->wlen, txn->rlen > 0, deadline);
+            ok = result == txn->wlen;
+        }
+        if (ok && txn->rlen) {
+            result = i2c_read_blocking_until(bus->i2c, device->addr, txn->rbuf, txn->rlen, false, deadline);
+            ok = result == txn->rlen;
+        }
+    }
+
+    uint32_t busy_us = (uint32_t)(time_us_64() - start_us);
+    bus->stats.chunks++;
+    if (busy_us > bus->stats.max_chunk_us) {
+        bus->stats.max_chunk_us = busy_us;
+    }
+
+    if (!ok) {
+        if (result == PICO_ERROR_TIMEOUT) {
+            bus->stats.timeouts++;
+            i2c_bus_recover(bus);
+            complete(bus, txn, I2C_BUS_TXN_TIMEOUT);
+        } else {
+            bus->stats.errors++;
+            complete(bus, txn, I2C_BUS_TXN_ERROR);
+        }
+    } else if (finished) {
+        complete(bus, txn, I2C_BUS_TXN_DONE);
+    } else {
+        txn->state = I2C_BUS_TXN_ACTIVE;
+    }
+
+    bus->polling = false;
+    return bus->count > 0;
+}
+
+// 等待事务完成
+bool i2c_bus_wait(i2c_bus_t *bus, i2c_bus_txn_t *txn) {
+    if (!bus || !txn) {
+        return false;
+    }
+    while (txn->state == I2C_BUS_TXN_PENDING || txn->state == I2C_BUS_TXN_ACTIVE) {
+        if (bus->polling) {
+            return false; // 在完成回调中等待会死锁
+        }
+        i2c_bus_poll(bus);
+    }
+    return txn->state == I2C_BUS_TXN_DONE;
+}
+
+// 提交并等待
+bool i2c_bus_transfer(i2c_bus_t *bus, const i2c_bus_device_t *device, const uint8_t *wbuf, uint16_t wlen,
+                      uint8_t *rbuf, uint16_t rlen, uint8_t priority) {
+    i2c_bus_txn_t txn;
+    i2c_bus_txn_init(&txn, device, wbuf, wlen, rbuf, rlen, priority);
+    if (!i2c_bus_submit(bus, &txn)) {
+        return false;
+    }
+    return i2c_bus_wait(bus, &txn);
+}
+
+// 总线恢复
+bool i2c_bus_recover_pins(i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin, uint32_t baudrate) {
+    i2c_deinit(i2c);
+
+    // 以GPIO模拟开漏：方向设为输出即拉低（输出值为0），设为输入则由上拉释放
+    gpio_init(sda_pin);
+    gpio_init(scl_pin);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+    busy_wait_us_32(5);
+
+    // 从机拉住SDA时最多给9个时钟，让它把当前字节移完
+    for (uint8_t i = 0; i < 9 && !gpio_get(sda_pin); i++) {
+        gpio_set_dir(scl_pin, GPIO_OUT);
+        busy_wait_us_32(5);
+        gpio_set_dir(scl_pin, GPIO_IN);
+        busy_wait_us_32(5);
+    }
+
+    // SCL为高时产生START再产生STOP，复位所有从机的总线状态
+    gpio_set_dir(sda_pin, GPIO_OUT);
+    busy_wait_us_32(5);
+    gpio_set_dir(sda_pin, GPIO_IN);
+    busy_wait_us_32(5);
+    bool released = gpio_get(sda_pin) && gpio_get(scl_pin);
+
+    i2c_init(i2c, baudrate);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+    return released;
+}
+
+bool i2c_bus_recover(i2c_bus_t *bus) {
+    if (!bus) {
+        return false;
+    }
+    bus->stats.recoveries++;
+    return i2c_bus_recover_pins(bus->i2c, bus->sda_pin, bus->scl_pin, bus->baudrate);
+}
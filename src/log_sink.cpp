@@ -0,0 +1,288 @@
+#include "log_sink.h"
+#include <stdio.h>
+
+#define LOG_SINK_MASK (LOG_SINK_RING_WORDS - 1)
+
+void log_sink_init(log_sink_t *sink, const char *const *formats, uint16_t format_count, log_now_fn_t now,
+                   void *now_ctx) {
+    if (!sink) {
+        return;
+    }
+    memset(sink, 0, sizeof(*sink));
+    sink->formats = formats;
+    sink->format_count = format_count;
+    sink->now = now;
+    sink->now_ctx = now_ctx;
+}
+
+// 写入方：只拷贝参数字，不格式化
+bool log_sink_push(log_sink_t *sink, uint16_t format, uint8_t nargs, const uint32_t *args) {
+    if (format >= sink->format_count || nargs > LOG_SINK_MAX_ARGS) {
+        sink->dropped++;
+        return false;
+    }
+    const uint32_t need = 2u + nargs;
+    // tail由输出方写，读到旧值只会少算空位，不会覆盖未取走的记录
+    const uint32_t head = sink->head;
+    const uint32_t used = head - __atomic_load_n(&sink->tail, __ATOMIC_ACQUIRE);
+    if (used + need > LOG_SINK_RING_WORDS) {
+        sink->dropped++;
+        return false;
+    }
+
+    sink->words[head & LOG_SINK_MASK] = ((uint32_t)format << 16) | nargs;
+    sink->words[(head + 1) & LOG_SINK_MASK] = sink->now ? (uint32_t)sink->now(sink->now_ctx) : 0;
+    for (uint8_t i = 0; i < nargs; i++) {
+        sink->words[(head + 2 + i) & LOG_SINK_MASK] = args[i];
+    }
+    __atomic_store_n(&sink->head, head + need, __ATOMIC_RELEASE);
+
+    sink->records++;
+    if (used + need > sink->high_water) {
+        sink->high_water = used + need;
+    }
+    return true;
+}
+
+bool log_sink_pending(const log_sink_t *sink) {
+    return __atomic_load_n(&sink->head, __ATOMIC_ACQUIRE) != sink->tail ||
+           __atomic_load_n(&sink->dropped, __ATOMIC_RELAXED) != sink->reported_dropped;
+}
+
+// LEB128变长整数，返回写入的字节数
+static uint8_t put_varint(uint8_t *out, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint32_t zigzag(uint32_t v) {
+    return (v << 1) ^ (uint32_t)((int32_t)v >> 31);
+}
+
+size_t log_sink_next(log_sink_t *sink, char *buf, size_t size, bool binary) {
+    if (!size) {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    const uint32_t dropped = __atomic_load_n(&sink->dropped, __ATOMIC_RELAXED);
+    if (dropped != sink->reported_dropped) {
+        sink->reported_dropped = dropped;
+        const int n = binary ? snprintf(buf, size, LOG_SINK_PREFIX "D,%lu\n", (unsigned long)dropped)
+                             : snprintf(buf, size, "日志: 累计丢弃%lu条\n", (unsigned long)dropped);
+        return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+    }
+
+    const uint32_t tail = sink->tail;
+    if (__atomic_load_n(&sink->head, __ATOMIC_ACQUIRE) == tail) {
+        return 0;
+    }
+    const uint32_t header = sink->words[tail & LOG_SINK_MASK];
+    const uint32_t ts = sink->words[(tail + 1) & LOG_SINK_MASK];
+    const uint16_t format = (uint16_t)(header >> 16);
+    const uint8_t nargs = (uint8_t)header;
+    uint32_t args[LOG_SINK_MAX_ARGS];
+    for (uint8_t i = 0; i < nargs; i++) {
+        args[i] = sink->words[(tail + 2 + i) & LOG_SINK_MASK];
+    }
+    __atomic_store_n(&sink->tail, tail + 2u + nargs, __ATOMIC_RELEASE);
+
+    if (!binary) {
+        return log_sink_format(sink->formats[format], args, nargs, buf, size);
+    }
+
+    uint8_t bytes[5 * (LOG_SINK_MAX_ARGS + 2)];
+    uint8_t len = put_varint(bytes, format);
+    len += put_varint(bytes + len, ts - sink->last_ts);
+    sink->last_ts = ts;
+    for (uint8_t i = 0; i < nargs; i++) {
+        len += put_varint(bytes + len, zigzag(args[i]));
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    const size_t prefix = sizeof(LOG_SINK_PREFIX "R,") - 1;
+    if (prefix + 2u * len + 2 > size) {
+        return 0;
+    }
+    memcpy(buf, LOG_SINK_PREFIX "R,", prefix);
+    size_t pos = prefix;
+    for (uint8_t i = 0; i < len; i++) {
+        buf[pos++] = hex[bytes[i] >> 4];
+        buf[pos++] = hex[bytes[i] & 0x0F];
+    }
+    buf[pos++] = '\n';
+    buf[pos] = '\0';
+    return pos;
+}
+
+uint32_t log_sink_drain(log_sink_t *sink, uint32_t max_records, bool binary) {
+    char line[LOG_SINK_LINE_MAX];
+    uint32_t count = 0;
+    size_t len;
+    while (count < max_records && (len = log_sink_next(sink, line, sizeof(line), binary)) > 0) {
+        fwrite(line, 1, len, stdout);
+        count++;
+    }
+    return count;
+}
+
+void log_sink_print_formats(log_sink_t *sink) {
+    for (uint16_t i = 0; i < sink->format_count; i++) {
+        printf(LOG_SINK_PREFIX "F,%u,", i);
+        for (const char *p = sink->formats[i]; *p; p++) {
+            if (*p == '\n') {
+                fputs("\\n", stdout);
+            } else if (*p == '\\') {
+                fputs("\\\\", stdout);
+            } else {
+                putchar(*p);
+            }
+        }
+        putchar('\n');
+    }
+    sink->last_ts = 0;
+}
+
+// 追加字符串，超出时截断
+static void append(char *buf, size_t size, size_t *pos, const char *s, size_t n) {
+    if (*pos + 1 >= size) {
+        return;
+    }
+    if (n > size - 1 - *pos) {
+        n = size - 1 - *pos;
+    }
+    memcpy(buf + *pos, s, n);
+    *pos += n;
+    buf[*pos] = '\0';
+}
+
+size_t log_sink_format(const char *format, const uint32_t *args, uint8_t nargs, char *buf, size_t size) {
+    if (!size) {
+        return 0;
+    }
+    size_t pos = 0;
+    uint8_t arg = 0;
+    buf[0] = '\0';
+
+    const char *p = format;
+    while (*p) {
+        if (*p != '%') {
+            const char *q = p;
+            while (*q && *q != '%') {
+                q++;
+            }
+            append(buf, size, &pos, p, (size_t)(q - p));
+            p = q;
+            continue;
+        }
+        if (p[1] == '%') {
+            append(buf, size, &pos, "%", 1);
+            p += 2;
+            continue;
+        }
+
+        // 复制标志、宽度与精度，去掉长度修饰，整数转换统一加'l'
+        char spec[16];
+        uint8_t n = 0;
+        const char *q = p + 1;
+        spec[n++] = '%';
+        while (*q && strchr("-+ #0123456789.", *q) && n < sizeof(spec) - 3) {
+            spec[n++] = *q++;
+        }
+        while (*q == 'l' || *q == 'h' || *q == 'z') {
+            q++;
+        }
+        const char conv = *q;
+        if (conv) {
+            q++;
+        }
+
+        char out[48];
+        int len = -1;
+        if (arg < nargs && conv && strchr("diuxXocfFeEgG", conv)) {
+            const uint32_t v = args[arg];
+            if (strchr("di", conv)) {
+                spec[n++] = 'l';
+                spec[n++] = conv;
+                spec[n] = '\0';
+                len = snprintf(out, sizeof(out), spec, (long)(int32_t)v);
+            } else if (strchr("uxXo", conv)) {
+                spec[n++] = 'l';
+                spec[n++] = conv;
+                spec[n] = '\0';
+                len = snprintf(out, sizeof(out), spec, (unsigned long)v);
+            } else if (conv == 'c') {
+                spec[n++] = conv;
+                spec[n] = '\0';
+                len = snprintf(out, sizeof(out), spec, (int)v);
+            } else {
+                float f;
+                memcpy(&f, &v, sizeof(f));
+                spec[n++] = conv;
+                spec[n] = '\0';
+                len = snprintf(out, sizeof(out), spec, (double)f);
+            }
+        }
+        if (len < 0) {
+            append(buf, size, &pos, "?", 1);
+        } else {
+            append(buf, size, &pos, out, (size_t)len < sizeof(out) ? (size_t)len : sizeof(out) - 1);
+        }
+        arg++;
+        p = q;
+    }
+    return pos;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int log_sink_decode_record(const char *hex, uint16_t *format, uint32_t *ts_delta, uint32_t *args,
+                           uint8_t max_args) {
+    uint32_t values[LOG_SINK_MAX_ARGS + 2];
+    uint8_t count = 0;
+    uint32_t v = 0;
+    uint8_t shift = 0;
+    bool partial = false;
+
+    for (const char *p = hex; *p && *p != '\n' && *p != '\r'; p += 2) {
+        const int hi = hex_value(p[0]);
+        const int lo = hi < 0 ? -1 : hex_value(p[1]);
+        if (lo < 0 || shift > 28) {
+            return -1;
+        }
+        const uint8_t b = (uint8_t)(hi << 4 | lo);
+        v |= (uint32_t)(b & 0x7F) << shift;
+        partial = true;
+        if (b & 0x80) {
+            shift += 7;
+            continue;
+        }
+        if (count == LOG_SINK_MAX_ARGS + 2) {
+            return -1;
+        }
+        values[count++] = v;
+        v = 0;
+        shift = 0;
+        partial = false;
+    }
+    if (partial || count < 2 || values[0] > 0xFFFF || count - 2 > max_args) {
+        return -1;
+    }
+
+    *format = (uint16_t)values[0];
+    *ts_delta = values[1];
+    for (uint8_t i = 2; i < count; i++) {
+        args[i - 2] = (values[i] >> 1) ^ (0u - (values[i] & 1));
+    }
+    return count - 2;
+}
@@ -1,110 +1,149 @@
 #include "ssd1306.h"
+#include "ssd1306_transform.h"
+#include "ssd1306_gray.h"
+#include "ssd1306_power.h"
+#include "ssd1306_font.h"
 #include <cstdio>
 #include <cstdlib>
 #include <algorithm>
 
-// 5x7字体数据 - 修正版本
-const uint8_t SSD1306::font5x7[][5] = {
-    {0x00, 0x00, 0x00, 0x00, 0x00}, // 空格 (32)
-    {0x00, 0x00, 0x5F, 0x00, 0x00}, // ! (33)
-    {0x00, 0x07, 0x00, 0x07, 0x00}, // " (34)
-    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // # (35)
-    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $ (36)
-    {0x23, 0x13, 0x08, 0x64, 0x62}, // % (37)
-    {0x36, 0x49, 0x55, 0x22, 0x50}, // & (38)
-    {0x00, 0x05, 0x03, 0x00, 0x00}, // ' (39)
-    {0x00, 0x1C, 0x22, 0x41, 0x00}, // ( (40)
-    {0x00, 0x41, 0x22, 0x1C, 0x00}, // ) (41)
-    {0x14, 0x08, 0x3E, 0x08, 0x14}, // * (42)
-    {0x08, 0x08, 0x3E, 0x08, 0x08}, // + (43)
-    {0x00, 0x00, 0xA0, 0x60, 0x00}, // , (44)
-    {0x08, 0x08, 0x08, 0x08, 0x08}, // - (45)
-    {0x00, 0x60, 0x60, 0x00, 0x00}, // . (46)
-    {0x20, 0x10, 0x08, 0x04, 0x02}, // / (47)
-    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0 (48)
-    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1 (49)
-    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2 (50)
-    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3 (51)
-    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4 (52)
-    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5 (53)
-    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6 (54)
-    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7 (55)
-    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8 (56)
-    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9 (57)
-    {0x00, 0x36, 0x36, 0x00, 0x00}, // : (58)
-    {0x00, 0x56, 0x36, 0x00, 0x00}, // ; (59)
-    {0x08, 0x14, 0x22, 0x41, 0x00}, // < (60)
-    {0x14, 0x14, 0x14, 0x14, 0x14}, // = (61)
-    {0x00, 0x41, 0x22, 0x14, 0x08}, // > (62)
-    {0x02, 0x01, 0x51, 0x09, 0x06}, // ? (63)
-    {0x32, 0x49, 0x59, 0x51, 0x3E}, // @ (64)
-    {0x7C, 0x12, 0x11, 0x12, 0x7C}, // A (65)
-    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B (66)
-    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C (67)
-    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D (68)
-    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E (69)
-    {0x7F, 0x09, 0x09, 0x09, 0x01}, // F (70)
-    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G (71)
-    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H (72)
-    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I (73)
-    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J (74)
-    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K (75)
-    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L (76)
-    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M (77)
-    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N (78)
-    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O (79)
-    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P (80)
-    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q (81)
-    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R (82)
-    {0x46, 0x49, 0x49, 0x49, 0x31}, // S (83)
-    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T (84)
-    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U (85)
-    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V (86)
-    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W (87)
-    {0x63, 0x14, 0x08, 0x14, 0x63}, // X (88)
-    {0x07, 0x08, 0x70, 0x08, 0x07}, // Y (89)
-    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z (90)
-    {0x00, 0x7F, 0x41, 0x41, 0x00}, // [ (91)
-    {0x02, 0x04, 0x08, 0x10, 0x20}, // \ (92)
-    {0x00, 0x00, 0x41, 0x41, 0x7F}, // ] (93)
-    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^ (94)
-    {0x40, 0x40, 0x40, 0x40, 0x40}, // _ (95)
-    {0x00, 0x01, 0x02, 0x04, 0x00}, // ` (96)
-    {0x20, 0x54, 0x54, 0x54, 0x78}, // a (97)
-    {0x7F, 0x48, 0x44, 0x44, 0x38}, // b (98)
-    {0x38, 0x44, 0x44, 0x44, 0x20}, // c (99)
-    {0x38, 0x44, 0x44, 0x48, 0x7F}, // d (100)
-    {0x38, 0x54, 0x54, 0x54, 0x18}, // e (101)
-    {0x08, 0x7E, 0x09, 0x01, 0x02}, // f (102)
-    {0x0C, 0x52, 0x52, 0x52, 0x3E}, // g (103)
-    {0x7F, 0x08, 0x04, 0x04, 0x78}, // h (104)
-    {0x00, 0x44, 0x7D, 0x40, 0x00}, // i (105)
-    {0x20, 0x40, 0x44, 0x3D, 0x00}, // j (106)
-    {0x7F, 0x10, 0x28, 0x44, 0x00}, // k (107)
-    {0x00, 0x41, 0x7F, 0x40, 0x00}, // l (108)
-    {0x7C, 0x04, 0x18, 0x04, 0x78}, // m (109)
-    {0x7C, 0x08, 0x04, 0x04, 0x78}, // n (110)
-    {0x38, 0x44, 0x44, 0x44, 0x38}, // o (111)
-    {0x7C, 0x14, 0x14, 0x14, 0x08}, // p (112)
-    {0x08, 0x14, 0x14, 0x18, 0x7C}, // q (113)
-    {0x7C, 0x08, 0x04, 0x04, 0x08}, // r (114)
-    {0x48, 0x54, 0x54, 0x54, 0x20}, // s (115)
-    {0x04, 0x3F, 0x44, 0x40, 0x20}, // t (116)
-    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // u (117)
-    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // v (118)
-    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // w (119)
-    {0x44, 0x28, 0x10, 0x28, 0x44}, // x (120)
-    {0x0C, 0x50, 0x50, 0x50, 0x3C}, // y (121)
-    {0x44, 0x64, 0x54, 0x4C, 0x44}, // z (122)
-    {0x00, 0x08, 0x36, 0x41, 0x00}, // { (123)
-    {0x00, 0x00, 0x7F, 0x00, 0x00}, // | (124)
-    {0x00, 0x41, 0x36, 0x08, 0x00}, // } (125)
-    {0x10, 0x08, 0x08, 0x10, 0x08}, // ~ (126)
+// 32位坐标收窄为int16：超出范围的值一定在画面外，收窄到边界值后仍在画面外（直接截断会回绕到画面内）
+static inline int16_t clamp16(int32_t v) {
+    return (int16_t)std::min<int32_t>(std::max<int32_t>(v, INT16_MIN), INT16_MAX);
+}
+
+#if SSD1306_INSTRUMENT
+// 最外层的绘图原语记录一次调用，并让作用域内低层写入的像素计入该原语
+class PrimScope {
+public:
+    PrimScope(uint8_t& current, ssd1306_counters_t& counters, uint8_t prim)
+        : current_(current), owner_(current == SSD1306_PRIM_NONE) {
+        if (owner_) {
+            current_ = prim;
+            counters.calls[prim]++;
+        }
+    }
+    ~PrimScope() {
+        if (owner_) {
+            current_ = SSD1306_PRIM_NONE;
+        }
+    }
+
+private:
+    uint8_t& current_;
+    bool owner_;
 };
 
+// 矩形与画面相交部分的像素数
+static uint32_t clipped_area(int16_t x, int16_t y, int16_t w, int16_t h, int16_t width, int16_t height) {
+    int32_t x0 = std::max<int32_t>(x, 0), x1 = std::min<int32_t>((int32_t)x + w, width);
+    int32_t y0 = std::max<int32_t>(y, 0), y1 = std::min<int32_t>((int32_t)y + h, height);
+    return (x1 > x0 && y1 > y0) ? (uint32_t)((x1 - x0) * (y1 - y0)) : 0;
+}
+
+uint64_t ssd1306_trace_now_us() {
+    return time_us_64();
+}
+
+#define SSD1306_PRIM(prim) PrimScope prim_scope_(prim_, counters_, prim)
+#define SSD1306_COUNT_PIXELS(n) \
+    (counters_.pixels[prim_ == SSD1306_PRIM_NONE ? SSD1306_PRIM_PIXEL : prim_] += (uint32_t)(n))
+// 按控制字节区分数据（0x40）与命令事务，字节数含控制字节
+#define SSD1306_COUNT_WRITE(control, bytes) \
+    ((control) == 0x40 ? (counters_.data_txns++, counters_.data_bytes += (uint32_t)(bytes)) \
+                       : (counters_.command_txns++, counters_.command_bytes += (uint32_t)(bytes)))
+#define SSD1306_FLUSH_TIMER_START() const uint64_t flush_start_us = time_us_64()
+#define SSD1306_FLUSH_TIMER_STOP() \
+    ssd1306_counters_record_flush(&counters_, (uint32_t)(time_us_64() - flush_start_us))
+#else
+#define SSD1306_PRIM(prim) ((void)0)
+#define SSD1306_COUNT_PIXELS(n) ((void)0)
+#define SSD1306_COUNT_WRITE(control, bytes) ((void)0)
+#define SSD1306_FLUSH_TIMER_START() ((void)0)
+#define SSD1306_FLUSH_TIMER_STOP() ((void)0)
+#endif
+
+// 面板默认对比度与COM引脚配置（由尺寸和供电方式决定）
+static constexpr uint8_t default_contrast(uint8_t vcc) {
+    return (SSD1306_LCDWIDTH == 128 && SSD1306_LCDHEIGHT == 64) ? (vcc == SSD1306_EXTERNALVCC ? 0x9F : 0xCF)
+         : (SSD1306_LCDWIDTH == 96 && SSD1306_LCDHEIGHT == 16)  ? (vcc == SSD1306_EXTERNALVCC ? 0x10 : 0xAF)
+         : 0x8F;
+}
+
+// 标记矩形与画面相交部分覆盖的块
+static void mark_tiles(TileMap* tiles, int16_t x, int16_t y, int16_t w, int16_t h, int16_t width, int16_t height) {
+    if (!tiles) {
+        return;
+    }
+    int32_t x0 = std::max<int32_t>(x, 0), x1 = std::min<int32_t>((int32_t)x + w, width) - 1;
+    int32_t y0 = std::max<int32_t>(y, 0), y1 = std::min<int32_t>((int32_t)y + h, height) - 1;
+    if (x0 <= x1 && y0 <= y1) {
+        tiles->markRect((int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1);
+    }
+}
+
+static constexpr uint8_t com_pins() {
+    return (SSD1306_LCDWIDTH == 128 && SSD1306_LCDHEIGHT == 64) ? 0x12 : 0x02;
+}
+
+// 初始化命令流：控制字节0x00（Co=0，后续字节全部为命令）加完整初始化序列，
+// 一次事务发送。SEGREMAP/COMSCAN取决于运行时的旋转与镜像，发送前在副本中改写
+#define SSD1306_INIT_SEGREMAP_INDEX 13
+#define SSD1306_INIT_COMSCAN_INDEX  14
+
+struct ssd1306_init_stream_t {
+    uint8_t bytes[26];
+};
+
+static constexpr ssd1306_init_stream_t make_init_stream(uint8_t vcc) {
+    return {{
+        0x00,                                           // 命令流
+        SSD1306_DISPLAYOFF,
+        SSD1306_SETDISPLAYCLOCKDIV, 0x80,               // 建议的比例 0x80
+        SSD1306_SETMULTIPLEX, SSD1306_LCDHEIGHT - 1,
+        SSD1306_SETDISPLAYOFFSET, 0x00,                 // 无偏移
+        SSD1306_SETSTARTLINE | 0x0,                     // 第0行
+        SSD1306_CHARGEPUMP, (uint8_t)(vcc == SSD1306_EXTERNALVCC ? 0x10 : 0x14),
+        SSD1306_MEMORYMODE, 0x00,                       // 水平寻址
+        SSD1306_SEGREMAP | 0x1,                         // 方向，发送前改写
+        SSD1306_COMSCANDEC,
+        SSD1306_SETCOMPINS, com_pins(),
+        SSD1306_SETCONTRAST, default_contrast(vcc),
+        SSD1306_SETPRECHARGE, (uint8_t)(vcc == SSD1306_EXTERNALVCC ? 0x22 : 0xF1),
+        SSD1306_SETVCOMDETECT, 0x40,
+        SSD1306_DISPLAYALLON_RESUME,
+        SSD1306_NORMALDISPLAY,
+        SSD1306_DISPLAYON
+    }};
+}
+
+static constexpr ssd1306_init_stream_t init_stream_internal = make_init_stream(SSD1306_SWITCHCAPVCC);
+static constexpr ssd1306_init_stream_t init_stream_external = make_init_stream(SSD1306_EXTERNALVCC);
+static_assert(init_stream_internal.bytes[SSD1306_INIT_SEGREMAP_INDEX] == (SSD1306_SEGREMAP | 0x1) &&
+              init_stream_internal.bytes[SSD1306_INIT_COMSCAN_INDEX] == SSD1306_COMSCANDEC,
+              "方向命令在初始化命令流中的位置与SSD1306_INIT_*_INDEX不符");
+static_assert(init_stream_internal.bytes[sizeof(init_stream_internal.bytes) - 1] == SSD1306_DISPLAYON,
+              "初始化命令流长度与内容不符");
+
 SSD1306::SSD1306(i2c_inst_t* i2c_instance, uint8_t address)
-    : i2c_(i2c_instance), address_(address), buffer_(nullptr), vccstate_(SSD1306_SWITCHCAPVCC),
-      contrast_(0x8F), cursor_x(0), cursor_y(0), textsize(1), textcolor(SSD1306_WHITE), textwrap(true) {
+    : i2c_(i2c_instance), bus_(nullptr), bus_device_{address, SSD1306_BUS_BAUDRATE}, address_(address), buffer_(nullptr), shadow_(nullptr), tiles_(nullptr), vccstate_(SSD1306_SWITCHCAPVCC),
+      contrast_(0x8F), sleeping_(false), rotation_(0), mirror_x_(false), mirror_y_(false),
+      width_(WIDTH), height_(HEIGHT), cursor_x(0), cursor_y(0), textsize(1), textcolor(SSD1306_WHITE), textwrap(true) {
+#if SSD1306_INSTRUMENT
+    prim_ = SSD1306_PRIM_NONE;
+    resetCounters();
+#endif
+}
+
+SSD1306::SSD1306(i2c_bus_t* bus, uint8_t address)
+    : i2c_(bus->i2c), bus_(bus), bus_device_{address, SSD1306_BUS_BAUDRATE}, address_(address),
+      buffer_(nullptr), shadow_(nullptr), tiles_(nullptr), vccstate_(SSD1306_SWITCHCAPVCC),
+      contrast_(0x8F), sleeping_(false), rotation_(0), mirror_x_(false), mirror_y_(false),
+      width_(WIDTH), height_(HEIGHT), cursor_x(0), cursor_y(0), textsize(1), textcolor(SSD1306_WHITE), textwrap(true) {
+#if SSD1306_INSTRUMENT
+    prim_ = SSD1306_PRIM_NONE;
+    resetCounters();
+#endif
 }
 
 SSD1306::~SSD1306() {
@@ -115,6 +154,7 @@ SSD1306::~SSD1306() {
 }
 
 bool SSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset) {
+    SSD1306_TRACE_SCOPE("ssd1306.begin");
     // 分配缓冲区
     if (!buffer_ && !(buffer_ = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) {
         return false;
@@ -122,102 +162,200 @@ bool SSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset) {
     
     clearDisplay();
     vccstate_ = switchvcc;
+    contrast_ = default_contrast(vccstate_);
     
     // 如果指定了I2C地址，使用它
     if (i2caddr) {
         address_ = i2caddr;
+        bus_device_.addr = i2caddr;
     }
     
-    // 初始化序列
-    static const uint8_t init1[] = {
-        SSD1306_DISPLAYOFF,         // 0xAE
-        SSD1306_SETDISPLAYCLOCKDIV, // 0xD5
-        0x80,                       // 建议的比例 0x80
-        SSD1306_SETMULTIPLEX        // 0xA8
-    };
-    ssd1306_commandList(init1, sizeof(init1));
-    ssd1306_command(HEIGHT - 1);
-    
-    static const uint8_t init2[] = {
-        SSD1306_SETDISPLAYOFFSET,   // 0xD3
-        0x0,                        // 无偏移
-        SSD1306_SETSTARTLINE | 0x0, // 第0行
-        SSD1306_CHARGEPUMP          // 0x8D
-    };
-    ssd1306_commandList(init2, sizeof(init2));
-    
-    ssd1306_command((vccstate_ == SSD1306_EXTERNALVCC) ? 0x10 : 0x14);
-    
-    static const uint8_t init3[] = {
-        SSD1306_MEMORYMODE,         // 0x20
-        0x00,                       // 0x0 像ks0108一样工作
-        SSD1306_SEGREMAP | 0x1,
-        SSD1306_COMSCANDEC
-    };
-    ssd1306_commandList(init3, sizeof(init3));
-    
-    uint8_t comPins = 0x02;
-    contrast_ = 0x8F;
-    
-    if ((WIDTH == 128) && (HEIGHT == 32)) {
-        comPins = 0x02;
-        contrast_ = 0x8F;
-    } else if ((WIDTH == 128) && (HEIGHT == 64)) {
-        comPins = 0x12;
-        contrast_ = (vccstate_ == SSD1306_EXTERNALVCC) ? 0x9F : 0xCF;
-    } else if ((WIDTH == 96) && (HEIGHT == 16)) {
-        comPins = 0x2;
-        contrast_ = (vccstate_ == SSD1306_EXTERNALVCC) ? 0x10 : 0xAF;
+    uint8_t segremap, comscan;
+    orientationCommands(&segremap, &comscan);
+    
+    if (!reset) {
+        // 热启动：其余寄存器与GDDRAM都保持着复位前的内容
+        const uint8_t cmds[] = {
+            0x00,                                       // 命令流
+            SSD1306_CHARGEPUMP,
+            (uint8_t)((vccstate_ == SSD1306_EXTERNALVCC) ? 0x10 : 0x14),
+            SSD1306_SETCONTRAST,
+            contrast_,
+            segremap,
+            comscan,
+            SSD1306_DISPLAYON
+        };
+        if (!writeRaw(cmds, sizeof(cmds))) {
+            return false;
+        }
+        sleeping_ = false;
+        return true;
     }
     
-    ssd1306_command(SSD1306_SETCOMPINS);
-    ssd1306_command(comPins);
-    ssd1306_command(SSD1306_SETCONTRAST);
-    ssd1306_command(contrast_);
-    
-    ssd1306_command(SSD1306_SETPRECHARGE);
-    ssd1306_command((vccstate_ == SSD1306_EXTERNALVCC) ? 0x22 : 0xF1);
-    
-    ssd1306_command(SSD1306_SETVCOMDETECT);
-    ssd1306_command(0x40);
-    
-    ssd1306_command(SSD1306_DISPLAYALLON_RESUME);
-    ssd1306_command(SSD1306_NORMALDISPLAY);
-    ssd1306_command(SSD1306_DISPLAYON);
+    const ssd1306_init_stream_t& init = (vccstate_ == SSD1306_EXTERNALVCC) ? init_stream_external
+                                                                           : init_stream_internal;
+    uint8_t cmds[sizeof(init.bytes)];
+    memcpy(cmds, init.bytes, sizeof(cmds));
+    cmds[SSD1306_INIT_SEGREMAP_INDEX] = segremap;
+    cmds[SSD1306_INIT_COMSCAN_INDEX] = comscan;
+    // 上电后GDDRAM内容随机
+    invalidatePanel();
+    if (!writeRaw(cmds, sizeof(cmds))) {
+        return false;
+    }
+    sleeping_ = false;
     
     return true;
 }
 
+void SSD1306::attachShadow(ssd1306_shadow_t* shadow) {
+    shadow_ = shadow;
+}
+
+void SSD1306::attachTiles(TileMap* tiles) {
+    tiles_ = tiles;
+    if (tiles_) {
+        tiles_->setSize(width_, height_);
+    }
+}
+
+void SSD1306::invalidatePanel() {
+    if (shadow_) {
+        shadow_->magic = 0;
+    }
+    if (tiles_) {
+        tiles_->invalidate();
+    }
+}
+
+#if SSD1306_INSTRUMENT
+void SSD1306::resetCounters() {
+    memset(&counters_, 0, sizeof(counters_));
+}
+#endif
+
 void SSD1306::display() {
-    static const uint8_t dlist1[] = {
+    displayRegion(0, width_ - 1, 0, (height_ + 7) / 8 - 1);
+}
+
+void SSD1306::displayRegion(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+    const uint8_t pages = (height_ + 7) / 8;
+    if (x1 >= width_) x1 = width_ - 1;
+    if (page1 >= pages) page1 = pages - 1;
+    if (x0 > x1 || page0 > page1) {
+        return;
+    }
+    SSD1306_TRACE_SCOPE("ssd1306.flush");
+    SSD1306_FLUSH_TIMER_START();
+    
+    // 逻辑窗口映射到物理窗口：90/270度时逻辑列对应物理行，逻辑页对应物理列
+    const bool transposed = (rotation_ & 1) != 0;
+    const uint8_t c0 = transposed ? page0 * 8 : x0;
+    const uint8_t c1 = transposed ? page1 * 8 + 7 : x1;
+    const uint8_t p0 = transposed ? x0 / 8 : page0;
+    const uint8_t p1 = transposed ? x1 / 8 : page1;
+    
+    // 设置地址窗口，水平寻址模式下写满一页的窗口宽度后自动换到下一页
+    const uint8_t col_offset = (WIDTH == 64) ? 0x20 : 0;
+    const uint8_t dlist[] = {
         SSD1306_PAGEADDR,
-        0,                   // 页起始地址
-        0xFF,                // 页结束（不是真的，但在这里有效）
-        SSD1306_COLUMNADDR   // 列起始地址
+        p0,
+        p1,
+        SSD1306_COLUMNADDR,
+        (uint8_t)(col_offset + c0),
+        (uint8_t)(col_offset + c1)
     };
-    ssd1306_commandList(dlist1, sizeof(dlist1));
+    ssd1306_commandList(dlist, sizeof(dlist));
     
-    if (WIDTH == 64) {
-        ssd1306_command(0x20);             // 列起始
-        ssd1306_command(0x20 + WIDTH - 1); // 列结束地址
+    // 把窗口内各页的列段拼接后一次传输
+    const uint16_t span = c1 - c0 + 1;
+    uint8_t buffer[WIDTH * ((HEIGHT + 7) / 8) + 1];
+    uint16_t count = span * (p1 - p0 + 1);
+    buffer[0] = 0x40; // 数据模式
+    if (transposed) {
+        // 在传输时逐个8x8块转置，绘图函数无需做坐标变换
+        for (uint8_t p = p0; p <= p1; p++) {
+            uint8_t* out = &buffer[1 + (p - p0) * span];
+            for (uint8_t q = page0; q <= page1; q++) {
+                ssd1306_transpose8x8(&buffer_[q * width_ + p * 8], 1, &out[(q - page0) * 8], 1);
+            }
+        }
     } else {
-        ssd1306_command(0);           // 列起始
-        ssd1306_command((WIDTH - 1)); // 列结束地址
+        for (uint8_t p = p0; p <= p1; p++) {
+            memcpy(&buffer[1 + (p - p0) * span], &buffer_[p * WIDTH + c0], span);
+        }
     }
     
-    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
-    uint8_t* ptr = buffer_;
-    
-    // I2C传输
-    uint8_t buffer[count + 1];
-    buffer[0] = 0x40; // 数据模式
-    memcpy(&buffer[1], ptr, count);
+    // 传输期间影子失效，传输被复位打断时不会误用
+    if (shadow_) {
+        shadow_->magic = 0;
+    }
+    bool ok;
+    if (bus_) {
+        // 共享总线：按分片提交，分片之间RTC等高优先级事务可以插入
+        static const uint8_t data_header = 0x40;
+        i2c_bus_txn_t txn;
+        i2c_bus_txn_init(&txn, &bus_device_, &buffer[1], count, nullptr, 0, I2C_BUS_PRIORITY_LOW);
+        txn.header = &data_header;
+        txn.header_len = 1;
+        txn.chunk = I2C_BUS_CHUNK_BYTES;
+        ok = i2c_bus_submit(bus_, &txn) && i2c_bus_wait(bus_, &txn);
+    } else {
+        ok = i2c_write_blocking(i2c_, address_, buffer, count + 1, false) == (int)(count + 1);
+    }
+    SSD1306_COUNT_WRITE(buffer[0], count + 1);
     
-    i2c_write_blocking(i2c_, address_, buffer, count + 1, false);
+    if (shadow_ && ok) {
+        for (uint8_t p = page0; p <= page1; p++) {
+            memcpy(&shadow_->frame[p * width_ + x0], &buffer_[p * width_ + x0], x1 - x0 + 1);
+        }
+        shadow_->magic = SSD1306_SHADOW_VALID;
+    }
+    if (tiles_) {
+        if (ok) {
+            tiles_->sent(buffer_, x0, x1, page0, page1);
+        } else {
+            tiles_->invalidate();
+        }
+    }
+    SSD1306_FLUSH_TIMER_STOP();
+}
+
+bool SSD1306::displayChanged() {
+    const uint8_t pages = (height_ + 7) / 8;
+    if (!shadow_ || shadow_->magic != SSD1306_SHADOW_VALID) {
+        display();
+        return true;
+    }
+    ssd1306_power_region_t r;
+    if (!ssd1306_power_dirty_region(buffer_, shadow_->frame, (uint8_t)width_, pages, &r)) {
+        return false;
+    }
+    displayRegion(r.x0, r.x1, r.page0, r.page1);
+    return true;
+}
+
+bool SSD1306::displayTiles() {
+    if (!tiles_) {
+        display();
+        return true;
+    }
+    if (tiles_->filter(buffer_) == 0) {
+        return false;
+    }
+    ssd1306_power_region_t windows[SSD1306_TILE_MAX_WINDOWS];
+    const uint8_t n = tiles_->windows(windows, SSD1306_TILE_MAX_WINDOWS);
+    for (uint8_t i = 0; i < n; i++) {
+        displayRegion(windows[i].x0, windows[i].x1, windows[i].page0, windows[i].page1);
+    }
+    return true;
 }
 
 void SSD1306::clearDisplay() {
     memset(buffer_, 0, WIDTH * ((HEIGHT + 7) / 8));
+    if (tiles_) {
+        tiles_->markAll();
+    }
 }
 
 void SSD1306::clear() {
@@ -229,51 +367,141 @@ void SSD1306::invertDisplay(bool i) {
 }
 
 void SSD1306::dim(bool dim) {
-    ssd1306_command(SSD1306_SETCONTRAST);
-    ssd1306_command(dim ? 0 : contrast_);
+    const uint8_t cmds[] = {SSD1306_SETCONTRAST, (uint8_t)(dim ? 0 : contrast_)};
+    ssd1306_commandList(cmds, sizeof(cmds));
+}
+
+void SSD1306::sleep() {
+    // 先关显示再停电荷泵，避免面板在升压电压下降过程中闪烁
+    static const uint8_t cmds[] = {
+        SSD1306_DISPLAYOFF,
+        SSD1306_CHARGEPUMP,
+        0x10
+    };
+    ssd1306_commandList(cmds, sizeof(cmds));
+    sleeping_ = true;
+}
+
+void SSD1306::wake() {
+    // 外部VCC时电荷泵始终关闭
+    const uint8_t cmds[] = {
+        SSD1306_CHARGEPUMP,
+        (uint8_t)((vccstate_ == SSD1306_EXTERNALVCC) ? 0x10 : 0x14),
+        SSD1306_DISPLAYON
+    };
+    ssd1306_commandList(cmds, sizeof(cmds));
+    sleeping_ = false;
+}
+
+uint8_t SSD1306::getContrast() const {
+    return contrast_;
 }
 
 void SSD1306::setContrast(uint8_t contrast) {
     contrast_ = contrast;
-    ssd1306_command(SSD1306_SETCONTRAST);
-    ssd1306_command(contrast);
+    const uint8_t cmds[] = {SSD1306_SETCONTRAST, contrast};
+    ssd1306_commandList(cmds, sizeof(cmds));
+}
+
+void SSD1306::setRotation(uint8_t rotation) {
+    rotation_ = rotation & 3;
+    width_ = (rotation_ & 1) ? HEIGHT : WIDTH;
+    height_ = (rotation_ & 1) ? WIDTH : HEIGHT;
+    applyOrientation();
+    // 面板内容相对新方向已失效，影子与块的逻辑布局也随之改变
+    if (tiles_) {
+        tiles_->setSize(width_, height_);
+    }
+    invalidatePanel();
+}
+
+void SSD1306::setMirror(bool mirror_x, bool mirror_y) {
+    mirror_x_ = mirror_x;
+    mirror_y_ = mirror_y;
+    applyOrientation();
+    invalidatePanel();
+}
+
+void SSD1306::orientationCommands(uint8_t* segremap, uint8_t* comscan) const {
+    // 以默认安装方向（SEGREMAP|1, COMSCANDEC）为基准：
+    // 180度 = 列、行同时翻转；90度 = 转置 + 列翻转；270度 = 转置 + 行翻转
+    bool flip_seg = (rotation_ == 1) || (rotation_ == 2);
+    bool flip_com = (rotation_ == 2) || (rotation_ == 3);
+    
+    // 镜像以逻辑坐标为准，90/270度时逻辑x轴对应物理行
+    if (rotation_ & 1) {
+        flip_com ^= mirror_x_;
+        flip_seg ^= mirror_y_;
+    } else {
+        flip_seg ^= mirror_x_;
+        flip_com ^= mirror_y_;
+    }
+    
+    *segremap = SSD1306_SEGREMAP | (flip_seg ? 0x0 : 0x1);
+    *comscan = flip_com ? SSD1306_COMSCANINC : SSD1306_COMSCANDEC;
+}
+
+void SSD1306::applyOrientation() {
+    uint8_t segremap, comscan;
+    orientationCommands(&segremap, &comscan);
+    const uint8_t cmds[] = {segremap, comscan};
+    ssd1306_commandList(cmds, sizeof(cmds));
+}
+
+void SSD1306::setStartLine(uint8_t line) {
+    ssd1306_command(SSD1306_SETSTARTLINE | (line & 0x3F));
 }
 
 void SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
-    if ((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT)) {
+    SSD1306_PRIM(SSD1306_PRIM_PIXEL);
+    if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
+        SSD1306_COUNT_PIXELS(1);
         switch (color) {
         case SSD1306_WHITE:
-            buffer_[x + (y / 8) * WIDTH] |= (1 << (y & 7));
+            buffer_[x + (y / 8) * width_] |= (1 << (y & 7));
             break;
         case SSD1306_BLACK:
-            buffer_[x + (y / 8) * WIDTH] &= ~(1 << (y & 7));
+            buffer_[x + (y / 8) * width_] &= ~(1 << (y & 7));
             break;
         case SSD1306_INVERSE:
-            buffer_[x + (y / 8) * WIDTH] ^= (1 << (y & 7));
+            buffer_[x + (y / 8) * width_] ^= (1 << (y & 7));
             break;
         }
+        if (tiles_) {
+            tiles_->markPixel(x, y);
+        }
     }
 }
 
 void SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    SSD1306_PRIM(SSD1306_PRIM_HLINE);
     drawFastHLineInternal(x, y, w, color);
 }
 
 void SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    SSD1306_PRIM(SSD1306_PRIM_VLINE);
     drawFastVLineInternal(x, y, h, color);
 }
 
 void SSD1306::drawFastHLineInternal(int16_t x, int16_t y, int16_t w, uint16_t color) {
-    if ((y >= 0) && (y < HEIGHT)) {
-        if (x < 0) {
-            w += x;
-            x = 0;
+    if ((y >= 0) && (y < height_)) {
+        // 在32位下裁剪：x与w都为负时，int16的w + x会回绕为正数
+        int32_t x0 = x, n = w;
+        if (x0 < 0) {
+            n += x0;
+            x0 = 0;
         }
-        if ((x + w) > WIDTH) {
-            w = (WIDTH - x);
+        if ((x0 + n) > width_) {
+            n = (width_ - x0);
         }
-        if (w > 0) {
-            uint8_t* pBuf = &buffer_[x + (y / 8) * WIDTH];
+        if (n > 0) {
+            x = (int16_t)x0;
+            w = (int16_t)n;
+            SSD1306_COUNT_PIXELS(w);
+            if (tiles_) {
+                tiles_->markRect(x, y, x + w - 1, y);
+            }
+            uint8_t* pBuf = &buffer_[x + (y / 8) * width_];
             uint8_t mask = 1 << (y & 7);
             switch (color) {
             case SSD1306_WHITE:
@@ -298,16 +526,23 @@ void SSD1306::drawFastHLineInternal(int16_t x, int16_t y, int16_t w, uint16_t co
 }
 
 void SSD1306::drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t color) {
-    if ((x >= 0) && (x < WIDTH)) {
-        if (y < 0) {
-            h += y;
-            y = 0;
+    if ((x >= 0) && (x < width_)) {
+        int32_t y0 = y, n = h;
+        if (y0 < 0) {
+            n += y0;
+            y0 = 0;
         }
-        if ((y + h) > HEIGHT) {
-            h = (HEIGHT - y);
+        if ((y0 + n) > height_) {
+            n = (height_ - y0);
         }
-        if (h > 0) {
-            uint8_t* pBuf = &buffer_[x + (y / 8) * WIDTH];
+        if (n > 0) {
+            y = (int16_t)y0;
+            h = (int16_t)n;
+            SSD1306_COUNT_PIXELS(h);
+            if (tiles_) {
+                tiles_->markRect(x, y, x, y + h - 1);
+            }
+            uint8_t* pBuf = &buffer_[x + (y / 8) * width_];
             uint8_t mod = (y & 7);
             uint8_t mask;
             uint8_t step;
@@ -329,7 +564,7 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t co
                     *pBuf ^= mask;
                     break;
                 }
-                pBuf += WIDTH;
+                pBuf += width_;
                 h -= mod;
             }
             
@@ -339,19 +574,19 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t co
                 case SSD1306_WHITE:
                     do {
                         *pBuf = 0xFF;
-                        pBuf += WIDTH;
+                        pBuf += width_;
                     } while (--step);
                     break;
                 case SSD1306_BLACK:
                     do {
                         *pBuf = 0x00;
-                        pBuf += WIDTH;
+                        pBuf += width_;
                     } while (--step);
                     break;
                 case SSD1306_INVERSE:
                     do {
                         *pBuf = ~*pBuf;
-                        pBuf += WIDTH;
+                        pBuf += width_;
                     } while (--step);
                     break;
                 }
@@ -378,68 +613,145 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t co
 }
 
 void SSD1306::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
-    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    SSD1306_PRIM(SSD1306_PRIM_LINE);
+    // 用32位计算：两端相距超过32767时int16的dx为负，且x1为32767时循环变量回绕、循环不会结束
+    int32_t ax = x0, ay = y0, bx = x1, by = y1;
+    const bool steep = abs(by - ay) > abs(bx - ax);
     if (steep) {
-        std::swap(x0, y0);
-        std::swap(x1, y1);
+        std::swap(ax, ay);
+        std::swap(bx, by);
     }
     
-    if (x0 > x1) {
-        std::swap(x0, x1);
-        std::swap(y0, y1);
+    if (ax > bx) {
+        std::swap(ax, bx);
+        std::swap(ay, by);
     }
     
-    int16_t dx, dy;
-    dx = x1 - x0;
-    dy = abs(y1 - y0);
-    
-    int16_t err = dx / 2;
-    int16_t ystep;
+    const int32_t dx = bx - ax;
+    const int32_t dy = abs(by - ay);
+    int32_t err = dx / 2;
+    const int32_t ystep = (ay < by) ? 1 : -1;
     
-    if (y0 < y1) {
-        ystep = 1;
-    } else {
-        ystep = -1;
+    // 主轴只遍历画面内的部分
+    const int32_t limit = (steep ? height_ : width_) - 1;
+    if (bx < 0 || ax > limit) {
+        return;
+    }
+    if (ax < 0) {
+        // 跳过k步：每步err减dy、为负时加dx并前进一行，err始终在[0, dx)内，
+        // 所以前进的行数n满足err - k * dy + n * dx在[0, dx)内（乘积不超过2^32，按无符号计算）
+        const uint32_t k = (uint32_t)-ax;
+        const uint32_t n = (k * (uint32_t)dy + (uint32_t)(dx - 1 - err)) / (uint32_t)dx;
+        err = (int32_t)((uint32_t)err + n * (uint32_t)dx - k * (uint32_t)dy);
+        ay += ystep * (int32_t)n;
+        ax = 0;
+    }
+    if (bx > limit) {
+        bx = limit;
     }
     
-    for (; x0 <= x1; x0++) {
+    for (; ax <= bx; ax++) {
         if (steep) {
-            drawPixel(y0, x0, color);
+            drawPixel((int16_t)ay, (int16_t)ax, color);
         } else {
-            drawPixel(x0, y0, color);
+            drawPixel((int16_t)ax, (int16_t)ay, color);
         }
         err -= dy;
         if (err < 0) {
-            y0 += ystep;
+            ay += ystep;
             err += dx;
         }
     }
 }
 
 void SSD1306::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    SSD1306_PRIM(SSD1306_PRIM_RECT);
     drawFastHLine(x, y, w, color);
-    drawFastHLine(x, y + h - 1, w, color);
+    drawFastHLine(x, clamp16((int32_t)y + h - 1), w, color);
     drawFastVLine(x, y, h, color);
-    drawFastVLine(x + w - 1, y, h, color);
+    drawFastVLine(clamp16((int32_t)x + w - 1), y, h, color);
 }
 
 void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-    for (int16_t i = x; i < x + w; i++) {
-        drawFastVLine(i, y, h, color);
+    SSD1306_PRIM(SSD1306_PRIM_RECT);
+    // 按页整行处理，代替逐列drawFastVLine
+    switch (color) {
+    case SSD1306_WHITE:
+        blendRect(x, y, w, h, SSD1306_BLEND_OR);
+        break;
+    case SSD1306_BLACK:
+        blendRect(x, y, w, h, SSD1306_BLEND_ANDNOT);
+        break;
+    case SSD1306_INVERSE:
+        blendRect(x, y, w, h, SSD1306_BLEND_XOR);
+        break;
+    }
+}
+
+void SSD1306::blend(const uint8_t* src, uint8_t op) {
+    SSD1306_PRIM(SSD1306_PRIM_BLEND);
+    SSD1306_COUNT_PIXELS(WIDTH * HEIGHT);
+    ssd1306_blend_buffer(buffer_, src, WIDTH * ((HEIGHT + 7) / 8), op);
+    if (tiles_) {
+        tiles_->markAll();
+    }
+}
+
+void SSD1306::blendImage(int16_t x, int16_t y, const uint8_t* img, int16_t w, int16_t h, uint8_t op) {
+    SSD1306_PRIM(SSD1306_PRIM_BLEND);
+    SSD1306_COUNT_PIXELS(clipped_area(x, y, w, h, width_, height_));
+    ssd1306_blend_image(buffer_, width_, height_, x, y, img, w, h, op);
+    mark_tiles(tiles_, x, y, w, h, width_, height_);
+}
+
+void SSD1306::blendRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t op) {
+    SSD1306_PRIM(SSD1306_PRIM_BLEND);
+    SSD1306_COUNT_PIXELS(clipped_area(x, y, w, h, width_, height_));
+    ssd1306_blend_rect(buffer_, width_, height_, x, y, w, h, op);
+    mark_tiles(tiles_, x, y, w, h, width_, height_);
+}
+
+void SSD1306::drawGrayImage(int16_t x, int16_t y, const uint8_t* gray, int16_t w, int16_t h, uint8_t dither) {
+    if (!gray || w <= 0 || h <= 0) {
+        return;
+    }
+
+    SSD1306_TRACE_SCOPE("ssd1306.gray");
+    SSD1306_PRIM(SSD1306_PRIM_GRAY);
+
+    if (dither == SSD1306_DITHER_FLOYD_STEINBERG) {
+        SSD1306_COUNT_PIXELS(clipped_area(x, y, w, h, width_, height_));
+        ssd1306_dither_fs(gray, w, h, buffer_, width_, height_, x, y);
+        mark_tiles(tiles_, x, y, w, h, width_, height_);
+        return;
+    }
+
+    // 每次抖动一个8行条带（最多WIDTH列）到页字节，再用合成内核复制到(x, y)处
+    uint8_t band[WIDTH];
+    for (int16_t row = 0; row < h; row += 8) {
+        const uint8_t rows = (h - row < 8) ? (uint8_t)(h - row) : 8;
+        for (int16_t col = 0; col < w; col += WIDTH) {
+            const int16_t n = (w - col < WIDTH) ? (w - col) : WIDTH;
+            ssd1306_dither_ordered_page(&gray[row * w + col], w, n, rows, band);
+            blendImage(x + col, y + row, band, n, rows, SSD1306_BLEND_COPY);
+        }
     }
 }
 
 void SSD1306::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-    
-    drawPixel(x0, y0 + r, color);
-    drawPixel(x0, y0 - r, color);
-    drawPixel(x0 + r, y0, color);
-    drawPixel(x0 - r, y0, color);
+    SSD1306_PRIM(SSD1306_PRIM_CIRCLE);
+    // 半径大于16383时int16的-2 * r溢出，圆心加减半径也会回绕，全部用32位计算
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+    auto plot = [&](int32_t px, int32_t py) { drawPixel(clamp16(px), clamp16(py), color); };
+    
+    plot(x0, y0 + r);
+    plot(x0, y0 - r);
+    plot(x0 + r, y0);
+    plot(x0 - r, y0);
     
     while (x < y) {
         if (f >= 0) {
@@ -451,32 +763,41 @@ void SSD1306::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
         ddF_x += 2;
         f += ddF_x;
         
-        drawPixel(x0 + x, y0 + y, color);
-        drawPixel(x0 - x, y0 + y, color);
-        drawPixel(x0 + x, y0 - y, color);
-        drawPixel(x0 - x, y0 - y, color);
-        drawPixel(x0 + y, y0 + x, color);
-        drawPixel(x0 - y, y0 + x, color);
-        drawPixel(x0 + y, y0 - x, color);
-        drawPixel(x0 - y, y0 - x, color);
+        plot(x0 + x, y0 + y);
+        plot(x0 - x, y0 + y);
+        plot(x0 + x, y0 - y);
+        plot(x0 - x, y0 - y);
+        plot(x0 + y, y0 + x);
+        plot(x0 - y, y0 + x);
+        plot(x0 + y, y0 - x);
+        plot(x0 - y, y0 - x);
     }
 }
 
 void SSD1306::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    SSD1306_PRIM(SSD1306_PRIM_CIRCLE);
+    drawVSpan(x0, (int32_t)y0 - r, 2 * (int32_t)r + 1, color);
     fillCircleHelper(x0, y0, r, 3, 0, color);
 }
 
+void SSD1306::drawVSpan(int32_t x, int32_t y, int32_t h, uint16_t color) {
+    // 先在32位下裁剪到画面，长度可达65535，不能直接收窄为int16
+    const int32_t y0 = std::max<int32_t>(y, 0), y1 = std::min<int32_t>(y + h, height_);
+    if (x >= 0 && x < width_ && y1 > y0) {
+        drawFastVLine((int16_t)x, (int16_t)y0, (int16_t)(y1 - y0), color);
+    }
+}
+
 void SSD1306::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-    int16_t px = x;
-    int16_t py = y;
-    
-    delta++;
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+    int32_t px = x;
+    int32_t py = y;
+    // 每列竖线长2 * y + 1，与drawCircle的上下两点对齐；delta为额外加长的像素数
+    const int32_t extra = delta + 1;
     
     while (x < y) {
         if (f >= 0) {
@@ -489,12 +810,12 @@ void SSD1306::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corner
         f += ddF_x;
         
         if (x < (y + 1)) {
-            if (corners & 1) drawFastVLine(x0 + x, y0 - y, 2 * y + 1 + delta, color);
-            if (corners & 2) drawFastVLine(x0 - x, y0 - y, 2 * y + 1 + delta, color);
+            if (corners & 1) drawVSpan(x0 + x, y0 - y, 2 * y + extra, color);
+            if (corners & 2) drawVSpan(x0 - x, y0 - y, 2 * y + extra, color);
         }
         if (y != py) {
-            if (corners & 1) drawFastVLine(x0 + py, y0 - px, 2 * px + 1 + delta, color);
-            if (corners & 2) drawFastVLine(x0 - py, y0 - px, 2 * px + 1 + delta, color);
+            if (corners & 1) drawVSpan(x0 + py, y0 - px, 2 * px + extra, color);
+            if (corners & 2) drawVSpan(x0 - py, y0 - px, 2 * px + extra, color);
             py = y;
         }
         px = x;
@@ -528,28 +849,28 @@ size_t SSD1306::write(uint8_t c) {
         return 1;
     }
     
-    if ((c < 32) || (c > 126)) return 0;
-    
-    // 确保索引在有效范围内
-    uint8_t index = c - 32;
-    if (index >= 95) return 0;  // 字体数组只有95个字符
+    // 字体之外的字节（含调用方传入的任意值）不绘制，索引不会越界
+    if ((c < SSD1306_FONT_FIRST) || (c > SSD1306_FONT_LAST)) return 0;
+    SSD1306_PRIM(SSD1306_PRIM_TEXT);
     
     uint8_t line;
-    for (int8_t i = 0; i < 5; i++) {
-        line = font5x7[index][i];
+    for (int8_t i = 0; i < SSD1306_FONT_WIDTH; i++) {
+        line = ssd1306_font5x7[c - SSD1306_FONT_FIRST][i];
         for (int8_t j = 0; j < 8; j++, line >>= 1) {
             if (line & 1) {
+                // 光标靠近int16边界时相加会回绕到画面内
                 if (textsize == 1) {
-                    drawPixel(cursor_x + i, cursor_y + j, textcolor);
+                    drawPixel(clamp16((int32_t)cursor_x + i), clamp16((int32_t)cursor_y + j), textcolor);
                 } else {
-                    fillRect(cursor_x + i * textsize, cursor_y + j * textsize, textsize, textsize, textcolor);
+                    fillRect(clamp16((int32_t)cursor_x + i * textsize), clamp16((int32_t)cursor_y + j * textsize),
+                             textsize, textsize, textcolor);
                 }
             }
         }
     }
     
     cursor_x += textsize * 6;
-    if (textwrap && (cursor_x > (WIDTH - textsize * 6))) {
+    if (textwrap && (cursor_x > (width_ - textsize * 6))) {
         cursor_x = 0;
         cursor_y += textsize * 8;
     }
@@ -558,6 +879,7 @@ size_t SSD1306::write(uint8_t c) {
 }
 
 void SSD1306::print(const char* str) {
+    SSD1306_TRACE_SCOPE("ssd1306.print");
     while (*str) {
         write(*str++);
     }
@@ -616,12 +938,19 @@ void SSD1306::ssd1306_command(uint8_t c) {
     uint8_t buffer[2];
     buffer[0] = 0x00; // 命令模式
     buffer[1] = c;
-    i2c_write_blocking(i2c_, address_, buffer, 2, false);
+    writeRaw(buffer, 2);
 }
 
+// 以控制字节0x00开头的命令流（与begin()相同），一次事务发送多条命令
 void SSD1306::ssd1306_commandList(const uint8_t* c, uint8_t n) {
-    for (uint8_t i = 0; i < n; i++) {
-        ssd1306_command(c[i]);
+    uint8_t buffer[SSD1306_COMMAND_STREAM_MAX + 1];
+    buffer[0] = 0x00; // 命令模式
+    while (n) {
+        const uint8_t count = n < SSD1306_COMMAND_STREAM_MAX ? n : SSD1306_COMMAND_STREAM_MAX;
+        memcpy(&buffer[1], c, count);
+        writeRaw(buffer, count + 1);
+        c += count;
+        n -= count;
     }
 }
 
@@ -629,6 +958,14 @@ void SSD1306::ssd1306_data(uint8_t* data, size_t size) {
     uint8_t* buffer = (uint8_t*)malloc(size + 1);
     buffer[0] = 0x40; // 数据模式
     memcpy(&buffer[1], data, size);
-    i2c_write_blocking(i2c_, address_, buffer, size + 1, false);
+    writeRaw(buffer, size + 1);
     free(buffer);
+}
+
+bool SSD1306::writeRaw(const uint8_t* data, size_t size) {
+    SSD1306_COUNT_WRITE(data[0], size);
+    if (bus_) {
+        return i2c_bus_transfer(bus_, &bus_device_, data, (uint16_t)size, nullptr, 0, I2C_BUS_PRIORITY_NORMAL);
+    }
+    return i2c_write_blocking(i2c_, address_, data, size, false) == (int)size;
 } 
\ No newline at end of file
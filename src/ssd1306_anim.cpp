@@ -0,0 +1,207 @@
+#include "ssd1306_anim.h"
+#include "pico/stdlib.h"
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+// Tween
+// ---------------------------------------------------------------------------
+
+Tween::Tween()
+    : from_(0), to_(0), start_us_(0), duration_us_(0), easing_(SSD1306_EASE_LINEAR) {
+}
+
+void Tween::start(int32_t from, int32_t to, uint32_t duration_us, uint64_t now_us, uint8_t easing) {
+    from_ = from;
+    to_ = to;
+    start_us_ = now_us;
+    duration_us_ = duration_us;
+    easing_ = easing;
+}
+
+int32_t Tween::value(uint64_t now_us) const {
+    if (done(now_us)) {
+        return to_;
+    }
+    if (now_us <= start_us_) {
+        return from_;
+    }
+
+    // 进度t为Q16定点数（0..65536）
+    uint64_t t = ((now_us - start_us_) << 16) / duration_us_;
+    uint64_t e;
+    switch (easing_) {
+    case SSD1306_EASE_IN_QUAD:
+        e = (t * t) >> 16;
+        break;
+    case SSD1306_EASE_OUT_QUAD:
+        e = (t * (131072 - t)) >> 16;
+        break;
+    case SSD1306_EASE_IN_OUT_QUAD:
+        if (t < 32768) {
+            e = (t * t) >> 15;
+        } else {
+            uint64_t r = 65536 - t;
+            e = 65536 - ((r * r) >> 15);
+        }
+        break;
+    default:
+        e = t;
+        break;
+    }
+
+    int64_t delta = (int64_t)to_ - from_;
+    return from_ + (int32_t)((delta * (int64_t)e) / 65536);
+}
+
+bool Tween::done(uint64_t now_us) const {
+    return now_us >= start_us_ + duration_us_;
+}
+
+// ---------------------------------------------------------------------------
+// FrameScheduler
+// ---------------------------------------------------------------------------
+
+FrameScheduler::FrameScheduler(uint32_t period_us)
+    : period_us_(period_us ? period_us : 1), next_frame_us_(0), render_start_us_(0), flush_start_us_(0) {
+    resetStats();
+}
+
+uint64_t FrameScheduler::waitNextFrame() {
+    uint64_t now = time_us_64();
+
+    if (next_frame_us_ == 0) {
+        next_frame_us_ = now;
+    } else if (now > next_frame_us_) {
+        // 落后：跳过已经错过的帧时刻
+        uint64_t missed = (now - next_frame_us_) / period_us_;
+        if (missed) {
+            stats_.dropped += (uint32_t)missed;
+            next_frame_us_ += missed * period_us_;
+        }
+    }
+
+    if (now < next_frame_us_) {
+        sleep_us(next_frame_us_ - now);
+    }
+
+    uint64_t frame_us = next_frame_us_;
+    next_frame_us_ += period_us_;
+    stats_.frames++;
+    return frame_us;
+}
+
+void FrameScheduler::setPeriod(uint32_t period_us) {
+    period_us_ = period_us ? period_us : 1;
+}
+
+void FrameScheduler::beginRender() {
+    render_start_us_ = time_us_64();
+}
+
+void FrameScheduler::endRender() {
+    uint32_t us = (uint32_t)(time_us_64() - render_start_us_);
+    stats_.render_us_last = us;
+    stats_.render_us_total += us;
+    if (us > stats_.render_us_max) stats_.render_us_max = us;
+}
+
+void FrameScheduler::beginFlush() {
+    flush_start_us_ = time_us_64();
+}
+
+void FrameScheduler::endFlush() {
+    uint32_t us = (uint32_t)(time_us_64() - flush_start_us_);
+    stats_.flush_us_last = us;
+    stats_.flush_us_total += us;
+    if (us > stats_.flush_us_max) stats_.flush_us_max = us;
+}
+
+void FrameScheduler::resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+// ---------------------------------------------------------------------------
+// Transition
+// ---------------------------------------------------------------------------
+
+Transition::Transition(SSD1306& oled)
+    : oled_(oled), from_(nullptr), to_(nullptr), type_(SSD1306_TRANSITION_WIPE_LEFT),
+      pos_(0), dirty_x0_(-1), dirty_x1_(-1), active_(false) {
+}
+
+void Transition::start(const uint8_t* from, const uint8_t* to, uint8_t type,
+                       uint32_t duration_us, uint64_t now_us, uint8_t easing) {
+    from_ = from;
+    to_ = to;
+    type_ = type;
+    pos_ = 0;
+    dirty_x0_ = dirty_x1_ = -1;
+    tween_.start(0, oled_.width(), duration_us, now_us, easing);
+    active_ = (from_ != nullptr) && (to_ != nullptr);
+}
+
+void Transition::markDirty(int16_t x0, int16_t x1) {
+    if (dirty_x0_ < 0 || x0 < dirty_x0_) dirty_x0_ = x0;
+    if (x1 > dirty_x1_) dirty_x1_ = x1;
+}
+
+bool Transition::render(uint64_t now_us) {
+    if (!active_) {
+        return false;
+    }
+
+    const int16_t w = oled_.width();
+    const int16_t pages = (oled_.height() + 7) / 8;
+    int16_t p = (int16_t)tween_.value(now_us);
+    if (p < pos_) p = pos_;
+    if (p > w) p = w;
+
+    if (tween_.done(now_us)) {
+        active_ = false;
+    }
+    if (p == pos_) {
+        return false;
+    }
+
+    uint8_t* buf = oled_.getBuffer();
+    switch (type_) {
+    case SSD1306_TRANSITION_WIPE_LEFT:
+        // 只复制新露出的列[pos_, p)
+        for (int16_t pg = 0; pg < pages; pg++) {
+            memcpy(&buf[pg * w + pos_], &to_[pg * w + pos_], p - pos_);
+        }
+        markDirty(pos_, p - 1);
+        break;
+    case SSD1306_TRANSITION_WIPE_RIGHT:
+        for (int16_t pg = 0; pg < pages; pg++) {
+            memcpy(&buf[pg * w + w - p], &to_[pg * w + w - p], p - pos_);
+        }
+        markDirty(w - p, w - pos_ - 1);
+        break;
+    case SSD1306_TRANSITION_SLIDE_LEFT:
+        for (int16_t pg = 0; pg < pages; pg++) {
+            memcpy(&buf[pg * w], &from_[pg * w + p], w - p);
+            memcpy(&buf[pg * w + w - p], &to_[pg * w], p);
+        }
+        markDirty(0, w - 1);
+        break;
+    case SSD1306_TRANSITION_SLIDE_RIGHT:
+        for (int16_t pg = 0; pg < pages; pg++) {
+            memcpy(&buf[pg * w], &to_[pg * w + w - p], p);
+            memcpy(&buf[pg * w + p], &from_[pg * w], w - p);
+        }
+        markDirty(0, w - 1);
+        break;
+    }
+
+    pos_ = p;
+    return true;
+}
+
+void Transition::flush() {
+    if (dirty_x0_ < 0) {
+        return;
+    }
+    oled_.displayRegion((uint8_t)dirty_x0_, (uint8_t)dirty_x1_, 0, (uint8_t)((oled_.height() + 7) / 8 - 1));
+    dirty_x0_ = dirty_x1_ = -1;
+}
@@ -0,0 +1,253 @@
+#include "ssd1306_blend.h"
+#include <cstring>
+
+namespace {
+
+// 32位字读写（通过memcpy避免未对齐访问和别名问题）
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store32(uint8_t* p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+inline bool isAligned32(const void* p) {
+    return ((uintptr_t)p & 3) == 0;
+}
+
+// 将字节复制到32位字的每个字节中
+inline uint32_t splat8(uint8_t b) {
+    return 0x01010101u * b;
+}
+
+// 混合操作（OP为编译期常量，switch在实例化时被消除）
+template <uint8_t OP, typename T>
+inline T blendOp(T d, T s) {
+    switch (OP) {
+    case SSD1306_BLEND_COPY:   return s;
+    case SSD1306_BLEND_OR:     return d | s;
+    case SSD1306_BLEND_AND:    return d & s;
+    case SSD1306_BLEND_XOR:    return d ^ s;
+    case SSD1306_BLEND_ANDNOT: return d & ~s;
+    }
+    return d;
+}
+
+// 只在掩码为1的位上应用混合结果
+template <uint8_t OP, typename T>
+inline T blendMasked(T d, T s, T m) {
+    return d ^ ((blendOp<OP, T>(d, s) ^ d) & m);
+}
+
+template <uint8_t OP>
+void blendBufferKernel(uint8_t* dst, const uint8_t* src, size_t size) {
+    // 头部：处理到dst按字对齐
+    while (size && !isAligned32(dst)) {
+        *dst = blendOp<OP, uint8_t>(*dst, *src);
+        dst++;
+        src++;
+        size--;
+    }
+    // 主体：每次4个字（16字节）
+    while (size >= 16) {
+        store32(dst,      blendOp<OP, uint32_t>(load32(dst),      load32(src)));
+        store32(dst + 4,  blendOp<OP, uint32_t>(load32(dst + 4),  load32(src + 4)));
+        store32(dst + 8,  blendOp<OP, uint32_t>(load32(dst + 8),  load32(src + 8)));
+        store32(dst + 12, blendOp<OP, uint32_t>(load32(dst + 12), load32(src + 12)));
+        dst += 16;
+        src += 16;
+        size -= 16;
+    }
+    while (size >= 4) {
+        store32(dst, blendOp<OP, uint32_t>(load32(dst), load32(src)));
+        dst += 4;
+        src += 4;
+        size -= 4;
+    }
+    // 尾部
+    while (size--) {
+        *dst = blendOp<OP, uint8_t>(*dst, *src);
+        dst++;
+        src++;
+    }
+}
+
+// 单页行内核：源 = (cur << s) | (prev >> (8 - s))，按页内掩码m合成
+// cur/prev为nullptr表示该部分超出图像范围（视为0）
+template <uint8_t OP>
+void blendRowKernel(uint8_t* d, const uint8_t* cur, const uint8_t* prev,
+                    uint8_t s, uint8_t m, int16_t n) {
+    if (OP == SSD1306_BLEND_COPY && s == 0 && m == 0xFF && cur) {
+        // 按页对齐的整页复制
+        memcpy(d, cur, n);
+        return;
+    }
+    const uint8_t lo8 = (uint8_t)(0xFF << s);
+    const uint8_t hi8 = (uint8_t)(0xFF >> (8 - s));
+    const uint32_t lo32 = splat8(lo8);
+    const uint32_t hi32 = splat8(hi8);
+    const uint32_t m32 = splat8(m);
+    int16_t i = 0;
+
+    // 头部
+    for (; i < n && !isAligned32(d + i); i++) {
+        uint8_t sv = cur ? (uint8_t)(cur[i] << s) : 0;
+        if (prev) sv |= prev[i] >> (8 - s);
+        d[i] = blendMasked<OP, uint8_t>(d[i], sv, m);
+    }
+    // 主体：4列并行，字内按字节移位后用掩码截断跨字节的溢出位
+    for (; i + 4 <= n; i += 4) {
+        uint32_t sv = cur ? (load32(cur + i) << s) & lo32 : 0;
+        if (prev) sv |= (load32(prev + i) >> (8 - s)) & hi32;
+        store32(d + i, blendMasked<OP, uint32_t>(load32(d + i), sv, m32));
+    }
+    // 尾部
+    for (; i < n; i++) {
+        uint8_t sv = cur ? (uint8_t)(cur[i] << s) : 0;
+        if (prev) sv |= prev[i] >> (8 - s);
+        d[i] = blendMasked<OP, uint8_t>(d[i], sv, m);
+    }
+}
+
+template <uint8_t OP>
+void fillRowKernel(uint8_t* d, uint8_t m, int16_t n) {
+    const uint32_t m32 = splat8(m);
+    int16_t i = 0;
+    for (; i < n && !isAligned32(d + i); i++) {
+        d[i] = blendMasked<OP, uint8_t>(d[i], 0xFF, m);
+    }
+    for (; i + 4 <= n; i += 4) {
+        store32(d + i, blendMasked<OP, uint32_t>(load32(d + i), 0xFFFFFFFFu, m32));
+    }
+    for (; i < n; i++) {
+        d[i] = blendMasked<OP, uint8_t>(d[i], 0xFF, m);
+    }
+}
+
+// 页dp内行范围[ymin, ymax)对应的位掩码
+inline uint8_t pageMask(int32_t dp, int32_t ymin, int32_t ymax) {
+    int32_t top = dp * 8;
+    int32_t lo = (ymin > top) ? ymin - top : 0;
+    int32_t hi = (ymax < top + 8) ? ymax - top : 8;
+    return (uint8_t)((0xFF << lo) & (0xFF >> (8 - hi)));
+}
+
+// 裁剪结果
+struct Clip {
+    int32_t x0, x1;     // 目标列范围[x0, x1)
+    int32_t ymin, ymax; // 目标行范围[ymin, ymax)
+};
+
+inline bool clipRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                     int16_t buf_w, int16_t buf_h, Clip& c) {
+    c.x0 = (x > 0) ? x : 0;
+    c.x1 = (x + w < buf_w) ? x + w : buf_w;
+    c.ymin = (y > 0) ? y : 0;
+    c.ymax = (y + h < buf_h) ? y + h : buf_h;
+    return (c.x0 < c.x1) && (c.ymin < c.ymax);
+}
+
+template <uint8_t OP>
+void blendImageKernel(uint8_t* dst, int16_t buf_w, const Clip& c, int32_t x, int32_t y,
+                      const uint8_t* img, int16_t img_w, int16_t img_h) {
+    // 图像第0页对应的目标页bp及页内位移s（y可为负）
+    int32_t bp = (y >= 0) ? y / 8 : -((7 - y) / 8);
+    uint8_t s = (uint8_t)(y - bp * 8);
+    int32_t img_pages = (img_h + 7) / 8;
+    int32_t sx = c.x0 - x;
+    int16_t n = (int16_t)(c.x1 - c.x0);
+
+    for (int32_t dp = c.ymin / 8; dp <= (c.ymax - 1) / 8; dp++) {
+        int32_t k = dp - bp;
+        const uint8_t* cur = (k >= 0 && k < img_pages) ? &img[k * img_w + sx] : nullptr;
+        const uint8_t* prev = (s && k >= 1 && k - 1 < img_pages) ? &img[(k - 1) * img_w + sx] : nullptr;
+        blendRowKernel<OP>(&dst[dp * buf_w + c.x0], cur, prev, s,
+                           pageMask(dp, c.ymin, c.ymax), n);
+    }
+}
+
+template <uint8_t OP>
+void blendRectKernel(uint8_t* dst, int16_t buf_w, const Clip& c) {
+    int16_t n = (int16_t)(c.x1 - c.x0);
+    for (int32_t dp = c.ymin / 8; dp <= (c.ymax - 1) / 8; dp++) {
+        fillRowKernel<OP>(&dst[dp * buf_w + c.x0], pageMask(dp, c.ymin, c.ymax), n);
+    }
+}
+
+} // namespace
+
+void ssd1306_blend_buffer(uint8_t* dst, const uint8_t* src, size_t size, uint8_t op) {
+    if (!dst || !src) {
+        return;
+    }
+    switch (op) {
+    case SSD1306_BLEND_COPY:   memcpy(dst, src, size); break;
+    case SSD1306_BLEND_OR:     blendBufferKernel<SSD1306_BLEND_OR>(dst, src, size); break;
+    case SSD1306_BLEND_AND:    blendBufferKernel<SSD1306_BLEND_AND>(dst, src, size); break;
+    case SSD1306_BLEND_XOR:    blendBufferKernel<SSD1306_BLEND_XOR>(dst, src, size); break;
+    case SSD1306_BLEND_ANDNOT: blendBufferKernel<SSD1306_BLEND_ANDNOT>(dst, src, size); break;
+    }
+}
+
+void ssd1306_blend_masked(uint8_t* dst, const uint8_t* src, const uint8_t* mask, size_t size) {
+    if (!dst || !src || !mask) {
+        return;
+    }
+    while (size && !isAligned32(dst)) {
+        *dst = blendMasked<SSD1306_BLEND_COPY, uint8_t>(*dst, *src, *mask);
+        dst++;
+        src++;
+        mask++;
+        size--;
+    }
+    while (size >= 4) {
+        store32(dst, blendMasked<SSD1306_BLEND_COPY, uint32_t>(load32(dst), load32(src), load32(mask)));
+        dst += 4;
+        src += 4;
+        mask += 4;
+        size -= 4;
+    }
+    while (size--) {
+        *dst = blendMasked<SSD1306_BLEND_COPY, uint8_t>(*dst, *src, *mask);
+        dst++;
+        src++;
+        mask++;
+    }
+}
+
+void ssd1306_blend_image(uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                         int16_t x, int16_t y,
+                         const uint8_t* img, int16_t img_w, int16_t img_h,
+                         uint8_t op) {
+    Clip c;
+    if (!dst || !img || img_w <= 0 || img_h <= 0 ||
+        !clipRect(x, y, img_w, img_h, buf_w, buf_h, c)) {
+        return;
+    }
+    switch (op) {
+    case SSD1306_BLEND_COPY:   blendImageKernel<SSD1306_BLEND_COPY>(dst, buf_w, c, x, y, img, img_w, img_h); break;
+    case SSD1306_BLEND_OR:     blendImageKernel<SSD1306_BLEND_OR>(dst, buf_w, c, x, y, img, img_w, img_h); break;
+    case SSD1306_BLEND_AND:    blendImageKernel<SSD1306_BLEND_AND>(dst, buf_w, c, x, y, img, img_w, img_h); break;
+    case SSD1306_BLEND_XOR:    blendImageKernel<SSD1306_BLEND_XOR>(dst, buf_w, c, x, y, img, img_w, img_h); break;
+    case SSD1306_BLEND_ANDNOT: blendImageKernel<SSD1306_BLEND_ANDNOT>(dst, buf_w, c, x, y, img, img_w, img_h); break;
+    }
+}
+
+void ssd1306_blend_rect(uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                        int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint8_t op) {
+    Clip c;
+    if (!dst || w <= 0 || h <= 0 || !clipRect(x, y, w, h, buf_w, buf_h, c)) {
+        return;
+    }
+    switch (op) {
+    case SSD1306_BLEND_COPY:
+    case SSD1306_BLEND_OR:     blendRectKernel<SSD1306_BLEND_OR>(dst, buf_w, c); break;
+    case SSD1306_BLEND_AND:    break; // 与全1相与不改变内容
+    case SSD1306_BLEND_XOR:    blendRectKernel<SSD1306_BLEND_XOR>(dst, buf_w, c); break;
+    case SSD1306_BLEND_ANDNOT: blendRectKernel<SSD1306_BLEND_ANDNOT>(dst, buf_w, c); break;
+    }
+}
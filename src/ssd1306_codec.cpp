@@ -0,0 +1,224 @@
+#include "ssd1306_codec.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// 差分字节：关键帧时prev为nullptr
+inline uint8_t deltaAt(const uint8_t* cur, const uint8_t* prev, size_t i) {
+    return prev ? (uint8_t)(cur[i] ^ prev[i]) : cur[i];
+}
+
+} // namespace
+
+size_t ssd1306_codec_encode(const uint8_t* cur, const uint8_t* prev, size_t size,
+                            uint8_t* out, size_t out_cap) {
+    if (!cur || !out || size > 0xFFFF || out_cap < SSD1306_CODEC_HEADER_SIZE) {
+        return 0;
+    }
+
+    out[0] = prev ? SSD1306_CODEC_DELTA : SSD1306_CODEC_KEY;
+    out[1] = (uint8_t)(size & 0xFF);
+    out[2] = (uint8_t)(size >> 8);
+    size_t o = SSD1306_CODEC_HEADER_SIZE;
+    size_t i = 0;
+
+    while (i < size) {
+        // 零游程
+        size_t z = 0;
+        while (i + z < size && deltaAt(cur, prev, i + z) == 0) {
+            z++;
+        }
+        if (z) {
+            while (z) {
+                size_t n = (z > 128) ? 128 : z;
+                if (o >= out_cap) return 0;
+                out[o++] = (uint8_t)(0x80 | (n - 1));
+                i += n;
+                z -= n;
+            }
+            continue;
+        }
+
+        // 字面游程：遇到至少3个连续零（或直到帧尾的零）时结束，
+        // 更短的零留在字面里比拆成两个令牌更省
+        size_t start = i;
+        size_t n = 0;
+        while (i < size && n < 128) {
+            if (deltaAt(cur, prev, i) == 0) {
+                size_t run = 0;
+                while (i + run < size && run < 3 && deltaAt(cur, prev, i + run) == 0) {
+                    run++;
+                }
+                if (run >= 3 || i + run == size) {
+                    break;
+                }
+            }
+            i++;
+            n++;
+        }
+
+        if (o + 1 + n > out_cap) return 0;
+        out[o++] = (uint8_t)(n - 1);
+        for (size_t k = start; k < start + n; k++) {
+            out[o++] = deltaAt(cur, prev, k);
+        }
+    }
+
+    return o;
+}
+
+bool ssd1306_codec_decode(const uint8_t* in, size_t in_len, uint8_t* frame, size_t size) {
+    if (!in || !frame || in_len < SSD1306_CODEC_HEADER_SIZE) {
+        return false;
+    }
+
+    const uint8_t type = in[0];
+    const size_t raw = in[1] | (in[2] << 8);
+    if (raw != size || (type != SSD1306_CODEC_KEY && type != SSD1306_CODEC_DELTA)) {
+        return false;
+    }
+    if (type == SSD1306_CODEC_KEY) {
+        memset(frame, 0, size);
+    }
+
+    size_t i = SSD1306_CODEC_HEADER_SIZE;
+    size_t pos = 0;
+    while (i < in_len) {
+        uint8_t tok = in[i++];
+        size_t n = (tok & 0x7F) + 1;
+        if (pos + n > size) {
+            return false;
+        }
+        if (tok & 0x80) {
+            pos += n; // 零字节：异或不改变内容
+        } else {
+            if (i + n > in_len) {
+                return false;
+            }
+            for (size_t k = 0; k < n; k++) {
+                frame[pos++] ^= in[i++];
+            }
+        }
+    }
+
+    return pos == size;
+}
+
+bool ssd1306_record_parse_line(const char* line, uint32_t* seq, uint64_t* timestamp_us,
+                               uint8_t* payload, size_t payload_cap, size_t* payload_len) {
+    if (!line || !seq || !timestamp_us || !payload || !payload_len) {
+        return false;
+    }
+
+    const char* p = strstr(line, SSD1306_RECORD_PREFIX);
+    if (!p) {
+        return false;
+    }
+    p += strlen(SSD1306_RECORD_PREFIX);
+
+    char* end;
+    const unsigned long long n = strtoull(p, &end, 10);
+    if (end == p || *end != ',' || n > UINT32_MAX) {
+        return false;
+    }
+    *seq = (uint32_t)n;
+    p = end + 1;
+
+    *timestamp_us = strtoull(p, &end, 10);
+    if (end == p || *end != ',') {
+        return false;
+    }
+    p = end + 1;
+
+    // base64解码，遇到换行、'='或字符串结束时停止
+    size_t len = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (; *p && *p != '\n' && *p != '\r' && *p != '='; p++) {
+        int v = base64Value(*p);
+        if (v < 0) {
+            return false;
+        }
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (len >= payload_cap) {
+                return false;
+            }
+            payload[len++] = (uint8_t)(acc >> bits);
+        }
+    }
+
+    *payload_len = len;
+    return len >= SSD1306_CODEC_HEADER_SIZE;
+}
+
+// ---------------------------------------------------------------------------
+// FrameRecorder
+// ---------------------------------------------------------------------------
+
+FrameRecorder::FrameRecorder(uint16_t key_interval)
+    : key_interval_(key_interval ? key_interval : 1), since_key_(0), have_prev_(false),
+      frames_(0), raw_bytes_(0), encoded_bytes_(0) {
+}
+
+void FrameRecorder::reset() {
+    have_prev_ = false;
+}
+
+bool FrameRecorder::record(const uint8_t* frame, size_t size, uint64_t timestamp_us) {
+    if (!frame || size > MAX_FRAME) {
+        return false;
+    }
+
+    const bool key = !have_prev_ || since_key_ >= key_interval_;
+    size_t n = ssd1306_codec_encode(frame, key ? nullptr : prev_, size, encoded_, sizeof(encoded_));
+    if (n == 0) {
+        return false;
+    }
+    memcpy(prev_, frame, size);
+    have_prev_ = true;
+    since_key_ = key ? 1 : since_key_ + 1;
+
+    // 分块base64输出，不需要整行缓冲区
+    // 序号即已输出的帧数，reset()不清零，回放端看到的序号始终连续
+    printf(SSD1306_RECORD_PREFIX "%lu,%llu,", (unsigned long)frames_, (unsigned long long)timestamp_us);
+    char chunk[64 + 1];
+    size_t c = 0;
+    for (size_t i = 0; i < n; i += 3) {
+        uint32_t v = (uint32_t)encoded_[i] << 16;
+        if (i + 1 < n) v |= (uint32_t)encoded_[i + 1] << 8;
+        if (i + 2 < n) v |= encoded_[i + 2];
+        chunk[c++] = kBase64[(v >> 18) & 0x3F];
+        chunk[c++] = kBase64[(v >> 12) & 0x3F];
+        chunk[c++] = (i + 1 < n) ? kBase64[(v >> 6) & 0x3F] : '=';
+        chunk[c++] = (i + 2 < n) ? kBase64[v & 0x3F] : '=';
+        if (c == 64) {
+            chunk[c] = '\0';
+            fputs(chunk, stdout);
+            c = 0;
+        }
+    }
+    chunk[c] = '\0';
+    fputs(chunk, stdout);
+    fputs("\n", stdout);
+
+    frames_++;
+    raw_bytes_ += size;
+    encoded_bytes_ += n;
+    return true;
+}
@@ -0,0 +1,278 @@
+#include "ssd1306_golden.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char kHex[] = "0123456789abcdef";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+inline bool pixelAt(const uint8_t* frame, uint16_t width, uint16_t x, uint16_t y) {
+    return (frame[(y / 8) * width + x] >> (y & 7)) & 1;
+}
+
+// 跳过PBM头中的空白与注释
+int nextToken(FILE* in) {
+    int c = fgetc(in);
+    while (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#') {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = fgetc(in);
+            }
+        }
+        c = fgetc(in);
+    }
+    return c;
+}
+
+bool readNumber(FILE* in, unsigned* value) {
+    int c = nextToken(in);
+    if (c < '0' || c > '9') {
+        return false;
+    }
+    unsigned v = 0;
+    while (c >= '0' && c <= '9') {
+        v = v * 10 + (c - '0');
+        c = fgetc(in);
+    }
+    // 数字后的单个空白字符属于头，P4的位图数据紧随其后
+    *value = v;
+    return true;
+}
+
+} // namespace
+
+uint32_t ssd1306_frame_hash(const uint8_t* frame, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ frame[i]) * 16777619u;
+    }
+    return h;
+}
+
+void ssd1306_golden_record(const char* name, uint32_t render_us, const uint8_t* frame, size_t size) {
+    printf(SSD1306_GOLDEN_PREFIX "%s,%lu,%08lx,", name, (unsigned long)render_us,
+           (unsigned long)ssd1306_frame_hash(frame, size));
+    // 分块输出，不需要整行缓冲区
+    char chunk[64 + 1];
+    size_t c = 0;
+    for (size_t i = 0; i < size; i++) {
+        chunk[c++] = kHex[frame[i] >> 4];
+        chunk[c++] = kHex[frame[i] & 0x0F];
+        if (c == 64) {
+            chunk[c] = '\0';
+            fputs(chunk, stdout);
+            c = 0;
+        }
+    }
+    chunk[c] = '\0';
+    fputs(chunk, stdout);
+    fputs("\n", stdout);
+}
+
+bool ssd1306_golden_parse_line(const char* line, char* name, size_t name_cap, uint32_t* render_us,
+                               uint8_t* frame, size_t frame_cap, size_t* frame_len) {
+    const char* p = strstr(line, SSD1306_GOLDEN_PREFIX);
+    if (!p || name_cap == 0) {
+        return false;
+    }
+    p += strlen(SSD1306_GOLDEN_PREFIX);
+
+    const char* comma = strchr(p, ',');
+    if (!comma || comma == p || (size_t)(comma - p) >= name_cap) {
+        return false;
+    }
+    memcpy(name, p, comma - p);
+    name[comma - p] = '\0';
+    p = comma + 1;
+
+    char* end;
+    unsigned long us = strtoul(p, &end, 10);
+    if (end == p || *end != ',') {
+        return false;
+    }
+    p = end + 1;
+    unsigned long hash = strtoul(p, &end, 16);
+    if (end == p || *end != ',') {
+        return false;
+    }
+    p = end + 1;
+
+    size_t len = 0;
+    while (true) {
+        int hi = hexValue(p[0]);
+        if (hi < 0) {
+            break;
+        }
+        int lo = hexValue(p[1]);
+        if (lo < 0 || len >= frame_cap) {
+            return false;
+        }
+        frame[len++] = (uint8_t)(hi << 4 | lo);
+        p += 2;
+    }
+    if (len == 0 || ssd1306_frame_hash(frame, len) != (uint32_t)hash) {
+        return false;
+    }
+    *render_us = (uint32_t)us;
+    *frame_len = len;
+    return true;
+}
+
+void ssd1306_golden_cost_record(const char* name, const ssd1306_golden_cost_t* cost) {
+    printf(SSD1306_GOLDEN_COST_PREFIX "%s,%lu,%lu,%lu,%lu\n", name, (unsigned long)cost->pixels,
+           (unsigned long)cost->calls, (unsigned long)cost->txns, (unsigned long)cost->bytes);
+}
+
+bool ssd1306_golden_cost_parse_line(const char* line, char* name, size_t name_cap, ssd1306_golden_cost_t* cost) {
+    const char* p = strstr(line, SSD1306_GOLDEN_COST_PREFIX);
+    if (!p || name_cap == 0) {
+        return false;
+    }
+    p += strlen(SSD1306_GOLDEN_COST_PREFIX);
+
+    const char* comma = strchr(p, ',');
+    if (!comma || comma == p || (size_t)(comma - p) >= name_cap) {
+        return false;
+    }
+    memcpy(name, p, comma - p);
+    name[comma - p] = '\0';
+    p = comma;
+
+    uint32_t values[SSD1306_GOLDEN_COST_FIELDS];
+    for (uint8_t i = 0; i < SSD1306_GOLDEN_COST_FIELDS; i++) {
+        if (*p != ',') {
+            return false;
+        }
+        char* end;
+        values[i] = (uint32_t)strtoul(p + 1, &end, 10);
+        if (end == p + 1) {
+            return false;
+        }
+        p = end;
+    }
+    if (*p && *p != '\n' && *p != '\r') {
+        return false;
+    }
+    cost->pixels = values[0];
+    cost->calls = values[1];
+    cost->txns = values[2];
+    cost->bytes = values[3];
+    return true;
+}
+
+uint32_t ssd1306_golden_cost_field(const ssd1306_golden_cost_t* cost, uint8_t field) {
+    switch (field) {
+    case 0: return cost->pixels;
+    case 1: return cost->calls;
+    case 2: return cost->txns;
+    default: return cost->bytes;
+    }
+}
+
+const char* ssd1306_golden_cost_field_name(uint8_t field) {
+    static const char* const names[SSD1306_GOLDEN_COST_FIELDS] = {"像素", "原语调用", "I2C事务", "I2C字节"};
+    return field < SSD1306_GOLDEN_COST_FIELDS ? names[field] : "?";
+}
+
+bool ssd1306_pbm_write(FILE* out, const uint8_t* frame, uint16_t width, uint16_t height) {
+    fprintf(out, "P4\n%u %u\n", width, height);
+    // P4每行按字节对齐，最高位为最左像素，1为黑；帧中点亮的像素写为1（黑底白字的反色）
+    for (uint16_t y = 0; y < height; y++) {
+        uint8_t acc = 0;
+        for (uint16_t x = 0; x < width; x++) {
+            acc = (uint8_t)(acc << 1 | pixelAt(frame, width, x, y));
+            if ((x & 7) == 7 || x == width - 1) {
+                acc <<= 7 - (x & 7);
+                if (fputc(acc, out) == EOF) {
+                    return false;
+                }
+                acc = 0;
+            }
+        }
+    }
+    return true;
+}
+
+bool ssd1306_pbm_read(FILE* in, uint8_t* frame, uint16_t width, uint16_t height) {
+    if (fgetc(in) != 'P') {
+        return false;
+    }
+    const int kind = fgetc(in);
+    unsigned w, h;
+    if ((kind != '1' && kind != '4') || !readNumber(in, &w) || !readNumber(in, &h) || w != width || h != height) {
+        return false;
+    }
+
+    memset(frame, 0, (size_t)width * ((height + 7) / 8));
+    int byte = 0;
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++) {
+            bool on;
+            if (kind == '4') {
+                if ((x & 7) == 0 && (byte = fgetc(in)) == EOF) {
+                    return false;
+                }
+                on = (byte >> (7 - (x & 7))) & 1;
+            } else {
+                int c = nextToken(in);
+                if (c != '0' && c != '1') {
+                    return false;
+                }
+                on = c == '1';
+            }
+            if (on) {
+                frame[(y / 8) * width + x] |= 1 << (y & 7);
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t ssd1306_frame_diff(const uint8_t* actual, const uint8_t* expected, uint16_t width, uint16_t height,
+                            ssd1306_frame_diff_t* diff) {
+    memset(diff, 0, sizeof(*diff));
+    diff->x0 = width;
+    diff->y0 = height;
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++) {
+            if (pixelAt(actual, width, x, y) == pixelAt(expected, width, x, y)) {
+                continue;
+            }
+            diff->pixels++;
+            if (x < diff->x0) diff->x0 = x;
+            if (x > diff->x1) diff->x1 = x;
+            if (y < diff->y0) diff->y0 = y;
+            if (y > diff->y1) diff->y1 = y;
+        }
+    }
+    return diff->pixels;
+}
+
+void ssd1306_frame_print_diff(FILE* out, const uint8_t* actual, const uint8_t* expected, uint16_t width,
+                              uint16_t height, const ssd1306_frame_diff_t* diff) {
+    if (diff->pixels == 0) {
+        return;
+    }
+    const int x0 = diff->x0 >= 2 ? diff->x0 - 2 : 0;
+    const int y0 = diff->y0 >= 2 ? diff->y0 - 2 : 0;
+    const int x1 = diff->x1 + 2 < width ? diff->x1 + 2 : width - 1;
+    const int y1 = diff->y1 + 2 < height ? diff->y1 + 2 : height - 1;
+
+    fprintf(out, "     x=%d..%d\n", x0, x1);
+    for (int y = y0; y <= y1; y++) {
+        fprintf(out, "%3d  ", y);
+        for (int x = x0; x <= x1; x++) {
+            const bool a = pixelAt(actual, width, (uint16_t)x, (uint16_t)y);
+            const bool e = pixelAt(expected, width, (uint16_t)x, (uint16_t)y);
+            fputc(a ? (e ? '#' : '+') : (e ? '-' : '.'), out);
+        }
+        fputc('\n', out);
+    }
+}
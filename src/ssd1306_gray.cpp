@@ -0,0 +1,246 @@
+#include "ssd1306_gray.h"
+#include "pico/stdlib.h"
+#include <cstring>
+
+namespace {
+
+// 8x8 Bayer矩阵换算的反阈值：255 - (v * 4 + 2)
+// 像素点亮条件 g > t 等价于 g + (255 - t) 产生进位
+alignas(4) constexpr uint8_t kBayerInv[8][8] = {
+    {253, 125, 221,  93, 245, 117, 213,  85},
+    { 61, 189,  29, 157,  53, 181,  21, 149},
+    {205,  77, 237, 109, 197,  69, 229, 101},
+    { 13, 141,  45, 173,   5, 133,  37, 165},
+    {241, 113, 209,  81, 249, 121, 217,  89},
+    { 49, 177,  17, 145,  57, 185,  25, 153},
+    {193,  65, 225,  97, 201,  73, 233, 105},
+    {  1, 129,  33, 161,   9, 137,  41, 169},
+};
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store32(uint8_t* p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+inline void setPixel(uint8_t* buf, int16_t buf_w, int16_t x, int16_t y, bool on) {
+    uint8_t* p = &buf[x + (y / 8) * buf_w];
+    if (on) {
+        *p |= (1 << (y & 7));
+    } else {
+        *p &= ~(1 << (y & 7));
+    }
+}
+
+} // namespace
+
+void ssd1306_dither_ordered_page(const uint8_t* gray, int16_t stride, int16_t w,
+                                 uint8_t rows, uint8_t* out) {
+    if (rows > 8) rows = 8;
+    int16_t c = 0;
+
+    // 4列并行：每字节的进位位 = (g + t') >= 256，用半加避免跨字节进位
+    for (; c + 4 <= w; c += 4) {
+        uint32_t acc = 0;
+        for (uint8_t b = 0; b < rows; b++) {
+            uint32_t g = load32(&gray[b * stride + c]);
+            uint32_t t = load32(&kBayerInv[b][c & 4]);
+            uint32_t h = ((g >> 1) & 0x7F7F7F7Fu) + ((t >> 1) & 0x7F7F7F7Fu) + (g & t & 0x01010101u);
+            acc |= (h & 0x80808080u) >> (7 - b);
+        }
+        store32(&out[c], acc);
+    }
+
+    // 尾部
+    for (; c < w; c++) {
+        uint8_t v = 0;
+        for (uint8_t b = 0; b < rows; b++) {
+            if (gray[b * stride + c] + kBayerInv[b][c & 7] >= 256) {
+                v |= (1 << b);
+            }
+        }
+        out[c] = v;
+    }
+}
+
+bool ssd1306_dither_fs(const uint8_t* gray, int16_t w, int16_t h,
+                       uint8_t* dst, int16_t buf_w, int16_t buf_h,
+                       int16_t x, int16_t y) {
+    if (!gray || !dst || w <= 0 || h <= 0) {
+        return false;
+    }
+    if (w > SSD1306_DITHER_FS_MAX_WIDTH) {
+        return false;
+    }
+
+    // 误差以1/16为单位累积，两端各留一个哨兵
+    int16_t err_a[SSD1306_DITHER_FS_MAX_WIDTH + 2];
+    int16_t err_b[SSD1306_DITHER_FS_MAX_WIDTH + 2];
+    int16_t* cur = err_a;
+    int16_t* nxt = err_b;
+    memset(err_a, 0, sizeof(err_a));
+
+    for (int16_t row = 0; row < h; row++) {
+        memset(nxt, 0, (w + 2) * sizeof(int16_t));
+        const int16_t py = y + row;
+        const bool row_visible = (py >= 0) && (py < buf_h);
+
+        for (int16_t col = 0; col < w; col++) {
+            int16_t v = gray[row * w + col] + ((cur[col + 1] + 8) >> 4);
+            bool on = v > 127;
+            int16_t e = on ? v - 255 : v;
+
+            cur[col + 2] += e * 7;
+            nxt[col]     += e * 3;
+            nxt[col + 1] += e * 5;
+            nxt[col + 2] += e;
+
+            const int16_t px = x + col;
+            if (row_visible && px >= 0 && px < buf_w) {
+                setPixel(dst, buf_w, px, py, on);
+            }
+        }
+
+        int16_t* t = cur;
+        cur = nxt;
+        nxt = t;
+    }
+    return true;
+}
+
+void ssd1306_gray_to_planes(const uint8_t* gray, int16_t w, int16_t h, uint8_t planes,
+                            uint8_t* const* planes_out, int16_t buf_w, int16_t buf_h) {
+    if (planes == 0 || planes > SSD1306_GRAY_MAX_PLANES) {
+        return;
+    }
+
+    const size_t size = buf_w * ((buf_h + 7) / 8);
+    for (uint8_t k = 0; k < planes; k++) {
+        memset(planes_out[k], 0, size);
+    }
+
+    const int16_t cw = (w < buf_w) ? w : buf_w;
+    const int16_t ch = (h < buf_h) ? h : buf_h;
+    const uint8_t shift = 8 - planes;
+    for (int16_t row = 0; row < ch; row++) {
+        const uint8_t bit = 1 << (row & 7);
+        const int16_t page_offset = (row / 8) * buf_w;
+        for (int16_t col = 0; col < cw; col++) {
+            uint8_t q = gray[row * w + col] >> shift;
+            for (uint8_t k = 0; k < planes; k++) {
+                if (q & (1 << k)) {
+                    planes_out[k][page_offset + col] |= bit;
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// GrayscalePlayer
+// ---------------------------------------------------------------------------
+
+GrayscalePlayer::GrayscalePlayer(SSD1306& oled)
+    : oled_(oled), plane_count_(0), current_(0), saved_contrast_(0),
+      full_refresh_(true), frames_(0), bytes_sent_(0), start_us_(0) {
+    memset(planes_, 0, sizeof(planes_));
+    memset(contrast_, 0, sizeof(contrast_));
+}
+
+size_t GrayscalePlayer::frameSize() const {
+    return oled_.width() * ((oled_.height() + 7) / 8);
+}
+
+bool GrayscalePlayer::load(const uint8_t* gray, int16_t w, int16_t h, uint8_t planes,
+                           uint8_t* plane_storage, uint8_t base_contrast) {
+    if (!gray || !plane_storage || planes == 0 || planes > SSD1306_GRAY_MAX_PLANES) {
+        return false;
+    }
+
+    plane_count_ = planes;
+    for (uint8_t k = 0; k < planes; k++) {
+        planes_[k] = plane_storage + k * frameSize();
+        // 第k位平面的对比度与权重2^k成比例，最高位使用base_contrast
+        contrast_[k] = (uint8_t)((base_contrast * (1u << k)) >> (planes - 1));
+    }
+    ssd1306_gray_to_planes(gray, w, h, planes, planes_, oled_.width(), oled_.height());
+
+    saved_contrast_ = oled_.getContrast();
+    current_ = planes - 1;
+    full_refresh_ = true;
+    frames_ = 0;
+    bytes_sent_ = 0;
+    start_us_ = 0;
+    return true;
+}
+
+void GrayscalePlayer::step() {
+    if (plane_count_ == 0) {
+        return;
+    }
+    if (start_us_ == 0) {
+        start_us_ = time_us_64();
+    }
+
+    const uint8_t next = (current_ + 1) % plane_count_;
+    const int16_t w = oled_.width();
+    const int16_t pages = (oled_.height() + 7) / 8;
+    const uint8_t* prev = planes_[current_];
+    const uint8_t* cur = planes_[next];
+    memcpy(oled_.getBuffer(), cur, frameSize());
+
+    // 与上一个位平面不同的区域的包围盒
+    int16_t x0 = w, x1 = -1, p0 = pages, p1 = -1;
+    if (full_refresh_) {
+        x0 = 0;
+        x1 = w - 1;
+        p0 = 0;
+        p1 = pages - 1;
+        full_refresh_ = false;
+    } else {
+        for (int16_t p = 0; p < pages; p++) {
+            const uint8_t* a = &prev[p * w];
+            const uint8_t* b = &cur[p * w];
+            int16_t lo = 0;
+            while (lo < w && a[lo] == b[lo]) lo++;
+            if (lo == w) {
+                continue;
+            }
+            int16_t hi = w - 1;
+            while (a[hi] == b[hi]) hi--;
+            if (lo < x0) x0 = lo;
+            if (hi > x1) x1 = hi;
+            if (p < p0) p0 = p;
+            p1 = p;
+        }
+    }
+
+    oled_.setContrast(contrast_[next]);
+    if (x1 >= 0) {
+        oled_.displayRegion((uint8_t)x0, (uint8_t)x1, (uint8_t)p0, (uint8_t)p1);
+        bytes_sent_ += (x1 - x0 + 1) * (p1 - p0 + 1);
+    }
+
+    current_ = next;
+    frames_++;
+}
+
+void GrayscalePlayer::stop() {
+    if (plane_count_ == 0) {
+        return;
+    }
+    oled_.setContrast(saved_contrast_);
+    plane_count_ = 0;
+}
+
+uint32_t GrayscalePlayer::planesPerSecond() const {
+    if (start_us_ == 0 || frames_ < 2) {
+        return 0;
+    }
+    uint64_t elapsed = time_us_64() - start_us_;
+    return elapsed ? (uint32_t)((uint64_t)frames_ * 1000000 / elapsed) : 0;
+}
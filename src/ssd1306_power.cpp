@@ -0,0 +1,179 @@
+#include "ssd1306_power.h"
+#include <cstring>
+
+uint32_t ssd1306_power_region_bits(const ssd1306_power_region_t* region) {
+    uint32_t bytes = (uint32_t)(region->x1 - region->x0 + 1) * (region->page1 - region->page0 + 1);
+    return SSD1306_POWER_COMMAND_BITS(SSD1306_POWER_WINDOW_COMMANDS) + SSD1306_POWER_TXN_BITS(2 + bytes);
+}
+
+bool ssd1306_power_dirty_region(const uint8_t* cur, const uint8_t* prev, uint8_t width, uint8_t pages,
+                                ssd1306_power_region_t* region) {
+    bool dirty = false;
+    for (uint8_t p = 0; p < pages; p++) {
+        const uint8_t* a = cur + p * width;
+        const uint8_t* b = prev + p * width;
+        if (memcmp(a, b, width) == 0) {
+            continue;
+        }
+        // 该页必有不同的字节，两端扫描不会越界
+        uint8_t l = 0;
+        while (a[l] == b[l]) l++;
+        uint8_t r = width - 1;
+        while (a[r] == b[r]) r--;
+
+        if (!dirty) {
+            region->x0 = l;
+            region->x1 = r;
+            region->page0 = p;
+            dirty = true;
+        } else {
+            if (l < region->x0) region->x0 = l;
+            if (r > region->x1) region->x1 = r;
+        }
+        region->page1 = p;
+    }
+    return dirty;
+}
+
+PowerManager::PowerManager(const ssd1306_power_policy_t& policy, uint32_t bus_baud)
+    : policy_(policy), bus_baud_(bus_baud), last_activity_s_(0), last_plan_s_(0), last_minute_(0),
+      mode_(SSD1306_POWER_ACTIVE), panel_on_(true), dimmed_(false), started_(false), have_prev_(false) {
+    resetStats();
+}
+
+void PowerManager::setPolicy(const ssd1306_power_policy_t& policy) {
+    policy_ = policy;
+    have_prev_ = false;
+}
+
+void PowerManager::activity(uint32_t now_s) {
+    last_activity_s_ = now_s;
+}
+
+bool PowerManager::inNight(uint16_t minute_of_day) const {
+    uint16_t start = policy_.night_start_min;
+    uint16_t end = policy_.night_end_min;
+    if (start == end) {
+        return false;
+    }
+    return start < end ? (minute_of_day >= start && minute_of_day < end)
+                       : (minute_of_day >= start || minute_of_day < end);
+}
+
+ssd1306_power_plan_t PowerManager::plan(uint32_t now_s, uint16_t minute_of_day) {
+    const bool first = !started_;
+    if (first) {
+        started_ = true;
+        last_activity_s_ = now_s;
+        last_plan_s_ = now_s;
+    }
+
+    // 上次唤醒以来的时间计入当时的档位
+    uint32_t dt = now_s - last_plan_s_;
+    stats_.elapsed_s += dt;
+    stats_.mode_s[mode_] += dt;
+    if (panel_on_) {
+        stats_.panel_on_s += dt;
+    }
+    last_plan_s_ = now_s;
+    stats_.wakeups++;
+
+    // 夜间窗口内刚操作过时先点亮，看一眼（night_grace_s）之后再关闭；与idle_after_s无关，
+    // idle_after_s为0（不降频）时夜间窗口照常生效
+    uint32_t idle = now_s - last_activity_s_;
+    uint8_t mode = SSD1306_POWER_ACTIVE;
+    if ((policy_.off_after_s && idle >= policy_.off_after_s) ||
+        (inNight(minute_of_day) && idle >= policy_.night_grace_s)) {
+        mode = SSD1306_POWER_OFF;
+    } else if (policy_.idle_after_s && idle >= policy_.idle_after_s) {
+        mode = SSD1306_POWER_IDLE;
+    }
+
+    ssd1306_power_plan_t p;
+    p.mode = mode;
+    p.mode_changed = first || mode != mode_;
+    p.panel_on = mode != SSD1306_POWER_OFF;
+    p.panel_changed = p.panel_on != panel_on_;
+    p.dim = mode == SSD1306_POWER_IDLE && policy_.dim_when_idle;
+    p.dim_changed = p.panel_on && p.dim != dimmed_;
+    p.show_seconds = mode == SSD1306_POWER_ACTIVE;
+    // IDLE只在分钟变化时重绘；档位切换时秒的显示与否也变了，需要重绘
+    p.redraw = p.panel_on && (mode == SSD1306_POWER_ACTIVE || p.mode_changed || minute_of_day != last_minute_);
+    p.wake_period_s = mode == SSD1306_POWER_ACTIVE ? 1 : 60;
+
+    if (p.panel_changed) {
+        accountBits(SSD1306_POWER_COMMAND_BITS(SSD1306_POWER_PANEL_COMMANDS),
+                    SSD1306_POWER_COMMAND_BYTES(SSD1306_POWER_PANEL_COMMANDS), bus_baud_);
+    }
+    if (p.dim_changed) {
+        accountBits(SSD1306_POWER_COMMAND_BITS(SSD1306_POWER_DIM_COMMANDS),
+                    SSD1306_POWER_COMMAND_BYTES(SSD1306_POWER_DIM_COMMANDS), bus_baud_);
+        dimmed_ = p.dim;
+    }
+    if (p.redraw) {
+        last_minute_ = minute_of_day;
+    }
+    mode_ = mode;
+    panel_on_ = p.panel_on;
+    return p;
+}
+
+bool PowerManager::flush(const uint8_t* frame, uint8_t width, uint8_t pages, ssd1306_power_region_t* region) {
+    const size_t size = (size_t)width * pages;
+    if (policy_.partial_flush && have_prev_ && size <= MAX_FRAME) {
+        if (!ssd1306_power_dirty_region(frame, prev_, width, pages, region)) {
+            stats_.skipped++;
+            return false;
+        }
+    } else {
+        region->x0 = 0;
+        region->x1 = width - 1;
+        region->page0 = 0;
+        region->page1 = pages - 1;
+    }
+    if (size <= MAX_FRAME) {
+        memcpy(prev_, frame, size);
+        have_prev_ = true;
+    }
+
+    uint32_t bytes = (uint32_t)(region->x1 - region->x0 + 1) * (region->page1 - region->page0 + 1);
+    accountBits(ssd1306_power_region_bits(region), SSD1306_POWER_COMMAND_BYTES(SSD1306_POWER_WINDOW_COMMANDS) + 2 + bytes,
+                bus_baud_);
+    stats_.flushes++;
+    return true;
+}
+
+void PowerManager::accountTransfer(uint32_t bytes, uint32_t transactions, uint32_t baud) {
+    // 每个事务另有地址字节
+    accountBits(bytes * 9 + transactions * SSD1306_POWER_TXN_BITS(1), bytes + transactions, baud);
+}
+
+void PowerManager::accountAwake(uint32_t awake_us) {
+    stats_.awake_us += awake_us;
+}
+
+void PowerManager::accountBits(uint32_t bits, uint32_t bytes, uint32_t baud) {
+    stats_.bus_bits += bits;
+    stats_.bus_bytes += bytes;
+    if (baud) {
+        stats_.bus_us += ((uint64_t)bits * 1000000 + baud - 1) / baud;
+    }
+}
+
+void PowerManager::report(ssd1306_power_report_t* out) const {
+    memset(out, 0, sizeof(*out));
+    if (stats_.elapsed_s == 0) {
+        return;
+    }
+    const float per_hour = 3600.0f / (float)stats_.elapsed_s;
+    out->bus_ms = stats_.bus_us / 1000.0f * per_hour;
+    out->awake_ms = stats_.awake_us / 1000.0f * per_hour;
+    out->bus_bytes = stats_.bus_bytes * per_hour;
+    out->wakeups = stats_.wakeups * per_hour;
+    out->flushes = stats_.flushes * per_hour;
+    out->panel_on_pct = 100.0f * stats_.panel_on_s / (float)stats_.elapsed_s;
+}
+
+void PowerManager::resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+}
@@ -0,0 +1,336 @@
+#include "ssd1306_ref.h"
+#include "ssd1306_font.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+
+struct Frame {
+    uint8_t* data;
+    int64_t width;
+    int64_t height;
+};
+
+void pixel(const Frame& f, int64_t x, int64_t y, uint16_t color) {
+    if (x < 0 || x >= f.width || y < 0 || y >= f.height) {
+        return;
+    }
+    uint8_t& byte = f.data[x + (y / 8) * f.width];
+    const uint8_t bit = (uint8_t)(1 << (y & 7));
+    switch (color) {
+    case 0:
+        byte &= (uint8_t)~bit;
+        break;
+    case 1:
+        byte |= bit;
+        break;
+    case 2:
+        byte ^= bit;
+        break;
+    }
+}
+
+// 矩形[x, x + w) x [y, y + h)；循环范围限制在画面内，只为不在画面外空转
+void rect(const Frame& f, int64_t x, int64_t y, int64_t w, int64_t h, uint16_t color) {
+    const int64_t x0 = std::max<int64_t>(x, 0), x1 = std::min<int64_t>(x + w, f.width);
+    const int64_t y0 = std::max<int64_t>(y, 0), y1 = std::min<int64_t>(y + h, f.height);
+    for (int64_t j = y0; j < y1; j++) {
+        for (int64_t i = x0; i < x1; i++) {
+            pixel(f, i, j, color);
+        }
+    }
+}
+
+void line(const Frame& f, int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint16_t color) {
+    const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    const int64_t dx = x1 - x0;
+    const int64_t dy = std::abs(y1 - y0);
+    const int64_t ystep = (y0 < y1) ? 1 : -1;
+    int64_t err = dx / 2;
+    for (; x0 <= x1; x0++) {
+        if (steep) {
+            pixel(f, y0, x0, color);
+        } else {
+            pixel(f, x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+void circle(const Frame& f, int64_t x0, int64_t y0, int64_t r, uint16_t color) {
+    int64_t fv = 1 - r;
+    int64_t ddF_x = 1;
+    int64_t ddF_y = -2 * r;
+    int64_t x = 0;
+    int64_t y = r;
+    pixel(f, x0, y0 + r, color);
+    pixel(f, x0, y0 - r, color);
+    pixel(f, x0 + r, y0, color);
+    pixel(f, x0 - r, y0, color);
+    while (x < y) {
+        if (fv >= 0) {
+            y--;
+            ddF_y += 2;
+            fv += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        fv += ddF_x;
+        pixel(f, x0 + x, y0 + y, color);
+        pixel(f, x0 - x, y0 + y, color);
+        pixel(f, x0 + x, y0 - y, color);
+        pixel(f, x0 - x, y0 - y, color);
+        pixel(f, x0 + y, y0 + x, color);
+        pixel(f, x0 - y, y0 + x, color);
+        pixel(f, x0 + y, y0 - x, color);
+        pixel(f, x0 - y, y0 - x, color);
+    }
+}
+
+void fillCircle(const Frame& f, int64_t x0, int64_t y0, int64_t r, uint16_t color) {
+    rect(f, x0, y0 - r, 1, 2 * r + 1, color);
+    int64_t fv = 1 - r;
+    int64_t ddF_x = 1;
+    int64_t ddF_y = -2 * r;
+    int64_t x = 0;
+    int64_t y = r;
+    int64_t px = x;
+    int64_t py = y;
+    while (x < y) {
+        if (fv >= 0) {
+            y--;
+            ddF_y += 2;
+            fv += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        fv += ddF_x;
+        if (x < y + 1) {
+            rect(f, x0 + x, y0 - y, 1, 2 * y + 1, color);
+            rect(f, x0 - x, y0 - y, 1, 2 * y + 1, color);
+        }
+        if (y != py) {
+            rect(f, x0 + py, y0 - px, 1, 2 * px + 1, color);
+            rect(f, x0 - py, y0 - px, 1, 2 * px + 1, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void glyph(const Frame& f, int64_t x, int64_t y, uint8_t ch, uint8_t size, uint16_t color) {
+    if (ch < SSD1306_FONT_FIRST || ch > SSD1306_FONT_LAST) {
+        return;
+    }
+    const int64_t s = size ? size : 1;
+    for (int64_t i = 0; i < SSD1306_FONT_WIDTH; i++) {
+        const uint8_t bits = ssd1306_font5x7[ch - SSD1306_FONT_FIRST][i];
+        for (int64_t j = 0; j < 8; j++) {
+            if ((bits >> j) & 1) {
+                rect(f, x + i * s, y + j * s, s, s, color);
+            }
+        }
+    }
+}
+
+// 坐标：画面附近为主，夹杂int16极值与全范围随机值
+int16_t coord(uint32_t* state, int16_t dim) {
+    static const int16_t extremes[] = {INT16_MIN, INT16_MIN + 1, -1, 0, 1, INT16_MAX - 1, INT16_MAX};
+    const uint32_t r = ssd1306_ref_random(state);
+    switch (r & 15) {
+    case 0:
+        return extremes[(r >> 4) % (sizeof(extremes) / sizeof(extremes[0]))];
+    case 1:
+        return (int16_t)(r >> 16);
+    case 2:
+        return (int16_t)(dim - 1 + (int16_t)((r >> 4) % 3));   // 边缘：dim - 1、dim、dim + 1
+    default:
+        return (int16_t)((int32_t)((r >> 4) % (uint32_t)(dim + 48)) - 24);
+    }
+}
+
+// 长度、半径：以画面尺度的正值为主，也有0、负值与极值
+int16_t extent(uint32_t* state, int16_t dim) {
+    const uint32_t r = ssd1306_ref_random(state);
+    switch (r & 15) {
+    case 0:
+        return (r & 16) ? INT16_MAX : INT16_MIN;
+    case 1:
+        return (int16_t)(r >> 16);
+    case 2:
+        return (int16_t)(-(int32_t)((r >> 4) % 4));
+    default:
+        return (int16_t)((r >> 4) % (uint32_t)(dim + 16));
+    }
+}
+
+} // namespace
+
+const char* ssd1306_ref_prim_name(uint8_t prim) {
+    static const char* const names[SSD1306_REF_PRIM_COUNT] = {
+        "pixel", "hline", "vline", "rect", "fill_rect", "char", "line", "circle", "fill_circle",
+    };
+    return prim < SSD1306_REF_PRIM_COUNT ? names[prim] : "?";
+}
+
+uint32_t ssd1306_ref_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint8_t pick_prim(uint32_t r, uint32_t prim_mask) {
+    prim_mask &= SSD1306_REF_ALL_MASK;
+    if (!prim_mask) {
+        return SSD1306_REF_PIXEL;
+    }
+    uint32_t n = r % (uint32_t)__builtin_popcount(prim_mask);
+    for (uint8_t p = 0; p < SSD1306_REF_PRIM_COUNT; p++) {
+        if ((prim_mask >> p) & 1) {
+            if (n-- == 0) {
+                return p;
+            }
+        }
+    }
+    return SSD1306_REF_PIXEL;
+}
+
+void ssd1306_ref_random_case(uint32_t* state, uint32_t prim_mask, int16_t width, int16_t height,
+                             ssd1306_ref_case_t* c) {
+    c->prim = pick_prim(ssd1306_ref_random(state), prim_mask);
+    c->x = coord(state, width);
+    c->y = coord(state, height);
+    c->a = 0;
+    c->b = 0;
+    switch (c->prim) {
+    case SSD1306_REF_HLINE:
+        c->a = extent(state, width);
+        break;
+    case SSD1306_REF_VLINE:
+        c->a = extent(state, height);
+        break;
+    case SSD1306_REF_RECT:
+    case SSD1306_REF_FILL_RECT:
+        c->a = extent(state, width);
+        c->b = extent(state, height);
+        break;
+    case SSD1306_REF_LINE:
+        c->a = coord(state, width);
+        c->b = coord(state, height);
+        break;
+    case SSD1306_REF_CIRCLE:
+    case SSD1306_REF_FILL_CIRCLE:
+        c->a = extent(state, height);
+        break;
+    }
+    const uint32_t r = ssd1306_ref_random(state);
+    c->color = (uint16_t)(r % 3);
+    // 字号以1为主，也有放大、0与255；字符以字体范围内为主
+    switch ((r >> 4) & 15) {
+    case 0:
+        c->size = (uint8_t)(r >> 8);
+        break;
+    case 1:
+    case 2:
+    case 3:
+        c->size = (uint8_t)(2 + (r >> 8) % 7);
+        break;
+    default:
+        c->size = 1;
+        break;
+    }
+    c->ch = ((r >> 16) & 3) ? (uint8_t)(SSD1306_FONT_FIRST + (r >> 18) % (SSD1306_FONT_LAST - SSD1306_FONT_FIRST + 1))
+                            : (uint8_t)(r >> 24);
+}
+
+bool ssd1306_ref_case_from_bytes(const uint8_t* data, size_t size, uint32_t prim_mask, ssd1306_ref_case_t* c) {
+    if (size < 12) {
+        return false;
+    }
+    c->prim = pick_prim(data[0], prim_mask);
+    c->x = (int16_t)(data[1] | data[2] << 8);
+    c->y = (int16_t)(data[3] | data[4] << 8);
+    c->a = (int16_t)(data[5] | data[6] << 8);
+    c->b = (int16_t)(data[7] | data[8] << 8);
+    c->color = (uint16_t)(data[9] % 3);
+    c->size = data[10];
+    c->ch = data[11];
+    return true;
+}
+
+void ssd1306_ref_draw(uint8_t* frame, int16_t width, int16_t height, const ssd1306_ref_case_t* c) {
+    const Frame f = {frame, width, height};
+    switch (c->prim) {
+    case SSD1306_REF_PIXEL:
+        pixel(f, c->x, c->y, c->color);
+        break;
+    case SSD1306_REF_HLINE:
+        rect(f, c->x, c->y, c->a, 1, c->color);
+        break;
+    case SSD1306_REF_VLINE:
+        rect(f, c->x, c->y, 1, c->a, c->color);
+        break;
+    case SSD1306_REF_RECT:
+        rect(f, c->x, c->y, c->a, 1, c->color);
+        rect(f, c->x, (int64_t)c->y + c->b - 1, c->a, 1, c->color);
+        rect(f, c->x, c->y, 1, c->b, c->color);
+        rect(f, (int64_t)c->x + c->a - 1, c->y, 1, c->b, c->color);
+        break;
+    case SSD1306_REF_FILL_RECT:
+        rect(f, c->x, c->y, c->a, c->b, c->color);
+        break;
+    case SSD1306_REF_CHAR:
+        glyph(f, c->x, c->y, c->ch, c->size, c->color);
+        break;
+    case SSD1306_REF_LINE:
+        line(f, c->x, c->y, c->a, c->b, c->color);
+        break;
+    case SSD1306_REF_CIRCLE:
+        circle(f, c->x, c->y, c->a, c->color);
+        break;
+    case SSD1306_REF_FILL_CIRCLE:
+        fillCircle(f, c->x, c->y, c->a, c->color);
+        break;
+    }
+}
+
+int ssd1306_ref_describe(const ssd1306_ref_case_t* c, char* buf, size_t size) {
+    switch (c->prim) {
+    case SSD1306_REF_PIXEL:
+        return snprintf(buf, size, "drawPixel(%d, %d, %u)", c->x, c->y, c->color);
+    case SSD1306_REF_HLINE:
+        return snprintf(buf, size, "drawFastHLine(%d, %d, %d, %u)", c->x, c->y, c->a, c->color);
+    case SSD1306_REF_VLINE:
+        return snprintf(buf, size, "drawFastVLine(%d, %d, %d, %u)", c->x, c->y, c->a, c->color);
+    case SSD1306_REF_RECT:
+        return snprintf(buf, size, "drawRect(%d, %d, %d, %d, %u)", c->x, c->y, c->a, c->b, c->color);
+    case SSD1306_REF_FILL_RECT:
+        return snprintf(buf, size, "fillRect(%d, %d, %d, %d, %u)", c->x, c->y, c->a, c->b, c->color);
+    case SSD1306_REF_CHAR:
+        return snprintf(buf, size, "setCursor(%d, %d); setTextSize(%u); setTextColor(%u); write(0x%02X)", c->x,
+                        c->y, c->size, c->color, c->ch);
+    case SSD1306_REF_LINE:
+        return snprintf(buf, size, "drawLine(%d, %d, %d, %d, %u)", c->x, c->y, c->a, c->b, c->color);
+    case SSD1306_REF_CIRCLE:
+        return snprintf(buf, size, "drawCircle(%d, %d, %d, %u)", c->x, c->y, c->a, c->color);
+    case SSD1306_REF_FILL_CIRCLE:
+        return snprintf(buf, size, "fillCircle(%d, %d, %d, %u)", c->x, c->y, c->a, c->color);
+    }
+    return snprintf(buf, size, "?");
+}
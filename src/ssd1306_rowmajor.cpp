@@ -0,0 +1,297 @@
+#include "ssd1306_rowmajor.h"
+#include "ssd1306_blend.h"
+#include "ssd1306_font.h"
+#include "ssd1306_transform.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const uint8_t kNoOp = 0xFF;
+
+// 颜色对应的字节操作：白=置位，黑=清除，反色=取反
+inline uint8_t colorOp(uint16_t color) {
+    switch (color) {
+    case 0:
+        return SSD1306_BLEND_ANDNOT;
+    case 1:
+        return SSD1306_BLEND_OR;
+    case 2:
+        return SSD1306_BLEND_XOR;
+    default:
+        return kNoOp;
+    }
+}
+
+inline void apply(uint8_t* p, uint8_t mask, uint8_t op) {
+    switch (op) {
+    case SSD1306_BLEND_OR:
+        *p |= mask;
+        break;
+    case SSD1306_BLEND_ANDNOT:
+        *p &= (uint8_t)~mask;
+        break;
+    default:
+        *p ^= mask;
+        break;
+    }
+}
+
+} // namespace
+
+RowCanvas::RowCanvas(int16_t width, int16_t height)
+    : width_(std::min<int16_t>(width, MAX_WIDTH) & ~7), height_(std::min<int16_t>(height, MAX_HEIGHT) & ~7),
+      stride_((uint8_t)(width_ / 8)), cursor_x_(0), cursor_y_(0), textsize_(1), textcolor_(1), textwrap_(true) {
+    markAllDirty();
+    clear();
+}
+
+void RowCanvas::clear() {
+    memset(rows_, 0, sizeof(rows_));
+    // 页格式中只有上次转换时有内容的块需要重写
+    memcpy(dirty_, drawn_, sizeof(dirty_));
+}
+
+void RowCanvas::markAllDirty() {
+    const uint16_t all = (uint16_t)((1u << (width_ / 8)) - 1);
+    for (int16_t p = 0; p < MAX_HEIGHT / 8; p++) {
+        dirty_[p] = p < height_ / 8 ? all : 0;
+        drawn_[p] = dirty_[p];
+    }
+}
+
+bool RowCanvas::dirty() const {
+    for (int16_t p = 0; p < height_ / 8; p++) {
+        if (dirty_[p]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RowCanvas::markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    const uint16_t tiles = (uint16_t)(((2u << (x1 >> 3)) - 1) & ~((1u << (x0 >> 3)) - 1));
+    for (int16_t p = y0 >> 3; p <= (y1 >> 3); p++) {
+        dirty_[p] |= tiles;
+    }
+}
+
+void RowCanvas::span(int16_t y, int16_t x0, int16_t x1, uint8_t op) {
+    uint8_t* row = &rows_[y * stride_];
+    const int16_t b0 = x0 >> 3;
+    const int16_t b1 = x1 >> 3;
+    const uint8_t m0 = (uint8_t)(0xFF << (x0 & 7));
+    const uint8_t m1 = (uint8_t)(0xFF >> (7 - (x1 & 7)));
+    if (b0 == b1) {
+        apply(&row[b0], m0 & m1, op);
+        return;
+    }
+    apply(&row[b0], m0, op);
+    // 中间的整字节
+    const int16_t n = b1 - b0 - 1;
+    if (n > 0) {
+        if (op == SSD1306_BLEND_XOR) {
+            for (int16_t i = b0 + 1; i < b1; i++) {
+                row[i] = (uint8_t)~row[i];
+            }
+        } else {
+            memset(&row[b0 + 1], op == SSD1306_BLEND_OR ? 0xFF : 0x00, n);
+        }
+    }
+    apply(&row[b1], m1, op);
+}
+
+void RowCanvas::bits(int16_t y, int16_t x, uint32_t mask, int16_t n, uint8_t op) {
+    // mask的第i位对应x + i列，共n列（n + 7 <= 32，M0+上避免64位移位）
+    if (x < 0) {
+        if (-x >= n) {
+            return;
+        }
+        mask >>= -x;
+        n += x;
+        x = 0;
+    }
+    if (x + n > width_) {
+        n = width_ - x;
+        if (n <= 0) {
+            return;
+        }
+        mask &= ((uint32_t)1 << n) - 1;
+    }
+    if (!mask) {
+        return;
+    }
+    uint8_t* p = &rows_[y * stride_ + (x >> 3)];
+    mask <<= x & 7;
+    for (; mask; mask >>= 8, p++) {
+        if (mask & 0xFF) {
+            apply(p, (uint8_t)mask, op);
+        }
+    }
+}
+
+void RowCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    const uint8_t op = colorOp(color);
+    if (x < 0 || x >= width_ || y < 0 || y >= height_ || op == kNoOp) {
+        return;
+    }
+    apply(&rows_[y * stride_ + (x >> 3)], (uint8_t)(1 << (x & 7)), op);
+    dirty_[y >> 3] |= (uint16_t)(1u << (x >> 3));
+}
+
+void RowCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void RowCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void RowCanvas::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    // 右边与下边在32位下计算后收窄到int16范围，直接截断会回绕到第0行/列
+    const int16_t x1 = (int16_t)std::min<int32_t>(std::max<int32_t>((int32_t)x + w - 1, INT16_MIN), INT16_MAX);
+    const int16_t y1 = (int16_t)std::min<int32_t>(std::max<int32_t>((int32_t)y + h - 1, INT16_MIN), INT16_MAX);
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x1, y, h, color);
+}
+
+void RowCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    const uint8_t op = colorOp(color);
+    int32_t x0 = std::max<int32_t>(x, 0), x1 = std::min<int32_t>((int32_t)x + w, width_) - 1;
+    int32_t y0 = std::max<int32_t>(y, 0), y1 = std::min<int32_t>((int32_t)y + h, height_) - 1;
+    if (x0 > x1 || y0 > y1 || op == kNoOp) {
+        return;
+    }
+    if (x0 == x1) {
+        // 竖线：每行同一字节的同一位
+        const uint8_t mask = (uint8_t)(1 << (x0 & 7));
+        uint8_t* p = &rows_[y0 * stride_ + (x0 >> 3)];
+        for (int32_t yy = y0; yy <= y1; yy++, p += stride_) {
+            apply(p, mask, op);
+        }
+    } else {
+        for (int32_t yy = y0; yy <= y1; yy++) {
+            span((int16_t)yy, (int16_t)x0, (int16_t)x1, op);
+        }
+    }
+    markDirty((int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1);
+}
+
+void RowCanvas::setCursor(int16_t x, int16_t y) {
+    cursor_x_ = x;
+    cursor_y_ = y;
+}
+
+void RowCanvas::setTextSize(uint8_t s) {
+    textsize_ = (s > 0) ? s : 1;
+}
+
+void RowCanvas::setTextColor(uint16_t c) {
+    textcolor_ = c;
+}
+
+void RowCanvas::setTextWrap(bool w) {
+    textwrap_ = w;
+}
+
+size_t RowCanvas::write(uint8_t c) {
+    if (c == '\n') {
+        cursor_x_ = 0;
+        cursor_y_ += textsize_ * 8;
+        return 1;
+    } else if (c == '\r') {
+        cursor_x_ = 0;
+        return 1;
+    }
+    if ((c < SSD1306_FONT_FIRST) || (c > SSD1306_FONT_LAST)) return 0;
+
+    // 字形5列转置为8行，每行第i位对应第i列
+    uint8_t cols[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    memcpy(cols, ssd1306_font5x7[c - SSD1306_FONT_FIRST], SSD1306_FONT_WIDTH);
+    uint8_t glyph[8];
+    ssd1306_transpose8x8(cols, 1, glyph, 1);
+
+    const uint8_t s = textsize_;
+    const uint8_t op = colorOp(textcolor_);
+    if (op != kNoOp && s * SSD1306_FONT_WIDTH + 7 <= 32) {
+        // 每列横向放大为s位，逐行写入；脏块按整个字形一次标记
+        bool drawn = false;
+        for (uint8_t r = 0; r < 8; r++) {
+            if (!glyph[r]) {
+                continue;
+            }
+            uint32_t mask = glyph[r];
+            if (s > 1) {
+                mask = 0;
+                for (uint8_t i = 0; i < SSD1306_FONT_WIDTH; i++) {
+                    if (glyph[r] & (1 << i)) {
+                        mask |= (((uint32_t)1 << s) - 1) << (i * s);
+                    }
+                }
+            }
+            for (uint8_t k = 0; k < s; k++) {
+                const int32_t y = (int32_t)cursor_y_ + r * s + k;
+                if (y >= 0 && y < height_) {
+                    bits((int16_t)y, cursor_x_, mask, s * SSD1306_FONT_WIDTH, op);
+                    drawn = true;
+                }
+            }
+        }
+        const int32_t x0 = std::max<int32_t>(cursor_x_, 0);
+        const int32_t x1 = std::min<int32_t>((int32_t)cursor_x_ + s * SSD1306_FONT_WIDTH, width_) - 1;
+        if (drawn && x0 <= x1) {
+            const int32_t y0 = std::max<int32_t>(cursor_y_, 0);
+            const int32_t y1 = std::min<int32_t>((int32_t)cursor_y_ + s * 8, height_) - 1;
+            markDirty((int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1);
+        }
+    } else if (op != kNoOp) {
+        // 超大字号按像素块填充
+        for (uint8_t r = 0; r < 8; r++) {
+            for (uint8_t i = 0; i < SSD1306_FONT_WIDTH; i++) {
+                if (glyph[r] & (1 << i)) {
+                    fillRect(cursor_x_ + i * s, cursor_y_ + r * s, s, s, textcolor_);
+                }
+            }
+        }
+    }
+
+    cursor_x_ += s * 6;
+    if (textwrap_ && (cursor_x_ > (width_ - s * 6))) {
+        cursor_x_ = 0;
+        cursor_y_ += s * 8;
+    }
+    return 1;
+}
+
+void RowCanvas::print(const char* str) {
+    while (*str) {
+        write(*str++);
+    }
+}
+
+uint16_t RowCanvas::convert(uint8_t* page_frame) {
+    uint16_t converted = 0;
+    for (int16_t p = 0; p < height_ / 8; p++) {
+        uint16_t m = dirty_[p];
+        dirty_[p] = 0;
+        while (m) {
+            const int t = __builtin_ctz(m);
+            m &= m - 1;
+            uint8_t* out = &page_frame[p * width_ + t * 8];
+            ssd1306_transpose8x8(&rows_[p * 8 * stride_ + t], stride_, out, 1);
+            uint32_t any = 0;
+            for (int i = 0; i < 8; i++) {
+                any |= out[i];
+            }
+            if (any) {
+                drawn_[p] |= (uint16_t)(1u << t);
+            } else {
+                drawn_[p] &= (uint16_t)~(1u << t);
+            }
+            converted++;
+        }
+    }
+    return converted;
+}
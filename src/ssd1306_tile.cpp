@@ -0,0 +1,231 @@
+#include "ssd1306_tile.h"
+#include <cstring>
+
+namespace {
+
+// 块段：第r0-r1行块中的第c0-c1列块
+struct Span {
+    uint8_t c0, c1;
+    uint8_t r0, r1;
+};
+
+ssd1306_power_region_t toRegion(const Span& s) {
+    ssd1306_power_region_t r;
+    r.x0 = (uint8_t)(s.c0 * 8);
+    r.x1 = (uint8_t)(s.c1 * 8 + 7);
+    r.page0 = s.r0;
+    r.page1 = s.r1;
+    return r;
+}
+
+// murmur3的最终混合，是32位上的双射
+uint32_t fmix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t spanBits(const Span& s) {
+    const ssd1306_power_region_t r = toRegion(s);
+    return ssd1306_power_region_bits(&r);
+}
+
+} // namespace
+
+TileMap::TileMap(int16_t width, int16_t height) {
+    setSize(width, height);
+    resetStats();
+}
+
+void TileMap::setSize(int16_t width, int16_t height) {
+    cols_ = (uint8_t)((width + 7) / 8);
+    rows_ = (uint8_t)((height + 7) / 8);
+    if (cols_ * rows_ > SSD1306_TILE_MAX) {
+        rows_ = (uint8_t)(SSD1306_TILE_MAX / cols_);
+    }
+    invalidate();
+}
+
+void TileMap::invalidate() {
+    memset(known_, 0, sizeof(known_));
+    markAll();
+}
+
+void TileMap::markAll() {
+    memset(dirty_, 0, sizeof(dirty_));
+    const uint16_t n = (uint16_t)(cols_ * rows_);
+    for (uint16_t w = 0; w * 32 < n; w++) {
+        dirty_[w] = (n - w * 32 >= 32) ? 0xFFFFFFFFu : ((1u << (n - w * 32)) - 1);
+    }
+}
+
+void TileMap::markRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    const uint8_t c0 = (uint8_t)(x0 >> 3), c1 = (uint8_t)(x1 >> 3);
+    for (int16_t r = y0 >> 3; r <= (y1 >> 3); r++) {
+        // 一行中的块位连续，按字整段置位
+        uint16_t t = (uint16_t)(r * cols_ + c0);
+        const uint16_t last = (uint16_t)(r * cols_ + c1);
+        while (t <= last) {
+            const uint16_t end = (uint16_t)((t | 31) < last ? (t | 31) : last);
+            const uint32_t n = end - t + 1;
+            dirty_[t >> 5] |= (n == 32 ? 0xFFFFFFFFu : ((1u << n) - 1)) << (t & 31);
+            t = (uint16_t)(end + 1);
+        }
+    }
+}
+
+bool TileMap::dirty() const {
+    for (uint8_t w = 0; w < SSD1306_TILE_MAX / 32; w++) {
+        if (dirty_[w]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t TileMap::dirtyCount() const {
+    uint16_t n = 0;
+    for (uint8_t w = 0; w < SSD1306_TILE_MAX / 32; w++) {
+        n += (uint16_t)__builtin_popcount(dirty_[w]);
+    }
+    return n;
+}
+
+uint32_t TileMap::hashTile(const uint8_t* frame, uint16_t t) const {
+    const uint8_t* p = &frame[(t / cols_) * cols_ * 8 + (t % cols_) * 8];
+    uint32_t a, b;
+    memcpy(&a, p, 4);
+    memcpy(&b, p + 4, 4);
+    // fmix32(fmix32(a) ^ b)：只改变前4列或只改变后4列时哈希必然不同
+    return fmix32(fmix32(a) ^ b);
+}
+
+uint16_t TileMap::filter(const uint8_t* frame) {
+    uint16_t remaining = 0;
+    stats_.flushes++;
+    for (uint8_t w = 0; w < SSD1306_TILE_MAX / 32; w++) {
+        uint32_t m = dirty_[w];
+        while (m) {
+            const uint16_t t = (uint16_t)(w * 32 + __builtin_ctz(m));
+            m &= m - 1;
+            stats_.marked++;
+            if (test(known_, t) && hashTile(frame, t) == hash_[t]) {
+                reset(dirty_, t);
+                stats_.skipped++;
+            } else {
+                remaining++;
+            }
+        }
+    }
+    return remaining;
+}
+
+uint8_t TileMap::windows(ssd1306_power_region_t* out, uint8_t max) const {
+    Span spans[SSD1306_TILE_MAX_WINDOWS];
+    uint8_t n = 0;
+    bool overflow = false;
+    Span box = {cols_, 0, rows_, 0};
+
+    for (uint8_t r = 0; r < rows_ && !overflow; r++) {
+        uint8_t c = 0;
+        while (c < cols_) {
+            while (c < cols_ && !isDirty(c, r)) {
+                c++;
+            }
+            if (c == cols_) {
+                break;
+            }
+            Span s = {c, c, r, r};
+            // 向右延伸：连续的脏块直接并入，隔着干净块的下一段在合并不增加位数时并入
+            for (uint8_t next = (uint8_t)(c + 1); next < cols_; next++) {
+                if (!isDirty(next, r)) {
+                    continue;
+                }
+                const Span merged = {s.c0, next, r, r};
+                const Span alone = {next, next, r, r};
+                if (next == s.c1 + 1 || spanBits(merged) <= spanBits(s) + spanBits(alone)) {
+                    s.c1 = next;
+                } else {
+                    break;
+                }
+            }
+            c = (uint8_t)(s.c1 + 1);
+
+            if (s.c0 < box.c0) box.c0 = s.c0;
+            if (s.c1 > box.c1) box.c1 = s.c1;
+            if (r < box.r0) box.r0 = r;
+            box.r1 = r;
+
+            // 与上一行列范围相同的窗口向下延伸
+            bool extended = false;
+            for (uint8_t i = 0; i < n; i++) {
+                if (spans[i].r1 + 1 == r && spans[i].c0 == s.c0 && spans[i].c1 == s.c1) {
+                    spans[i].r1 = r;
+                    extended = true;
+                    break;
+                }
+            }
+            if (!extended) {
+                if (n == max || n == SSD1306_TILE_MAX_WINDOWS) {
+                    overflow = true;
+                    break;
+                }
+                spans[n++] = s;
+            }
+        }
+    }
+    if (n == 0 && !overflow) {
+        return 0;
+    }
+
+    if (!overflow) {
+        uint32_t bits = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            bits += spanBits(spans[i]);
+        }
+        if (bits < spanBits(box)) {
+            for (uint8_t i = 0; i < n; i++) {
+                out[i] = toRegion(spans[i]);
+            }
+            return n;
+        }
+    } else {
+        // 包围盒还要覆盖未扫描到的行
+        for (uint8_t r = 0; r < rows_; r++) {
+            for (uint8_t c = 0; c < cols_; c++) {
+                if (isDirty(c, r)) {
+                    if (c < box.c0) box.c0 = c;
+                    if (c > box.c1) box.c1 = c;
+                    if (r < box.r0) box.r0 = r;
+                    if (r > box.r1) box.r1 = r;
+                }
+            }
+        }
+    }
+    out[0] = toRegion(box);
+    return 1;
+}
+
+void TileMap::sent(const uint8_t* frame, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+    stats_.windows++;
+    for (uint8_t r = page0; r <= page1 && r < rows_; r++) {
+        for (uint8_t c = (uint8_t)(x0 >> 3); c <= (x1 >> 3) && c < cols_; c++) {
+            const uint16_t t = (uint16_t)(r * cols_ + c);
+            if (x0 <= c * 8 && x1 >= c * 8 + 7) {
+                hash_[t] = hashTile(frame, t);
+                set(known_, t);
+                reset(dirty_, t);
+                stats_.sent++;
+            } else if (test(dirty_, t)) {
+                reset(known_, t);
+            }
+        }
+    }
+}
+
+void TileMap::resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+}
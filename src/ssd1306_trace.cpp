@@ -0,0 +1,137 @@
+#include "ssd1306_trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if SSD1306_INSTRUMENT
+
+static const char* const kPrimNames[SSD1306_PRIM_COUNT] = {
+    "pixel", "hline", "vline", "line", "rect", "circle", "text", "blend", "gray"};
+
+static ssd1306_trace_hook_t trace_hook = nullptr;
+static void* trace_ctx = nullptr;
+
+void ssd1306_counters_record_flush(ssd1306_counters_t* counters, uint32_t us) {
+    uint8_t bucket = 0;
+    while (bucket < SSD1306_TRACE_HIST_BUCKETS - 1 && (us >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    counters->flush_hist[bucket]++;
+    counters->flushes++;
+    if (us > counters->flush_us_max) {
+        counters->flush_us_max = us;
+    }
+}
+
+uint32_t ssd1306_counters_flush_percentile(const ssd1306_counters_t* counters, uint8_t percentile) {
+    if (!counters || counters->flushes == 0) {
+        return 0;
+    }
+    if (percentile > 100) {
+        percentile = 100;
+    }
+
+    uint32_t target = (uint32_t)(((uint64_t)counters->flushes * percentile + 99) / 100);
+    if (target == 0) {
+        target = 1;
+    }
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < SSD1306_TRACE_HIST_BUCKETS; i++) {
+        seen += counters->flush_hist[i];
+        if (seen >= target) {
+            uint32_t upper = (i == SSD1306_TRACE_HIST_BUCKETS - 1) ? counters->flush_us_max : (2u << i) - 1;
+            return upper < counters->flush_us_max ? upper : counters->flush_us_max;
+        }
+    }
+    return counters->flush_us_max;
+}
+
+void ssd1306_counters_print(const ssd1306_counters_t* counters) {
+    printf("SSD1306: 命令 %lu次/%lu字节, 数据 %lu次/%lu字节, 刷新 %lu次 p50 %luus p99 %luus 最长 %luus\n",
+           (unsigned long)counters->command_txns, (unsigned long)counters->command_bytes,
+           (unsigned long)counters->data_txns, (unsigned long)counters->data_bytes,
+           (unsigned long)counters->flushes,
+           (unsigned long)ssd1306_counters_flush_percentile(counters, 50),
+           (unsigned long)ssd1306_counters_flush_percentile(counters, 99),
+           (unsigned long)counters->flush_us_max);
+    printf("  像素(调用):");
+    for (uint8_t i = 0; i < SSD1306_PRIM_COUNT; i++) {
+        if (counters->calls[i]) {
+            printf(" %s %lu(%lu)", kPrimNames[i], (unsigned long)counters->pixels[i],
+                   (unsigned long)counters->calls[i]);
+        }
+    }
+    printf("\n");
+}
+
+void ssd1306_trace_set_hook(ssd1306_trace_hook_t hook, void* ctx) {
+    // 先摘下旧钩子再换ctx，避免旧钩子收到新的ctx
+    trace_hook = nullptr;
+    trace_ctx = ctx;
+    trace_hook = hook;
+}
+
+void ssd1306_trace_emit(const char* name, char phase, uint64_t ts_us) {
+    if (trace_hook) {
+        trace_hook(name, phase, ts_us, trace_ctx);
+    }
+}
+
+void ssd1306_trace_buffer_hook(const char* name, char phase, uint64_t ts_us, void* ctx) {
+    ssd1306_trace_buffer_t* buffer = (ssd1306_trace_buffer_t*)ctx;
+    if (buffer->count >= SSD1306_TRACE_RING) {
+        buffer->dropped++;
+        return;
+    }
+    ssd1306_trace_event_t* ev = &buffer->events[buffer->count++];
+    ev->name = name;
+    ev->ts_us = ts_us;
+    ev->phase = phase;
+}
+
+void ssd1306_trace_print_hook(const char* name, char phase, uint64_t ts_us, void* ctx) {
+    (void)ctx;
+    printf(SSD1306_TRACE_PREFIX "%llu,%c,%s\n", (unsigned long long)ts_us, phase, name);
+}
+
+uint32_t ssd1306_trace_dump(ssd1306_trace_buffer_t* buffer) {
+    const uint32_t n = buffer->count;
+    for (uint32_t i = 0; i < n; i++) {
+        const ssd1306_trace_event_t* ev = &buffer->events[i];
+        printf(SSD1306_TRACE_PREFIX "%llu,%c,%s\n", (unsigned long long)ev->ts_us, ev->phase, ev->name);
+    }
+    if (buffer->dropped) {
+        printf("SSD1306追踪: 缓冲区满，丢弃 %lu 个事件\n", (unsigned long)buffer->dropped);
+    }
+    buffer->count = 0;
+    buffer->dropped = 0;
+    return n;
+}
+
+#endif // SSD1306_INSTRUMENT
+
+bool ssd1306_trace_parse_line(const char* line, uint64_t* ts_us, char* phase, char* name, size_t name_cap) {
+    const char* p = strstr(line, SSD1306_TRACE_PREFIX);
+    if (!p || name_cap == 0) {
+        return false;
+    }
+    p += strlen(SSD1306_TRACE_PREFIX);
+
+    char* end;
+    unsigned long long ts = strtoull(p, &end, 10);
+    if (end == p || end[0] != ',' || (end[1] != SSD1306_TRACE_BEGIN && end[1] != SSD1306_TRACE_END) ||
+        end[2] != ',') {
+        return false;
+    }
+    *ts_us = ts;
+    *phase = end[1];
+
+    p = end + 3;
+    size_t len = strcspn(p, "\r\n");
+    if (len == 0 || len >= name_cap) {
+        return false;
+    }
+    memcpy(name, p, len);
+    name[len] = '\0';
+    return true;
+}
@@ -0,0 +1,185 @@
+// DS3231闹钟调度器模拟（主机端）
+//
+// 用主机端DS3231模型（tools/host_stubs/host_ds3231）运行ds3231_alarm_scheduler：
+// MCU在两次INT下降沿之间“休眠”（虚拟时钟按秒推进），醒来后读取时间并调用
+// ds3231_alarm_scheduler_service()。随机的单次与周期定时器（最多DS3231_ALARM_MAX_TIMERS个，
+// 截止时间从几秒到DS3231_ALARM_MAX_AHEAD_S之外，跨月末与闰日）在回调中被重新添加或取消。
+// 检查：
+//   - 每个定时器以预期的截止时间执行，不提前、不重复、不遗漏，记录迟到的秒数；
+//   - 每次service之后INT已释放（否则下一个闹钟不会再产生下降沿）；
+//   - 只有闹钟1、闹钟2两个硬件闹钟，A1F/A2F各自的匹配次数。
+// -f 按给定概率让闹钟1的写入被NAK：此时应由闹钟2在不晚于截止时间的整分钟唤醒，
+// 截止时间在当前这一分钟之内的定时器最多迟到59秒。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ds3231_alarm_sim.cpp tools/host_stubs/host_ds3231.cpp tools/host_stubs/host_stubs.cpp src/ds3231/*.cpp src/i2c_bus.cpp -o ds3231_alarm_sim
+// 用法: ds3231_alarm_sim [-d 模拟天数] [-f 闹钟1写入失败概率] [-s 随机种子]
+
+#include "host_ds3231.h"
+#include "ds3231/ds3231_alarm.h"
+#include "ds3231/ds3231_calendar.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+
+#define INT_GPIO 3
+
+// 2024-02-20 00:00:00，一周之后经过闰日与月末
+#define START_EPOCH 1708387200LL
+
+struct Expected {
+    int64_t deadline;
+    uint32_t period_s;
+};
+
+static ds3231_alarm_scheduler_t sched;
+static std::map<uint32_t, Expected> expected;
+static std::mt19937 rng;
+static int64_t now;
+static unsigned long executed, wrong, late, cancels;
+static int64_t max_late;
+
+static void onTimer(uint32_t id, int64_t deadline, void* ctx);
+
+static int64_t randomDelay() {
+    switch (rng() % 8) {
+    case 0: return 1 + rng() % 10;                                     // 几秒之内
+    case 1: return 30 + rng() % 90;                                    // 跨分钟
+    case 2: return DS3231_ALARM_MAX_AHEAD_S + 1 + rng() % (5 * 86400); // 超过闹钟1的日期匹配范围
+    default: return 1 + rng() % (3 * 86400);
+    }
+}
+
+static void addRandom() {
+    const int64_t deadline = now + randomDelay();
+    const uint32_t period = rng() % 4 == 0 ? 1 + rng() % 7200 : 0;
+    const uint32_t id = ds3231_alarm_scheduler_add(&sched, deadline, period, onTimer, nullptr);
+    if (id) {
+        expected[id] = {deadline, period};
+    }
+}
+
+static void onTimer(uint32_t id, int64_t deadline, void* ctx) {
+    executed++;
+    auto it = expected.find(id);
+    if (it == expected.end() || it->second.deadline != deadline || deadline > now) {
+        if (wrong++ < 5) {
+            fprintf(stderr, "定时器 %u: 截止时间 %lld, 预期 %lld, 当前 %lld\n", id, (long long)deadline,
+                    it == expected.end() ? -1LL : (long long)it->second.deadline, (long long)now);
+        }
+        return;
+    }
+    if (now > deadline) {
+        late++;
+        if (now - deadline > max_late) {
+            max_late = now - deadline;
+        }
+    }
+
+    if (it->second.period_s) {
+        // 与调度器相同：错过多个周期时只执行一次
+        const int64_t missed = (now - deadline) / it->second.period_s + 1;
+        it->second.deadline += missed * it->second.period_s;
+    } else {
+        expected.erase(it);
+        addRandom();
+    }
+
+    // 偶尔取消另一个定时器并补一个新的
+    if (rng() % 16 == 0 && !expected.empty()) {
+        auto victim = expected.begin();
+        std::advance(victim, rng() % expected.size());
+        if (ds3231_alarm_scheduler_cancel(&sched, victim->first)) {
+            expected.erase(victim);
+            cancels++;
+            addRandom();
+        }
+    }
+}
+
+static int64_t readNow(ds3231_t* ds3231) {
+    ds3231_time_t t;
+    if (!ds3231_read_time(ds3231, &t)) {
+        fprintf(stderr, "读取时间失败\n");
+        exit(1);
+    }
+    return ds3231_time_to_epoch(&t);
+}
+
+int main(int argc, char** argv) {
+    unsigned long days = 120;
+    double fail_rate = 0.0;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            days = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            fail_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-d 模拟天数] [-f 闹钟1写入失败概率] [-s 随机种子]\n", argv[0]);
+            return 2;
+        }
+    }
+    rng.seed(seed);
+
+    static host_ds3231_t rtc;
+    host_ds3231_init(&rtc, START_EPOCH, INT_GPIO);
+    static ds3231_t ds3231;
+    host_ds3231_attach(&rtc, i2c0);
+    if (!ds3231_init(&ds3231, i2c0, 4, 5)) {
+        fprintf(stderr, "DS3231初始化失败\n");
+        return 1;
+    }
+    ds3231_alarm_scheduler_init(&sched, &ds3231);
+
+    now = readNow(&ds3231);
+    for (int i = 0; i < 12; i++) {
+        addRandom();
+    }
+    ds3231_alarm_scheduler_service(&sched, now);
+
+    const uint64_t end_us = time_us_64() + (uint64_t)days * 86400 * 1000000;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    unsigned long wakeups = 0, idle_wakeups = 0, stuck = 0, injected = 0;
+    while (host_ds3231_run_until_int(&rtc, end_us)) {
+        wakeups++;
+        now = readNow(&ds3231);
+        // 本次service对闹钟1的写入失败
+        if (uniform(rng) < fail_rate) {
+            rtc.fail_reg_lo = DS3231_ALARM1_SEC;
+            rtc.fail_reg_hi = DS3231_ALARM1_DAY;
+            rtc.fail_writes = 1;
+            injected++;
+        }
+        const uint32_t fired = ds3231_alarm_scheduler_service(&sched, now);
+        idle_wakeups += fired == 0;
+        rtc.fail_writes = 0;
+        host_ds3231_update(&rtc);
+        if (rtc.int_low) {
+            stuck++;
+        }
+    }
+    now = readNow(&ds3231);
+
+    // 到期但没有执行的定时器
+    unsigned long missed = 0;
+    for (const auto& e : expected) {
+        if (e.second.deadline <= now) {
+            missed++;
+        }
+    }
+
+    printf("模拟 %lu 天, INT唤醒 %lu 次（其中无定时器到期 %lu 次）, 闹钟1写入失败注入 %lu 次\n", days, wakeups,
+           idle_wakeups, injected);
+    printf("定时器执行 %lu 次, 取消 %lu 次, 当前 %zu 个; 闹钟匹配 A1F %u 次, A2F %u 次\n", executed, cancels,
+           expected.size(), rtc.alarm1_matches, rtc.alarm2_matches);
+    printf("迟到 %lu 次（最多 %lld 秒）, 截止时间错误 %lu, 遗漏 %lu, INT未释放 %lu\n", late, (long long)max_late,
+           wrong, missed, stuck);
+
+    // 没有故障注入时必须准时；有故障时最多迟到一分钟以内
+    const bool ok = !wrong && !missed && !stuck && (fail_rate > 0 ? max_late < 60 : late == 0);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+// DS3231日历换算的穷举校验与基准（主机端）
+//
+// 与C库逐一比较ds3231_calendar.h的换算，覆盖DS3231能表示的整个范围（2000-2099年）：
+//   - 每一天：ds3231_days_from_civil()与timegm()、ds3231_civil_from_days()往返、
+//     ds3231_weekday()/ds3231_weekday_from_days()与tm_wday、ds3231_days_in_month()；
+//   - 每一分钟（秒数取0-59轮换）：ds3231_epoch_to_time()与gmtime_r()、
+//     ds3231_time_to_epoch()往返，ds3231_format_iso8601()与strftime()；
+//   - 时区：每15分钟比较ds3231_tz_offset_min()与localtime_r()（TZ设为对应的POSIX规则，
+//     不依赖系统时区数据库），在相邻两个采样点之间偏移变化时逐秒比较切换前后两小时。
+//     时区为欧洲中部（CET/CEST）、美国东部（EST/EDT）与澳大利亚东部（AEST/AEDT，南半球跨年）。
+// 之后与C库对比各函数的耗时（主机上的数值，只用于相对比较，设备上需另行测量）。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ds3231_calendar_check.cpp src/ds3231/ds3231_calendar.cpp -o ds3231_calendar_check
+// 用法: ds3231_calendar_check [-n 基准迭代次数]
+
+#include "ds3231/ds3231_calendar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#define FIRST_DAY 10957   // 2000-01-01
+#define LAST_DAY  47481   // 2099-12-31
+
+static unsigned long errors;
+
+static void report(const char* what, int64_t value) {
+    if (errors++ < 10) {
+        fprintf(stderr, "%s不一致: %lld\n", what, (long long)value);
+    }
+}
+
+// 每一天的日期换算
+static unsigned long checkDays() {
+    unsigned long n = 0;
+    for (int32_t days = FIRST_DAY; days <= LAST_DAY; days++, n++) {
+        const time_t t = (time_t)days * 86400;
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        const int32_t year = tm.tm_year + 1900;
+        const uint32_t month = (uint32_t)tm.tm_mon + 1, date = (uint32_t)tm.tm_mday;
+
+        if (ds3231_days_from_civil(year, month, date) != days || timegm(&tm) != t) {
+            report("days_from_civil", days);
+        }
+        int32_t y;
+        uint32_t m, d;
+        ds3231_civil_from_days(days, &y, &m, &d);
+        if (y != year || m != month || d != date) {
+            report("civil_from_days", days);
+        }
+        const ds3231_time_t time = {0, 0, 0, 0, (uint8_t)date, (uint8_t)month, (uint8_t)(year - 2000)};
+        if (ds3231_weekday(&time) != tm.tm_wday || ds3231_weekday_from_days(days) != tm.tm_wday) {
+            report("weekday", days);
+        }
+        // 当月最后一天的下一天是下月1日
+        if (date == 1) {
+            const time_t last = t - 86400;
+            struct tm prev;
+            gmtime_r(&last, &prev);
+            if (ds3231_days_in_month(prev.tm_year + 1900, (uint32_t)prev.tm_mon + 1) != prev.tm_mday) {
+                report("days_in_month", days - 1);
+            }
+        }
+    }
+    return n;
+}
+
+// 每一分钟的时间换算与格式化
+static unsigned long checkMinutes() {
+    unsigned long n = 0;
+    const int64_t first = (int64_t)FIRST_DAY * 86400, end = (int64_t)(LAST_DAY + 1) * 86400;
+    for (int64_t minute = first; minute < end; minute += 60, n++) {
+        const int64_t epoch = minute + n % 60;
+        const time_t t = (time_t)epoch;
+        struct tm tm;
+        gmtime_r(&t, &tm);
+
+        ds3231_time_t time;
+        ds3231_epoch_to_time(epoch, &time);
+        if (time.year + 2000 != tm.tm_year + 1900 || time.month != tm.tm_mon + 1 || time.date != tm.tm_mday ||
+            time.hours != tm.tm_hour || time.minutes != tm.tm_min || time.seconds != tm.tm_sec ||
+            time.day != tm.tm_wday) {
+            report("epoch_to_time", epoch);
+        }
+        if (ds3231_time_to_epoch(&time) != epoch) {
+            report("time_to_epoch", epoch);
+        }
+        // 格式化较慢，每小时比较一次
+        if (n % 60 == 0) {
+            char ours[32], ref[32];
+            ds3231_format_iso8601(ours, sizeof(ours), &time, 0);
+            strftime(ref, sizeof(ref), "%Y-%m-%dT%H:%M:%SZ", &tm);
+            if (strcmp(ours, ref) != 0) {
+                report("format_iso8601", epoch);
+            }
+        }
+    }
+    return n;
+}
+
+struct Zone {
+    const char* name;
+    const char* posix;
+    ds3231_tz_t tz;
+};
+
+static const Zone zones[] = {
+    {"CET/CEST", "CET-1CEST,M3.5.0,M10.5.0/3", {60, 60, {3, 5, 0, 120}, {10, 5, 0, 180}}},
+    {"EST/EDT", "EST5EDT,M3.2.0,M11.1.0", {-300, 60, {3, 2, 0, 120}, {11, 1, 0, 120}}},
+    {"AEST/AEDT", "AEST-10AEDT,M10.1.0,M4.1.0/3", {600, 60, {10, 1, 0, 120}, {4, 1, 0, 180}}},
+};
+
+static bool zoneMatches(const Zone& zone, int64_t epoch, int32_t* offset_min) {
+    const time_t t = (time_t)epoch;
+    struct tm tm;
+    localtime_r(&t, &tm);
+    bool dst;
+    *offset_min = ds3231_tz_offset_min(&zone.tz, epoch, &dst);
+    return *offset_min == tm.tm_gmtoff / 60 && dst == (tm.tm_isdst > 0) &&
+           ds3231_utc_to_local(&zone.tz, epoch, nullptr) == epoch + tm.tm_gmtoff;
+}
+
+// 每15分钟采样，偏移变化处逐秒比较
+static void checkZone(const Zone& zone, unsigned long* samples, unsigned long* transitions) {
+    setenv("TZ", zone.posix, 1);
+    tzset();
+    const int64_t first = (int64_t)FIRST_DAY * 86400, end = (int64_t)(LAST_DAY + 1) * 86400;
+    int32_t prev_offset = 0;
+    for (int64_t epoch = first; epoch < end; epoch += 900) {
+        int32_t offset;
+        if (!zoneMatches(zone, epoch, &offset)) {
+            report(zone.name, epoch);
+        }
+        (*samples)++;
+        if (epoch > first && offset != prev_offset) {
+            (*transitions)++;
+            for (int64_t s = epoch - 900 - 7200; s < epoch + 7200; s++) {
+                if (!zoneMatches(zone, s, &offset)) {
+                    report(zone.name, s);
+                }
+                (*samples)++;
+            }
+        }
+        prev_offset = offset;
+    }
+}
+
+// ---- 基准 ----
+
+static volatile int64_t sink;
+
+template <typename Fn>
+static double nsPerCall(unsigned long n, Fn fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; i++) {
+        fn(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double)n;
+}
+
+static void bench(unsigned long n) {
+    // 输入在整个范围内分布，避免分支预测只看到同一个日期
+    const int64_t span = (int64_t)(LAST_DAY + 1 - FIRST_DAY) * 86400;
+    auto epochAt = [span](unsigned long i) { return (int64_t)FIRST_DAY * 86400 + (int64_t)(i * 2654435761u) % span; };
+    static const ds3231_tz_t& cet = zones[0].tz;
+    setenv("TZ", zones[0].posix, 1);
+    tzset();
+
+    printf("%10s %10s   %s\n", "本实现ns", "C库ns", "操作（主机）");
+    printf("%10.1f %10.1f   %s\n", nsPerCall(n, [&](unsigned long i) {
+               ds3231_time_t t;
+               ds3231_epoch_to_time(epochAt(i), &t);
+               sink += t.seconds + t.day;
+           }),
+           nsPerCall(n, [&](unsigned long i) {
+               const time_t t = (time_t)epochAt(i);
+               struct tm tm;
+               gmtime_r(&t, &tm);
+               sink += tm.tm_sec + tm.tm_wday;
+           }),
+           "epoch转时间（gmtime_r）");
+    printf("%10.1f %10.1f   %s\n", nsPerCall(n, [&](unsigned long i) {
+               ds3231_time_t t;
+               ds3231_epoch_to_time(epochAt(i), &t);
+               sink += ds3231_time_to_epoch(&t);
+           }),
+           nsPerCall(n, [&](unsigned long i) {
+               const time_t t = (time_t)epochAt(i);
+               struct tm tm;
+               gmtime_r(&t, &tm);
+               sink += timegm(&tm);
+           }),
+           "往返（gmtime_r+timegm）");
+    printf("%10.1f %10s   %s\n", nsPerCall(n, [&](unsigned long i) {
+               const ds3231_time_t t = {0, 0, 0, 0, (uint8_t)(1 + i % 28), (uint8_t)(1 + i % 12),
+                                        (uint8_t)(i % 100)};
+               sink += ds3231_weekday(&t);
+           }),
+           "-", "星期（读取时间时）");
+    printf("%10.1f %10.1f   %s\n", nsPerCall(n, [&](unsigned long i) {
+               bool dst;
+               sink += ds3231_tz_offset_min(&cet, epochAt(i), &dst) + dst;
+           }),
+           nsPerCall(n, [&](unsigned long i) {
+               const time_t t = (time_t)epochAt(i);
+               struct tm tm;
+               localtime_r(&t, &tm);
+               sink += tm.tm_gmtoff + tm.tm_isdst;
+           }),
+           "CET偏移（localtime_r）");
+    printf("%10.1f %10.1f   %s\n", nsPerCall(n, [&](unsigned long i) {
+               ds3231_time_t t;
+               ds3231_epoch_to_time(epochAt(i), &t);
+               char buf[32];
+               sink += (int64_t)ds3231_format_iso8601(buf, sizeof(buf), &t, 60);
+           }),
+           nsPerCall(n, [&](unsigned long i) {
+               const time_t t = (time_t)epochAt(i);
+               struct tm tm;
+               gmtime_r(&t, &tm);
+               char buf[32];
+               sink += (int64_t)strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S+01:00", &tm);
+           }),
+           "ISO-8601格式化（gmtime_r+strftime）");
+}
+
+int main(int argc, char** argv) {
+    unsigned long iterations = 2000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 基准迭代次数]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const unsigned long days = checkDays();
+    const unsigned long minutes = checkMinutes();
+    printf("日期: %lu天, 时间: %lu分钟（2000-2099年）\n", days, minutes);
+    for (const Zone& zone : zones) {
+        unsigned long samples = 0, transitions = 0;
+        checkZone(zone, &samples, &transitions);
+        printf("%-10s %lu个采样, %lu次切换\n", zone.name, samples, transitions);
+    }
+    printf("不一致: %lu\n", errors);
+
+    if (iterations) {
+        bench(iterations);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+// 时钟表盘帧记录生成（主机端，不需要设备）
+//
+// 用主机端SDK替身（tools/host_stubs）运行示例的表盘代码（examples/clock_face.cpp）：
+// 每秒渲染一次、整屏刷新，再像ds3231_clock.cpp中FRAME_MIRROR_ENABLED=1时那样
+// 由FrameRecorder输出$SSDF记录行。时间戳取虚拟时钟（含模拟的I2C刷新时间），
+// 温度每分钟变化0.25度。默认从23:58:30开始记录3分钟，跨过午夜时日期和星期也会变化。
+// tools/captures/ds3231_clock.log即由默认参数生成，供ssd1306_replay统计压缩率。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude -Iexamples tools/ds3231_clock_capture.cpp examples/clock_face.cpp src/ssd1306*.cpp src/i2c_bus.cpp src/ds3231/ds3231_calendar.cpp tools/host_stubs/host_stubs.cpp -o ds3231_clock_capture
+// 用法: ds3231_clock_capture [-n 秒数] [-e 起始Unix时间] > tools/captures/ds3231_clock.log
+
+#include "host_stubs.h"
+#include "ssd1306.h"
+#include "ssd1306_codec.h"
+#include "ds3231/ds3231_calendar.h"
+#include "clock_face.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 2024-03-15 23:58:30
+#define DEFAULT_EPOCH 1710547110LL
+
+static bool panelWrite(void* ctx, const uint8_t* src, size_t len) {
+    return true;
+}
+
+int main(int argc, char** argv) {
+    unsigned long count = 180;
+    int64_t epoch = DEFAULT_EPOCH;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            count = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            epoch = strtoll(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 秒数] [-e 起始Unix时间]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static const host_i2c_device_t panel = {panelWrite, nullptr, nullptr, nullptr};
+    i2c_init(i2c0, 400000);
+    host_i2c_attach(i2c0, SSD1306::ADDRESS, &panel);
+
+    SSD1306 oled(i2c0);
+    if (!oled.begin()) {
+        fprintf(stderr, "SSD1306初始化失败\n");
+        return 1;
+    }
+
+    static FrameRecorder mirror;
+    const size_t size = oled.width() * ((oled.height() + 7) / 8);
+    const uint64_t start_us = time_us_64();
+    for (unsigned long n = 0; n < count; n++) {
+        // 等到下一秒的边沿
+        const uint64_t edge_us = start_us + 1000000ULL * (n + 1);
+        if (time_us_64() < edge_us) {
+            host_time_advance(edge_us - time_us_64());
+        }
+
+        ds3231_time_t now;
+        ds3231_epoch_to_time(epoch + (int64_t)n, &now);
+        const float temperature = 24.5f + 0.25f * (float)((n / 60) % 4);
+        renderDualColorClock(oled, now, temperature, true);
+        oled.display();
+        mirror.record(oled.getBuffer(), size, time_us_64());
+    }
+    return 0;
+}
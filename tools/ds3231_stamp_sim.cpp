@@ -0,0 +1,146 @@
+// DS3231事件时间戳模拟（主机端）
+//
+// 模拟32.768kHz计数器（16位回绕，回绕中断有随机延迟）与随机到达的GPIO事件：
+// 生产者线程扮演捕获中断调用ds3231_stamp_capture()，消费者线程扮演另一个核
+// 批量取出事件，逐个与真实时刻比对，最后打印吞吐量与丢弃数。
+//
+// 默认按实际时间以给定速率产生事件（与硬件上一样，缓冲区满时丢弃）；
+// -f 时生产者不限速，缓冲区满时等待，用于测量环形缓冲区的最大吞吐。
+//
+// 编译: g++ -std=c++17 -O2 -pthread -Iinclude tools/ds3231_stamp_sim.cpp src/ds3231/ds3231_stamp.cpp -o ds3231_stamp_sim
+// 用法: ds3231_stamp_sim [-f] [-n 事件数] [-r 每秒事件数] [-d 消费者每批之后的延迟(微秒)]
+
+#include "ds3231/ds3231_stamp.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Truth {
+    uint32_t seconds;
+    uint16_t ticks;
+};
+
+int main(int argc, char** argv) {
+    unsigned long total = 500000;
+    double rate = 50000.0;
+    int delay_us = 0;
+    bool flat_out = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0) {
+            flat_out = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            total = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            delay_us = atoi(argv[++i]);
+        }
+    }
+    if (total == 0 || rate <= 0.0) {
+        fprintf(stderr, "无效的参数\n");
+        return 1;
+    }
+
+    // 计数器从0开始，等待第一个秒边沿期间已回绕一次
+    const uint64_t anchor_count = 0x10000 + 12345;
+    const uint32_t anchor_seconds = 1760000000;
+
+    static ds3231_stamp_t stamp;
+    ds3231_stamp_init(&stamp);
+    ds3231_stamp_wrap(&stamp);
+    ds3231_stamp_anchor(&stamp, ds3231_stamp_count(&stamp, (uint16_t)anchor_count, false), anchor_seconds);
+
+    // 真实时刻按发布顺序记录，消费者按同样顺序比对
+    std::vector<Truth> truth(total);
+    std::atomic<bool> done(false);
+    unsigned long mismatches = 0, consumed = 0;
+
+    std::thread consumer([&] {
+        ds3231_stamp_event_t batch[64];
+        while (true) {
+            bool finished = done.load(std::memory_order_acquire);
+            uint32_t n = ds3231_stamp_read(&stamp, batch, 64);
+            for (uint32_t i = 0; i < n; i++) {
+                const Truth& t = truth[consumed++];
+                if (batch[i].seconds != t.seconds || batch[i].ticks != t.ticks) {
+                    if (mismatches++ < 5) {
+                        fprintf(stderr, "事件 %lu: %u.%05u, 应为 %u.%05u\n", consumed - 1,
+                                batch[i].seconds, batch[i].ticks, t.seconds, t.ticks);
+                    }
+                }
+            }
+            if (n == 0 && finished) {
+                break;
+            }
+            // 主机可能只有一个核，空闲时让出时间片
+            if (delay_us) {
+                std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+            } else if (n == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> gap(rate / DS3231_STAMP_HZ);
+    std::uniform_int_distribution<uint64_t> latency(0, 64);   // 回绕中断延迟（计数）
+    double t = (double)anchor_count;
+    uint64_t next_wrap = (anchor_count | 0xFFFF) + 1;
+    uint64_t wrap_irq_at = next_wrap + latency(rng);
+    unsigned long published = 0, wraps = 0, pending_hits = 0, count_errors = 0, stalls = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < total; i++) {
+        t += gap(rng);
+        uint64_t count = (uint64_t)t;
+        if (!flat_out) {
+            std::this_thread::sleep_until(t0 + std::chrono::duration<double>((t - anchor_count) / DS3231_STAMP_HZ));
+        }
+
+        // 先执行此前到期的回绕中断
+        while (wrap_irq_at <= count) {
+            ds3231_stamp_wrap(&stamp);
+            next_wrap += 0x10000;
+            wrap_irq_at = next_wrap + latency(rng);
+            wraps++;
+        }
+
+        // 已回绕但回绕中断尚未执行时，挂起标志为真
+        bool pending = next_wrap <= count;
+        pending_hits += pending;
+        uint64_t extended = ds3231_stamp_count(&stamp, (uint16_t)count, pending);
+        count_errors += extended != count;
+
+        uint64_t since = count - anchor_count;
+        truth[published] = {anchor_seconds + (uint32_t)(since >> DS3231_STAMP_HZ_SHIFT),
+                            (uint16_t)(since & (DS3231_STAMP_HZ - 1))};
+        while (flat_out && ds3231_stamp_available(&stamp) >= DS3231_STAMP_RING_SIZE) {
+            stalls++;
+            std::this_thread::yield();
+        }
+        if (ds3231_stamp_capture(&stamp, extended, 7, DS3231_STAMP_RISE)) {
+            published++;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    double elapsed = std::chrono::duration<double>(t1 - t0).count();
+    double simulated = (t - anchor_count) / DS3231_STAMP_HZ;
+    printf("事件: %lu, 发布: %lu, 取出: %lu, 丢弃: %u, 不一致: %lu\n",
+           total, published, consumed, stamp.dropped, mismatches);
+    printf("模拟时长: %.1f 秒 (%.0f 事件/秒), 回绕 %lu 次, 回绕中断挂起时捕获 %lu 次, 计数扩展错误 %lu\n",
+           simulated, total / simulated, wraps, pending_hits, count_errors);
+    printf("主机吞吐: %.2f M事件/秒 (%s)\n", total / elapsed / 1e6, flat_out ? "不限速" : "按实际时间");
+    if (flat_out) {
+        printf("缓冲区满时等待: %lu 次\n", stalls);
+    }
+    return (mismatches || count_errors || consumed != published) ? 2 : 0;
+}
@@ -0,0 +1,179 @@
+// DS3231节拍分发器模拟（主机端）
+//
+// 扮演SQW中断调用ds3231_tick_post()，扮演主循环调用ds3231_tick_dispatch()，检查：
+//   - 每个订阅者只在tick % period == phase时被调用，相邻两次正好相隔period个节拍，
+//     调用次数与理论值相同，且节拍按顺序分发、不重不漏；
+//   - 主循环来不及分发时（一次积压多个节拍）仍逐个分发，lagged只在积压时递增；
+//   - 分发期间到达的节拍（在回调中投递，相当于回调执行时来了中断）留到下一次；
+//   - edge_us：及时分发时为该节拍自己的边沿，积压时为快照时最后一个边沿；
+//   - 无效订阅（period为0、phase >= period、超过DS3231_TICK_MAX_SUBSCRIBERS）被拒绝。
+// 积压按随机长度产生，边沿时间为1Hz加随机抖动。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ds3231_tick_sim.cpp src/ds3231/ds3231_tick.cpp -o ds3231_tick_sim
+// 用法: ds3231_tick_sim [-n 节拍数] [-b 最大积压节拍数] [-s 随机种子]
+
+#include "ds3231/ds3231_tick.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct Subscriber {
+    uint32_t period;
+    uint32_t phase;
+    uint32_t calls;
+    uint32_t last_tick;
+    unsigned long errors;
+};
+
+// 模拟状态：回调据此核对节拍与边沿时间
+struct Sim {
+    ds3231_tick_t tick;
+    std::vector<uint64_t> edges;   // 每个节拍的边沿时间
+    uint32_t snapshot;             // 本次dispatch开始时已投递的节拍数
+    uint32_t next_tick;            // 下一个应分发的节拍（按订阅者顺序检查单调性）
+    int last_sub;
+    unsigned long order_errors;
+    unsigned long edge_errors;
+    std::mt19937 rng;
+    bool inject;                   // 在回调中投递节拍
+    unsigned long injected;
+    Subscriber subs[DS3231_TICK_MAX_SUBSCRIBERS];
+};
+
+static Sim sim;
+
+static uint64_t nextEdge() {
+    const uint64_t prev = sim.edges.empty() ? 0 : sim.edges.back();
+    return prev + 1000000 + (int)(sim.rng() % 401) - 200; // 1Hz，+-200us抖动
+}
+
+static void post() {
+    const uint64_t edge = nextEdge();
+    sim.edges.push_back(edge);
+    ds3231_tick_post(&sim.tick, edge);
+}
+
+static void onTick(uint32_t tick, uint64_t edge_us, void* ctx) {
+    const int index = (int)(intptr_t)ctx;
+    Subscriber& sub = sim.subs[index];
+
+    if (tick % sub.period != sub.phase || (sub.calls && tick - sub.last_tick != sub.period) ||
+        (!sub.calls && tick != sub.phase)) {
+        if (sub.errors++ < 5) {
+            fprintf(stderr, "订阅者 %d (period %u, phase %u): 节拍 %u, 上次 %u\n", index, sub.period, sub.phase,
+                    tick, sub.last_tick);
+        }
+    }
+    sub.calls++;
+    sub.last_tick = tick;
+
+    // 同一节拍内按订阅顺序调用，节拍之间递增，且不超过本次快照
+    if (tick >= sim.snapshot || tick + 1 < sim.next_tick || (tick + 1 == sim.next_tick && index <= sim.last_sub)) {
+        sim.order_errors++;
+    }
+    sim.next_tick = tick + 1;
+    sim.last_sub = index;
+
+    // 快照时的最后一个边沿
+    if (edge_us != sim.edges[sim.snapshot - 1]) {
+        sim.edge_errors++;
+    }
+
+    if (sim.inject && sim.rng() % 8 == 0) {
+        post();
+        sim.injected++;
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned long total = 1000000;
+    unsigned max_backlog = 5;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            total = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            max_backlog = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 节拍数] [-b 最大积压节拍数] [-s 随机种子]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (max_backlog == 0) {
+        max_backlog = 1;
+    }
+
+    // 无效订阅
+    ds3231_tick_init(&sim.tick);
+    unsigned long reject_errors = 0;
+    reject_errors += ds3231_tick_subscribe(&sim.tick, 0, 0, onTick, nullptr);
+    reject_errors += ds3231_tick_subscribe(&sim.tick, 5, 5, onTick, nullptr);
+    reject_errors += ds3231_tick_subscribe(&sim.tick, 1, 0, nullptr, nullptr);
+    reject_errors += sim.tick.subscriber_count != 0;
+
+    // 示例中的用法（每秒、每分钟第0秒）加上互质、非整除的周期与各种相位
+    static const uint32_t config[DS3231_TICK_MAX_SUBSCRIBERS][2] = {
+        {1, 0}, {60, 0}, {2, 1}, {5, 3}, {7, 6}, {10, 9}, {3600, 1799}, {13, 0},
+    };
+    for (int i = 0; i < DS3231_TICK_MAX_SUBSCRIBERS; i++) {
+        sim.subs[i] = {config[i][0], config[i][1], 0, 0, 0};
+        if (!ds3231_tick_subscribe(&sim.tick, config[i][0], config[i][1], onTick, (void*)(intptr_t)i)) {
+            reject_errors++;
+        }
+    }
+    reject_errors += ds3231_tick_subscribe(&sim.tick, 1, 0, onTick, nullptr); // 已满
+
+    sim.rng.seed(seed);
+    sim.edges.reserve(total + total / 4);
+    sim.last_sub = DS3231_TICK_MAX_SUBSCRIBERS;
+
+    unsigned long dispatches = 0, backlogged = 0, count_errors = 0;
+    while (sim.edges.size() < total) {
+        // 主循环每轮醒来前到达1到max_backlog个节拍；一半时间允许回调中来中断
+        const unsigned n = 1 + sim.rng() % max_backlog;
+        for (unsigned k = 0; k < n; k++) {
+            post();
+        }
+        sim.inject = sim.rng() % 2;
+
+        const uint32_t before = sim.tick.dispatched;
+        sim.snapshot = sim.tick.posted;
+        const uint32_t expected = sim.snapshot - before;
+        const uint32_t lagged = sim.tick.lagged;
+        const uint32_t count = ds3231_tick_dispatch(&sim.tick);
+        dispatches++;
+        backlogged += expected > 1;
+
+        if (count != expected || sim.tick.dispatched != sim.snapshot ||
+            sim.tick.lagged != lagged + (expected > 1) ||
+            ds3231_tick_pending(&sim.tick) != (sim.tick.posted != sim.snapshot)) {
+            count_errors++;
+        }
+    }
+    // 取完回调中投递的节拍
+    while (ds3231_tick_pending(&sim.tick)) {
+        sim.snapshot = sim.tick.posted;
+        sim.inject = false;
+        ds3231_tick_dispatch(&sim.tick);
+    }
+
+    const uint32_t ticks = sim.tick.dispatched;
+    unsigned long sub_errors = 0;
+    printf("%-8s %6s %6s %10s %10s %6s\n", "订阅者", "period", "phase", "调用", "理论", "错误");
+    for (int i = 0; i < DS3231_TICK_MAX_SUBSCRIBERS; i++) {
+        const Subscriber& s = sim.subs[i];
+        const uint32_t expected = ticks > s.phase ? (ticks - s.phase + s.period - 1) / s.period : 0;
+        const unsigned long errors = s.errors + (s.calls != expected);
+        sub_errors += errors;
+        printf("%-8d %6u %6u %10u %10u %6lu\n", i, s.period, s.phase, s.calls, expected, errors);
+    }
+    printf("节拍: %u (回调中投递 %lu), 分发: %lu 次, 积压: %lu 次, lagged: %u\n", ticks, sim.injected, dispatches,
+           backlogged, sim.tick.lagged);
+    printf("顺序错误: %lu, 边沿时间错误: %lu, 计数错误: %lu, 无效订阅未拒绝: %lu\n", sim.order_errors,
+           sim.edge_errors, count_errors, reject_errors);
+    return (sub_errors || sim.order_errors || sim.edge_errors || count_errors || reject_errors) ? 1 : 0;
+}
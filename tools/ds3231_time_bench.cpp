@@ -0,0 +1,214 @@
+// DS3231时间寄存器编解码的校验与基准（主机端）
+//
+// ds3231_decode_time()/ds3231_encode_time()一次处理全部7个寄存器（64位字内逐字节并行的
+// BCD换算与范围校验）。本程序与逐字段的做法（按原实现在本文件中重写，不做校验）比较：
+//   - 2000-2099年的每一天，时分秒取每天不同的值，另有一天遍历全部86400秒：
+//     解码结果与逐字段解码相同，编码后再解码回到原值，星期寄存器为星期+1；
+//   - 随机的7字节寄存器内容：解码接受与否与逐字节的参考校验（两个半字节0-9、
+//     各字段范围、当月天数）一致，接受时各字段与逐字段解码相同；
+//   - 耗时：4096个不同时间循环解码、编码（主机上的数值，只用于相对比较）。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ds3231_time_bench.cpp tools/host_stubs/host_stubs.cpp src/ds3231/*.cpp src/i2c_bus.cpp -o ds3231_time_bench
+// 用法: ds3231_time_bench [-n 基准迭代次数] [-r 随机用例数] [-s 随机种子]
+
+#include "ds3231/ds3231.h"
+#include "ds3231/ds3231_calendar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define FIRST_DAY 10957   // 2000-01-01
+#define LAST_DAY  47481   // 2099-12-31
+
+// ---- 逐字段的做法 ----
+
+static uint8_t legacyBcdToBin(uint8_t bcd) {
+    return ((bcd >> 4) * 10) + (bcd & 0x0F);
+}
+
+static uint8_t legacyBinToBcd(uint8_t bin) {
+    return ((bin / 10) << 4) | (bin % 10);
+}
+
+static void legacyDecode(const uint8_t* data, ds3231_time_t* time) {
+    time->seconds = legacyBcdToBin(data[0] & 0x7F);
+    time->minutes = legacyBcdToBin(data[1] & 0x7F);
+    time->hours = legacyBcdToBin(data[2] & 0x3F);
+    time->date = legacyBcdToBin(data[4] & 0x3F);
+    time->month = legacyBcdToBin(data[5] & 0x1F);
+    time->year = legacyBcdToBin(data[6]);
+    time->day = ds3231_weekday_from_days(ds3231_days_from_civil(2000 + time->year, time->month, time->date));
+}
+
+static void legacyEncode(const ds3231_time_t* time, uint8_t* data) {
+    data[0] = legacyBinToBcd(time->seconds);
+    data[1] = legacyBinToBcd(time->minutes);
+    data[2] = legacyBinToBcd(time->hours);
+    data[3] = ds3231_weekday_from_days(ds3231_days_from_civil(2000 + time->year, time->month, time->date)) + 1;
+    data[4] = legacyBinToBcd(time->date);
+    data[5] = legacyBinToBcd(time->month);
+    data[6] = legacyBinToBcd(time->year);
+}
+
+// 逐字节的参考校验
+static bool referenceValid(const uint8_t* data) {
+    static const uint8_t masks[7] = {0x7F, 0x7F, 0x3F, 0x00, 0x3F, 0x1F, 0xFF};
+    static const uint8_t lo[7] = {0, 0, 0, 0, 1, 1, 0}, hi[7] = {59, 59, 23, 0, 31, 12, 99};
+    uint8_t v[7];
+    for (int i = 0; i < 7; i++) {
+        if (i == 3) {
+            continue;
+        }
+        const uint8_t b = data[i] & masks[i];
+        if ((b >> 4) > 9 || (b & 0x0F) > 9) {
+            return false;
+        }
+        v[i] = legacyBcdToBin(b);
+        if (v[i] < lo[i] || v[i] > hi[i]) {
+            return false;
+        }
+    }
+    return v[4] <= ds3231_days_in_month(2000 + v[6], v[5]);
+}
+
+static bool sameTime(const ds3231_time_t& a, const ds3231_time_t& b) {
+    return a.seconds == b.seconds && a.minutes == b.minutes && a.hours == b.hours && a.day == b.day &&
+           a.date == b.date && a.month == b.month && a.year == b.year;
+}
+
+static unsigned long errors;
+
+static void report(const char* what, const uint8_t* regs) {
+    if (errors++ < 10) {
+        fprintf(stderr, "%s: %02X %02X %02X %02X %02X %02X %02X\n", what, regs[0], regs[1], regs[2], regs[3],
+                regs[4], regs[5], regs[6]);
+    }
+}
+
+// 一个有效时间：逐字段编码后比较解码、再编码
+static void checkValid(int64_t epoch) {
+    ds3231_time_t t;
+    ds3231_epoch_to_time(epoch, &t);
+    uint8_t regs[7], ours[7];
+    legacyEncode(&t, regs);
+
+    ds3231_time_t decoded, legacy;
+    legacyDecode(regs, &legacy);
+    if (!ds3231_decode_time(regs, &decoded) || !sameTime(decoded, legacy) || !sameTime(decoded, t)) {
+        report("解码", regs);
+    }
+    if (!ds3231_encode_time(&t, ours) || memcmp(ours, regs, 7) != 0) {
+        report("编码", regs);
+    }
+}
+
+// ---- 基准 ----
+
+static volatile uint32_t sink;
+
+template <typename Fn>
+static double nsPerCall(unsigned long n, Fn fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; i++) {
+        fn(i & 4095);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double)n;
+}
+
+int main(int argc, char** argv) {
+    unsigned long iterations = 20000000, randoms = 20000000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            randoms = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 基准迭代次数] [-r 随机用例数] [-s 随机种子]\n", argv[0]);
+            return 2;
+        }
+    }
+    std::mt19937 rng(seed);
+
+    // 每一天，时分秒每天不同；2024-02-29遍历全天
+    unsigned long valid = 0;
+    for (int32_t days = FIRST_DAY; days <= LAST_DAY; days++, valid++) {
+        checkValid((int64_t)days * 86400 + rng() % 86400);
+    }
+    const int64_t leap_day = (int64_t)ds3231_days_from_civil(2024, 2, 29) * 86400;
+    for (int64_t s = 0; s < 86400; s++, valid++) {
+        checkValid(leap_day + s);
+    }
+
+    // 随机寄存器内容：一半完全随机，一半只在一个字节上偏离有效值（覆盖边界附近）
+    unsigned long accepted = 0;
+    for (unsigned long i = 0; i < randoms; i++) {
+        uint8_t regs[7];
+        if (i & 1) {
+            ds3231_time_t t;
+            ds3231_epoch_to_time((int64_t)FIRST_DAY * 86400 + rng() % ((uint64_t)(LAST_DAY + 1 - FIRST_DAY) * 86400),
+                                 &t);
+            legacyEncode(&t, regs);
+            regs[rng() % 7] = (uint8_t)rng();
+        } else {
+            for (uint8_t& r : regs) {
+                r = (uint8_t)rng();
+            }
+        }
+        ds3231_time_t decoded, legacy;
+        const bool ok = ds3231_decode_time(regs, &decoded);
+        if (ok != referenceValid(regs)) {
+            report(ok ? "应拒绝" : "应接受", regs);
+            continue;
+        }
+        if (ok) {
+            accepted++;
+            legacyDecode(regs, &legacy);
+            if (!sameTime(decoded, legacy)) {
+                report("随机解码", regs);
+            }
+        }
+    }
+    printf("有效时间: %lu, 随机寄存器: %lu（有效 %lu）, 不一致: %lu\n", valid, randoms, accepted, errors);
+
+    if (iterations) {
+        // 4096个分布在整个范围内的时间
+        std::vector<uint8_t> regs(4096 * 7);
+        std::vector<ds3231_time_t> times(4096);
+        for (int i = 0; i < 4096; i++) {
+            ds3231_epoch_to_time((int64_t)FIRST_DAY * 86400 + rng() % ((uint64_t)(LAST_DAY + 1 - FIRST_DAY) * 86400),
+                                 &times[i]);
+            legacyEncode(&times[i], &regs[i * 7]);
+        }
+        printf("%10s %10s   %s\n", "逐字段ns", "当前ns", "操作（主机）");
+        printf("%10.1f %10.1f   %s\n", nsPerCall(iterations, [&](unsigned i) {
+                   ds3231_time_t t;
+                   legacyDecode(&regs[i * 7], &t);
+                   sink += t.seconds + t.day;
+               }),
+               nsPerCall(iterations, [&](unsigned i) {
+                   ds3231_time_t t;
+                   sink += ds3231_decode_time(&regs[i * 7], &t);
+                   sink += t.seconds + t.day;
+               }),
+               "解码（含星期；当前做法另含全部校验）");
+        printf("%10.1f %10.1f   %s\n", nsPerCall(iterations, [&](unsigned i) {
+                   uint8_t out[7];
+                   legacyEncode(&times[i], out);
+                   sink += out[0] + out[3];
+               }),
+               nsPerCall(iterations, [&](unsigned i) {
+                   uint8_t out[7];
+                   sink += ds3231_encode_time(&times[i], out);
+                   sink += out[0] + out[3];
+               }),
+               "编码（含星期；当前做法另含全部校验）");
+    }
+    return errors ? 1 : 0;
+}
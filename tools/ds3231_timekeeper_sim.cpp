@@ -0,0 +1,165 @@
+// DS3231软件计时服务模拟（主机端）
+//
+// 在主机端DS3231模型（tools/host_stubs/host_ds3231）上运行ds3231_timekeeper：
+// 模型的1Hz SQW每秒产生下降沿，每个周期比本地定时器的1秒长ppm微秒（RTC偏慢，
+// 即本地偏快ppm），按固定间隔在SQW边沿上调用ds3231_timekeeper_sync_at_edge()。
+// 依次运行：
+//   频偏   每次同步后频偏估计收敛到设定值附近，同步前的推算误差不超过上界；
+//   跳变   收敛后把RTC改写为+300秒、-300秒、+1秒（ds3231_write_time()，相当于设置时间或
+//          读错），每次跳变之后的同步应丢弃频偏估计（drift_valid为0）并以新时间为基准，
+//          其后60秒本地时间推算前进60秒；之后的同步重新收敛。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ds3231_timekeeper_sim.cpp tools/host_stubs/host_ds3231.cpp tools/host_stubs/host_stubs.cpp src/ds3231/*.cpp src/i2c_bus.cpp -o ds3231_timekeeper_sim
+// 用法: ds3231_timekeeper_sim [-p 本地频偏ppm] [-i 同步间隔秒数]
+
+#include "host_ds3231.h"
+#include "ds3231/ds3231_calendar.h"
+#include "ds3231/ds3231_timekeeper.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define SQW_GPIO 3
+
+// 2024-06-01 12:00:00
+#define START_EPOCH 1717243200LL
+
+#define SYNCS_PER_PHASE 12
+#define DRIFT_TOLERANCE_PPB 1000    // 收敛后的频偏估计误差上界
+
+static host_ds3231_t rtc;
+static ds3231_t ds3231;
+static ds3231_timekeeper_t tk;
+static uint32_t skew_us;
+static unsigned long failures;
+
+static void fail(const char* what, long long value) {
+    if (failures++ < 10) {
+        fprintf(stderr, "%s: %lld\n", what, value);
+    }
+}
+
+// 运行到第seconds个SQW边沿，返回边沿时刻；每个RTC秒比本地的1秒长skew_us
+static uint64_t runSeconds(uint32_t seconds) {
+    uint64_t edge = 0;
+    for (uint32_t i = 0; i < seconds; i++) {
+        if (!host_ds3231_run_until_int(&rtc, UINT64_MAX)) {
+            fail("SQW没有边沿", i);
+            return edge;
+        }
+        edge = time_us_64();
+        rtc.next_second_us += skew_us;
+    }
+    return edge;
+}
+
+// 在下一个边沿同步并返回同步前本地推算与RTC之差（us）
+static int32_t syncAt(uint32_t seconds) {
+    const uint64_t edge = runSeconds(seconds);
+    if (!ds3231_timekeeper_sync_at_edge(&tk, edge)) {
+        fail("同步失败", (long long)edge);
+    }
+    return tk.last_error_us;
+}
+
+// 改写RTC：相当于设置时间或一次错误的读数被写回
+static void stepRtc(int64_t delta_s) {
+    ds3231_time_t t;
+    if (!ds3231_read_time(&ds3231, &t)) {
+        fail("读取时间失败", 0);
+        return;
+    }
+    ds3231_epoch_to_time(ds3231_time_to_epoch(&t) + delta_s, &t);
+    if (!ds3231_write_time(&ds3231, &t)) {
+        fail("写入时间失败", delta_s);
+    }
+}
+
+static bool converged(int32_t expected_ppb) {
+    return tk.drift_valid && abs(tk.drift_ppb - expected_ppb) <= DRIFT_TOLERANCE_PPB;
+}
+
+int main(int argc, char** argv) {
+    uint32_t ppm = 20, interval = 600;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            ppm = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-p 本地频偏ppm] [-i 同步间隔秒数]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (ppm >= DS3231_TIMEKEEPER_MAX_DRIFT_PPM || interval < DS3231_TIMEKEEPER_MIN_DRIFT_S) {
+        fprintf(stderr, "频偏须小于%dppm，同步间隔至少%d秒\n", DS3231_TIMEKEEPER_MAX_DRIFT_PPM,
+                DS3231_TIMEKEEPER_MIN_DRIFT_S);
+        return 2;
+    }
+    skew_us = ppm;
+    const int32_t expected_ppb = (int32_t)(ppm * 1000);
+    // 同步前的推算误差：未补偿时为整个间隔的频偏，收敛后只剩估计误差
+    const int32_t raw_error_us = (int32_t)(ppm * interval);
+    const int32_t converged_error_us = (int32_t)((uint64_t)DRIFT_TOLERANCE_PPB * interval / 1000000) + 1;
+
+    host_time_set(0);
+    host_ds3231_init(&rtc, START_EPOCH, SQW_GPIO);
+    host_ds3231_attach(&rtc, i2c0);
+    if (!ds3231_init(&ds3231, i2c0, 4, 5) || !ds3231_set_sqw(&ds3231, DS3231_SQW_1HZ) ||
+        !ds3231_timekeeper_init(&tk, &ds3231, interval)) {
+        fprintf(stderr, "初始化失败\n");
+        return 1;
+    }
+
+    // ---- 频偏 ----
+    syncAt(1);
+    printf("频偏 %uppm（%dppb）, 同步间隔 %us\n", ppm, expected_ppb, interval);
+    printf("%-6s %10s %10s %6s\n", "阶段", "同步前误差us", "估计ppb", "有效");
+    for (int i = 0; i < SYNCS_PER_PHASE; i++) {
+        const int32_t error = syncAt(interval);
+        printf("%-6s %10d %10d %6d\n", "频偏", error, tk.drift_ppb, tk.drift_valid);
+        if (abs(error) > raw_error_us + 1) {
+            fail("推算误差超过未补偿的频偏", error);
+        }
+    }
+    if (!converged(expected_ppb)) {
+        fail("频偏估计没有收敛", tk.drift_ppb);
+    }
+    if (abs(tk.last_error_us) > converged_error_us) {
+        fail("收敛后的推算误差", tk.last_error_us);
+    }
+
+    // ---- 跳变 ----
+    static const int64_t steps[] = {300, -300, 1};
+    for (int64_t delta : steps) {
+        const uint32_t steps_before = tk.steps;
+        runSeconds(interval / 2);
+        stepRtc(delta);
+        const int32_t error = syncAt(interval - interval / 2);
+        printf("%+5llds %10d %10d %6d\n", (long long)delta, error, tk.drift_ppb, tk.drift_valid);
+        // 1秒的跳变在长间隔内与真实频偏区分不开时，由频偏上界剔除
+        if (tk.steps != steps_before + 1 || tk.drift_valid || tk.drift_ppb != 0) {
+            fail("跳变没有丢弃频偏估计", tk.drift_ppb);
+        }
+
+        // 以新时间为基准：其后60秒本地推算前进60秒（频偏未补偿，误差为ppm*60us）
+        const uint64_t before = ds3231_timekeeper_now_us(&tk);
+        runSeconds(60);
+        const int64_t advanced = (int64_t)(ds3231_timekeeper_now_us(&tk) - before);
+        if (llabs(advanced - 60000000) > (int64_t)ppm * 60 + 1000) {
+            fail("跳变后60秒的推算", advanced);
+        }
+
+        for (int i = 0; i < SYNCS_PER_PHASE; i++) {
+            const int32_t e = syncAt(interval);
+            printf("%-6s %10d %10d %6d\n", "恢复", e, tk.drift_ppb, tk.drift_valid);
+        }
+        if (!converged(expected_ppb)) {
+            fail("跳变后频偏估计没有重新收敛", tk.drift_ppb);
+        }
+    }
+
+    printf("同步 %u 次, RTC读取 %u 次, 检测到跳变 %u 次, 失败 %lu\n", tk.sync_count, tk.rtc_reads, tk.steps,
+           failures);
+    return failures ? 1 : 0;
+}
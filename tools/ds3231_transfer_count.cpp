@@ -0,0 +1,269 @@
+// DS3231驱动I2C事务计数（主机端）
+//
+// 在主机端DS3231模型（tools/host_stubs/host_ds3231）上逐项执行常用操作，统计每项的
+// I2C事务数、数据字节数与100kHz下的总线时间（host_i2c_stats），比较两种做法：
+//   逐寄存器 单寄存器读写、读改写先读后写（突发读写与寄存器缓存之前驱动的做法，
+//            按原实现在本文件中重写）
+//   当前驱动 src/ds3231下的突发读写与控制/状态/老化寄存器写穿缓存
+// 两种做法分别作用于各自的DS3231模型，最后比较两者的寄存器（时间、温度除外）
+// 确认结果相同。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ds3231_transfer_count.cpp tools/host_stubs/host_ds3231.cpp tools/host_stubs/host_stubs.cpp src/ds3231/*.cpp src/i2c_bus.cpp -o ds3231_transfer_count
+// 用法: ds3231_transfer_count
+
+#include "host_ds3231.h"
+#include "ds3231/ds3231.h"
+#include <cstdio>
+#include <cstring>
+
+// 2024-06-01 12:00:00
+#define START_EPOCH 1717243200LL
+
+// ---- 逐寄存器的做法 ----
+
+static bool legacyWrite(ds3231_t* ds, uint8_t reg, uint8_t value) {
+    uint8_t data[2] = {reg, value};
+    return i2c_write_blocking(ds->i2c, ds->addr, data, 2, false) == 2;
+}
+
+static bool legacyRead(ds3231_t* ds, uint8_t reg, uint8_t* value) {
+    return i2c_write_blocking(ds->i2c, ds->addr, &reg, 1, true) == 1 &&
+           i2c_read_blocking(ds->i2c, ds->addr, value, 1, false) == 1;
+}
+
+static bool legacyReadTime(ds3231_t* ds, ds3231_time_t* time) {
+    uint8_t reg = DS3231_SECONDS_REG, data[7];
+    if (i2c_write_blocking(ds->i2c, ds->addr, &reg, 1, true) != 1 ||
+        i2c_read_blocking(ds->i2c, ds->addr, data, 7, false) != 7) {
+        return false;
+    }
+    return ds3231_decode_time(data, time);
+}
+
+static bool legacyReadTemperature(ds3231_t* ds, float* temperature) {
+    uint8_t msb, lsb;
+    if (!legacyRead(ds, DS3231_TEMP_MSB, &msb) || !legacyRead(ds, DS3231_TEMP_LSB, &lsb)) {
+        return false;
+    }
+    *temperature = (int16_t)((msb << 8) | lsb) / 64 * 0.25f;
+    return true;
+}
+
+static bool legacyUpdateControl(ds3231_t* ds, uint8_t clear_bits, uint8_t set_bits) {
+    uint8_t control;
+    return legacyRead(ds, DS3231_CONTROL_REG, &control) &&
+           legacyWrite(ds, DS3231_CONTROL_REG, (uint8_t)((control & ~clear_bits) | set_bits));
+}
+
+static bool legacySetAlarm(ds3231_t* ds, uint8_t first, const uint8_t* regs, uint8_t count) {
+    uint8_t data[5];
+    data[0] = first;
+    memcpy(&data[1], regs, count);
+    return i2c_write_blocking(ds->i2c, ds->addr, data, count + 1, false) == count + 1;
+}
+
+static bool legacyReadFlags(ds3231_t* ds, uint8_t* flags) {
+    uint8_t status;
+    if (!legacyRead(ds, DS3231_STATUS_REG, &status)) {
+        return false;
+    }
+    *flags = status & (DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG);
+    return true;
+}
+
+static bool legacyClearFlags(ds3231_t* ds, uint8_t flags) {
+    uint8_t status;
+    return legacyRead(ds, DS3231_STATUS_REG, &status) &&
+           legacyWrite(ds, DS3231_STATUS_REG, (uint8_t)(status & ~flags));
+}
+
+// ---- 测量 ----
+
+struct Side {
+    host_ds3231_t rtc;
+    ds3231_t ds;
+    i2c_inst_t* i2c;
+};
+
+struct Cost {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint64_t busy_us;
+};
+
+static Cost total_before, total_after;
+static bool all_ok = true;
+
+template <typename Fn>
+static Cost measure(Side& side, Fn fn) {
+    host_i2c_reset_stats(side.i2c);
+    if (!fn(&side.ds)) {
+        all_ok = false;
+    }
+    const host_i2c_stats_t* s = host_i2c_stats(side.i2c);
+    return {s->transactions, s->bytes, s->busy_us};
+}
+
+template <typename Before, typename After>
+static void row(const char* name, Side& before, Side& after, Before fb, After fa) {
+    const Cost b = measure(before, fb);
+    const Cost a = measure(after, fa);
+    printf("%5u %5u %7llu   %5u %5u %7llu   %s\n", b.transactions, b.bytes, (unsigned long long)b.busy_us,
+           a.transactions, a.bytes, (unsigned long long)a.busy_us, name);
+    total_before.transactions += b.transactions;
+    total_before.bytes += b.bytes;
+    total_before.busy_us += b.busy_us;
+    total_after.transactions += a.transactions;
+    total_after.bytes += a.bytes;
+    total_after.busy_us += a.busy_us;
+}
+
+static void setupSide(Side& side, i2c_inst_t* i2c) {
+    side.i2c = i2c;
+    host_ds3231_init(&side.rtc, START_EPOCH, -1);
+    host_ds3231_set_temperature(&side.rtc, 27.25f);
+    host_ds3231_attach(&side.rtc, i2c);
+    // 逐寄存器一侧只用到i2c和addr
+    side.ds.i2c = i2c;
+    side.ds.addr = DS3231_I2C_ADDR;
+    i2c_init(i2c, DS3231_I2C_BAUDRATE);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        fprintf(stderr, "用法: %s\n", argv[0]);
+        return 2;
+    }
+
+    // 两种做法各用一路I2C和一个DS3231模型
+    static Side before, after;
+    setupSide(before, i2c0);
+    setupSide(after, i2c1);
+
+    printf("逐寄存器: 事务 字节 总线us | 当前驱动: 事务 字节 总线us | 操作\n");
+
+    row("初始化（启用振荡器）", before, after,
+        [](ds3231_t* ds) { return legacyUpdateControl(ds, 1 << DS3231_EOSC_BIT, 0); },
+        [](ds3231_t* ds) { return ds3231_init(ds, i2c1, 2, 3); });
+
+    row("读取时间+温度", before, after,
+        [](ds3231_t* ds) {
+            ds3231_time_t t;
+            float c;
+            return legacyReadTime(ds, &t) && legacyReadTemperature(ds, &c);
+        },
+        [](ds3231_t* ds) {
+            ds3231_time_t t;
+            float c;
+            return ds3231_read_time(ds, &t) && ds3231_read_temperature(ds, &c);
+        });
+
+    // 示例的每秒循环：逐寄存器每秒读时间和温度；当前驱动的温度在两次自动转换之间取缓存
+    row("每秒时间+温度，持续64秒", before, after,
+        [](ds3231_t* ds) {
+            for (int i = 0; i < 64; i++) {
+                ds3231_time_t t;
+                float c;
+                if (!legacyReadTime(ds, &t) || !legacyReadTemperature(ds, &c)) {
+                    return false;
+                }
+                host_time_advance(1000000);
+            }
+            return true;
+        },
+        [](ds3231_t* ds) {
+            for (int i = 0; i < 64; i++) {
+                ds3231_time_t t;
+                float c;
+                if (!ds3231_read_time(ds, &t) || !ds3231_get_temperature(ds, &c)) {
+                    return false;
+                }
+                host_time_advance(1000000);
+            }
+            return true;
+        });
+
+    row("启用1Hz SQW", before, after,
+        [](ds3231_t* ds) {
+            return legacyUpdateControl(ds, (1 << DS3231_INTCN_BIT) | (1 << DS3231_RS2_BIT) | (1 << DS3231_RS1_BIT), 0);
+        },
+        [](ds3231_t* ds) { return ds3231_set_sqw(ds, DS3231_SQW_1HZ); });
+
+    row("再次启用1Hz SQW（不变）", before, after,
+        [](ds3231_t* ds) {
+            return legacyUpdateControl(ds, (1 << DS3231_INTCN_BIT) | (1 << DS3231_RS2_BIT) | (1 << DS3231_RS1_BIT), 0);
+        },
+        [](ds3231_t* ds) { return ds3231_set_sqw(ds, DS3231_SQW_1HZ); });
+
+    // 闹钟调度器每次service的寄存器访问：读标志、清标志、设置两个闹钟、中断使能
+    static const ds3231_alarm_t a1 = {30, 5, 13, 1}, a2 = {0, 10, 13, 1};
+    row("闹钟service（首次）", before, after,
+        [](ds3231_t* ds) {
+            static const uint8_t r1[4] = {0x30, 0x05, 0x13, 0x01}, r2[3] = {0x10, 0x13, 0x01};
+            uint8_t flags;
+            return legacyReadFlags(ds, &flags) && legacyClearFlags(ds, flags) &&
+                   legacySetAlarm(ds, DS3231_ALARM1_SEC, r1, 4) && legacySetAlarm(ds, DS3231_ALARM2_MIN, r2, 3) &&
+                   legacyUpdateControl(ds, (1 << DS3231_A1IE_BIT) | (1 << DS3231_A2IE_BIT),
+                                       (1 << DS3231_INTCN_BIT) | (1 << DS3231_A1IE_BIT) | (1 << DS3231_A2IE_BIT));
+        },
+        [](ds3231_t* ds) {
+            uint8_t flags;
+            return ds3231_read_alarm_flags(ds, &flags) && ds3231_clear_alarm_flags(ds, flags) &&
+                   ds3231_set_alarm1(ds, &a1, DS3231_ALARM1_MATCH_DATE_HMS) &&
+                   ds3231_set_alarm2(ds, &a2, DS3231_ALARM2_MATCH_DATE_HM) &&
+                   ds3231_enable_alarm_interrupts(ds, true, true);
+        });
+
+    row("清除闹钟标志", before, after, [](ds3231_t* ds) { return legacyClearFlags(ds, DS3231_ALARM1_FLAG); },
+        [](ds3231_t* ds) { return ds3231_clear_alarm_flags(ds, DS3231_ALARM1_FLAG); });
+
+    row("读取全部19个寄存器", before, after,
+        [](ds3231_t* ds) {
+            uint8_t v;
+            for (uint8_t r = 0; r < DS3231_REG_COUNT; r++) {
+                if (!legacyRead(ds, r, &v)) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        [](ds3231_t* ds) {
+            uint8_t regs[DS3231_REG_COUNT];
+            return ds3231_read_snapshot(ds, regs);
+        });
+
+    // 写入后确认不忙（BSY）再强制转换（CONV），使新偏移立即生效
+    row("设置老化偏移", before, after,
+        [](ds3231_t* ds) {
+            uint8_t status;
+            return legacyWrite(ds, DS3231_AGING_REG, 0xFE) && legacyRead(ds, DS3231_STATUS_REG, &status) &&
+                   !(status & (1 << DS3231_BSY_BIT)) && legacyUpdateControl(ds, 0, 1 << DS3231_CONV_BIT);
+        },
+        [](ds3231_t* ds) { return ds3231_set_aging_offset(ds, -2); });
+
+    row("读取老化偏移", before, after,
+        [](ds3231_t* ds) {
+            uint8_t v;
+            return legacyRead(ds, DS3231_AGING_REG, &v) && v == 0xFE;
+        },
+        [](ds3231_t* ds) {
+            int8_t v;
+            return ds3231_get_aging_offset(ds, &v) && v == -2;
+        });
+
+    printf("%5u %5u %7llu   %5u %5u %7llu   合计\n", total_before.transactions, total_before.bytes,
+           (unsigned long long)total_before.busy_us, total_after.transactions, total_after.bytes,
+           (unsigned long long)total_after.busy_us);
+
+    // 两侧寄存器应一致（时间、温度除外）
+    bool same = true;
+    for (uint8_t r = DS3231_ALARM1_SEC; r < DS3231_TEMP_MSB; r++) {
+        if (before.rtc.regs[r] != after.rtc.regs[r]) {
+            printf("寄存器0x%02X不一致: 逐寄存器 0x%02X, 当前驱动 0x%02X\n", r, before.rtc.regs[r],
+                   after.rtc.regs[r]);
+            same = false;
+        }
+    }
+    printf("寄存器结果%s, 操作%s\n", same ? "一致" : "不一致", all_ok ? "全部成功" : "有失败");
+    return same && all_ok ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// 事件循环模拟（主机端）
+//
+// 在host_stubs的虚拟时钟上运行event_loop：now端口为time_us_64()，idle端口把虚拟时钟
+// 拨到until_us或下一个“中断”（SQW边沿）中较早的一个，相当于设备上的WFE。
+// 任务的CPU时间用host_time_advance()模拟，按优先级（添加顺序）为：
+//   tick   轮询来源：每秒一个SQW边沿（中断只置位，poll读取），通知render，50us
+//   sensor 周期定时器：每100ms一次，向log写一条，300us
+//   render 信号：渲染一帧后通知flush，向log写一条，2000us
+//   blink  协程：亮100ms、灭900ms（EVENT_TASK_SLEEP），每次20us
+//   flush  协程：整帧23200us的传输分成若干块，块之间EVENT_TASK_YIELD
+//   log    轮询来源：队列非空时每次输出一条，200us
+// 检查：各任务的运行次数与预期相同；CPU时间等于运行次数乘以每次的耗时，
+// 各任务与空闲之和等于总时长；定时器与轮询来源的最大延迟不超过上界
+// （非抢占：一次最长的任务运行，加上优先级更高的任务各运行一次）。
+// 之后用event_loop_print_stats()输出各任务的CPU占比。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/event_loop_sim.cpp src/event_loop.cpp tools/host_stubs/host_stubs.cpp -o event_loop_sim
+// 用法: event_loop_sim [-t 模拟秒数] [-c 每帧传输块数]
+
+#include "host_stubs.h"
+#include "event_loop.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define TICK_COST_US    50
+#define SENSOR_COST_US  300
+#define RENDER_COST_US  2000
+#define BLINK_COST_US   20
+#define FLUSH_FRAME_US  23200
+#define LOG_COST_US     200
+
+#define SQW_PERIOD_US    1000000
+#define SQW_FIRST_US     500000
+#define SENSOR_PERIOD_US 100000
+#define SENSOR_FIRST_US  10000   // 与传输重叠：边沿后10ms到期时flush正在传输
+#define BLINK_ON_US      100000
+#define BLINK_OFF_US     900000
+
+#define RENDER_EV_FRAME 0x01
+#define FLUSH_EV_FRAME  0x01
+#define BLINK_EV_START  0x01
+
+struct Sim {
+    event_loop_t loop;
+    event_task_t tick, sensor, render, blink, flush, log;
+    uint64_t next_edge_us;      // 下一个SQW边沿
+    uint32_t edges;
+    uint32_t max_edge_late_us;  // 边沿到tick任务运行的最长延迟
+    uint32_t chunks;            // 每帧的传输块数
+    uint32_t chunk;             // flush协程的进度
+    uint32_t chunks_sent;
+    uint32_t toggles;
+    uint32_t log_pending;
+    uint32_t log_written;
+};
+
+static Sim sim;
+
+static uint64_t hostNow(void* ctx) {
+    return time_us_64();
+}
+
+// 没有就绪任务：睡到最近的定时器，SQW边沿（中断）提前唤醒
+static void hostIdle(void* ctx, uint64_t until_us) {
+    const uint64_t wake = std::min(until_us, sim.next_edge_us);
+    if (wake > time_us_64()) {
+        host_time_advance(wake - time_us_64());
+    }
+}
+
+static bool edgePending(void* ctx) {
+    return time_us_64() >= sim.next_edge_us;
+}
+
+static void tickTask(event_task_t* task, uint32_t events) {
+    const uint64_t now = time_us_64();
+    while (now >= sim.next_edge_us) {
+        sim.max_edge_late_us = std::max(sim.max_edge_late_us, (uint32_t)(now - sim.next_edge_us));
+        sim.next_edge_us += SQW_PERIOD_US;
+        sim.edges++;
+    }
+    event_task_signal(&sim.render, RENDER_EV_FRAME);
+    host_time_advance(TICK_COST_US);
+}
+
+static void sensorTask(event_task_t* task, uint32_t events) {
+    sim.log_pending++;
+    host_time_advance(SENSOR_COST_US);
+}
+
+static void renderTask(event_task_t* task, uint32_t events) {
+    event_task_signal(&sim.flush, FLUSH_EV_FRAME);
+    sim.log_pending++;
+    host_time_advance(RENDER_COST_US);
+}
+
+static void blinkTask(event_task_t* task, uint32_t events) {
+    EVENT_TASK_BEGIN(task);
+    while (true) {
+        sim.toggles++;
+        host_time_advance(BLINK_COST_US);
+        EVENT_TASK_SLEEP(task, &sim.loop, BLINK_ON_US);
+        sim.toggles++;
+        host_time_advance(BLINK_COST_US);
+        EVENT_TASK_SLEEP(task, &sim.loop, BLINK_OFF_US);
+    }
+    EVENT_TASK_END(task);
+}
+
+static void flushTask(event_task_t* task, uint32_t events) {
+    EVENT_TASK_BEGIN(task);
+    if (!(events & FLUSH_EV_FRAME)) {
+        return;
+    }
+    for (sim.chunk = 0; sim.chunk < sim.chunks; sim.chunk++) {
+        host_time_advance(FLUSH_FRAME_US / sim.chunks);
+        sim.chunks_sent++;
+        EVENT_TASK_YIELD(task);
+    }
+    EVENT_TASK_END(task);
+}
+
+static bool logPending(void* ctx) {
+    return sim.log_pending != 0;
+}
+
+static void logTask(event_task_t* task, uint32_t events) {
+    sim.log_pending--;
+    sim.log_written++;
+    host_time_advance(LOG_COST_US);
+}
+
+static unsigned long failures;
+
+static void expect(const char* what, uint64_t actual, uint64_t expected) {
+    if (actual != expected) {
+        failures++;
+        fprintf(stderr, "%s: %llu, 预期 %llu\n", what, (unsigned long long)actual, (unsigned long long)expected);
+    }
+}
+
+static void expectAtMost(const char* what, uint64_t actual, uint64_t bound) {
+    if (actual > bound) {
+        failures++;
+        fprintf(stderr, "%s: %llu, 上界 %llu\n", what, (unsigned long long)actual, (unsigned long long)bound);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 60, chunks = 8;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            chunks = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-t 模拟秒数] [-c 每帧传输块数]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!seconds || !chunks || FLUSH_FRAME_US % chunks) {
+        fprintf(stderr, "模拟秒数须大于0，块数须能整除%d\n", FLUSH_FRAME_US);
+        return 2;
+    }
+
+    host_time_set(0);
+    sim.chunks = chunks;
+    sim.next_edge_us = SQW_FIRST_US;
+    event_loop_t* loop = &sim.loop;
+    event_loop_init(loop, hostNow, hostIdle, nullptr);
+    event_loop_add(loop, &sim.tick, "tick", tickTask, nullptr);
+    event_loop_add(loop, &sim.sensor, "sensor", sensorTask, nullptr);
+    event_loop_add(loop, &sim.render, "render", renderTask, nullptr);
+    event_loop_add(loop, &sim.blink, "blink", blinkTask, nullptr);
+    event_loop_add(loop, &sim.flush, "flush", flushTask, nullptr);
+    event_loop_add(loop, &sim.log, "log", logTask, nullptr);
+    event_task_set_poll(&sim.tick, edgePending);
+    event_task_set_poll(&sim.log, logPending);
+    event_task_timer(loop, &sim.sensor, SENSOR_FIRST_US, SENSOR_PERIOD_US);
+    event_task_signal(&sim.blink, BLINK_EV_START);
+
+    const uint64_t end_us = (uint64_t)seconds * 1000000;
+    event_loop_run(loop, end_us);
+    event_loop_print_stats(loop);
+
+    // 运行次数：每帧的最后一块之后flush还要运行一次结束协程
+    expect("SQW边沿", sim.edges, seconds);
+    expect("tick运行", sim.tick.runs, seconds);
+    expect("sensor运行", sim.sensor.runs, (end_us - SENSOR_FIRST_US + SENSOR_PERIOD_US - 1) / SENSOR_PERIOD_US);
+    expect("render运行", sim.render.runs, seconds);
+    expect("传输块", sim.chunks_sent, (uint64_t)seconds * chunks);
+    expect("flush运行", sim.flush.runs, (uint64_t)seconds * (chunks + 1));
+    expect("log运行", sim.log.runs, sim.log_written);
+    expect("log条数", sim.log_written, sim.sensor.runs + sim.render.runs);
+    expect("sensor错过周期", sim.sensor.overruns, 0);
+    // 亮灭各一次为一个周期，SLEEP从运行时刻起算，延迟会累积，最后一个周期可能不完整
+    expectAtMost("blink切换", sim.toggles, 2 * seconds);
+    expectAtMost("blink缺少的切换", 2 * seconds - std::min(sim.toggles, 2 * seconds), 1);
+
+    // CPU时间：虚拟时钟只在任务中推进，各任务的CPU时间恰为运行次数乘以耗时
+    uint64_t busy = 0;
+    const struct {
+        const event_task_t* task;
+        uint32_t cost_us;
+    } costs[] = {{&sim.tick, TICK_COST_US},     {&sim.sensor, SENSOR_COST_US}, {&sim.render, RENDER_COST_US},
+                 {&sim.blink, BLINK_COST_US},   {&sim.log, LOG_COST_US}};
+    for (const auto& c : costs) {
+        expect(c.task->name, c.task->cpu_us, (uint64_t)c.task->runs * c.cost_us);
+        busy += c.task->cpu_us;
+    }
+    expect("flush CPU", sim.flush.cpu_us, (uint64_t)sim.chunks_sent * (FLUSH_FRAME_US / chunks));
+    busy += sim.flush.cpu_us;
+    expect("任务与空闲之和", busy + loop->idle_us, end_us);
+
+    // 延迟上界：非抢占，最长一次运行之后，优先级更高的任务各运行一次
+    const uint32_t longest = std::max<uint32_t>({TICK_COST_US, SENSOR_COST_US, RENDER_COST_US, BLINK_COST_US,
+                                                 FLUSH_FRAME_US / chunks, LOG_COST_US});
+    const uint32_t tick_bound = longest;
+    const uint32_t sensor_bound = longest + TICK_COST_US;
+    expectAtMost("SQW边沿延迟", sim.max_edge_late_us, tick_bound);
+    expectAtMost("sensor定时器延迟", sim.sensor.max_late_us, sensor_bound);
+
+    printf("每帧%u块: 边沿最长延迟 %uus（上界 %u）, 定时器最长延迟 %uus（上界 %u）, 失败 %lu\n", chunks,
+           sim.max_edge_late_us, tick_bound, sim.sensor.max_late_us, sensor_bound, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,21 @@
+// 主机端Pico SDK替身：时钟配置为空操作
+#ifndef HOST_STUBS_HARDWARE_CLOCKS_H
+#define HOST_STUBS_HARDWARE_CLOCKS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MHZ 1000000
+#define XOSC_MHZ 12
+#define CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC 2
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF 0
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS 0
+
+enum clock_index { clk_gpout0 = 0, clk_gpout1, clk_gpout2, clk_gpout3, clk_ref, clk_sys, clk_peri, clk_usb, clk_adc, clk_rtc };
+
+static inline bool clock_configure(enum clock_index clk, uint32_t src, uint32_t auxsrc, uint32_t src_freq,
+                                   uint32_t freq) { return true; }
+static inline void clock_stop(enum clock_index clk) {}
+static inline void clocks_init(void) {}
+
+#endif // HOST_STUBS_HARDWARE_CLOCKS_H
@@ -0,0 +1,43 @@
+// 主机端Pico SDK替身：GPIO配置为空操作，输入读为高电平，边沿中断由host_gpio_irq()模拟
+#ifndef HOST_STUBS_HARDWARE_GPIO_H
+#define HOST_STUBS_HARDWARE_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum gpio_function { GPIO_FUNC_I2C = 3, GPIO_FUNC_PWM = 4, GPIO_FUNC_SIO = 5 };
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1,
+    GPIO_IRQ_LEVEL_HIGH = 0x2,
+    GPIO_IRQ_EDGE_FALL = 0x4,
+    GPIO_IRQ_EDGE_RISE = 0x8
+};
+#define GPIO_IN  false
+#define GPIO_OUT true
+
+typedef void (*gpio_irq_callback_t)(unsigned int gpio, uint32_t event_mask);
+
+static inline void gpio_init(unsigned int gpio) {}
+static inline void gpio_set_function(unsigned int gpio, enum gpio_function fn) {}
+static inline void gpio_pull_up(unsigned int gpio) {}
+static inline void gpio_set_dir(unsigned int gpio, bool out) {}
+static inline void gpio_put(unsigned int gpio, bool value) {}
+static inline bool gpio_get(unsigned int gpio) { return true; }
+static inline void gpio_set_irq_enabled(unsigned int gpio, uint32_t events, bool enabled) {}
+static inline void gpio_set_dormant_irq_enabled(unsigned int gpio, uint32_t events, bool enabled) {}
+static inline void gpio_add_raw_irq_handler_masked(uint32_t gpio_mask, void (*handler)(void)) {}
+static inline void gpio_remove_raw_irq_handler_masked(uint32_t gpio_mask, void (*handler)(void)) {}
+static inline void gpio_acknowledge_irq(unsigned int gpio, uint32_t events) {}
+uint32_t gpio_get_irq_event_mask(unsigned int gpio);
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_STUBS_HARDWARE_GPIO_H
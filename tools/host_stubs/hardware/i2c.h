@@ -0,0 +1,62 @@
+// 主机端Pico SDK替身：I2C控制器（两路），目标设备由host_i2c_attach()挂接。
+// 阻塞接口按速率推进虚拟时钟；直接操作寄存器的异步事务由FIFO模型处理（见host_stubs.cpp）
+#ifndef HOST_STUBS_HARDWARE_I2C_H
+#define HOST_STUBS_HARDWARE_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/time.h"
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400
+#define I2C_IC_DATA_CMD_STOP_BITS    0x00000200
+#define I2C_IC_DATA_CMD_CMD_BITS     0x00000100
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS  0x00000040
+
+// 只保留驱动用到的寄存器；读清零寄存器（clr_*）在主机上由FIFO模型在下一个事务开始时清除
+typedef struct {
+    volatile uint32_t con;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t intr_mask;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_intr;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+    volatile uint32_t enable;
+} i2c_hw_t;
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *const i2c0;
+extern i2c_inst_t *const i2c1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+unsigned int i2c_set_baudrate(i2c_inst_t *i2c, unsigned int baudrate);
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+int i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                             absolute_time_t until);
+int i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                            absolute_time_t until);
+static inline int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return i2c_write_blocking_until(i2c, addr, src, len, nostop, UINT64_MAX);
+}
+static inline int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    return i2c_read_blocking_until(i2c, addr, dst, len, nostop, UINT64_MAX);
+}
+size_t i2c_get_write_available(i2c_inst_t *i2c);
+size_t i2c_get_read_available(i2c_inst_t *i2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_STUBS_HARDWARE_I2C_H
@@ -0,0 +1,20 @@
+// 主机端Pico SDK替身：中断注册为空操作
+#ifndef HOST_STUBS_HARDWARE_IRQ_H
+#define HOST_STUBS_HARDWARE_IRQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*irq_handler_t)(void);
+
+#define PWM_IRQ_WRAP 4
+#define IO_IRQ_BANK0 13
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+static inline void irq_add_shared_handler(unsigned int num, irq_handler_t handler, uint8_t order) {}
+static inline void irq_remove_handler(unsigned int num, irq_handler_t handler) {}
+static inline void irq_set_enabled(unsigned int num, bool enabled) {}
+
+#endif // HOST_STUBS_HARDWARE_IRQ_H
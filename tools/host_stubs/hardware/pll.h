@@ -0,0 +1,12 @@
+// 主机端Pico SDK替身
+#ifndef HOST_STUBS_HARDWARE_PLL_H
+#define HOST_STUBS_HARDWARE_PLL_H
+
+typedef struct { int unused; } pll_hw_t;
+typedef pll_hw_t *PLL;
+#define pll_sys ((PLL)0)
+#define pll_usb ((PLL)0)
+
+static inline void pll_deinit(PLL pll) {}
+
+#endif // HOST_STUBS_HARDWARE_PLL_H
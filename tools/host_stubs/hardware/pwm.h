@@ -0,0 +1,27 @@
+// 主机端Pico SDK替身：PWM计数器恒为0
+#ifndef HOST_STUBS_HARDWARE_PWM_H
+#define HOST_STUBS_HARDWARE_PWM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+enum pwm_chan { PWM_CHAN_A = 0, PWM_CHAN_B = 1 };
+enum pwm_clkdiv_mode { PWM_DIV_FREE_RUNNING, PWM_DIV_B_HIGH, PWM_DIV_B_RISING, PWM_DIV_B_FALLING };
+typedef struct { uint32_t csr, div, top; } pwm_config;
+
+static inline unsigned int pwm_gpio_to_slice_num(unsigned int gpio) { return (gpio >> 1) & 7; }
+static inline unsigned int pwm_gpio_to_channel(unsigned int gpio) { return gpio & 1; }
+static inline pwm_config pwm_get_default_config(void) {
+    pwm_config c = {0, 16, 0xFFFF};
+    return c;
+}
+static inline void pwm_config_set_clkdiv_mode(pwm_config *c, enum pwm_clkdiv_mode mode) { c->csr = mode; }
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->top = wrap; }
+static inline void pwm_init(unsigned int slice, pwm_config *c, bool start) {}
+static inline void pwm_set_enabled(unsigned int slice, bool enabled) {}
+static inline uint16_t pwm_get_counter(unsigned int slice) { return 0; }
+static inline void pwm_clear_irq(unsigned int slice) {}
+static inline void pwm_set_irq_enabled(unsigned int slice, bool enabled) {}
+static inline uint32_t pwm_get_irq_status_mask(void) { return 0; }
+
+#endif // HOST_STUBS_HARDWARE_PWM_H
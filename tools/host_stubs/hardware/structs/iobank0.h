@@ -0,0 +1,14 @@
+// 主机端Pico SDK替身：中断状态寄存器恒为0
+#ifndef HOST_STUBS_HARDWARE_STRUCTS_IOBANK0_H
+#define HOST_STUBS_HARDWARE_STRUCTS_IOBANK0_H
+
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t intr[4];
+} iobank0_hw_t;
+
+extern iobank0_hw_t host_iobank0;
+#define iobank0_hw (&host_iobank0)
+
+#endif // HOST_STUBS_HARDWARE_STRUCTS_IOBANK0_H
@@ -0,0 +1,13 @@
+// 主机端Pico SDK替身：单线程模拟，无需关中断
+#ifndef HOST_STUBS_HARDWARE_SYNC_H
+#define HOST_STUBS_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) {}
+static inline void __wfe(void) {}
+static inline void __wfi(void) {}
+static inline void __sev(void) {}
+
+#endif // HOST_STUBS_HARDWARE_SYNC_H
@@ -0,0 +1,9 @@
+// 主机端Pico SDK替身：总是冷启动
+#ifndef HOST_STUBS_HARDWARE_WATCHDOG_H
+#define HOST_STUBS_HARDWARE_WATCHDOG_H
+
+#include <stdbool.h>
+
+static inline bool watchdog_caused_reboot(void) { return false; }
+
+#endif // HOST_STUBS_HARDWARE_WATCHDOG_H
@@ -0,0 +1,7 @@
+// 主机端Pico SDK替身：dormant立即返回
+#ifndef HOST_STUBS_HARDWARE_XOSC_H
+#define HOST_STUBS_HARDWARE_XOSC_H
+
+static inline void xosc_dormant(void) {}
+
+#endif // HOST_STUBS_HARDWARE_XOSC_H
@@ -0,0 +1,221 @@
+#include "host_ds3231.h"
+#include "ds3231/ds3231_calendar.h"
+#include <string.h>
+
+static uint8_t to_bcd(uint32_t v) {
+    return (uint8_t)(((v / 10) << 4) | (v % 10));
+}
+
+static uint32_t from_bcd(uint8_t v) {
+    return (v >> 4) * 10 + (v & 0x0F);
+}
+
+// epoch写入时间寄存器（星期寄存器单独维护）
+static void store_time(host_ds3231_t *rtc) {
+    ds3231_time_t t;
+    ds3231_epoch_to_time(rtc->epoch, &t);
+    rtc->regs[DS3231_SECONDS_REG] = to_bcd(t.seconds);
+    rtc->regs[DS3231_MINUTES_REG] = to_bcd(t.minutes);
+    rtc->regs[DS3231_HOURS_REG] = to_bcd(t.hours);
+    rtc->regs[DS3231_DATE_REG] = to_bcd(t.date);
+    rtc->regs[DS3231_MONTH_REG] = to_bcd(t.month);
+    rtc->regs[DS3231_YEAR_REG] = to_bcd(t.year % 100);
+}
+
+// 时间寄存器换算为epoch（24小时制，2000-2099年）
+static void load_time(host_ds3231_t *rtc) {
+    const uint8_t *r = rtc->regs;
+    int32_t days = ds3231_days_from_civil(2000 + (int32_t)from_bcd(r[DS3231_YEAR_REG]),
+                                          from_bcd(r[DS3231_MONTH_REG] & 0x1F), from_bcd(r[DS3231_DATE_REG] & 0x3F));
+    rtc->epoch = (int64_t)days * 86400 + from_bcd(r[DS3231_HOURS_REG] & 0x3F) * 3600 +
+                 from_bcd(r[DS3231_MINUTES_REG] & 0x7F) * 60 + from_bcd(r[DS3231_SECONDS_REG] & 0x7F);
+}
+
+// 闹钟寄存器与当前时间比较：bit7为屏蔽位，最后一个寄存器的bit6为DY/DT
+static bool alarm_matches(const host_ds3231_t *rtc, uint8_t first, uint8_t count, uint8_t time_reg) {
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t a = rtc->regs[first + i];
+        if (a & 0x80) {
+            continue;
+        }
+        if (i == count - 1) {
+            // 日期/星期
+            if (a & 0x40) {
+                if ((a & 0x0F) != (rtc->regs[DS3231_DAY_REG] & 0x07)) {
+                    return false;
+                }
+            } else if ((a & 0x3F) != (rtc->regs[DS3231_DATE_REG] & 0x3F)) {
+                return false;
+            }
+        } else if ((a & 0x7F) != (rtc->regs[time_reg + i] & 0x7F)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 秒更新：时间加1秒，比较闹钟
+static void second_tick(host_ds3231_t *rtc) {
+    rtc->epoch++;
+    store_time(rtc);
+    if (rtc->epoch % 86400 == 0) {
+        rtc->regs[DS3231_DAY_REG] = (uint8_t)(rtc->regs[DS3231_DAY_REG] % 7 + 1);
+    }
+
+    if (alarm_matches(rtc, DS3231_ALARM1_SEC, 4, DS3231_SECONDS_REG)) {
+        rtc->regs[DS3231_STATUS_REG] |= DS3231_ALARM1_FLAG;
+        rtc->alarm1_matches++;
+    }
+    if (rtc->regs[DS3231_SECONDS_REG] == 0 && alarm_matches(rtc, DS3231_ALARM2_MIN, 3, DS3231_MINUTES_REG)) {
+        rtc->regs[DS3231_STATUS_REG] |= DS3231_ALARM2_FLAG;
+        rtc->alarm2_matches++;
+    }
+
+    const uint8_t control = rtc->regs[DS3231_CONTROL_REG];
+    if (!(control & (1 << DS3231_INTCN_BIT)) && !(control & ((1 << DS3231_RS2_BIT) | (1 << DS3231_RS1_BIT)))) {
+        rtc->sqw_edge = true;
+    }
+}
+
+// 追上虚拟时钟（I2C回调中也会调用，此时不送出边沿）
+static void catch_up(host_ds3231_t *rtc) {
+    const uint64_t now = host_time_us();
+    while (now >= rtc->next_second_us) {
+        second_tick(rtc);
+        rtc->next_second_us += 1000000;
+    }
+}
+
+// 送出INT/SQW下降沿，返回送出的边沿数
+static uint32_t deliver_edges(host_ds3231_t *rtc) {
+    const uint8_t control = rtc->regs[DS3231_CONTROL_REG];
+    const uint8_t status = rtc->regs[DS3231_STATUS_REG];
+    bool low = false;
+    if (control & (1 << DS3231_INTCN_BIT)) {
+        low = (status & control & (DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG)) != 0;
+    }
+
+    uint32_t edges = 0;
+    if ((low && !rtc->int_low) || rtc->sqw_edge) {
+        edges++;
+    }
+    rtc->int_low = low;
+    rtc->sqw_edge = false;
+    if (edges) {
+        rtc->int_edges++;
+        if (rtc->int_gpio >= 0) {
+            host_gpio_irq((unsigned int)rtc->int_gpio, GPIO_IRQ_EDGE_FALL);
+        }
+    }
+    return edges;
+}
+
+static bool rtc_write(void *ctx, const uint8_t *src, size_t len) {
+    host_ds3231_t *rtc = (host_ds3231_t *)ctx;
+    if (len == 0) {
+        return true;
+    }
+    if (src[0] >= DS3231_REG_COUNT) {
+        return false;
+    }
+    if (len > 1 && rtc->fail_writes && src[0] >= rtc->fail_reg_lo && src[0] <= rtc->fail_reg_hi) {
+        rtc->fail_writes--;
+        return false;
+    }
+
+    catch_up(rtc);
+    rtc->pointer = src[0];
+    for (size_t i = 1; i < len; i++) {
+        const uint8_t reg = rtc->pointer;
+        const uint8_t v = src[i];
+        if (reg == DS3231_STATUS_REG) {
+            // OSF/A2F/A1F写0清除、写1不变；EN32kHz可写；BSY只读
+            const uint8_t flags = (1 << DS3231_OSF_BIT) | DS3231_ALARM1_FLAG | DS3231_ALARM2_FLAG;
+            const uint8_t old = rtc->regs[reg];
+            rtc->regs[reg] = (old & flags & v) | (v & (1 << DS3231_EN32KHZ_BIT));
+        } else if (reg == DS3231_CONTROL_REG) {
+            rtc->regs[reg] = v & ~(1 << DS3231_CONV_BIT); // 转换立即完成
+        } else if (reg < DS3231_TEMP_MSB) {
+            rtc->regs[reg] = v;
+            if (reg <= DS3231_YEAR_REG) {
+                rtc->time_written = true;
+                if (reg == DS3231_SECONDS_REG) {
+                    rtc->next_second_us = host_time_us() + 1000000;
+                }
+            }
+        }
+        rtc->pointer = (uint8_t)((rtc->pointer + 1) % DS3231_REG_COUNT);
+    }
+    return true;
+}
+
+static bool rtc_read(void *ctx, uint8_t *dst, size_t len) {
+    host_ds3231_t *rtc = (host_ds3231_t *)ctx;
+    catch_up(rtc);
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = rtc->regs[rtc->pointer];
+        rtc->pointer = (uint8_t)((rtc->pointer + 1) % DS3231_REG_COUNT);
+    }
+    return true;
+}
+
+static void rtc_stop(void *ctx) {
+    host_ds3231_t *rtc = (host_ds3231_t *)ctx;
+    if (rtc->time_written) {
+        rtc->time_written = false;
+        load_time(rtc);
+    }
+}
+
+void host_ds3231_init(host_ds3231_t *rtc, int64_t epoch, int int_gpio) {
+    memset(rtc, 0, sizeof(*rtc));
+    rtc->epoch = epoch;
+    rtc->int_gpio = int_gpio;
+    rtc->next_second_us = host_time_us() + 1000000;
+    store_time(rtc);
+    ds3231_time_t t;
+    ds3231_epoch_to_time(epoch, &t);
+    rtc->regs[DS3231_DAY_REG] = (uint8_t)(t.day + 1);
+    rtc->regs[DS3231_CONTROL_REG] = (1 << DS3231_RS2_BIT) | (1 << DS3231_RS1_BIT) | (1 << DS3231_INTCN_BIT);
+    rtc->regs[DS3231_STATUS_REG] = (1 << DS3231_OSF_BIT) | (1 << DS3231_EN32KHZ_BIT);
+    host_ds3231_set_temperature(rtc, 25.0f);
+    rtc->dev.write = rtc_write;
+    rtc->dev.read = rtc_read;
+    rtc->dev.stop = rtc_stop;
+    rtc->dev.ctx = rtc;
+}
+
+bool host_ds3231_attach(host_ds3231_t *rtc, i2c_inst_t *i2c) {
+    return host_i2c_attach(i2c, DS3231_I2C_ADDR, &rtc->dev);
+}
+
+void host_ds3231_set_temperature(host_ds3231_t *rtc, float celsius) {
+    // 0.25度分辨率，二进制补码：MSB为整数部分，LSB高2位为小数
+    const int16_t quarters = (int16_t)(celsius * 4.0f + (celsius < 0 ? -0.5f : 0.5f));
+    const uint16_t raw = (uint16_t)(quarters << 6);
+    rtc->regs[DS3231_TEMP_MSB] = (uint8_t)(raw >> 8);
+    rtc->regs[DS3231_TEMP_LSB] = (uint8_t)raw;
+}
+
+void host_ds3231_update(host_ds3231_t *rtc) {
+    catch_up(rtc);
+    deliver_edges(rtc);
+}
+
+bool host_ds3231_run_until_int(host_ds3231_t *rtc, uint64_t until_us) {
+    catch_up(rtc);
+    if (deliver_edges(rtc)) {
+        return true;
+    }
+    while (rtc->next_second_us <= until_us) {
+        host_time_advance(rtc->next_second_us - host_time_us());
+        catch_up(rtc);
+        if (deliver_edges(rtc)) {
+            return true;
+        }
+    }
+    if (host_time_us() < until_us) {
+        host_time_advance(until_us - host_time_us());
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+// 主机端DS3231模型（配合host_stubs使用）
+//
+// 19字节寄存器文件，按DS3231数据手册的行为响应I2C读写：
+//   - 寄存器指针：写事务的第一个字节，读写后自动递增，0x12之后回到0x00；
+//   - 时间：按虚拟时钟每秒更新一次时间寄存器（BCD，24小时制），星期寄存器在
+//     午夜加1（1-7循环）。写入秒寄存器时重新开始一秒的计数，写入的时间在STOP时生效；
+//   - 闹钟：每次秒更新时按A1M1-A1M4、A2M2-A2M4屏蔽位与DY/DT比较，匹配时置位A1F/A2F
+//     （闹钟2只在秒为00时比较）。A1F/A2F/OSF写0清除、写1不变，BSY与温度寄存器只读；
+//   - INT/SQW：INTCN=1时任一已使能的闹钟标志置位即拉低，标志清除后释放；
+//     INTCN=0且RS2:RS1为1Hz时每秒更新时产生下降沿。
+// 引脚边沿只在host_ds3231_update()/host_ds3231_run_until_int()中通过host_gpio_irq()送出，
+// 不会在I2C回调中途触发。
+//
+// 故障注入：fail_writes非0时，起始寄存器在[fail_reg_lo, fail_reg_hi]内的写事务被NAK，
+// 每次NAK减1。
+
+#ifndef HOST_DS3231_H
+#define HOST_DS3231_H
+
+#include "host_stubs.h"
+#include "ds3231/ds3231.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t regs[DS3231_REG_COUNT];
+    uint8_t pointer;
+    bool writing_first;       // 写事务的下一个字节是寄存器指针
+    bool time_written;        // 本次写事务改写了时间寄存器
+    int64_t epoch;            // 时间寄存器对应的Unix时间
+    uint64_t next_second_us;  // 下一次秒更新的虚拟时间
+    int int_gpio;             // INT/SQW所接GPIO，-1表示未接
+    bool int_low;             // INT/SQW引脚当前电平（true为低）
+    bool sqw_edge;            // 1Hz方波：有一个待送出的下降沿
+    uint8_t fail_reg_lo;
+    uint8_t fail_reg_hi;
+    uint32_t fail_writes;
+    uint32_t alarm1_matches;
+    uint32_t alarm2_matches;
+    uint32_t int_edges;       // 送出的下降沿数
+    uint32_t reads;           // 读事务数
+    uint32_t writes;          // 写事务数
+    host_i2c_device_t dev;
+} host_ds3231_t;
+
+// 以Unix时间epoch初始化（上电默认值：INTCN=1、RS=8.192kHz、OSF=1、EN32kHz=1）
+void host_ds3231_init(host_ds3231_t *rtc, int64_t epoch, int int_gpio);
+bool host_ds3231_attach(host_ds3231_t *rtc, i2c_inst_t *i2c);
+void host_ds3231_set_temperature(host_ds3231_t *rtc, float celsius);
+// 把时间寄存器推进到当前虚拟时间，并送出期间产生的INT/SQW下降沿
+void host_ds3231_update(host_ds3231_t *rtc);
+// 按秒推进虚拟时钟，直到INT被拉低（相当于MCU休眠等待INT）或到达until_us；
+// INT拉低时停在对应的秒更新时刻并返回true
+bool host_ds3231_run_until_int(host_ds3231_t *rtc, uint64_t until_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_DS3231_H
@@ -0,0 +1,351 @@
+#include "host_stubs.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/iobank0.h"
+#include <string.h>
+
+// 虚拟时钟（纳秒，位时间不是整微秒）
+static uint64_t now_ns;
+
+#define TX_FIFO_DEPTH 16
+#define RX_QUEUE 32
+#define WRITE_BUFFER 1100
+#define DATA_CMD_EMPTY 0xFFFFFFFFu // data_cmd中没有待处理的命令
+
+struct i2c_inst {
+    i2c_hw_t hw;
+    uint32_t baudrate;
+    struct {
+        uint8_t addr;
+        const host_i2c_device_t *dev;
+    } devices[HOST_I2C_MAX_DEVICES];
+    host_i2c_stats_t stats;
+    // 阻塞接口：上一次以nostop结束，下一次为重复起始
+    bool open;
+    // FIFO模型
+    bool in_txn;
+    bool aborted;                   // 已NAK，丢弃命令直到STOP
+    bool reading;                   // 当前阶段方向
+    bool rx_presented;              // data_cmd中是交给驱动的接收字节
+    const host_i2c_device_t *target;
+    uint8_t wbuf[WRITE_BUFFER];     // 当前写阶段的数据，阶段结束时交给设备
+    uint16_t wlen;
+    uint64_t bus_free_ns;           // 已入队的命令全部完成的时刻
+    uint64_t done_ns[TX_FIFO_DEPTH];// 最近16条命令的完成时刻，用于计算TX FIFO空位
+    uint8_t done_head;
+    uint8_t rx[RX_QUEUE];
+    uint64_t rx_ready_ns[RX_QUEUE];
+    uint8_t rx_head, rx_count;
+    uint64_t stop_ns, abort_ns;     // 到这一时刻置位STOP_DET/TX_ABRT，0表示无
+};
+
+static i2c_inst host_i2c[2];
+i2c_inst_t *const i2c0 = &host_i2c[0];
+i2c_inst_t *const i2c1 = &host_i2c[1];
+
+// data_cmd初始为空，否则第一次查询会把0当作驱动写入的命令
+static struct HostI2cInit {
+    HostI2cInit() {
+        host_i2c[0].hw.data_cmd = DATA_CMD_EMPTY;
+        host_i2c[1].hw.data_cmd = DATA_CMD_EMPTY;
+    }
+} host_i2c_init;
+
+iobank0_hw_t host_iobank0;
+
+static gpio_irq_callback_t gpio_callback;
+
+// 字节数（含地址字节）对应的总线时间
+static uint64_t bytes_ns(const i2c_inst_t *i2c, uint32_t bytes) {
+    const uint32_t baud = i2c->baudrate ? i2c->baudrate : 100000;
+    return (uint64_t)bytes * 9 * 1000000000ull / baud;
+}
+
+static const host_i2c_device_t *find_device(const i2c_inst_t *i2c, uint8_t addr) {
+    for (const auto &d : i2c->devices) {
+        if (d.dev && d.addr == addr) {
+            return d.dev;
+        }
+    }
+    return nullptr;
+}
+
+// ---- FIFO模型：驱动写入data_cmd后，下一次调用time_us_64()或查询FIFO时取走命令 ----
+
+static void flush_writes(i2c_inst_t *i2c) {
+    if (i2c->wlen && i2c->target && i2c->target->write &&
+        !i2c->target->write(i2c->target->ctx, i2c->wbuf, i2c->wlen)) {
+        i2c->stats.naks++;
+    }
+    i2c->wlen = 0;
+}
+
+static void take_command(i2c_inst_t *i2c, uint32_t cmd) {
+    const bool read = (cmd & I2C_IC_DATA_CMD_CMD_BITS) != 0;
+    const bool stop = (cmd & I2C_IC_DATA_CMD_STOP_BITS) != 0;
+    const uint64_t start = now_ns > i2c->bus_free_ns ? now_ns : i2c->bus_free_ns;
+    uint32_t bytes = 1;
+
+    if (!i2c->in_txn) {
+        // 新事务：相当于驱动清除了上一次的STOP/中止标志
+        i2c->hw.raw_intr_stat = 0;
+        i2c->stop_ns = i2c->abort_ns = 0;
+        i2c->in_txn = true;
+        i2c->aborted = false;
+        i2c->reading = read;
+        i2c->wlen = 0;
+        i2c->target = find_device(i2c, (uint8_t)i2c->hw.tar);
+        i2c->stats.transactions++;
+        i2c->stats.starts++;
+        bytes++;
+        if (!i2c->target) {
+            i2c->stats.naks++;
+            i2c->aborted = true;
+            i2c->abort_ns = start + bytes_ns(i2c, 1);
+        }
+    } else if (!i2c->aborted && ((cmd & I2C_IC_DATA_CMD_RESTART_BITS) || read != i2c->reading)) {
+        flush_writes(i2c);
+        i2c->reading = read;
+        i2c->stats.starts++;
+        bytes++;
+    }
+
+    if (!i2c->aborted) {
+        if (read) {
+            uint8_t v = 0xFF;
+            if (i2c->target->read) {
+                i2c->target->read(i2c->target->ctx, &v, 1);
+            }
+            if (i2c->rx_count < RX_QUEUE) {
+                const uint8_t slot = (uint8_t)((i2c->rx_head + i2c->rx_count) % RX_QUEUE);
+                i2c->rx[slot] = v;
+                i2c->rx_ready_ns[slot] = start + bytes_ns(i2c, bytes);
+                i2c->rx_count++;
+            }
+        } else if (i2c->wlen < WRITE_BUFFER) {
+            i2c->wbuf[i2c->wlen++] = (uint8_t)cmd;
+        }
+        i2c->stats.bytes++;
+        i2c->bus_free_ns = start + bytes_ns(i2c, bytes);
+        i2c->stats.busy_us += bytes_ns(i2c, bytes) / 1000;
+    }
+    i2c->done_ns[i2c->done_head] = i2c->aborted ? start : i2c->bus_free_ns;
+    i2c->done_head = (uint8_t)((i2c->done_head + 1) % TX_FIFO_DEPTH);
+
+    if (stop) {
+        if (!i2c->aborted) {
+            flush_writes(i2c);
+            if (i2c->target->stop) {
+                i2c->target->stop(i2c->target->ctx);
+            }
+            i2c->stop_ns = i2c->bus_free_ns;
+        }
+        i2c->in_txn = false;
+    }
+}
+
+static void pump(i2c_inst_t *i2c) {
+    i2c_hw_t *hw = &i2c->hw;
+    if (i2c->rx_presented) {
+        // 驱动总是在read_available之后立即读取data_cmd
+        i2c->rx_presented = false;
+        hw->data_cmd = DATA_CMD_EMPTY;
+    } else if (hw->data_cmd != DATA_CMD_EMPTY) {
+        const uint32_t cmd = hw->data_cmd;
+        hw->data_cmd = DATA_CMD_EMPTY;
+        take_command(i2c, cmd);
+    }
+    if (i2c->stop_ns && now_ns >= i2c->stop_ns) {
+        hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+        i2c->stop_ns = 0;
+    }
+    if (i2c->abort_ns && now_ns >= i2c->abort_ns) {
+        hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+        i2c->abort_ns = 0;
+        // 中止时控制器清空FIFO
+        i2c->rx_count = 0;
+    }
+}
+
+static void pump_all() {
+    pump(i2c0);
+    pump(i2c1);
+}
+
+// ---- 时间 ----
+
+uint64_t time_us_64(void) {
+    pump_all();
+    return now_ns / 1000;
+}
+
+void sleep_us(uint64_t us) {
+    now_ns += us * 1000;
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout) {
+    if (timeout * 1000 > now_ns) {
+        now_ns = timeout * 1000;
+    }
+    return true;
+}
+
+void host_time_set(uint64_t us) {
+    now_ns = us * 1000;
+}
+
+void host_time_advance(uint64_t us) {
+    now_ns += us * 1000;
+}
+
+uint64_t host_time_us(void) {
+    return now_ns / 1000;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    return PICO_ERROR_TIMEOUT;
+}
+
+// ---- I2C ----
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate) {
+    i2c_hw_t hw = {};
+    i2c->hw = hw;
+    i2c->hw.data_cmd = DATA_CMD_EMPTY;
+    i2c->hw.enable = 1;
+    i2c->baudrate = baudrate;
+    i2c->open = i2c->in_txn = i2c->rx_presented = false;
+    i2c->rx_count = 0;
+    i2c->wlen = 0;
+    i2c->stop_ns = i2c->abort_ns = 0;
+    memset(i2c->done_ns, 0, sizeof(i2c->done_ns));
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->hw.enable = 0;
+}
+
+unsigned int i2c_set_baudrate(i2c_inst_t *i2c, unsigned int baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c) {
+    pump(i2c);
+    size_t busy = 0;
+    for (uint64_t t : i2c->done_ns) {
+        busy += t > now_ns;
+    }
+    return TX_FIFO_DEPTH - busy;
+}
+
+size_t i2c_get_read_available(i2c_inst_t *i2c) {
+    pump(i2c);
+    size_t n = 0;
+    for (uint8_t i = 0; i < i2c->rx_count; i++) {
+        n += i2c->rx_ready_ns[(i2c->rx_head + i) % RX_QUEUE] <= now_ns;
+    }
+    if (n) {
+        i2c->hw.data_cmd = i2c->rx[i2c->rx_head];
+        i2c->rx_head = (uint8_t)((i2c->rx_head + 1) % RX_QUEUE);
+        i2c->rx_count--;
+        i2c->rx_presented = true;
+    }
+    return n;
+}
+
+// 阻塞传输：地址字节加数据，时钟推进整个传输的时间；超过期限时停在期限处返回超时
+static int blocking_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, uint8_t *dst, size_t len,
+                             bool nostop, absolute_time_t until) {
+    const host_i2c_device_t *dev = find_device(i2c, addr);
+    if (!i2c->open) {
+        i2c->stats.transactions++;
+    }
+    i2c->stats.starts++;
+    i2c->open = nostop;
+
+    if (!dev || (src && dev->write && !dev->write(dev->ctx, src, len)) ||
+        (dst && dev->read && !dev->read(dev->ctx, dst, len))) {
+        i2c->stats.naks++;
+        i2c->open = false;
+        now_ns += bytes_ns(i2c, 1);
+        return PICO_ERROR_GENERIC;
+    }
+    const uint64_t ns = bytes_ns(i2c, (uint32_t)len + 1);
+    i2c->stats.bytes += (uint32_t)len;
+    i2c->stats.busy_us += ns / 1000;
+    if (now_ns + ns > until * 1000) {
+        now_ns = until * 1000 > now_ns ? until * 1000 : now_ns;
+        i2c->open = false;
+        return PICO_ERROR_TIMEOUT;
+    }
+    now_ns += ns;
+    if (!nostop && dev->stop) {
+        dev->stop(dev->ctx);
+    }
+    return (int)len;
+}
+
+int i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                             absolute_time_t until) {
+    return blocking_transfer(i2c, addr, src, nullptr, len, nostop, until);
+}
+
+int i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                            absolute_time_t until) {
+    return blocking_transfer(i2c, addr, nullptr, dst, len, nostop, until);
+}
+
+bool host_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const host_i2c_device_t *dev) {
+    for (auto &d : i2c->devices) {
+        if (d.dev && d.addr == addr) {
+            d.dev = dev;
+            return true;
+        }
+    }
+    for (auto &d : i2c->devices) {
+        if (!d.dev) {
+            d.addr = addr;
+            d.dev = dev;
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_i2c_detach(i2c_inst_t *i2c, uint8_t addr) {
+    for (auto &d : i2c->devices) {
+        if (d.dev && d.addr == addr) {
+            d.dev = nullptr;
+        }
+    }
+}
+
+host_i2c_stats_t *host_i2c_stats(i2c_inst_t *i2c) {
+    return &i2c->stats;
+}
+
+void host_i2c_reset_stats(i2c_inst_t *i2c) {
+    memset(&i2c->stats, 0, sizeof(i2c->stats));
+}
+
+// ---- GPIO ----
+
+uint32_t gpio_get_irq_event_mask(unsigned int gpio) {
+    return 0;
+}
+
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    gpio_callback = callback;
+}
+
+void host_gpio_irq(unsigned int gpio, uint32_t events) {
+    if (gpio_callback) {
+        gpio_callback(gpio, events);
+    }
+}
@@ -0,0 +1,63 @@
+// 主机端Pico SDK替身
+//
+// 让src/下的驱动不经修改在主机上编译运行，供tools/下的模拟与测试程序使用：
+//   - 虚拟时钟：time_us_64()从0开始，只由睡眠/等待、I2C传输和host_time_advance()推进，
+//     同样的输入总是得到同样的结果；
+//   - I2C：每路控制器最多挂接HOST_I2C_MAX_DEVICES个目标设备，未挂接的地址NAK。
+//     阻塞接口每字节（含地址字节）按9个位时间推进时钟；直接读写寄存器的异步事务
+//     （data_cmd、raw_intr_stat）由16级FIFO模型处理，命令在总线上按位时间依次完成；
+//   - GPIO中断：host_gpio_irq()调用驱动注册的回调；
+//   - 其余（PWM、时钟、中断控制器、看门狗）为空操作。
+// host_ds3231.h是挂在这套I2C模型上的DS3231寄存器文件模型（时间、闹钟、INT引脚）。
+//
+// 使用时把tools/host_stubs放在包含路径中，并链接host_stubs.cpp：
+//   g++ -std=c++17 -Itools/host_stubs -Iinclude ... tools/host_stubs/host_stubs.cpp
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#define HOST_I2C_MAX_DEVICES 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 目标设备：回调在事务的各阶段调用，返回false表示NAK
+typedef struct {
+    bool (*write)(void *ctx, const uint8_t *src, size_t len);   // START或重复起始之后写入的数据
+    bool (*read)(void *ctx, uint8_t *dst, size_t len);          // 读取
+    void (*stop)(void *ctx);                                    // STOP，可为NULL
+    void *ctx;
+} host_i2c_device_t;
+
+typedef struct {
+    uint32_t transactions;  // START到STOP，中间的重复起始不另计
+    uint32_t starts;        // START与重复起始
+    uint32_t bytes;         // 数据字节（不含地址字节）
+    uint32_t naks;
+    uint64_t busy_us;       // 总线占用时间
+} host_i2c_stats_t;
+
+// 虚拟时钟
+void host_time_set(uint64_t us);
+void host_time_advance(uint64_t us);
+// 当前虚拟时间：与time_us_64()不同，不推进I2C FIFO模型，设备模型可在回调中调用
+uint64_t host_time_us(void);
+
+// 挂接目标设备（dev须在使用期间有效），addr已挂接时替换
+bool host_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const host_i2c_device_t *dev);
+void host_i2c_detach(i2c_inst_t *i2c, uint8_t addr);
+host_i2c_stats_t *host_i2c_stats(i2c_inst_t *i2c);
+void host_i2c_reset_stats(i2c_inst_t *i2c);
+
+// 模拟GPIO边沿中断：调用gpio_set_irq_enabled_with_callback()注册的回调
+void host_gpio_irq(unsigned int gpio, uint32_t events);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_STUBS_H
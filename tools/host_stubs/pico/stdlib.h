@@ -0,0 +1,27 @@
+// 主机端Pico SDK替身（见tools/host_stubs/host_stubs.h）
+#ifndef HOST_STUBS_PICO_STDLIB_H
+#define HOST_STUBS_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+typedef unsigned int uint;
+
+#define __uninitialized_ram(name) name
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline bool stdio_init_all(void) { return true; }
+static inline void tight_loop_contents(void) {}
+int getchar_timeout_us(uint32_t timeout_us);   // 主机上总是超时
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_STUBS_PICO_STDLIB_H
@@ -0,0 +1,33 @@
+// 主机端Pico SDK替身：虚拟时钟，只由睡眠、等待和I2C传输推进
+#ifndef HOST_STUBS_PICO_TIME_H
+#define HOST_STUBS_PICO_TIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline bool time_reached(absolute_time_t t) { return time_us_64() >= t; }
+
+void sleep_us(uint64_t us);
+static inline void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000); }
+static inline void busy_wait_us(uint64_t us) { sleep_us(us); }
+static inline void busy_wait_us_32(uint32_t us) { sleep_us(us); }
+// 没有中断源：直接把虚拟时钟拨到期限
+bool best_effort_wfe_or_timeout(absolute_time_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_STUBS_PICO_TIME_H
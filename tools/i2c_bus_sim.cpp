@@ -0,0 +1,236 @@
+// 共享I2C总线仲裁器模拟（主机端）
+//
+// 在主机端I2C模型（tools/host_stubs）上用i2c_bus_t调度一条总线上的两个设备：
+//   OLED   0x3C，400kHz：连续传输整帧（1024字节，LOW优先级，按分片发送，header为0x40），
+//          每帧之前一条窗口命令流（0x00与6个命令字节，NORMAL优先级），即SSD1306::displayRegion()提交的事务；
+//   DS3231 0x68，100kHz（tools/host_stubs/host_ds3231模型）：时间读取（写寄存器指针+读7字节，
+//          HIGH优先级），即ds3231_read_registers()在共享总线上提交的事务。
+// RTC请求在随机时刻到达（多数落在某个分片的传输途中），相当于中断或更高优先级的任务
+// 在该时刻提交；提交时间记为到达时刻，等待与完成延迟都从到达算起。
+// 对每种分片长度报告RTC请求的等待、完成延迟（p50/p99/最长）与理论上界，以及整帧传输时间：
+//   等待上界 = 最长的单次总线占用（一个分片、一条命令或一次RTC读取中的最长者）
+//   完成上界 = 等待上界 + RTC读取本身的总线时间
+// 实测超过上界时返回1。位时间按每字节9位计算（含地址字节），不含起始/停止条件与
+// 速率切换的开销，设备上的数值会略大。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/i2c_bus_sim.cpp tools/host_stubs/host_ds3231.cpp tools/host_stubs/host_stubs.cpp src/ds3231/*.cpp src/i2c_bus.cpp -o i2c_bus_sim
+// 用法: i2c_bus_sim [-t 每种分片模拟秒数] [-c 分片字节数] [-s 随机种子]
+
+#include "host_ds3231.h"
+#include "i2c_bus.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define OLED_ADDR      0x3C
+#define OLED_BAUDRATE  400000
+#define FRAME_BYTES    1024
+#define RTC_READ_BYTES 7
+
+// 每字节9位，含地址字节
+static uint32_t busUs(uint32_t bytes, uint32_t baudrate) {
+    return (uint32_t)((uint64_t)bytes * 9 * 1000000 / baudrate);
+}
+
+// OLED：只接收数据
+static bool oledWrite(void* ctx, const uint8_t* src, size_t len) {
+    return true;
+}
+
+static bool oledRead(void* ctx, uint8_t* dst, size_t len) {
+    memset(dst, 0, len);
+    return true;
+}
+
+struct Result {
+    uint16_t chunk;
+    uint32_t requests;
+    uint32_t frames;
+    uint32_t wait_p50, wait_p99, wait_max;
+    uint32_t done_p50, done_p99, done_max;
+    uint32_t wait_bound, done_bound;
+    uint32_t max_chunk_us;
+    uint32_t frame_us;
+    uint32_t errors;
+};
+
+struct RtcRequest {
+    i2c_bus_txn_t txn;
+    uint8_t reg;
+    uint8_t data[RTC_READ_BYTES];
+    uint64_t arrival_us;
+    bool outstanding;
+    std::vector<uint32_t>* done_us;
+};
+
+static void onRtcDone(i2c_bus_txn_state_t state, void* ctx) {
+    RtcRequest* req = (RtcRequest*)ctx;
+    req->outstanding = false;
+    req->done_us->push_back((uint32_t)(time_us_64() - req->arrival_us));
+}
+
+static uint32_t percentile(std::vector<uint32_t>& v, unsigned percent) {
+    if (v.empty()) {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, v.size() * percent / 100)];
+}
+
+static Result simulate(uint16_t chunk, uint32_t seconds, unsigned seed) {
+    std::mt19937 rng(seed);
+    host_time_set(0);
+
+    static host_ds3231_t rtc;
+    host_ds3231_init(&rtc, 1717243200LL, -1);
+    host_ds3231_attach(&rtc, i2c0);
+    static const host_i2c_device_t oled = {oledWrite, oledRead, nullptr, nullptr};
+    host_i2c_attach(i2c0, OLED_ADDR, &oled);
+
+    static i2c_bus_t bus;
+    i2c_bus_init(&bus, i2c0, 2, 3, OLED_BAUDRATE);
+    static const i2c_bus_device_t oled_device = {OLED_ADDR, OLED_BAUDRATE};
+    static const i2c_bus_device_t rtc_device = {DS3231_I2C_ADDR, DS3231_I2C_BAUDRATE};
+
+    static uint8_t frame[FRAME_BYTES];
+    static const uint8_t window[7] = {0x00, 0x22, 0, 7, 0x21, 0, 127};
+    static const uint8_t data_header = 0x40;
+    static i2c_bus_txn_t window_txn, frame_txn;
+    frame_txn.state = I2C_BUS_TXN_DONE;
+
+    std::vector<uint32_t> done_us;
+    static RtcRequest req;
+    memset(&req, 0, sizeof(req));
+    req.reg = DS3231_SECONDS_REG;
+    req.done_us = &done_us;
+
+    Result r = {};
+    r.chunk = chunk;
+    const uint64_t end_us = (uint64_t)seconds * 1000000;
+    uint64_t next_arrival = rng() % 10000;
+    bool scheduled = true;
+    uint64_t frame_start = 0, frame_total = 0;
+    bool frame_started = false;
+
+    while (time_us_64() < end_us) {
+        // 上一帧传完立即提交下一帧：总线上始终有LOW优先级的分片在排队
+        if (frame_txn.state != I2C_BUS_TXN_PENDING && frame_txn.state != I2C_BUS_TXN_ACTIVE) {
+            if (frame_started) {
+                if (frame_txn.state == I2C_BUS_TXN_DONE) {
+                    r.frames++;
+                    frame_total += time_us_64() - frame_start;
+                } else {
+                    r.errors++;
+                }
+            }
+            frame_start = time_us_64();
+            frame_started = true;
+            i2c_bus_txn_init(&window_txn, &oled_device, window, sizeof(window), nullptr, 0, I2C_BUS_PRIORITY_NORMAL);
+            i2c_bus_txn_init(&frame_txn, &oled_device, frame, FRAME_BYTES, nullptr, 0, I2C_BUS_PRIORITY_LOW);
+            frame_txn.header = &data_header;
+            frame_txn.header_len = 1;
+            frame_txn.chunk = chunk;
+            i2c_bus_submit(&bus, &window_txn);
+            i2c_bus_submit(&bus, &frame_txn);
+        }
+
+        // RTC请求在到达时刻提交；到达发生在上一次总线占用途中时，等待从到达算起
+        if (scheduled && time_us_64() >= next_arrival) {
+            i2c_bus_txn_init(&req.txn, &rtc_device, &req.reg, 1, req.data, RTC_READ_BYTES, I2C_BUS_PRIORITY_HIGH);
+            req.txn.callback = onRtcDone;
+            req.txn.ctx = &req;
+            req.arrival_us = next_arrival;
+            req.outstanding = true;
+            if (!i2c_bus_submit(&bus, &req.txn)) {
+                r.errors++;
+                req.outstanding = false;
+            }
+            req.txn.submit_us = next_arrival;
+            r.requests++;
+            scheduled = false;
+        }
+
+        i2c_bus_poll(&bus);
+        // 同一时刻只有一个RTC请求（驱动等待完成后才返回），下一个在完成后0-10ms到达
+        if (!scheduled && !req.outstanding) {
+            next_arrival = time_us_64() + rng() % 10000;
+            scheduled = true;
+        }
+        if (req.txn.state == I2C_BUS_TXN_ERROR || req.txn.state == I2C_BUS_TXN_TIMEOUT) {
+            r.errors++;
+            req.txn.state = I2C_BUS_TXN_IDLE;
+        }
+    }
+
+    // 等待时间：完成延迟减去RTC读取本身的总线时间
+    const uint32_t rtc_us = busUs(2 + 1 + RTC_READ_BYTES, DS3231_I2C_BAUDRATE);
+    std::vector<uint32_t> wait_us(done_us);
+    for (uint32_t& w : wait_us) {
+        w = w > rtc_us ? w - rtc_us : 0;
+    }
+    r.wait_p50 = percentile(wait_us, 50);
+    r.wait_p99 = percentile(wait_us, 99);
+    r.wait_max = bus.stats.max_wait_us[I2C_BUS_PRIORITY_HIGH];
+    r.done_p50 = percentile(done_us, 50);
+    r.done_p99 = percentile(done_us, 99);
+    r.done_max = done_us.empty() ? 0 : done_us.back();
+    r.max_chunk_us = bus.stats.max_chunk_us;
+
+    const uint32_t chunk_us = busUs(1 + 1 + chunk, OLED_BAUDRATE);
+    const uint32_t window_us = busUs(1 + sizeof(window), OLED_BAUDRATE);
+    r.wait_bound = std::max(std::max(chunk_us, window_us), rtc_us);
+    r.done_bound = r.wait_bound + rtc_us;
+    r.frame_us = r.frames ? (uint32_t)(frame_total / r.frames) : 0;
+    r.errors += bus.stats.errors + bus.stats.timeouts;
+
+    host_i2c_detach(i2c0, OLED_ADDR);
+    host_i2c_detach(i2c0, DS3231_I2C_ADDR);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 20;
+    int chunk = 0;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            chunk = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-t 每种分片模拟秒数] [-c 分片字节数] [-s 随机种子]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (chunk < 0 || chunk > I2C_BUS_CHUNK_BYTES) {
+        fprintf(stderr, "分片字节数须在1-%d之间\n", I2C_BUS_CHUNK_BYTES);
+        return 2;
+    }
+
+    std::vector<uint16_t> chunks;
+    if (chunk) {
+        chunks.push_back((uint16_t)chunk);
+    } else {
+        chunks = {16, 32, 64, I2C_BUS_CHUNK_BYTES};
+    }
+
+    printf("RTC等待us: p50 p99 最长 上界 | RTC完成us: p50 p99 最长 上界 | 最长占用us 每帧us 请求数 分片\n");
+    bool ok = true;
+    for (uint16_t c : chunks) {
+        const Result r = simulate(c, seconds, seed);
+        const bool within = r.wait_max <= r.wait_bound && r.done_max <= r.done_bound && !r.errors;
+        ok = ok && within;
+        printf("%5u %5u %5u %5u   %5u %5u %5u %5u   %8u %7u %6u   %u%s\n", r.wait_p50, r.wait_p99, r.wait_max,
+               r.wait_bound, r.done_p50, r.done_p99, r.done_max, r.done_bound, r.max_chunk_us, r.frame_us,
+               r.requests, r.chunk, within ? "" : "  超过上界");
+        if (r.errors) {
+            printf("  错误 %u\n", r.errors);
+        }
+    }
+    return ok ? 0 : 1;
+}
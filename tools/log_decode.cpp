@@ -0,0 +1,259 @@
+// 二进制日志解码工具（主机端）
+//
+// 读取串口日志（可混有普通printf输出），按$SSDL,F格式表行格式化$SSDL,R记录行，
+// 每条记录前加上设备时间（秒），其余行原样输出；最后在stderr打印记录数、
+// 记录行与格式化后文本的字节数、丢弃数。
+//
+// -b时不读取日志，在主机上测量吞吐量：调用处直接snprintf、log_sink_write()写入、
+// 输出方文本格式化与二进制编码各自每条记录的耗时，并检查二进制记录解码后的
+// 文本与直接格式化的结果一致。主机上的数字只用于比较几种做法的相对开销，
+// RP2040上的浮点格式化要慢得多。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/log_decode.cpp src/log_sink.cpp -o log_decode
+// 用法: log_decode [-q] [日志文件]   （省略文件时读取stdin）
+//       log_decode -b [记录数]
+//       -q 只输出解码后的记录
+
+#include "log_sink.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string unescape(const char* s) {
+    std::string out;
+    for (; *s && *s != '\n' && *s != '\r'; s++) {
+        if (*s == '\\' && s[1] == 'n') {
+            out += '\n';
+            s++;
+        } else if (*s == '\\' && s[1] == '\\') {
+            out += '\\';
+            s++;
+        } else {
+            out += *s;
+        }
+    }
+    return out;
+}
+
+static int decode(FILE* in, bool quiet) {
+    std::vector<std::string> formats;
+    char line[1024];
+    char text[LOG_SINK_LINE_MAX];
+    uint64_t ts_us = 0;
+    unsigned long records = 0, unknown = 0, corrupt = 0, dropped = 0;
+    unsigned long record_bytes = 0, text_bytes = 0;
+    const size_t prefix = strlen(LOG_SINK_PREFIX);
+
+    while (fgets(line, sizeof(line), in)) {
+        if (strncmp(line, LOG_SINK_PREFIX, prefix) != 0 || line[prefix + 1] != ',') {
+            if (!quiet) {
+                fputs(line, stdout);
+            }
+            continue;
+        }
+        const char kind = line[prefix];
+        const char* body = line + prefix + 2;
+
+        if (kind == 'F') {
+            char* end;
+            const unsigned long id = strtoul(body, &end, 10);
+            if (*end != ',' || id > 0xFFFF) {
+                corrupt++;
+                continue;
+            }
+            if (id >= formats.size()) {
+                formats.resize(id + 1);
+            }
+            formats[id] = unescape(end + 1);
+            if (id == 0) {
+                ts_us = 0;
+            }
+        } else if (kind == 'R') {
+            uint16_t format;
+            uint32_t delta;
+            uint32_t args[LOG_SINK_MAX_ARGS];
+            const int nargs = log_sink_decode_record(body, &format, &delta, args, LOG_SINK_MAX_ARGS);
+            if (nargs < 0) {
+                corrupt++;
+                continue;
+            }
+            ts_us += delta;
+            records++;
+            record_bytes += (unsigned long)strlen(line);
+            if (format >= formats.size() || formats[format].empty()) {
+                unknown++;
+                printf("[%10.6f] <格式%u未知>\n", ts_us / 1e6, format);
+                continue;
+            }
+            size_t len = log_sink_format(formats[format].c_str(), args, (uint8_t)nargs, text, sizeof(text));
+            text_bytes += (unsigned long)len;
+            while (len > 0 && text[len - 1] == '\n') {
+                text[--len] = '\0';
+            }
+            printf("[%10.6f] %s\n", ts_us / 1e6, text);
+        } else if (kind == 'D') {
+            dropped = strtoul(body, nullptr, 10);
+            printf("[%10.6f] <设备端累计丢弃%lu条>\n", ts_us / 1e6, dropped);
+        } else {
+            corrupt++;
+        }
+    }
+
+    fprintf(stderr, "记录: %lu, 记录行%lu字节, 格式化后%lu字节, 未知格式%lu, 损坏的行%lu, 设备端丢弃%lu\n",
+            records, record_bytes, text_bytes, unknown, corrupt, dropped);
+    return corrupt ? 1 : 0;
+}
+
+// 与examples/ds3231_clock.cpp中每秒输出的日志相同的格式
+static const char* const bench_formats[] = {
+    "DS3231时间: %04d-%02d-%02d %02d:%02d:%02d (星期%d)\n",
+    "温度: %.1f°C\n",
+    "时间同步: 偏差%ldus, 频偏%ldppb\n",
+};
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static uint64_t bench_now(void* ctx) {
+    return (*(uint64_t*)ctx += 1000);
+}
+
+static void push_record(log_sink_t* sink, uint32_t i) {
+    switch (i % 3) {
+    case 0:
+        log_sink_write(sink, 0, 2000 + (int)(i % 100), (int)(i % 12 + 1), (int)(i % 28 + 1), (int)(i % 24),
+                       (int)(i % 60), (int)(i % 60), (int)(i % 7 + 1));
+        break;
+    case 1:
+        log_sink_write(sink, 1, 20.0f + (float)(i % 200) * 0.25f);
+        break;
+    default:
+        log_sink_write(sink, 2, (long)(i % 2000) - 1000, (long)(i * 7919u % 40000u) - 20000);
+        break;
+    }
+}
+
+static int benchmark(uint32_t count) {
+    static log_sink_t sink;
+    uint64_t clock_us = 0;
+    log_sink_init(&sink, bench_formats, 3, bench_now, &clock_us);
+    char line[LOG_SINK_LINE_MAX];
+    char direct[LOG_SINK_LINE_MAX];
+    volatile size_t sink_bytes = 0;
+
+    // 调用处直接格式化（不含串口输出本身）
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        int n;
+        switch (i % 3) {
+        case 0:
+            n = snprintf(line, sizeof(line), bench_formats[0], 2000 + (int)(i % 100), (int)(i % 12 + 1),
+                         (int)(i % 28 + 1), (int)(i % 24), (int)(i % 60), (int)(i % 60), (int)(i % 7 + 1));
+            break;
+        case 1:
+            n = snprintf(line, sizeof(line), bench_formats[1], (double)(20.0f + (float)(i % 200) * 0.25f));
+            break;
+        default:
+            n = snprintf(line, sizeof(line), bench_formats[2], (long)(i % 2000) - 1000,
+                         (long)(i * 7919u % 40000u) - 20000);
+            break;
+        }
+        sink_bytes = sink_bytes + (size_t)n;
+    }
+    const double direct_s = seconds(t0);
+
+    // 写入与输出分批进行，每批不超过缓冲区容量
+    const uint32_t batch = LOG_SINK_RING_WORDS / (2 + 7);
+    double push_s = 0, text_s = 0, binary_s = 0;
+    unsigned long text_bytes = 0, binary_bytes = 0, mismatches = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        const bool binary = pass == 1;
+        for (uint32_t done = 0; done < count; done += batch) {
+            const uint32_t n = count - done < batch ? count - done : batch;
+            t0 = std::chrono::steady_clock::now();
+            for (uint32_t i = done; i < done + n; i++) {
+                push_record(&sink, i);
+            }
+            push_s += seconds(t0);
+
+            t0 = std::chrono::steady_clock::now();
+            size_t len;
+            if (!binary) {
+                while ((len = log_sink_next(&sink, line, sizeof(line), false)) > 0) {
+                    text_bytes += (unsigned long)len;
+                }
+                text_s += seconds(t0);
+                continue;
+            }
+            std::vector<std::string> lines;
+            while ((len = log_sink_next(&sink, line, sizeof(line), true)) > 0) {
+                binary_bytes += (unsigned long)len;
+                lines.emplace_back(line, len);
+            }
+            binary_s += seconds(t0);
+
+            // 解码后与文本格式化的结果比较
+            static log_sink_t check;
+            uint64_t check_us = 0;
+            log_sink_init(&check, bench_formats, 3, bench_now, &check_us);
+            for (uint32_t i = done; i < done + n; i++) {
+                push_record(&check, i);
+            }
+            for (const std::string& l : lines) {
+                uint16_t format;
+                uint32_t delta;
+                uint32_t args[LOG_SINK_MAX_ARGS];
+                const int nargs = log_sink_decode_record(l.c_str() + strlen(LOG_SINK_PREFIX "R,"), &format, &delta,
+                                                         args, LOG_SINK_MAX_ARGS);
+                log_sink_next(&check, direct, sizeof(direct), false);
+                if (nargs < 0 || format >= 3 ||
+                    (log_sink_format(bench_formats[format], args, (uint8_t)nargs, line, sizeof(line)),
+                     strcmp(line, direct) != 0)) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    // 两遍各写入count条
+    push_s /= 2;
+
+    const double ns = 1e9 / count;
+    printf("记录数: %lu（主机测量，只比较相对开销）\n", (unsigned long)count);
+    printf("调用处snprintf:   %7.1f ns/条, %5.1f 字节/条\n", direct_s * ns, (double)sink_bytes / count);
+    printf("log_sink_write:   %7.1f ns/条\n", push_s * ns);
+    printf("输出方文本格式化: %7.1f ns/条, %5.1f 字节/条\n", text_s * ns, (double)text_bytes / count);
+    printf("输出方二进制编码: %7.1f ns/条, %5.1f 字节/条\n", binary_s * ns, (double)binary_bytes / count);
+    printf("解码不一致: %lu, 丢弃: %lu\n", mismatches, (unsigned long)sink.dropped);
+    return mismatches || sink.dropped ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    const char* in_path = nullptr;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            const uint32_t count = (i + 1 < argc) ? (uint32_t)strtoul(argv[i + 1], nullptr, 10) : 300000;
+            return benchmark(count ? count : 300000);
+        } else {
+            in_path = argv[i];
+        }
+    }
+
+    FILE* in = in_path ? fopen(in_path, "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "无法打开 %s\n", in_path);
+        return 1;
+    }
+    const int rc = decode(in, quiet);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return rc;
+}
@@ -0,0 +1,195 @@
+// 页格式合成内核基准（主机端）
+//
+// 在128x64（1KB）帧缓冲上比较ssd1306_blend_*与逐像素循环（每个像素单独取位、合成、写回）：
+// 先在随机缓冲区上逐字节核对两者结果，再分别计时，打印每次调用的耗时与加速比。
+// 图像合成覆盖按页对齐与非对齐的y、部分超出画面的位置；矩形覆盖整屏与非对齐的小矩形。
+// 主机上的数字只用于比较两种做法的相对开销，RP2040上按字处理的收益来自更少的加载/存储。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_blend_bench.cpp src/ssd1306_blend.cpp -o ssd1306_blend_bench
+// 用法: ssd1306_blend_bench [-n 每项的调用次数]
+
+#include "ssd1306_blend.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#define WIDTH 128
+#define HEIGHT 64
+#define SIZE (WIDTH * HEIGHT / 8)
+
+static const char* const op_names[] = {"copy", "or", "and", "xor", "andnot"};
+
+static bool getPixel(const uint8_t* buf, int w, int x, int y) {
+    return (buf[x + (y / 8) * w] >> (y & 7)) & 1;
+}
+
+static void setPixel(uint8_t* buf, int w, int x, int y, bool v) {
+    uint8_t& b = buf[x + (y / 8) * w];
+    const uint8_t bit = (uint8_t)(1 << (y & 7));
+    b = v ? (b | bit) : (b & ~bit);
+}
+
+static bool blendPixel(bool d, bool s, uint8_t op) {
+    switch (op) {
+    case SSD1306_BLEND_COPY:   return s;
+    case SSD1306_BLEND_OR:     return d || s;
+    case SSD1306_BLEND_AND:    return d && s;
+    case SSD1306_BLEND_XOR:    return d != s;
+    case SSD1306_BLEND_ANDNOT: return d && !s;
+    }
+    return d;
+}
+
+// 逐像素参考实现
+static void pixelBuffer(uint8_t* dst, const uint8_t* src, uint8_t op) {
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            setPixel(dst, WIDTH, x, y, blendPixel(getPixel(dst, WIDTH, x, y), getPixel(src, WIDTH, x, y), op));
+        }
+    }
+}
+
+static void pixelMasked(uint8_t* dst, const uint8_t* src, const uint8_t* mask) {
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            if (getPixel(mask, WIDTH, x, y)) {
+                setPixel(dst, WIDTH, x, y, getPixel(src, WIDTH, x, y));
+            }
+        }
+    }
+}
+
+static void pixelImage(uint8_t* dst, int x0, int y0, const uint8_t* img, int img_w, int img_h, uint8_t op) {
+    for (int y = 0; y < img_h; y++) {
+        for (int x = 0; x < img_w; x++) {
+            const int dx = x0 + x, dy = y0 + y;
+            if (dx >= 0 && dx < WIDTH && dy >= 0 && dy < HEIGHT) {
+                setPixel(dst, WIDTH, dx, dy, blendPixel(getPixel(dst, WIDTH, dx, dy), getPixel(img, img_w, x, y), op));
+            }
+        }
+    }
+}
+
+static void pixelRect(uint8_t* dst, int x0, int y0, int w, int h, uint8_t op) {
+    for (int y = y0; y < y0 + h; y++) {
+        for (int x = x0; x < x0 + w; x++) {
+            if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+                setPixel(dst, WIDTH, x, y, blendPixel(getPixel(dst, WIDTH, x, y), true, op));
+            }
+        }
+    }
+}
+
+struct Case {
+    char name[48];
+    void (*kernel)(const Case&, uint8_t*);
+    void (*reference)(const Case&, uint8_t*);
+    uint8_t op;
+    int16_t x, y, w, h;
+};
+
+static uint8_t src[SIZE], mask[SIZE], img[SIZE], background[SIZE];
+
+static void kernelBuffer(const Case& c, uint8_t* dst) { ssd1306_blend_buffer(dst, src, SIZE, c.op); }
+static void referenceBuffer(const Case& c, uint8_t* dst) { pixelBuffer(dst, src, c.op); }
+static void kernelMasked(const Case&, uint8_t* dst) { ssd1306_blend_masked(dst, src, mask, SIZE); }
+static void referenceMasked(const Case&, uint8_t* dst) { pixelMasked(dst, src, mask); }
+static void kernelImage(const Case& c, uint8_t* dst) {
+    ssd1306_blend_image(dst, WIDTH, HEIGHT, c.x, c.y, img, c.w, c.h, c.op);
+}
+static void referenceImage(const Case& c, uint8_t* dst) { pixelImage(dst, c.x, c.y, img, c.w, c.h, c.op); }
+static void kernelRect(const Case& c, uint8_t* dst) { ssd1306_blend_rect(dst, WIDTH, HEIGHT, c.x, c.y, c.w, c.h, c.op); }
+static void referenceRect(const Case& c, uint8_t* dst) { pixelRect(dst, c.x, c.y, c.w, c.h, c.op); }
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// 每次调用前恢复背景，两种实现付出相同的复制开销
+static double timeCalls(const Case& c, void (*fn)(const Case&, uint8_t*), uint8_t* dst, unsigned long runs) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < runs; i++) {
+        memcpy(dst, background, SIZE);
+        fn(c, dst);
+    }
+    return seconds(t0) * 1e9 / runs;
+}
+
+int main(int argc, char** argv) {
+    unsigned long runs = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 每项的调用次数]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!runs) {
+        runs = 1;
+    }
+
+    std::mt19937 rng(1);
+    for (int i = 0; i < SIZE; i++) {
+        src[i] = (uint8_t)rng();
+        mask[i] = (uint8_t)rng();
+        img[i] = (uint8_t)rng();
+        background[i] = (uint8_t)rng();
+    }
+
+    static Case cases[64];
+    int count = 0;
+    for (uint8_t op = SSD1306_BLEND_COPY; op <= SSD1306_BLEND_ANDNOT; op++) {
+        Case& c = cases[count++];
+        c = {"", kernelBuffer, referenceBuffer, op, 0, 0, WIDTH, HEIGHT};
+        snprintf(c.name, sizeof(c.name), "buffer %s", op_names[op]);
+    }
+    cases[count] = {"", kernelMasked, referenceMasked, SSD1306_BLEND_COPY, 0, 0, WIDTH, HEIGHT};
+    snprintf(cases[count++].name, sizeof(cases[0].name), "masked");
+
+    // 图像：整屏、页对齐、非对齐y、部分超出画面
+    static const int16_t images[][4] = {
+        {0, 0, 128, 64}, {16, 8, 64, 32}, {13, 5, 64, 32}, {-7, -3, 40, 24}, {100, 50, 48, 24},
+    };
+    for (const auto& im : images) {
+        for (uint8_t op : {SSD1306_BLEND_COPY, SSD1306_BLEND_OR, SSD1306_BLEND_XOR}) {
+            Case& c = cases[count++];
+            c = {"", kernelImage, referenceImage, op, im[0], im[1], im[2], im[3]};
+            snprintf(c.name, sizeof(c.name), "image %dx%d@(%d,%d) %s", im[2], im[3], im[0], im[1], op_names[op]);
+        }
+    }
+    // 矩形：整屏、按页对齐、非对齐的小矩形（高亮、光标）
+    static const int16_t rects[][4] = {{0, 0, 128, 64}, {0, 16, 128, 16}, {37, 21, 50, 11}, {60, 3, 6, 9}};
+    for (const auto& r : rects) {
+        for (uint8_t op : {SSD1306_BLEND_OR, SSD1306_BLEND_XOR, SSD1306_BLEND_ANDNOT}) {
+            Case& c = cases[count++];
+            c = {"", kernelRect, referenceRect, op, r[0], r[1], r[2], r[3]};
+            snprintf(c.name, sizeof(c.name), "rect %dx%d@(%d,%d) %s", r[2], r[3], r[0], r[1], op_names[op]);
+        }
+    }
+
+    static uint8_t actual[SIZE], expected[SIZE];
+    int mismatches = 0;
+    printf("%-32s %10s %10s %8s\n", "内核（主机测量）", "字处理ns", "逐像素ns", "加速比");
+    for (int i = 0; i < count; i++) {
+        const Case& c = cases[i];
+        memcpy(actual, background, SIZE);
+        memcpy(expected, background, SIZE);
+        c.kernel(c, actual);
+        c.reference(c, expected);
+        const bool ok = memcmp(actual, expected, SIZE) == 0;
+        if (!ok) {
+            mismatches++;
+        }
+
+        // 逐像素实现慢得多，调用次数减少到1/16
+        const double kernel_ns = timeCalls(c, c.kernel, actual, runs);
+        const double pixel_ns = timeCalls(c, c.reference, expected, runs / 16 ? runs / 16 : 1);
+        printf("%-32s %10.0f %10.0f %7.1fx%s\n", c.name, kernel_ns, pixel_ns, pixel_ns / kernel_ns,
+               ok ? "" : "  结果不一致");
+    }
+    printf("用例: %d, 不一致: %d\n", count, mismatches);
+    return mismatches ? 1 : 0;
+}
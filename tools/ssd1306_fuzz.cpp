@@ -0,0 +1,307 @@
+// 绘图原语性质测试与吞吐量基准（主机端）
+//
+// 用随机用例（坐标偏向画面边缘与int16极值，见ssd1306_ref.h）比较优化实现与参考光栅化器：
+//   rowmajor  RowCanvas的点、线、矩形、填充与字符（转换为页格式后比较）
+//   blend     ssd1306_blend_rect()，即SSD1306::fillRect()的合成内核，帧前后加保护字节检查越界写
+//   ssd1306   SSD1306类的全部原语（含直线与圆），用主机端SDK替身（tools/host_stubs）编译驱动；
+//             -r选择旋转，90/270度时逻辑画面为64x128
+// 每个用例在相同的随机背景上执行（黑色与反色也会被检查），不一致时打印调用形式与差异图。
+// 最后按原语打印优化实现与参考实现每个用例的平均耗时（主机上测量，只比较相对开销；
+// rowmajor的耗时包含转换为页格式）。设备上用示例中的PRIMITIVE_FUZZ做ssd1306的同样比较。
+//
+// 编译: g++ -std=c++17 -O2 -Itools/host_stubs -Iinclude tools/ssd1306_fuzz.cpp src/ssd1306*.cpp src/i2c_bus.cpp
+//           tools/host_stubs/host_stubs.cpp -o ssd1306_fuzz
+// 用法: ssd1306_fuzz [-n 用例数] [-s 种子] [-w 宽度] [-h 高度] [-r 旋转0-3]
+//       （-w/-h只用于rowmajor与blend，ssd1306为128x64面板）
+//
+// libFuzzer（输入字节经ssd1306_ref_case_from_bytes()构造用例，不一致时abort）:
+//   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -DSSD1306_FUZZ_LIBFUZZER -Itools/host_stubs
+//           -Iinclude tools/ssd1306_fuzz.cpp src/ssd1306*.cpp src/i2c_bus.cpp tools/host_stubs/host_stubs.cpp
+//           -o ssd1306_libfuzzer
+//   旋转由环境变量SSD1306_FUZZ_ROTATION选择
+
+#include "host_stubs.h"
+#include "ssd1306.h"
+#include "ssd1306_ref.h"
+#include "ssd1306_rowmajor.h"
+#include "ssd1306_blend.h"
+#include "ssd1306_golden.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define GUARD 16
+#define GUARD_BYTE 0xA5
+#define MAX_FRAME (RowCanvas::MAX_WIDTH * RowCanvas::MAX_HEIGHT / 8)
+
+struct Timing {
+    unsigned long cases = 0;
+    double optimized_s = 0;
+    double reference_s = 0;
+};
+
+struct Target {
+    const char* name;
+    uint32_t prim_mask;
+    unsigned long mismatches;
+    Timing timing[SSD1306_REF_PRIM_COUNT];
+};
+
+static int16_t g_width = RowCanvas::MAX_WIDTH;
+static int16_t g_height = RowCanvas::MAX_HEIGHT;
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void report(const Target& target, const ssd1306_ref_case_t& c, const uint8_t* actual,
+                   const uint8_t* expected, int16_t width, int16_t height, bool guard_ok) {
+    char text[128];
+    ssd1306_ref_describe(&c, text, sizeof(text));
+    ssd1306_frame_diff_t diff;
+    const uint32_t pixels = ssd1306_frame_diff(actual, expected, (uint16_t)width, (uint16_t)height, &diff);
+    printf("%s 不一致: %s, %lu个像素%s\n", target.name, text, (unsigned long)pixels,
+           guard_ok ? "" : ", 写到了帧外");
+    if (pixels) {
+        ssd1306_frame_print_diff(stdout, actual, expected, (uint16_t)width, (uint16_t)height, &diff);
+    }
+}
+
+// RowCanvas：随机行主序背景转换为页格式作为期望帧的起点
+static bool checkRowMajor(Target& target, RowCanvas& canvas, const ssd1306_ref_case_t& c, uint32_t* state,
+                          bool verbose) {
+    static uint8_t actual[MAX_FRAME];
+    static uint8_t expected[MAX_FRAME];
+    const size_t size = (size_t)g_width * (g_height / 8);
+    uint8_t* rows = canvas.getBuffer();
+    for (size_t i = 0; i < size; i++) {
+        rows[i] = (uint8_t)ssd1306_ref_random(state);
+    }
+    canvas.markAllDirty();
+    canvas.convert(actual);
+    memcpy(expected, actual, size);
+
+    auto t0 = std::chrono::steady_clock::now();
+    ssd1306_ref_apply_basic(canvas, c);
+    canvas.convert(actual);
+    Timing& t = target.timing[c.prim];
+    t.optimized_s += seconds(t0);
+    t0 = std::chrono::steady_clock::now();
+    ssd1306_ref_draw(expected, g_width, g_height, &c);
+    t.reference_s += seconds(t0);
+    t.cases++;
+
+    if (memcmp(actual, expected, size) == 0) {
+        return true;
+    }
+    target.mismatches++;
+    if (verbose) {
+        report(target, c, actual, expected, g_width, g_height, true);
+    }
+    return false;
+}
+
+// 合成内核：只有填充矩形
+static bool checkBlend(Target& target, const ssd1306_ref_case_t& c, uint32_t* state, bool verbose) {
+    static uint8_t actual[MAX_FRAME + 2 * GUARD];
+    static uint8_t expected[MAX_FRAME];
+    static const uint8_t ops[3] = {SSD1306_BLEND_ANDNOT, SSD1306_BLEND_OR, SSD1306_BLEND_XOR};
+    const size_t size = (size_t)g_width * ((g_height + 7) / 8);
+    memset(actual, GUARD_BYTE, sizeof(actual));
+    for (size_t i = 0; i < size; i++) {
+        actual[GUARD + i] = (uint8_t)ssd1306_ref_random(state);
+    }
+    memcpy(expected, actual + GUARD, size);
+
+    auto t0 = std::chrono::steady_clock::now();
+    ssd1306_blend_rect(actual + GUARD, g_width, g_height, c.x, c.y, c.a, c.b, ops[c.color % 3]);
+    Timing& t = target.timing[c.prim];
+    t.optimized_s += seconds(t0);
+    t0 = std::chrono::steady_clock::now();
+    ssd1306_ref_draw(expected, g_width, g_height, &c);
+    t.reference_s += seconds(t0);
+    t.cases++;
+
+    bool guard_ok = true;
+    for (size_t i = 0; i < GUARD; i++) {
+        if (actual[i] != GUARD_BYTE || actual[GUARD + size + i] != GUARD_BYTE) {
+            guard_ok = false;
+        }
+    }
+    if (guard_ok && memcmp(actual + GUARD, expected, size) == 0) {
+        return true;
+    }
+    target.mismatches++;
+    if (verbose) {
+        report(target, c, actual + GUARD, expected, g_width, g_height, guard_ok);
+    }
+    return false;
+}
+
+// 面板：接受所有写入
+static bool panelWrite(void* ctx, const uint8_t* src, size_t len) {
+    return true;
+}
+
+static bool beginPanel(SSD1306& oled, uint8_t rotation) {
+    static const host_i2c_device_t panel = {panelWrite, nullptr, nullptr, nullptr};
+    i2c_init(i2c0, 400000);
+    host_i2c_attach(i2c0, SSD1306::ADDRESS, &panel);
+    if (!oled.begin()) {
+        return false;
+    }
+    oled.setRotation(rotation);
+    return true;
+}
+
+// SSD1306类：随机背景直接写入帧缓冲
+static bool checkSSD1306(Target& target, SSD1306& oled, const ssd1306_ref_case_t& c, uint32_t* state,
+                         bool verbose) {
+    static uint8_t expected[SSD1306_LCDWIDTH * ((SSD1306_LCDHEIGHT + 7) / 8)];
+    uint8_t* frame = oled.getBuffer();
+    const int16_t w = oled.width(), h = oled.height();
+    const size_t size = (size_t)w * ((h + 7) / 8);
+    for (size_t i = 0; i < size; i++) {
+        frame[i] = (uint8_t)ssd1306_ref_random(state);
+    }
+    memcpy(expected, frame, size);
+
+    auto t0 = std::chrono::steady_clock::now();
+    ssd1306_ref_apply(oled, c);
+    Timing& t = target.timing[c.prim];
+    t.optimized_s += seconds(t0);
+    t0 = std::chrono::steady_clock::now();
+    ssd1306_ref_draw(expected, w, h, &c);
+    t.reference_s += seconds(t0);
+    t.cases++;
+
+    if (memcmp(frame, expected, size) == 0) {
+        return true;
+    }
+    target.mismatches++;
+    if (verbose) {
+        report(target, c, frame, expected, w, h, true);
+    }
+    return false;
+}
+
+#ifdef SSD1306_FUZZ_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static RowCanvas canvas;
+    static SSD1306 oled(i2c0);
+    static bool panel_ready = false;
+    static Target rowmajor = {"rowmajor", SSD1306_REF_BASIC_MASK, 0, {}};
+    static Target blend = {"blend", 1u << SSD1306_REF_FILL_RECT, 0, {}};
+    static Target ssd1306 = {"ssd1306", SSD1306_REF_ALL_MASK, 0, {}};
+    if (!panel_ready) {
+        const char* rotation = getenv("SSD1306_FUZZ_ROTATION");
+        if (!beginPanel(oled, (uint8_t)(rotation ? atoi(rotation) & 3 : 0))) {
+            abort();
+        }
+        panel_ready = true;
+    }
+    ssd1306_ref_case_t c;
+    uint32_t state = 0x9E3779B9u;
+    if (!ssd1306_ref_case_from_bytes(data, size, SSD1306_REF_ALL_MASK, &c)) {
+        return 0;
+    }
+    bool ok = checkSSD1306(ssd1306, oled, c, &state, true);
+    if ((SSD1306_REF_BASIC_MASK >> c.prim) & 1) {
+        ok = checkRowMajor(rowmajor, canvas, c, &state, true) && ok;
+    }
+    if (c.prim == SSD1306_REF_FILL_RECT) {
+        ok = checkBlend(blend, c, &state, true) && ok;
+    }
+    if (!ok) {
+        abort();
+    }
+    return 0;
+}
+#else
+int main(int argc, char** argv) {
+    unsigned long count = 200000;
+    uint32_t seed = 1;
+    int rotation = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            count = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            g_width = (int16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc) {
+            g_height = (int16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rotation = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [-n 用例数] [-s 种子] [-w 宽度] [-h 高度] [-r 旋转0-3]\n", argv[0]);
+            return 2;
+        }
+    }
+    // RowCanvas的尺寸按8对齐
+    g_width = (int16_t)(g_width / 8 * 8);
+    g_height = (int16_t)(g_height / 8 * 8);
+    if (g_width < 8 || g_width > RowCanvas::MAX_WIDTH || g_height < 8 || g_height > RowCanvas::MAX_HEIGHT) {
+        fprintf(stderr, "尺寸须在8x8到%dx%d之间\n", RowCanvas::MAX_WIDTH, RowCanvas::MAX_HEIGHT);
+        return 2;
+    }
+    if (rotation < 0 || rotation > 3) {
+        fprintf(stderr, "旋转须为0-3\n");
+        return 2;
+    }
+    if (!seed) {
+        seed = 1;
+    }
+
+    static RowCanvas canvas(g_width, g_height);
+    static SSD1306 oled(i2c0);
+    if (!beginPanel(oled, (uint8_t)rotation)) {
+        fprintf(stderr, "SSD1306初始化失败\n");
+        return 1;
+    }
+    Target targets[3] = {
+        {"rowmajor", SSD1306_REF_BASIC_MASK, 0, {}},
+        {"blend", 1u << SSD1306_REF_FILL_RECT, 0, {}},
+        {"ssd1306", SSD1306_REF_ALL_MASK, 0, {}},
+    };
+    printf("种子 %lu, %lu个用例, 画面%dx%d, SSD1306 %dx%d（旋转%d）\n", (unsigned long)seed, count, g_width,
+           g_height, oled.width(), oled.height(), rotation);
+
+    uint32_t state = seed;
+    for (unsigned long n = 0; n < count; n++) {
+        for (Target& target : targets) {
+            ssd1306_ref_case_t c;
+            // 只打印前几个不一致
+            const bool verbose = target.mismatches < 3;
+            if (&target == &targets[2]) {
+                ssd1306_ref_random_case(&state, target.prim_mask, oled.width(), oled.height(), &c);
+                checkSSD1306(target, oled, c, &state, verbose);
+                continue;
+            }
+            ssd1306_ref_random_case(&state, target.prim_mask, g_width, g_height, &c);
+            if (&target == &targets[0]) {
+                checkRowMajor(target, canvas, c, &state, verbose);
+            } else {
+                checkBlend(target, c, &state, verbose);
+            }
+        }
+    }
+
+    unsigned long total = 0;
+    for (const Target& target : targets) {
+        printf("%-9s 不一致 %lu\n", target.name, target.mismatches);
+        for (uint8_t p = 0; p < SSD1306_REF_PRIM_COUNT; p++) {
+            const Timing& t = target.timing[p];
+            if (!t.cases) {
+                continue;
+            }
+            printf("  %-12s %7lu例  优化 %8.1f ns/例  参考 %9.1f ns/例\n", ssd1306_ref_prim_name(p), t.cases,
+                   t.optimized_s * 1e9 / t.cases, t.reference_s * 1e9 / t.cases);
+        }
+        total += target.mismatches;
+    }
+    return total ? 1 : 0;
+}
+#endif
@@ -0,0 +1,275 @@
+// SSD1306黄金图像比较工具（主机端）
+//
+// 读取示例在GOLDEN_SCENES=1时输出的串口日志（可混有普通printf输出）或
+// tools/ssd1306_golden_render的输出，对每个$SSDG场景：
+//   - 与<黄金图像目录>/<场景名>.pbm逐像素比较，不一致时打印差异图，
+//     并把实际画面保存为<输出目录>/<场景名>.actual.pbm
+//   - $SSDC开销记录（SSD1306_INSTRUMENT=1时输出）与<黄金图像目录>/costs.txt比较，
+//     像素、原语调用、I2C事务或字节任一项超过基线×(1+开销容差)时判为开销退化；
+//   - 与<黄金图像目录>/timings.txt中的耗时基线比较，超过基线×(1+容差)+抖动余量时判为退化
+// 任一场景画面不一致、缺少黄金图像、开销或耗时退化时返回非0。
+//
+// 开销是驱动计数，与时钟无关，主机端渲染（tools/ssd1306_golden_render以SSD1306_INSTRUMENT=1
+// 编译）与设备上相同，costs.txt提交在仓库中，CI据此检查性能退化。绘图或传输有意改变时，
+// 用主机端渲染加-u重新生成，并在提交中说明计数的变化。
+// 耗时只在设备上有意义：基线须在已知正确的版本上用设备日志加-u记录，且只适用于同一硬件、
+// 同一编译选项。主机端渲染的记录耗时为0，不做耗时比较，-u时也不写入耗时基线；
+// 仓库中不提交timings.txt。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_golden.cpp src/ssd1306_golden.cpp -o ssd1306_golden
+// 用法: ssd1306_golden [-g 黄金图像目录] [-o 输出目录] [-u] [-t 容差%] [-c 开销容差%] [-w 宽度] [日志文件]
+//       -u 用本次日志更新黄金图像、开销与耗时基线（不做比较）
+
+#include "ssd1306_golden.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#define TIMING_SLACK_US 20 // 中断等引起的抖动余量
+
+static std::map<std::string, ssd1306_golden_cost_t> loadCosts(const std::string& path) {
+    std::map<std::string, ssd1306_golden_cost_t> costs;
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        return costs;
+    }
+    char line[128], name[SSD1306_GOLDEN_NAME_MAX];
+    unsigned long v[SSD1306_GOLDEN_COST_FIELDS];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] != '#' && sscanf(line, "%31s %lu %lu %lu %lu", name, &v[0], &v[1], &v[2], &v[3]) == 5) {
+            costs[name] = {(uint32_t)v[0], (uint32_t)v[1], (uint32_t)v[2], (uint32_t)v[3]};
+        }
+    }
+    fclose(f);
+    return costs;
+}
+
+static bool writeCosts(const std::string& path, const std::map<std::string, ssd1306_golden_cost_t>& costs) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    fprintf(f, "# 场景 像素 原语调用 I2C事务 I2C字节（ssd1306_golden_render以SSD1306_INSTRUMENT=1编译，-u生成）\n");
+    for (const auto& kv : costs) {
+        fprintf(f, "%s %lu %lu %lu %lu\n", kv.first.c_str(), (unsigned long)kv.second.pixels,
+                (unsigned long)kv.second.calls, (unsigned long)kv.second.txns, (unsigned long)kv.second.bytes);
+    }
+    fclose(f);
+    return true;
+}
+
+static std::map<std::string, uint32_t> loadTimings(const std::string& path) {
+    std::map<std::string, uint32_t> timings;
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        return timings;
+    }
+    char name[SSD1306_GOLDEN_NAME_MAX];
+    unsigned long us;
+    while (fscanf(f, "%31s %lu", name, &us) == 2) {
+        timings[name] = (uint32_t)us;
+    }
+    fclose(f);
+    return timings;
+}
+
+int main(int argc, char** argv) {
+    std::string golden_dir = "tools/golden";
+    std::string out_dir = ".";
+    bool update = false;
+    int tolerance = 25;
+    int cost_tolerance = 2;
+    int width = 128;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            golden_dir = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tolerance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cost_tolerance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (width <= 0 || width > 0xFFFF || tolerance < 0 || cost_tolerance < 0) {
+        fprintf(stderr, "无效的参数\n");
+        return 1;
+    }
+
+    FILE* in = path ? fopen(path, "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "无法打开 %s\n", path);
+        return 1;
+    }
+
+    const std::string timings_path = golden_dir + "/timings.txt";
+    std::map<std::string, uint32_t> baseline = loadTimings(timings_path);
+    std::map<std::string, uint32_t> measured;
+    if (!update && baseline.empty()) {
+        printf("没有耗时基线（%s），不比较耗时\n", timings_path.c_str());
+    }
+    const std::string costs_path = golden_dir + "/costs.txt";
+    const std::map<std::string, ssd1306_golden_cost_t> cost_baseline = loadCosts(costs_path);
+    std::map<std::string, ssd1306_golden_cost_t> costs;
+
+    static char line[16384];
+    static uint8_t frame[4096];
+    static uint8_t expected[4096];
+    char name[SSD1306_GOLDEN_NAME_MAX];
+    uint32_t render_us;
+    size_t len;
+    unsigned long scenes = 0, failed = 0, slow = 0, costly = 0, corrupt = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        if (strstr(line, SSD1306_GOLDEN_COST_PREFIX)) {
+            ssd1306_golden_cost_t cost;
+            if (!ssd1306_golden_cost_parse_line(line, name, sizeof(name), &cost)) {
+                corrupt++;
+                continue;
+            }
+            costs[name] = cost;
+            auto base = cost_baseline.find(name);
+            if (update || base == cost_baseline.end()) {
+                continue;
+            }
+            for (uint8_t f = 0; f < SSD1306_GOLDEN_COST_FIELDS; f++) {
+                const uint32_t actual = ssd1306_golden_cost_field(&cost, f);
+                const uint32_t limit = ssd1306_golden_cost_field(&base->second, f);
+                if (actual > (uint64_t)limit * (100 + cost_tolerance) / 100) {
+                    costly++;
+                    printf("%-24s 开销退化: %s %lu，基线%lu\n", name, ssd1306_golden_cost_field_name(f),
+                           (unsigned long)actual, (unsigned long)limit);
+                }
+            }
+            continue;
+        }
+        if (!strstr(line, SSD1306_GOLDEN_PREFIX)) {
+            continue;
+        }
+        if (!ssd1306_golden_parse_line(line, name, sizeof(name), &render_us, frame, sizeof(frame), &len) ||
+            (len * 8) % width != 0) {
+            corrupt++;
+            continue;
+        }
+        scenes++;
+        if (render_us) {
+            measured[name] = render_us;
+        }
+        const uint16_t height = (uint16_t)(len * 8 / width);
+        const std::string golden_path = golden_dir + "/" + name + ".pbm";
+
+        if (update) {
+            FILE* f = fopen(golden_path.c_str(), "wb");
+            if (!f || !ssd1306_pbm_write(f, frame, (uint16_t)width, height)) {
+                fprintf(stderr, "无法写入 %s\n", golden_path.c_str());
+                return 1;
+            }
+            fclose(f);
+            printf("%-24s 已更新 (%luus)\n", name, (unsigned long)render_us);
+            continue;
+        }
+
+        FILE* f = fopen(golden_path.c_str(), "rb");
+        bool loaded = f && ssd1306_pbm_read(f, expected, (uint16_t)width, height);
+        if (f) {
+            fclose(f);
+        }
+
+        ssd1306_frame_diff_t diff;
+        bool pass = loaded && ssd1306_frame_diff(frame, expected, (uint16_t)width, height, &diff) == 0;
+        if (!pass) {
+            failed++;
+            const std::string actual_path = out_dir + "/" + name + ".actual.pbm";
+            FILE* a = fopen(actual_path.c_str(), "wb");
+            if (a) {
+                ssd1306_pbm_write(a, frame, (uint16_t)width, height);
+                fclose(a);
+            }
+            if (!loaded) {
+                printf("%-24s 失败: 无法读取 %s，实际画面已保存到 %s\n", name, golden_path.c_str(),
+                       actual_path.c_str());
+            } else {
+                printf("%-24s 失败: %lu个像素不同，范围 (%u,%u)-(%u,%u)，实际画面已保存到 %s\n", name,
+                       (unsigned long)diff.pixels, diff.x0, diff.y0, diff.x1, diff.y1, actual_path.c_str());
+                ssd1306_frame_print_diff(stdout, frame, expected, (uint16_t)width, height, &diff);
+            }
+        }
+
+        auto base = render_us ? baseline.find(name) : baseline.end();
+        bool regressed = base != baseline.end() &&
+                         render_us > (uint64_t)base->second * (100 + tolerance) / 100 + TIMING_SLACK_US;
+        if (regressed) {
+            slow++;
+        }
+        if (pass) {
+            if (!render_us) {
+                printf("%-24s 通过\n", name);
+            } else if (base == baseline.end()) {
+                printf("%-24s 通过 %6luus\n", name, (unsigned long)render_us);
+            } else {
+                printf("%-24s 通过 %6luus (基线%luus%s)\n", name, (unsigned long)render_us,
+                       (unsigned long)base->second, regressed ? "，耗时退化" : "");
+            }
+        } else if (regressed) {
+            printf("%-24s 耗时退化: %luus，基线%luus\n", name, (unsigned long)render_us,
+                   (unsigned long)base->second);
+        }
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    if (update && !costs.empty() && !writeCosts(costs_path, costs)) {
+        fprintf(stderr, "无法写入 %s\n", costs_path.c_str());
+        return 1;
+    }
+    if (update && measured.empty()) {
+        printf("已更新 %lu 个场景%s（记录中没有设备耗时，保留原耗时基线）\n", scenes,
+               costs.empty() ? "" : "与开销基线");
+        return 0;
+    }
+    if (update) {
+        FILE* f = fopen(timings_path.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "无法写入 %s\n", timings_path.c_str());
+            return 1;
+        }
+        for (const auto& kv : measured) {
+            fprintf(f, "%s %lu\n", kv.first.c_str(), (unsigned long)kv.second);
+        }
+        fclose(f);
+        printf("已更新 %lu 个场景与耗时基线\n", scenes);
+        return 0;
+    }
+
+    // 主机端记录（没有耗时）在有开销基线时须有开销记录，避免未插桩的构建悄悄跳过检查；
+    // 设备日志可以只带耗时
+    unsigned long missing_costs = 0;
+    for (const auto& kv : measured.empty() && !update ? cost_baseline : decltype(cost_baseline)()) {
+        if (!costs.count(kv.first)) {
+            missing_costs++;
+        }
+    }
+    if (missing_costs) {
+        printf("%lu个场景没有开销记录（渲染程序须以SSD1306_INSTRUMENT=1编译）\n", missing_costs);
+        costly += missing_costs;
+    }
+
+    printf("场景: %lu, 画面不一致: %lu, 开销退化: %lu, 耗时退化: %lu, 损坏的记录: %lu\n", scenes, failed, costly,
+           slow, corrupt);
+    if (scenes == 0) {
+        fprintf(stderr, "日志中没有%s记录\n", SSD1306_GOLDEN_PREFIX);
+        return 1;
+    }
+    return (failed || costly || slow || corrupt) ? 2 : 0;
+}
@@ -0,0 +1,53 @@
+// SSD1306黄金图像场景的主机端渲染（不需要设备）
+//
+// 用主机端SDK替身（tools/host_stubs）编译SSD1306驱动和示例的表盘、场景代码
+// （examples/clock_face.cpp、examples/golden_scenes.cpp），渲染与设备上GOLDEN_SCENES=1时
+// 相同的一组场景，以$SSDG记录行输出到stdout，交给tools/ssd1306_golden比较或更新黄金图像。
+// 绘图代码与设备上完全相同，画面应逐像素一致；记录中的渲染耗时为0，ssd1306_golden对耗时为0的
+// 记录不做耗时比较（耗时基线只能来自设备日志）。以SSD1306_INSTRUMENT=1编译时每个场景另输出
+// $SSDC开销记录（像素、原语调用、I2C事务与字节），由ssd1306_golden与tools/golden/costs.txt比较，
+// 在主机上检查性能退化。
+//
+// 编译: g++ -std=c++17 -O2 -DSSD1306_INSTRUMENT=1 -Itools/host_stubs -Iinclude -Iexamples tools/ssd1306_golden_render.cpp examples/clock_face.cpp examples/golden_scenes.cpp src/ssd1306*.cpp src/i2c_bus.cpp tools/host_stubs/host_stubs.cpp -o ssd1306_golden_render
+// 用法: ssd1306_golden_render | ssd1306_golden [-g 黄金图像目录] [-u]
+
+#include "host_stubs.h"
+#include "ssd1306.h"
+#include "ssd1306_golden.h"
+#include "golden_scenes.h"
+#include <cstdio>
+#include <cstring>
+
+// 面板：接受所有写入
+static bool panelWrite(void* ctx, const uint8_t* src, size_t len) {
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        fprintf(stderr, "用法: %s | ssd1306_golden [-g 黄金图像目录] [-u]\n", argv[0]);
+        return 2;
+    }
+
+    static const host_i2c_device_t panel = {panelWrite, nullptr, nullptr, nullptr};
+    i2c_init(i2c0, 400000);
+    host_i2c_attach(i2c0, SSD1306::ADDRESS, &panel);
+
+    SSD1306 oled(i2c0);
+    if (!oled.begin()) {
+        fprintf(stderr, "SSD1306初始化失败\n");
+        return 1;
+    }
+
+    const size_t size = oled.width() * ((oled.height() + 7) / 8);
+    for (size_t i = 0; i < golden_scene_count; i++) {
+#if SSD1306_INSTRUMENT
+        const ssd1306_golden_cost_t cost = golden_scene_cost(oled, golden_scenes[i]);
+        ssd1306_golden_cost_record(golden_scenes[i].name, &cost);
+#else
+        golden_scenes[i].render(oled);
+#endif
+        ssd1306_golden_record(golden_scenes[i].name, 0, oled.getBuffer(), size);
+    }
+    return 0;
+}
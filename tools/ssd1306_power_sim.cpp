@@ -0,0 +1,215 @@
+// 低功耗显示策略模拟（主机端）
+//
+// 按秒推进一段墙上时间，用与示例相同的布局在页格式帧缓冲中绘制时钟画面，
+// 对每种策略驱动PowerManager：唤醒（每秒SQW、每分钟闹钟或随机按键）时读取RTC、
+// 按计划重绘并求传输窗口。模拟面板RAM，逐次应用传输窗口并与帧缓冲比对，
+// 验证局部刷新不会漏传。最后打印每小时的总线时间与唤醒时间。
+//
+// 唤醒时间按下列估算值累计：唤醒开销 + 重绘时间 + 阻塞传输时间。
+// 不用dormant时两次唤醒之间内核在WFE中，时钟仍在运行，因此另列“时钟运行”一栏。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_power_sim.cpp src/ssd1306_power.cpp -o ssd1306_power_sim
+// 用法: ssd1306_power_sim [-H 小时数] [-a 每小时按键次数] [-r 重绘时间us] [-w dormant唤醒开销us]
+
+#include "ssd1306_power.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define WIDTH 128
+#define PAGES 8
+#define YELLOW_HEIGHT 20
+
+#define RTC_BAUD 100000
+#define WFE_WAKE_US 10      // 从WFE唤醒并进入中断的开销
+
+static uint8_t frame[WIDTH * PAGES];
+
+static void pixel(int x, int y) {
+    if (x >= 0 && x < WIDTH && y >= 0 && y < PAGES * 8) {
+        frame[(y / 8) * WIDTH + x] |= 1 << (y & 7);
+    }
+}
+
+static void hline(int x, int y, int w) {
+    for (int i = 0; i < w; i++) pixel(x + i, y);
+}
+
+static void vline(int x, int y, int h) {
+    for (int i = 0; i < h; i++) pixel(x, y + i);
+}
+
+// 与示例相同的14x28七段数字
+static void digit(int x, int y, int d) {
+    static const uint8_t seg[10] = {0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70, 0x7F, 0x7B};
+    uint8_t p = seg[d];
+    if (p & 0x40) hline(x + 1, y + 1, 12);
+    if (p & 0x20) vline(x + 12, y + 3, 10);
+    if (p & 0x10) vline(x + 12, y + 15, 10);
+    if (p & 0x08) hline(x + 1, y + 25, 12);
+    if (p & 0x04) vline(x + 1, y + 15, 10);
+    if (p & 0x02) vline(x + 1, y + 3, 10);
+    if (p & 0x01) hline(x + 1, y + 13, 12);
+}
+
+static void colon(int x, int y) {
+    pixel(x + 2, y + 8);
+    pixel(x + 2, y + 20);
+}
+
+// 文本只需在字符变化时改变对应的6列：每个字符画成由字符值决定的5x7图案
+static void text(int x, int y, const char* s) {
+    for (; *s; s++, x += 6) {
+        for (int c = 0; c < 5; c++) {
+            uint8_t bits = (uint8_t)((*s * 37 + c * 11) ^ (*s >> 1)) & 0x7F;
+            for (int r = 0; r < 7; r++) {
+                if (bits & (1 << r)) pixel(x + c, y + r);
+            }
+        }
+    }
+}
+
+static void render(uint32_t sod, uint32_t day, float temperature, bool show_seconds) {
+    memset(frame, 0, sizeof(frame));
+    static const char* weekdays[] = {"Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed"};
+    char buf[16];
+    snprintf(buf, sizeof(buf), "2026-01-%02u", 1 + day % 31);
+    text(2, 1, buf);
+    text(2, 9, weekdays[day % 7]);
+    snprintf(buf, sizeof(buf), "%.1fC", temperature);
+    text(90, 9, buf);
+
+    uint32_t h = sod / 3600, m = sod / 60 % 60, s = sod % 60;
+    int x = show_seconds ? 14 : 29;
+    int y = YELLOW_HEIGHT + 8;
+    digit(x, y, h / 10);
+    digit(x + 16, y, h % 10);
+    colon(x + 34, y + 2);
+    digit(x + 40, y, m / 10);
+    digit(x + 56, y, m % 10);
+    if (show_seconds) {
+        colon(x + 70, y + 2);
+        digit(x + 76, y, s / 10);
+        digit(x + 92, y, s % 10);
+    }
+}
+
+struct Policy {
+    const char* name;
+    ssd1306_power_policy_t policy;
+};
+
+int main(int argc, char** argv) {
+    double hours = 24.0;
+    double presses_per_hour = 4.0;
+    uint32_t render_us = 800;
+    uint32_t dormant_wake_us = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+            hours = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            presses_per_hour = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            render_us = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            dormant_wake_us = (uint32_t)atoi(argv[++i]);
+        }
+    }
+    if (hours <= 0.0 || presses_per_hour < 0.0) {
+        fprintf(stderr, "无效的参数\n");
+        return 1;
+    }
+
+    const Policy policies[] = {
+        {"每秒整屏刷新",   {0, 0, 0, 0, 0, false, false, false}},
+        {"局部刷新",       {0, 0, 0, 0, 0, true, false, false}},
+        {"局部+夜间关闭",  {0, 0, 23 * 60, 7 * 60, 60, true, false, false}},
+        {"空闲每分钟刷新", {60, 0, 0, 0, 0, true, true, false}},
+        {"+夜间关闭面板",  {60, 0, 23 * 60, 7 * 60, 60, true, true, false}},
+        {"+dormant",       {60, 0, 23 * 60, 7 * 60, 60, true, true, true}},
+    };
+
+    // 从当地0点开始；按键只出现在07:00-23:00，各策略使用同一组按键时刻
+    const uint32_t start = 1767225600; // 2026-01-01 00:00:00
+    const uint32_t end = start + (uint32_t)(hours * 3600);
+    std::vector<uint32_t> presses;
+    if (presses_per_hour > 0.0) {
+        std::mt19937 rng(1);
+        std::exponential_distribution<double> gap(presses_per_hour / 3600.0);
+        for (double t = start + gap(rng); t < end; t += gap(rng)) {
+            uint32_t sod = (uint32_t)(t - start) % 86400;
+            if (sod >= 7 * 3600 && sod < 23 * 3600) {
+                presses.push_back((uint32_t)t);
+            }
+        }
+    }
+
+    printf("模拟 %.1f 小时, 按键 %zu 次; 估算: 重绘%luus, dormant唤醒%luus, WFE唤醒%dus\n\n",
+           hours, presses.size(), (unsigned long)render_us, (unsigned long)dormant_wake_us, WFE_WAKE_US);
+    printf("%-16s %10s %10s %8s %8s %10s %12s %8s\n",
+           "策略(每小时)", "总线ms", "字节", "唤醒", "刷新", "运行ms", "时钟运行ms", "面板%");
+
+    int errors = 0;
+    for (const Policy& pol : policies) {
+        PowerManager pm(pol.policy);
+
+        static uint8_t panel[WIDTH * PAGES];
+        memset(panel, 0, sizeof(panel));
+        size_t next_press = 0;
+        uint32_t t = start;
+        uint32_t next_wake = start;
+        uint8_t wake_period = 1;
+
+        while (t < end) {
+            bool pressed = next_press < presses.size() && presses[next_press] <= next_wake;
+            uint32_t now = pressed ? presses[next_press++] : next_wake;
+            t = now;
+
+            const uint64_t bus_before = pm.stats().bus_us;
+            pm.accountTransfer(1 + 7, 2, RTC_BAUD);
+            if (!pressed && wake_period == 60) {
+                pm.accountTransfer(2, 1, RTC_BAUD);
+            }
+            if (pressed) {
+                pm.activity(t);
+            }
+
+            const uint32_t sod = (t - start) % 86400;
+            ssd1306_power_plan_t plan = pm.plan(t, (uint16_t)(sod / 60));
+            uint32_t awake = pol.policy.dormant ? dormant_wake_us : WFE_WAKE_US;
+            if (plan.redraw) {
+                float temperature = 20.0f + 0.25f * ((t / 900) % 8);
+                render(sod, (t - start) / 86400, temperature, plan.show_seconds);
+                ssd1306_power_region_t r;
+                if (pm.flush(frame, WIDTH, PAGES, &r)) {
+                    for (uint8_t p = r.page0; p <= r.page1; p++) {
+                        memcpy(&panel[p * WIDTH + r.x0], &frame[p * WIDTH + r.x0], r.x1 - r.x0 + 1);
+                    }
+                }
+                if (memcmp(panel, frame, sizeof(frame)) != 0 && errors++ < 5) {
+                    fprintf(stderr, "%s: %u 面板内容与帧缓冲不一致\n", pol.name, t);
+                }
+                awake += render_us;
+            }
+            awake += (uint32_t)(pm.stats().bus_us - bus_before);
+            pm.accountAwake(awake);
+
+            wake_period = plan.wake_period_s;
+            next_wake = wake_period == 1 ? t + 1 : (t / 60 + 1) * 60;
+        }
+        pm.plan(end, (uint16_t)(((end - start) % 86400) / 60));
+
+        ssd1306_power_report_t rep;
+        pm.report(&rep);
+        const double clock_ms = pol.policy.dormant ? rep.awake_ms : 3600.0 * 1000.0;
+        printf("%-16s %10.1f %10.0f %8.0f %8.0f %10.1f %12.1f %8.1f\n", pol.name, rep.bus_ms, rep.bus_bytes,
+               rep.wakeups, rep.flushes, rep.awake_ms, clock_ms, rep.panel_on_pct);
+    }
+    if (errors) {
+        fprintf(stderr, "局部刷新错误: %d\n", errors);
+    }
+    return errors ? 2 : 0;
+}
@@ -0,0 +1,138 @@
+// SSD1306帧记录回放工具（主机端）
+//
+// 读取FrameRecorder输出的串口日志（可混有普通printf输出），逐帧解码并以
+// 字符画显示，最后打印压缩率统计。
+// 记录行损坏（无法解析或解码）或序号不连续（丢行）时失去同步，之后的差分帧
+// 跳过，直到下一个关键帧。
+//
+// tools/captures/ds3231_clock.log是时钟表盘连续3分钟的记录（由
+// tools/ds3231_clock_capture.cpp在主机上生成），可作为压缩率的基准输入：
+//   ssd1306_replay -q tools/captures/ds3231_clock.log
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_replay.cpp src/ssd1306_codec.cpp -o ssd1306_replay
+// 用法: ssd1306_replay [-q] [-w 宽度] [日志文件]   （省略文件时读取stdin）
+//       -q 只输出统计，不显示画面
+
+#include "ssd1306_codec.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void printFrame(const uint8_t* frame, int width, int height) {
+    // 每个字符表示上下2个像素
+    static const char glyphs[4] = {' ', '\'', '.', ':'};
+    for (int y = 0; y < height; y += 2) {
+        for (int x = 0; x < width; x++) {
+            int top = (frame[x + (y / 8) * width] >> (y & 7)) & 1;
+            int bottom = (y + 1 < height) ? (frame[x + ((y + 1) / 8) * width] >> ((y + 1) & 7)) & 1 : 0;
+            putchar(glyphs[top | (bottom << 1)]);
+        }
+        putchar('\n');
+    }
+}
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    int width = 128;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (width <= 0) {
+        fprintf(stderr, "无效的宽度\n");
+        return 1;
+    }
+
+    FILE* in = path ? fopen(path, "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "无法打开 %s\n", path);
+        return 1;
+    }
+
+    static char line[8192];
+    static uint8_t payload[SSD1306_CODEC_MAX_SIZE(4096)];
+    static uint8_t frame[4096];
+    bool synced = false;
+    bool have_seq = false;
+    uint32_t next_seq = 0;
+    uint64_t last_ts = 0;
+    unsigned long frames = 0, keys = 0, errors = 0, dropped = 0, skipped = 0;
+    unsigned long long raw_bytes = 0, encoded_bytes = 0, line_bytes = 0;
+    size_t min_size = (size_t)-1, max_size = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        if (!strstr(line, SSD1306_RECORD_PREFIX)) {
+            continue; // 普通输出
+        }
+
+        uint32_t seq;
+        uint64_t ts;
+        size_t len;
+        if (!ssd1306_record_parse_line(line, &seq, &ts, payload, sizeof(payload), &len)) {
+            errors++;
+            synced = false;
+            continue;
+        }
+
+        // 序号不连续：中间的行丢失，缓冲区中的上一帧已不可信
+        if (have_seq && seq != next_seq) {
+            dropped += (uint32_t)(seq - next_seq);
+            synced = false;
+        }
+        have_seq = true;
+        next_seq = seq + 1;
+
+        const bool key = payload[0] == SSD1306_CODEC_KEY;
+        const size_t size = payload[1] | (payload[2] << 8);
+        if (!key && !synced) {
+            skipped++;
+            continue;
+        }
+        if (size > sizeof(frame) || !ssd1306_codec_decode(payload, len, frame, size)) {
+            errors++;
+            synced = false;
+            continue;
+        }
+        synced = true;
+
+        frames++;
+        keys += key;
+        raw_bytes += size;
+        encoded_bytes += len;
+        line_bytes += strlen(line);
+        if (len < min_size) min_size = len;
+        if (len > max_size) max_size = len;
+
+        if (!quiet) {
+            printf("帧 %lu  #%lu  t=%llu us  +%llu us  %s  %zu -> %zu 字节\n",
+                   frames, (unsigned long)seq, (unsigned long long)ts,
+                   (unsigned long long)(frames > 1 ? ts - last_ts : 0),
+                   key ? "关键帧" : "差分帧", size, len);
+            printFrame(frame, width, (int)(size * 8 / width));
+        }
+        last_ts = ts;
+    }
+
+    if (path) {
+        fclose(in);
+    }
+
+    printf("\n帧数: %lu (关键帧 %lu), 解码失败: %lu, 缺失序号: %lu, 等待关键帧跳过: %lu\n", frames, keys, errors,
+           dropped, skipped);
+    if (frames) {
+        printf("原始: %llu 字节, 编码: %llu 字节, 压缩率: %.1f:1\n",
+               raw_bytes, encoded_bytes, (double)raw_bytes / encoded_bytes);
+        printf("每帧编码长度: 最小 %zu, 平均 %.1f, 最大 %zu\n",
+               min_size, (double)encoded_bytes / frames, max_size);
+        printf("串口文本（含base64）: %llu 字节, 相对原始帧十六进制输出节省 %.1f%%\n",
+               line_bytes, 100.0 * (1.0 - (double)line_bytes / (raw_bytes * 2)));
+    }
+    return errors || dropped ? 2 : 0;
+}
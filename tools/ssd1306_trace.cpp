@@ -0,0 +1,143 @@
+// SSD1306追踪日志转换工具（主机端）
+//
+// 读取SSD1306_INSTRUMENT=1时输出的串口日志（可混有普通printf输出），提取$SSDT记录行，
+// 转换为Chrome trace格式的JSON（在chrome://tracing或ui.perfetto.dev中打开），
+// 并在stderr打印各区间的次数与耗时统计。
+//
+// 追踪区间由作用域对象产生，严格嵌套；按栈配对BEGIN/END。缓冲区输出前已结束的
+// 区间的END可能出现在日志开头而没有对应的BEGIN，这类事件与末尾未结束的BEGIN都被丢弃。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_trace.cpp src/ssd1306_trace.cpp -o ssd1306_trace
+// 用法: ssd1306_trace [-o 输出文件] [日志文件]   （省略时读取stdin、输出到stdout）
+
+#include "ssd1306_trace.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Event {
+    std::string name;
+    uint64_t ts_us;
+    char phase;
+    bool keep;
+};
+
+struct Summary {
+    unsigned long count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+};
+
+static void writeJsonString(FILE* out, const std::string& s) {
+    fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if ((unsigned char)c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+int main(int argc, char** argv) {
+    const char* in_path = nullptr;
+    const char* out_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            in_path = argv[i];
+        }
+    }
+
+    FILE* in = in_path ? fopen(in_path, "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "无法打开 %s\n", in_path);
+        return 1;
+    }
+
+    std::vector<Event> events;
+    static char line[1024];
+    char name[128];
+    uint64_t ts;
+    char phase;
+    while (fgets(line, sizeof(line), in)) {
+        if (ssd1306_trace_parse_line(line, &ts, &phase, name, sizeof(name))) {
+            events.push_back({name, ts, phase, false});
+        }
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    // 按栈配对；名称不符说明中间有事件丢失（缓冲区满），此时清空栈重新开始
+    std::vector<size_t> stack;
+    std::map<std::string, Summary> summary;
+    unsigned long unmatched = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        Event& ev = events[i];
+        if (ev.phase == SSD1306_TRACE_BEGIN) {
+            stack.push_back(i);
+            continue;
+        }
+        if (stack.empty() || events[stack.back()].name != ev.name) {
+            unmatched += 1 + stack.size();
+            stack.clear();
+            continue;
+        }
+        Event& begin = events[stack.back()];
+        stack.pop_back();
+        begin.keep = true;
+        ev.keep = true;
+
+        Summary& s = summary[ev.name];
+        const uint64_t d = ev.ts_us - begin.ts_us;
+        s.count++;
+        s.total_us += d;
+        if (d > s.max_us) {
+            s.max_us = d;
+        }
+    }
+    unmatched += stack.size();
+
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "无法写入 %s\n", out_path);
+        return 1;
+    }
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+    bool first = true;
+    for (const Event& ev : events) {
+        if (!ev.keep) {
+            continue;
+        }
+        if (!first) {
+            fputs(",\n", out);
+        }
+        first = false;
+        fputs("{\"name\":", out);
+        writeJsonString(out, ev.name);
+        fprintf(out, ",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":1}", ev.phase, (unsigned long long)ev.ts_us);
+    }
+    fputs("\n]}\n", out);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    fprintf(stderr, "事件: %zu, 区间: %lu, 未配对丢弃: %lu\n", events.size(),
+            (unsigned long)((events.size() - unmatched) / 2), unmatched);
+    fprintf(stderr, "%-20s %8s %10s %10s\n", "区间", "次数", "平均us", "最长us");
+    for (const auto& kv : summary) {
+        const Summary& s = kv.second;
+        fprintf(stderr, "%-20s %8lu %10.1f %10llu\n", kv.first.c_str(), s.count, (double)s.total_us / s.count,
+                (unsigned long long)s.max_us);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// 8x8位矩阵转置基准（主机端）
+//
+// 比较ssd1306_transpose8x8()（32位掩码交换）与两种朴素做法：
+//   逐位转置   每个8x8块按64次取位/置位转置
+//   逐像素旋转 整帧按像素交换坐标（绘图时做坐标变换的等价开销）
+// 先用随机块（含不同步长）核对转置结果，再按90度显示刷新的方式转换整个1KB帧
+// （64x128逻辑画布 -> 128x64面板，共128个块）并计时。
+// 主机上的数字只用于比较几种做法的相对开销。
+//
+// 编译: g++ -std=c++17 -O2 -Iinclude tools/ssd1306_transpose_bench.cpp -o ssd1306_transpose_bench
+// 用法: ssd1306_transpose_bench [-n 整帧转换次数]
+
+#include "ssd1306_transform.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+// 逻辑画布（旋转90度后）与面板
+#define LOGICAL_W 64
+#define LOGICAL_H 128
+#define PANEL_W 128
+#define PANEL_H 64
+#define SIZE (PANEL_W * PANEL_H / 8)
+
+static void naiveTranspose(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride) {
+    for (int j = 0; j < 8; j++) {
+        uint8_t v = 0;
+        for (int i = 0; i < 8; i++) {
+            v |= (uint8_t)(((src[i * src_stride] >> j) & 1) << i);
+        }
+        dst[j * dst_stride] = v;
+    }
+}
+
+// 与SSD1306::displayRegion()相同的块顺序：面板第p页由逻辑画布第p列块组成
+template <void (*Transpose)(const uint8_t*, size_t, uint8_t*, size_t)>
+static void frameByBlocks(const uint8_t* logical, uint8_t* panel) {
+    for (int p = 0; p < PANEL_H / 8; p++) {
+        uint8_t* out = &panel[p * PANEL_W];
+        for (int q = 0; q < LOGICAL_H / 8; q++) {
+            Transpose(&logical[q * LOGICAL_W + p * 8], 1, &out[q * 8], 1);
+        }
+    }
+}
+
+static void kernelTranspose(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride) {
+    ssd1306_transpose8x8(src, src_stride, dst, dst_stride);
+}
+
+// 逐像素：逻辑(x, y)落在面板(y, x)
+static void frameByPixels(const uint8_t* logical, uint8_t* panel) {
+    memset(panel, 0, SIZE);
+    for (int y = 0; y < LOGICAL_H; y++) {
+        for (int x = 0; x < LOGICAL_W; x++) {
+            if ((logical[x + (y / 8) * LOGICAL_W] >> (y & 7)) & 1) {
+                panel[y + (x / 8) * PANEL_W] |= (uint8_t)(1 << (x & 7));
+            }
+        }
+    }
+}
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <typename Fn>
+static double timeFrames(Fn fn, const uint8_t* logical, uint8_t* panel, unsigned long runs) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < runs; i++) {
+        fn(logical, panel);
+        // 防止编译器把多次转换合并
+        __asm__ __volatile__("" : : "r"(panel) : "memory");
+    }
+    return seconds(t0) * 1e9 / runs;
+}
+
+int main(int argc, char** argv) {
+    unsigned long runs = 20000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [-n 整帧转换次数]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!runs) {
+        runs = 1;
+    }
+
+    // 随机块，源与目标步长各取1-16
+    std::mt19937 rng(1);
+    unsigned long block_mismatches = 0;
+    const unsigned long blocks = 200000;
+    for (unsigned long n = 0; n < blocks; n++) {
+        uint8_t src[8 * 16], a[8 * 16], b[8 * 16];
+        for (uint8_t& v : src) {
+            v = (uint8_t)rng();
+        }
+        const size_t ss = 1 + rng() % 16, ds = 1 + rng() % 16;
+        memset(a, 0, sizeof(a));
+        memset(b, 0, sizeof(b));
+        ssd1306_transpose8x8(src, ss, a, ds);
+        naiveTranspose(src, ss, b, ds);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            block_mismatches++;
+        }
+    }
+
+    static uint8_t logical[SIZE], kernel[SIZE], naive[SIZE], pixels[SIZE];
+    for (uint8_t& v : logical) {
+        v = (uint8_t)rng();
+    }
+    frameByBlocks<kernelTranspose>(logical, kernel);
+    frameByBlocks<naiveTranspose>(logical, naive);
+    frameByPixels(logical, pixels);
+    const bool frame_ok = memcmp(kernel, naive, SIZE) == 0 && memcmp(kernel, pixels, SIZE) == 0;
+
+    const double kernel_ns = timeFrames(frameByBlocks<kernelTranspose>, logical, kernel, runs);
+    const double naive_ns = timeFrames(frameByBlocks<naiveTranspose>, logical, naive, runs / 4 ? runs / 4 : 1);
+    const double pixel_ns = timeFrames(frameByPixels, logical, pixels, runs / 16 ? runs / 16 : 1);
+
+    printf("随机块: %lu, 不一致: %lu; 整帧三种做法结果%s\n", blocks, block_mismatches, frame_ok ? "一致" : "不一致");
+    printf("整帧90度转换（128块，主机测量）:\n");
+    printf("  掩码交换   %9.0f ns/帧  %6.1f ns/块\n", kernel_ns, kernel_ns / 128);
+    printf("  逐位转置   %9.0f ns/帧  %6.1f ns/块  %5.1fx\n", naive_ns, naive_ns / 128, naive_ns / kernel_ns);
+    printf("  逐像素旋转 %9.0f ns/帧  %6.1f ns/块  %5.1fx\n", pixel_ns, pixel_ns / 128, pixel_ns / kernel_ns);
+    return block_mismatches || !frame_ok ? 1 : 0;
+}